@@ -18,6 +18,7 @@
 
 #include <AssetClient.h>
 #include <AvatarHashMap.h>
+#include <AudioCodec.h>
 #include <AudioInjectorManager.h>
 #include <AssetClient.h>
 #include <MessagesClient.h>
@@ -90,11 +91,11 @@ void Agent::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNo
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
             int piggyBackedSizeWithHeader = message->getSize() - statsMessageLength;
             
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketBuffer(new char[piggyBackedSizeWithHeader]);
             memcpy(buffer.get(), message->getRawMessage() + statsMessageLength, piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, message->getSenderSockAddr());
-            message = QSharedPointer<ReceivedMessage>::create(*newPacket);
+            message = QSharedPointer<ReceivedMessage>::create(std::move(newPacket));
         } else {
             return; // bail since no piggyback data
         }
@@ -420,6 +421,9 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
                 // write the number of silent samples so the audio-mixer can uphold timing
                 audioPacket->writePrimitive(SCRIPT_AUDIO_BUFFER_SAMPLES);
 
+                // scripted avatars take their mix as raw samples
+                audioPacket->writePrimitive((quint8)AudioCodec::PCM);
+
                 // use the orientation and position of this avatar for the source of this audio
                 audioPacket->writePrimitive(scriptedAvatar->getPosition());
                 glm::quat headOrientation = scriptedAvatar->getHeadOrientation();
@@ -429,6 +433,9 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
                 // assume scripted avatar audio is mono and set channel flag to zero
                 audioPacket->writePrimitive((quint8)0);
 
+                // scripted avatar audio is sent as raw samples
+                audioPacket->writePrimitive((quint8)AudioCodec::PCM);
+
                 // use the orientation and position of this avatar for the source of this audio
                 audioPacket->writePrimitive(scriptedAvatar->getPosition());
                 glm::quat headOrientation = scriptedAvatar->getHeadOrientation();
@@ -0,0 +1,74 @@
+//
+//  AudibilityGrid.cpp
+//  assignment-client/src/audio
+//
+//  Created by High Fidelity on 1/18/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PositionalAudioStream.h"
+
+#include "AudibilityGrid.h"
+
+const float AudibilityGrid::DEFAULT_CELL_SIZE = 16.0f;
+
+// cell coordinates are packed 21 bits per axis into the hash key, keep them inside that range
+const int MAX_CELL_COORDINATE = (1 << 20) - 1;
+
+AudibilityGrid::AudibilityGrid(float cellSize) :
+    _cellSize(cellSize),
+    _numEntries(0),
+    _maxTrailingLoudness(0.0f)
+{
+}
+
+void AudibilityGrid::clear() {
+    _cells.clear();
+    _cellIndices.clear();
+    _numEntries = 0;
+    _maxTrailingLoudness = 0.0f;
+}
+
+void AudibilityGrid::insert(const SharedNodePointer& node, const QUuid& streamUUID, PositionalAudioStream* stream) {
+    Entry entry { node, streamUUID, stream, stream->getPosition(), stream->getLastPopOutputTrailingLoudness() };
+
+    glm::ivec3 coordinates = cellCoordinatesFor(entry.position);
+    quint64 key = keyFor(coordinates);
+
+    auto it = _cellIndices.constFind(key);
+    int cellIndex;
+    if (it == _cellIndices.constEnd()) {
+        cellIndex = (int)_cells.size();
+        _cells.push_back({ coordinates, 0.0f, std::vector<Entry>() });
+        _cellIndices.insert(key, cellIndex);
+    } else {
+        cellIndex = it.value();
+    }
+
+    Cell& cell = _cells[cellIndex];
+    cell.maxTrailingLoudness = std::max(cell.maxTrailingLoudness, entry.trailingLoudness);
+    _maxTrailingLoudness = std::max(_maxTrailingLoudness, entry.trailingLoudness);
+
+    cell.entries.push_back(entry);
+    ++_numEntries;
+}
+
+glm::ivec3 AudibilityGrid::cellCoordinatesFor(const glm::vec3& position) const {
+    glm::vec3 coordinates = glm::clamp(glm::floor(position / _cellSize),
+                                       glm::vec3((float)-MAX_CELL_COORDINATE), glm::vec3((float)MAX_CELL_COORDINATE));
+    return glm::ivec3(coordinates);
+}
+
+quint64 AudibilityGrid::keyFor(const glm::ivec3& coordinates) {
+    const quint64 MASK = (1 << 21) - 1;
+    return ((quint64)(coordinates.x & MASK) << 42) | ((quint64)(coordinates.y & MASK) << 21) | (quint64)(coordinates.z & MASK);
+}
+
+float AudibilityGrid::distanceToCell(const glm::vec3& position, const Cell& cell) const {
+    glm::vec3 cellMinimum = glm::vec3(cell.coordinates) * _cellSize;
+    glm::vec3 closestPoint = glm::clamp(position, cellMinimum, cellMinimum + glm::vec3(_cellSize));
+    return glm::distance(position, closestPoint);
+}
@@ -0,0 +1,133 @@
+//
+//  AudibilityGrid.h
+//  assignment-client/src/audio
+//
+//  Created by High Fidelity on 1/18/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudibilityGrid_h
+#define hifi_AudibilityGrid_h
+
+#include <algorithm>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include <Node.h>
+#include <NumericalConstants.h>
+
+class PositionalAudioStream;
+
+/// A uniform hash grid of every audio stream that was popped this frame, rebuilt by the AudioMixer each frame.
+/// The mixer rejects a stream for a listener when its trailing loudness divided by its distance to the listener is at or
+/// below the minimum audibility threshold. Each cell keeps the loudest trailing loudness of its streams, so a listener
+/// can reject a whole cell with one test against the closest point of the cell, and never looks at cells that are out
+/// of range of even the loudest stream in the domain.
+class AudibilityGrid {
+public:
+    struct Entry {
+        SharedNodePointer node;         // the node the stream belongs to
+        QUuid streamUUID;               // the key the listener uses for its per source data
+        PositionalAudioStream* stream;
+        glm::vec3 position;
+        float trailingLoudness;
+    };
+
+    static const float DEFAULT_CELL_SIZE;
+
+    AudibilityGrid(float cellSize = DEFAULT_CELL_SIZE);
+
+    void clear();
+    void insert(const SharedNodePointer& node, const QUuid& streamUUID, PositionalAudioStream* stream);
+
+    int getNumCells() const { return (int)_cells.size(); }
+    int getNumEntries() const { return _numEntries; }
+
+    /// calls entryFunctor for every stream that is in a cell that could be audible at the listener position
+    /// returns the number of streams that were culled without being handed to entryFunctor
+    template<typename EntryFunctor>
+    int forEachAudibleCandidate(const glm::vec3& listenerPosition, float minAudibilityThreshold,
+                                EntryFunctor entryFunctor) const;
+
+private:
+    struct Cell {
+        glm::ivec3 coordinates;
+        float maxTrailingLoudness;
+        std::vector<Entry> entries;
+    };
+
+    glm::ivec3 cellCoordinatesFor(const glm::vec3& position) const;
+    static quint64 keyFor(const glm::ivec3& coordinates);
+
+    float distanceToCell(const glm::vec3& position, const Cell& cell) const;
+
+    template<typename EntryFunctor>
+    void visitCell(const Cell& cell, const glm::vec3& listenerPosition, float minAudibilityThreshold,
+                   EntryFunctor& entryFunctor, int& numVisited) const;
+
+    float _cellSize;
+
+    std::vector<Cell> _cells;
+    QHash<quint64, int> _cellIndices;
+
+    int _numEntries;
+    float _maxTrailingLoudness;
+};
+
+template<typename EntryFunctor>
+void AudibilityGrid::visitCell(const Cell& cell, const glm::vec3& listenerPosition, float minAudibilityThreshold,
+                               EntryFunctor& entryFunctor, int& numVisited) const {
+    // this is the same test the mixer runs on each stream, with the loudest stream at the closest point of the cell
+    float distance = std::max(distanceToCell(listenerPosition, cell), EPSILON);
+    if (cell.maxTrailingLoudness / distance <= minAudibilityThreshold) {
+        return;
+    }
+
+    for (const Entry& entry : cell.entries) {
+        entryFunctor(entry);
+    }
+    numVisited += (int)cell.entries.size();
+}
+
+template<typename EntryFunctor>
+int AudibilityGrid::forEachAudibleCandidate(const glm::vec3& listenerPosition, float minAudibilityThreshold,
+                                            EntryFunctor entryFunctor) const {
+    int numVisited = 0;
+
+    // no stream can be heard further away than this
+    float maxAudibleDistance = _maxTrailingLoudness / minAudibilityThreshold;
+
+    glm::ivec3 minCoordinates = cellCoordinatesFor(listenerPosition - glm::vec3(maxAudibleDistance));
+    glm::ivec3 maxCoordinates = cellCoordinatesFor(listenerPosition + glm::vec3(maxAudibleDistance));
+    glm::dvec3 extents = glm::dvec3(maxCoordinates - minCoordinates) + glm::dvec3(1.0);
+    double numCellsInRange = extents.x * extents.y * extents.z;
+
+    if (numCellsInRange < (double)_cells.size()) {
+        // the audible range is small compared to the grid, only look up the cells in range
+        for (int x = minCoordinates.x; x <= maxCoordinates.x; ++x) {
+            for (int y = minCoordinates.y; y <= maxCoordinates.y; ++y) {
+                for (int z = minCoordinates.z; z <= maxCoordinates.z; ++z) {
+                    auto it = _cellIndices.constFind(keyFor(glm::ivec3(x, y, z)));
+                    if (it != _cellIndices.constEnd()) {
+                        visitCell(_cells[it.value()], listenerPosition, minAudibilityThreshold, entryFunctor, numVisited);
+                    }
+                }
+            }
+        }
+    } else {
+        for (const Cell& cell : _cells) {
+            visitCell(cell, listenerPosition, minAudibilityThreshold, entryFunctor, numVisited);
+        }
+    }
+
+    return _numEntries - numVisited;
+}
+
+#endif // hifi_AudibilityGrid_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <fstream>
@@ -51,6 +52,7 @@
 #include <StDev.h>
 #include <UUID.h>
 
+#include "AudioMixKernels.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
@@ -64,6 +66,7 @@ const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
+const int DEFAULT_NUM_MIX_THREADS = 1;
 
 InboundAudioStream::Settings AudioMixer::_streamSettings;
 
@@ -85,6 +88,13 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _mixThreadPool(this),
+    _sumUsecsMixingFrames(0),
+    _sumGridCells(0),
+    _sumGridStreams(0),
+    _sumStreamsCulled(0),
+    _sumUsecsBuildingGrid(0),
+    _sendCompressedMixes(true),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -92,6 +102,9 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     _timeSpentPerHashMatchCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
     _readPendingCallsPerSecondStats(1, READ_DATAGRAMS_STATS_WINDOW_SECONDS)
 {
+    memset(_sumMixesByCodec, 0, sizeof(_sumMixesByCodec));
+    memset(_sumMixedAudioBytesByCodec, 0, sizeof(_sumMixedAudioBytesByCodec));
+
     // constant defined in AudioMixer.h.  However, we don't want to include this here
     // we will soon find a better common home for these audio-related constants
     // SOON
@@ -103,12 +116,35 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
                                               PacketType::AudioStreamStats },
                                             this, "handleNodeAudioPacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+
+    // the mix threads are busy every frame, don't let them expire between frames
+    _mixThreadPool.setExpiryTimeout(-1);
+    setNumMixThreads(DEFAULT_NUM_MIX_THREADS);
+}
+
+void AudioMixer::setNumMixThreads(int numThreads) {
+    if (numThreads < 1) {
+        numThreads = QThread::idealThreadCount();
+    }
+    numThreads = std::max(numThreads, 1);
+
+    _mixJobs.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        _mixJobs.emplace_back(new AudioMixerJob(this));
+    }
+
+    // the mixer thread runs the first job, so the pool only needs threads for the rest
+    _mixThreadPool.setMaxThreadCount(std::max(numThreads - 1, 1));
+
+    _sumUsecsMixingPerThread.assign(numThreads, 0);
+    _sumListenersPerThread.assign(numThreads, 0);
 }
 
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
 const float RADIUS_OF_HEAD = 0.076f;
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
+int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerJob& job,
+                                                         AudioMixerClientData* listenerNodeData,
                                                          const QUuid& streamUUID,
                                                          PositionalAudioStream* streamToAdd,
                                                          AvatarAudioStream* listeningNodeStream) {
@@ -165,7 +201,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
+    ++job._numMixes;
 
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
@@ -204,8 +240,9 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
     for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
+        // mixes run on several threads at once, so only use the const accessors of the zone hash here
+        if (_audioZones.value(_zonesSettings[i].source).contains(streamToAdd->getPosition()) &&
+            _audioZones.value(_zonesSettings[i].listener).contains(listeningNodeStream->getPosition())) {
             attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
             break;
         }
@@ -261,107 +298,60 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
 
+    // attenuation and fade applied to all samples
+    float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+
+    // if this stream gets the penumbra filter it is rendered on its own into the pre-mix buffer first,
+    // otherwise it can go straight into the mix for this listener
+    bool applyPenumbraFilter = !sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter();
+
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
-
-        // we need to do several things in this process:
         //    1) convert from mono to stereo by copying each input sample into the left and right output samples
-        //    2)
         //    2) apply an attenuation AND fade to all samples (left and right)
         //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
         //       right channel of the input into the output
         //    4) because one of these channels is delayed, we will need to use historical samples from
         //       the input stream for that delayed channel
+        // the kernel does all of this in one pass, we only need to hand it the frame with the history in front of it
+        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
 
-        // Mono input to stereo output (item 1 above)
-        int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
-        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-
-        // attenuation and fade applied to all samples (item 2 above)
-        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        // TODO: the historical samples may be inside the last frame written if the ringbuffer is completely full
+        // maybe make AudioRingBuffer have 1 extra frame in its buffer
+        (streamPopOutput - numSamplesDelay).readSamples(job._streamSamples, numSamplesDelay + inputSampleCount);
+        const int16_t* streamSamples = job._streamSamples + numSamplesDelay;
 
         // determine which side is weak and delayed (item 3 above)
         bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
 
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
-
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
-
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
-
         // The weak/delayed channel will be attenuated by this additional amount
         float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
 
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
-        if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex;
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        }
-
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
-
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
+        float leftSideAttenuation = rightSideWeakAndDelayed ? attenuationAndFade : attenuationAndWeakChannelRatioAndFade;
+        float rightSideAttenuation = rightSideWeakAndDelayed ? attenuationAndWeakChannelRatioAndFade : attenuationAndFade;
+        int leftSideDelay = rightSideWeakAndDelayed ? 0 : numSamplesDelay;
+        int rightSideDelay = rightSideWeakAndDelayed ? numSamplesDelay : 0;
 
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
+        if (applyPenumbraFilter) {
+            AudioMixKernels::panMonoToStereo(streamSamples, job._preMixSamples, inputSampleCount,
+                                             leftSideAttenuation, rightSideAttenuation, leftSideDelay, rightSideDelay);
+        } else {
+            AudioMixKernels::addMonoToStereo(streamSamples, job._mixSamples, inputSampleCount,
+                                             leftSideAttenuation, rightSideAttenuation, leftSideDelay, rightSideDelay);
         }
-
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
+        streamPopOutput.readSamples(job._streamSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
+        if (applyPenumbraFilter) {
+            AudioMixKernels::applyGain(job._streamSamples, job._preMixSamples,
+                                       AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, attenuationAndFade);
+        } else {
+            AudioMixKernels::addWithGain(job._streamSamples, job._mixSamples,
+                                         AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, attenuationAndFade);
         }
     }
 
-    if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
+    if (applyPenumbraFilter) {
 
         const float TWO_OVER_PI = 2.0f / PI;
 
@@ -421,56 +411,144 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
-    }
+        penumbraFilter.render(job._preMixSamples, job._preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
+        // Actually mix the filtered _preMixSamples into the _mixSamples here.
+        AudioMixKernels::addSaturating(job._preMixSamples, job._mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
+int AudioMixer::prepareMixForListeningNode(AudioMixerJob& job, Node* node) {
     AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
     // zero out the client mix for this node
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    memset(job._mixSamples, 0, sizeof(job._mixSamples));
 
-    // loop through all other nodes that have sufficient audio to mix
+    // loop through all streams that have sufficient audio to mix
     int streamsMixed = 0;
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+    // only look at the streams in cells of the audibility grid that can be heard from here
+    int streamsCulled = _audibilityGrid.forEachAudibleCandidate(nodeAudioStream->getPosition(), _minAudibilityThreshold,
+                                                                [&](const AudibilityGrid::Entry& entry) {
+        if (*entry.node != *node || entry.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(job, listenerNodeData, entry.streamUUID,
+                                                                     entry.stream, nodeAudioStream);
+        }
+    });
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+    job._numStreamsCulled += streamsCulled;
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+    return streamsMixed;
+}
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
-                
-                // clear out the pre-mix samples before filling it up with this source
-                memset(_preMixSamples, 0, sizeof(_preMixSamples));
+std::unique_ptr<NLPacket> AudioMixer::createMixPacketForListeningNode(AudioMixerJob& job, Node* node) {
+    AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
-                }
-            }
+    int streamsMixed = prepareMixForListeningNode(job, node);
+
+    // the mix goes back in the codec the listener sends its own audio in
+    const AudioCodec* codec = nodeData->getAvatarAudioStream()->getCodec();
+    if (!codec || !_sendCompressedMixes) {
+        codec = AudioCodec::getCodec(AudioCodec::PCM);
+    }
+
+    std::unique_ptr<NLPacket> mixPacket;
+
+    if (streamsMixed > 0) {
+        const int MIXED_AUDIO_CHANNELS = 2;
+        int encodedBytes = codec->getEncodedBytes(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, MIXED_AUDIO_CHANNELS);
+
+        int mixPacketBytes = sizeof(quint16) + sizeof(quint8) + encodedBytes;
+        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // pack the codec
+        mixPacket->writePrimitive((quint8)codec->getType());
+
+        // pack mixed audio samples, encoded straight into the packet
+        qint64 leadingBytes = mixPacket->getPayloadSize();
+        mixPacket->setPayloadSize(leadingBytes + encodedBytes);
+        codec->encode(job._mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, MIXED_AUDIO_CHANNELS,
+                      mixPacket->getPayload() + leadingBytes);
+
+        job._numMixesByCodec[codec->getType()]++;
+        job._mixedAudioBytesByCodec[codec->getType()] += encodedBytes;
+    } else {
+        int silentPacketBytes = sizeof(quint16) + sizeof(quint16) + sizeof(quint8);
+        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // pack number of silent audio samples
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        mixPacket->writePrimitive(numSilentSamples);
+
+        // pack the codec
+        mixPacket->writePrimitive((quint8)codec->getType());
+    }
+
+    return mixPacket;
+}
+
+void AudioMixer::buildAudibilityGrid(const std::vector<SharedNodePointer>& audioNodes) {
+    quint64 start = usecTimestampNow();
+
+    _audibilityGrid.clear();
+
+    for (const SharedNodePointer& node : audioNodes) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+        const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+        for (auto it = audioStreams.constBegin(); it != audioStreams.constEnd(); ++it) {
+            PositionalAudioStream* stream = it.value();
+
+            // the mic stream is keyed by the node UUID in the listener's per source data
+            QUuid streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : it.key();
+
+            _audibilityGrid.insert(node, streamUUID, stream);
         }
-    });
+    }
 
-    return streamsMixed;
+    _sumGridCells += _audibilityGrid.getNumCells();
+    _sumGridStreams += _audibilityGrid.getNumEntries();
+    _sumUsecsBuildingGrid += usecTimestampNow() - start;
+}
+
+void AudioMixer::runMixJobs(const std::vector<SharedNodePointer>& listeners) {
+    int numJobs = (int)_mixJobs.size();
+
+    // deal the listeners out round-robin so that every job gets a similar share of the frame
+    for (auto& job : _mixJobs) {
+        job->clearListeners();
+    }
+    for (size_t i = 0; i < listeners.size(); ++i) {
+        _mixJobs[i % numJobs]->addListener(listeners[i]);
+    }
+
+    quint64 start = usecTimestampNow();
+
+    // hand every job but the first to the pool, and mix the first one right here on the mixer thread
+    for (int i = 1; i < numJobs; ++i) {
+        if (!_mixJobs[i]->getListeners().empty()) {
+            _mixThreadPool.start(_mixJobs[i].get());
+        }
+    }
+
+    _mixJobs[0]->run();
+
+    if (numJobs > 1) {
+        _mixThreadPool.waitForDone();
+    }
+
+    _sumUsecsMixingFrames += usecTimestampNow() - start;
 }
 
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
@@ -580,9 +658,76 @@ void AudioMixer::sendStatsPacket() {
         statsObject["average_mixes_per_listener"] = 0.0;
     }
 
+    // mix thread stats - the busy percentage is how much of the mix phase the pool as a whole spent mixing
+    QJsonObject mixThreadsStats;
+    mixThreadsStats["num_threads"] = (int) _mixJobs.size();
+
+    quint64 sumUsecsMixingAllThreads = 0;
+    for (size_t i = 0; i < _mixJobs.size(); ++i) {
+        QJsonObject threadStats;
+        threadStats["average_listeners_per_frame"] = (_numStatFrames > 0)
+            ? (float) _sumListenersPerThread[i] / (float) _numStatFrames : 0.0f;
+        threadStats["average_usecs_per_frame"] = (_numStatFrames > 0)
+            ? (float) _sumUsecsMixingPerThread[i] / (float) _numStatFrames : 0.0f;
+        mixThreadsStats["thread_" + QString::number(i)] = threadStats;
+
+        sumUsecsMixingAllThreads += _sumUsecsMixingPerThread[i];
+        _sumUsecsMixingPerThread[i] = 0;
+        _sumListenersPerThread[i] = 0;
+    }
+
+    mixThreadsStats["average_usecs_mixing_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumUsecsMixingFrames / (float) _numStatFrames : 0.0f;
+    mixThreadsStats["busy_percentage"] = (_sumUsecsMixingFrames > 0)
+        ? (float) sumUsecsMixingAllThreads / (float) (_sumUsecsMixingFrames * _mixJobs.size()) * 100.0f : 0.0f;
+
+    statsObject["mix_threads"] = mixThreadsStats;
+
+    QJsonObject audibilityGridStats;
+    audibilityGridStats["average_cells_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumGridCells / (float) _numStatFrames : 0.0f;
+    audibilityGridStats["average_streams_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumGridStreams / (float) _numStatFrames : 0.0f;
+    audibilityGridStats["average_usecs_building_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumUsecsBuildingGrid / (float) _numStatFrames : 0.0f;
+    audibilityGridStats["average_culled_per_listener"] = (_sumListeners > 0)
+        ? (float) _sumStreamsCulled / (float) _sumListeners : 0.0f;
+
+    statsObject["audibility_grid"] = audibilityGridStats;
+
+    _sumGridCells = 0;
+    _sumGridStreams = 0;
+    _sumStreamsCulled = 0;
+    _sumUsecsBuildingGrid = 0;
+
+    // downstream bandwidth of each codec, and how much the codecs saved over sending every mix as PCM
+    QJsonObject codecsStats;
+    int sumMixesAllCodecs = 0;
+    quint64 sumMixedAudioBytesAllCodecs = 0;
+    for (int codecType = 0; codecType < AudioCodec::NUM_TYPES; ++codecType) {
+        QJsonObject codecStats;
+        codecStats["average_mixes_per_frame"] = (_numStatFrames > 0)
+            ? (float) _sumMixesByCodec[codecType] / (float) _numStatFrames : 0.0f;
+        codecStats["average_bytes_per_mix"] = (_sumMixesByCodec[codecType] > 0)
+            ? (float) _sumMixedAudioBytesByCodec[codecType] / (float) _sumMixesByCodec[codecType] : 0.0f;
+        codecsStats[AudioCodec::getCodec(codecType)->getName()] = codecStats;
+
+        sumMixesAllCodecs += _sumMixesByCodec[codecType];
+        sumMixedAudioBytesAllCodecs += _sumMixedAudioBytesByCodec[codecType];
+        _sumMixesByCodec[codecType] = 0;
+        _sumMixedAudioBytesByCodec[codecType] = 0;
+    }
+
+    quint64 sumPCMBytesAllCodecs = (quint64) sumMixesAllCodecs * AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+    codecsStats["bandwidth_saved_percentage"] = (sumPCMBytesAllCodecs > 0)
+        ? (1.0f - (float) sumMixedAudioBytesAllCodecs / (float) sumPCMBytesAllCodecs) * 100.0f : 0.0f;
+
+    statsObject["codecs"] = codecsStats;
+
     _sumListeners = 0;
     _sumMixes = 0;
     _numStatFrames = 0;
+    _sumUsecsMixingFrames = 0;
 
     QJsonObject readPendingDatagramStats;
 
@@ -748,6 +893,10 @@ void AudioMixer::broadcastMixes() {
             _lastPerSecondCallbackTime = now;
         }
         
+        // first pop a frame from every stream, so that all of the mixes below see the same frame for each source
+        std::vector<SharedNodePointer> audioNodes;
+        std::vector<SharedNodePointer> listeners;
+
         nodeList->eachNode([&](const SharedNodePointer& node) {
             
             if (node->getLinkedData()) {
@@ -757,6 +906,7 @@ void AudioMixer::broadcastMixes() {
                 // a pointer to the popped data is stored as a member in InboundAudioStream.
                 // That's how the popped audio data will be read for mixing (but only if the pop was successful)
                 nodeData->checkBuffersBeforeFrameSend();
+                audioNodes.push_back(node);
                 
                 // if the stream should be muted, send mute packet
                 if (nodeData->getAvatarAudioStream()
@@ -767,53 +917,59 @@ void AudioMixer::broadcastMixes() {
                 
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
-                    
-                    int streamsMixed = prepareMixForListeningNode(node.data());
-                    
-                    std::unique_ptr<NLPacket> mixPacket;
-                    
-                    if (streamsMixed > 0) {
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
-                        
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-                        
-                        // pack mixed audio samples
-                        mixPacket->write(reinterpret_cast<char*>(_mixSamples),
-                                         AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
-                        
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
-                        
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
-                    
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
-                    
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
-                    
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
-                    
-                    ++_sumListeners;
+                    listeners.push_back(node);
                 }
             }
         });
         
+        // place every stream in the audibility grid so listeners can skip the ones they can't hear
+        buildAudibilityGrid(audioNodes);
+        
+        // run the mixes for this frame, in parallel if we have more than one mix thread
+        runMixJobs(listeners);
+        
+        // every job is done, send out the mixes
+        for (size_t jobIndex = 0; jobIndex < _mixJobs.size(); ++jobIndex) {
+            AudioMixerJob& job = *_mixJobs[jobIndex];
+            const std::vector<SharedNodePointer>& jobListeners = job.getListeners();
+            
+            for (size_t i = 0; i < jobListeners.size(); ++i) {
+                const SharedNodePointer& node = jobListeners[i];
+                AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+                
+                // Send audio environment
+                sendAudioEnvironmentPacket(node);
+                
+                // queue the mixed audio packet, the mixes of every listener go out together below
+                nodeList->batchPacket(std::move(job.getMixPacket((int)i)), *node, _mixPacketBatch);
+                nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                
+                // send an audio stream stats packet if it's time
+                if (_sendAudioStreamStats) {
+                    nodeData->sendAudioStreamStatsPackets(node);
+                    _sendAudioStreamStats = false;
+                }
+            }
+            
+            _sumListeners += (int)jobListeners.size();
+            _sumMixes += job.getNumMixes();
+            _sumStreamsCulled += job.getNumStreamsCulled();
+            for (int codecType = 0; codecType < AudioCodec::NUM_TYPES; ++codecType) {
+                _sumMixesByCodec[codecType] += job.getNumMixesByCodec((AudioCodec::Type)codecType);
+                _sumMixedAudioBytesByCodec[codecType] += job.getMixedAudioBytesByCodec((AudioCodec::Type)codecType);
+            }
+            _sumListenersPerThread[jobIndex] += (int)jobListeners.size();
+            _sumUsecsMixingPerThread[jobIndex] += job.getUsecsMixing();
+            
+            // drop our references to the listeners until the next frame
+            job.clearListeners();
+        }
+        
+        nodeList->sendBatch(_mixPacketBatch);
+        
+        // the grid holds on to the nodes and their streams, let them go until the next frame
+        _audibilityGrid.clear();
+        
         ++_numStatFrames;
         
         // since we're a while loop we need to help Qt's event processing
@@ -957,6 +1113,22 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             qDebug() << "Repetition with fade disabled";
         }
 
+        const QString MIX_THREADS_JSON_KEY = "mix_threads";
+        int numMixThreads = audioBufferGroupObject[MIX_THREADS_JSON_KEY].toString().toInt(&ok);
+        if (!ok) {
+            numMixThreads = DEFAULT_NUM_MIX_THREADS;
+        }
+        setNumMixThreads(numMixThreads);
+        qDebug() << "Mixing with" << _mixJobs.size() << "mix threads";
+
+        const QString COMPRESSED_MIXES_JSON_KEY = "compressed_mixes";
+        _sendCompressedMixes = audioBufferGroupObject.value(COMPRESSED_MIXES_JSON_KEY).toBool(true);
+        if (_sendCompressedMixes) {
+            qDebug() << "Mixed audio will be sent in the codec of each listener";
+        } else {
+            qDebug() << "Mixed audio will always be sent as PCM";
+        }
+
         const QString PRINT_STREAM_STATS_JSON_KEY = "print_stream_stats";
         _printStreamStats = audioBufferGroupObject[PRINT_STREAM_STATS_JSON_KEY].toBool();
         if (_printStreamStats) {
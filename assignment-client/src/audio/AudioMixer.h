@@ -12,16 +12,23 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <memory>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+
 #include <AABox.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
+#include <udt/PacketBatch.h>
+
+#include "AudibilityGrid.h"
+#include "AudioMixerJob.h"
 
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
 
-const int SAMPLE_PHASE_DELAY_AT_90 = 20;
-
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
@@ -45,27 +52,33 @@ private slots:
     void handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
 
 private:    
+    friend class AudioMixerJob;
+
     void domainSettingsRequestComplete();
     
-    /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
+    /// adds one stream to the mix for a listening node, using the buffers of the given job
+    int addStreamToMixForListeningNodeWithStream(AudioMixerJob& job,
+                                                    AudioMixerClientData* listenerNodeData,
                                                     const QUuid& streamUUID,
                                                     PositionalAudioStream* streamToAdd,
                                                     AvatarAudioStream* listeningNodeStream);
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// prepares a mix for one Node in the mix buffer of the given job
+    int prepareMixForListeningNode(AudioMixerJob& job, Node* node);
+
+    /// prepares a mix for one Node and packs it into a MixedAudio (or SilentAudioFrame) packet, called from mix jobs
+    std::unique_ptr<NLPacket> createMixPacketForListeningNode(AudioMixerJob& job, Node* node);
+
+    /// places the streams of every node with audio in the audibility grid for this frame
+    void buildAudibilityGrid(const std::vector<SharedNodePointer>& audioNodes);
+
+    /// splits this frame's listeners across the mix jobs and runs them, returns once every job is done
+    void runMixJobs(const std::vector<SharedNodePointer>& listeners);
 
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
-
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    void setNumMixThreads(int numThreads);
 
     void perSecondActions();
 
@@ -82,6 +95,31 @@ private:
     int _sumListeners;
     int _sumMixes;
 
+    // one job per mix thread - the first job is always run on the mixer thread itself,
+    // the others are handed to the pool which has one less thread than we have jobs
+    std::vector<std::unique_ptr<AudioMixerJob>> _mixJobs;
+    QThreadPool _mixThreadPool;
+
+    // the mixed audio packets of a frame, sent out together once every listener has been mixed
+    udt::PacketBatch _mixPacketBatch;
+
+    // per mix thread stats, reset with the other frame stats in sendStatsPacket
+    std::vector<quint64> _sumUsecsMixingPerThread;
+    std::vector<int> _sumListenersPerThread;
+    quint64 _sumUsecsMixingFrames;
+
+    // rebuilt every frame from the popped streams, read by all of the mix jobs
+    AudibilityGrid _audibilityGrid;
+    int _sumGridCells;
+    int _sumGridStreams;
+    int _sumStreamsCulled;
+    quint64 _sumUsecsBuildingGrid;
+
+    // mixes are sent in the codec of each listener unless this is turned off in the domain settings
+    bool _sendCompressedMixes;
+    int _sumMixesByCodec[AudioCodec::NUM_TYPES];
+    quint64 _sumMixedAudioBytesByCodec[AudioCodec::NUM_TYPES];
+
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
         QString source;
@@ -241,6 +241,12 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
         upstreamStats["max_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMax);
         upstreamStats["avg_gap_30s"] = formatUsecTime(streamStats._timeGapWindowAverage);
 
+        const AudioCodec* codec = avatarAudioStream->getCodec();
+        upstreamStats["codec"] = codec ? codec->getName() : "unknown";
+        upstreamStats["compression_ratio"] = (avatarAudioStream->getEncodedBytesReceived() > 0)
+            ? (double) avatarAudioStream->getDecodedBytesReceived() / (double) avatarAudioStream->getEncodedBytesReceived()
+            : 0.0;
+
         result["upstream"] = upstreamStats;
     } else {
         result["upstream"] = "mic unknown";
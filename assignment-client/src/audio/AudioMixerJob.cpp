@@ -0,0 +1,54 @@
+//
+//  AudioMixerJob.cpp
+//  assignment-client/src/audio
+//
+//  Created by High Fidelity on 1/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <SharedUtil.h>
+
+#include "AudioMixer.h"
+
+#include "AudioMixerJob.h"
+
+AudioMixerJob::AudioMixerJob(AudioMixer* mixer) :
+    QRunnable(),
+    _mixer(mixer),
+    _numMixes(0),
+    _numStreamsCulled(0),
+    _usecsMixing(0)
+{
+    // jobs are re-used every frame, the mixer owns them
+    setAutoDelete(false);
+
+    clearListeners();
+}
+
+void AudioMixerJob::clearListeners() {
+    _listeners.clear();
+    _mixPackets.clear();
+
+    _numMixes = 0;
+    _numStreamsCulled = 0;
+    _usecsMixing = 0;
+    memset(_numMixesByCodec, 0, sizeof(_numMixesByCodec));
+    memset(_mixedAudioBytesByCodec, 0, sizeof(_mixedAudioBytesByCodec));
+}
+
+void AudioMixerJob::run() {
+    quint64 start = usecTimestampNow();
+
+    _mixPackets.resize(_listeners.size());
+
+    for (size_t i = 0; i < _listeners.size(); ++i) {
+        _mixPackets[i] = _mixer->createMixPacketForListeningNode(*this, _listeners[i].data());
+    }
+
+    _usecsMixing = usecTimestampNow() - start;
+}
@@ -0,0 +1,76 @@
+//
+//  AudioMixerJob.h
+//  assignment-client/src/audio
+//
+//  Created by High Fidelity on 1/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerJob_h
+#define hifi_AudioMixerJob_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QRunnable>
+
+#include <AudioCodec.h>
+#include <AudioConstants.h>
+#include <NLPacket.h>
+#include <Node.h>
+
+class AudioMixer;
+
+const int SAMPLE_PHASE_DELAY_AT_90 = 20;
+
+/// One slice of a frame's listener mixes. Each worker in the AudioMixer pool owns one job, and with it its own
+/// pre-mix and mix buffers, so that mixes for different listeners can be computed in parallel.
+/// The job only builds the mixed audio packets - they are sent by the mixer once every job for the frame is done.
+class AudioMixerJob : public QRunnable {
+public:
+    AudioMixerJob(AudioMixer* mixer);
+
+    void run();
+
+    void clearListeners();
+    void addListener(const SharedNodePointer& listener) { _listeners.push_back(listener); }
+
+    const std::vector<SharedNodePointer>& getListeners() const { return _listeners; }
+    std::unique_ptr<NLPacket>& getMixPacket(int listenerIndex) { return _mixPackets[listenerIndex]; }
+
+    int getNumMixes() const { return _numMixes; }
+    int getNumStreamsCulled() const { return _numStreamsCulled; }
+    quint64 getUsecsMixing() const { return _usecsMixing; }
+    int getNumMixesByCodec(AudioCodec::Type codecType) const { return _numMixesByCodec[codecType]; }
+    int getMixedAudioBytesByCodec(AudioCodec::Type codecType) const { return _mixedAudioBytesByCodec[codecType]; }
+
+private:
+    friend class AudioMixer;
+
+    // the popped frame of the stream being mixed, copied out of its ring buffer along with
+    // the historical samples needed for the phase delay
+    int16_t _streamSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + SAMPLE_PHASE_DELAY_AT_90];
+
+    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
+    // data from a phase delay as well as an entire network buffer
+    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+
+    // client samples capacity is larger than what will be sent to optimize mixing
+    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+
+    AudioMixer* _mixer;
+
+    std::vector<SharedNodePointer> _listeners;
+    std::vector<std::unique_ptr<NLPacket>> _mixPackets;
+
+    int _numMixes;
+    int _numStreamsCulled;
+    quint64 _usecsMixing;
+    int _numMixesByCodec[AudioCodec::NUM_TYPES];
+    int _mixedAudioBytesByCodec[AudioCodec::NUM_TYPES];
+};
+
+#endif // hifi_AudioMixerJob_h
@@ -27,6 +27,9 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         readBytes += sizeof(quint16);
         numAudioSamples = (int)numSilentSamples;
 
+        // read the codec the client wants its mix in
+        readBytes += parseCodec(packetAfterSeqNum, readBytes, _isStereo ? 2 : 1);
+
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
 
@@ -46,12 +49,15 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
             _isStereo = isStereo;
         }
 
+        // read the codec of the audio data, which is also the codec the client wants its mix in
+        readBytes += parseCodec(packetAfterSeqNum, readBytes, _isStereo ? 2 : 1);
+
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
         
         // calculate how many samples are in this packet
         int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+        numAudioSamples = getNumDecodedSamples(numAudioBytes);
     }
 
     return readBytes;
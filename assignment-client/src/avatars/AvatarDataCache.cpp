@@ -0,0 +1,126 @@
+//
+//  AvatarDataCache.cpp
+//  assignment-client/src/avatars
+//
+//  Created by High Fidelity on 1/25/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+
+#include <AvatarData.h>
+
+#include "AvatarDataCache.h"
+
+const char* AvatarDataCache::getDetailName(Detail detail) {
+    switch (detail) {
+        case PositionOnly:
+            return "position_only";
+        case ChangedJoints:
+            return "changed_joints";
+        case AllJoints:
+            return "all_joints";
+        default:
+            return "unknown";
+    }
+}
+
+AvatarDataCache::Stats& AvatarDataCache::Stats::operator+=(const Stats& other) {
+    numEncodes += other.numEncodes;
+    for (int detail = 0; detail < NUM_DETAILS; ++detail) {
+        numUses[detail] += other.numUses[detail];
+    }
+    numHits += other.numHits;
+    numUnusedEncodes += other.numUnusedEncodes;
+    bytesEncoded += other.bytesEncoded;
+    bytesSaved += other.bytesSaved;
+    return *this;
+}
+
+float AvatarDataCache::Stats::getHitRatio() const {
+    int totalUses = 0;
+    for (int detail = 0; detail < NUM_DETAILS; ++detail) {
+        totalUses += numUses[detail];
+    }
+    return (totalUses > 0) ? (float)numHits / (float)totalUses : 0.0f;
+}
+
+AvatarDataCache::AvatarDataCache() :
+    _numAvatars(0)
+{
+}
+
+void AvatarDataCache::encode(int avatarIndex, AvatarData& avatar, Detail detail) {
+    assert(avatarIndex <= _numAvatars);
+    if (avatarIndex == _numAvatars) {
+        if ((int)_entries.size() == _numAvatars) {
+            _entries.emplace_back(new Entry);
+        }
+        ++_numAvatars;
+
+        Entry& newEntry = *_entries[avatarIndex];
+        for (int i = 0; i < NUM_DETAILS; ++i) {
+            newEntry.isEncoded[i] = false;
+            newEntry.numUses[i] = 0;
+        }
+    }
+    Entry& entry = *_entries[avatarIndex];
+
+    switch (detail) {
+        case PositionOnly:
+            entry.payloads[detail] = avatar.toByteArray(false, false, false);
+            break;
+        case ChangedJoints:
+            entry.payloads[detail] = avatar.toByteArray(false, false);
+            break;
+        case AllJoints:
+            entry.payloads[detail] = avatar.toByteArray(false, true);
+            break;
+        default:
+            return;
+    }
+    entry.isEncoded[detail] = true;
+
+    ++_stats.numEncodes;
+    _stats.bytesEncoded += entry.payloads[detail].size();
+}
+
+const QByteArray& AvatarDataCache::use(int avatarIndex, Detail detail) const {
+    assert(avatarIndex < _numAvatars);
+    const Entry& entry = *_entries[avatarIndex];
+    assert(entry.isEncoded[detail]);
+
+    entry.numUses[detail].fetch_add(1, std::memory_order_relaxed);
+    return entry.payloads[detail];
+}
+
+void AvatarDataCache::finishFrame() {
+    for (int i = 0; i < _numAvatars; ++i) {
+        const Entry& entry = *_entries[i];
+        for (int detail = 0; detail < NUM_DETAILS; ++detail) {
+            if (!entry.isEncoded[detail]) {
+                continue;
+            }
+
+            int numUses = entry.numUses[detail].load(std::memory_order_relaxed);
+            if (numUses == 0) {
+                ++_stats.numUnusedEncodes;
+                continue;
+            }
+
+            // the first use pays for the encode, every other use is an encode we did not have to do
+            _stats.numUses[detail] += numUses;
+            _stats.numHits += numUses - 1;
+            _stats.bytesSaved += (quint64)(numUses - 1) * entry.payloads[detail].size();
+        }
+    }
+}
+
+AvatarDataCache::Stats AvatarDataCache::takeStats() {
+    Stats stats = _stats;
+    _stats = Stats();
+    return stats;
+}
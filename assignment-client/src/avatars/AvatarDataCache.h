@@ -0,0 +1,82 @@
+//
+//  AvatarDataCache.h
+//  assignment-client/src/avatars
+//
+//  Created by High Fidelity on 1/25/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataCache_h
+#define hifi_AvatarDataCache_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+class AvatarData;
+
+/// The AvatarData payloads of one avatar mixer frame, encoded once per avatar and detail, and shared by every listener
+/// that is sent that avatar. Avatars are keyed by the index of their snapshot in the frame.
+/// Payloads are encoded on the broadcast thread while the avatar is locked. After that the broadcast jobs can look
+/// them up from any thread, and the cache counts how often each payload was used.
+class AvatarDataCache {
+public:
+    enum Detail : uint8_t {
+        PositionOnly = 0,   // the body of the avatar without any joints, for listeners that are far away
+        ChangedJoints,      // the joints that changed since the avatar was last encoded
+        AllJoints,          // every joint, sent now and then so that listeners can resync
+        NUM_DETAILS
+    };
+
+    static const char* getDetailName(Detail detail);
+
+    struct Stats {
+        int numEncodes { 0 };
+        int numUses[NUM_DETAILS] { };
+        int numHits { 0 };
+        int numUnusedEncodes { 0 };
+        quint64 bytesEncoded { 0 };
+        quint64 bytesSaved { 0 };
+
+        Stats& operator+=(const Stats& other);
+        float getHitRatio() const;
+    };
+
+    AvatarDataCache();
+
+    /// drops the payloads of the previous frame
+    void startFrame() { _numAvatars = 0; }
+
+    /// encodes the avatar at the given detail, the caller must hold the lock on the avatar.
+    /// Avatars have to be added in order, the first encode of an avatar index adds the avatar to this frame.
+    void encode(int avatarIndex, AvatarData& avatar, Detail detail);
+
+    /// returns a payload encoded this frame, counting the use - safe to call from the broadcast jobs
+    const QByteArray& use(int avatarIndex, Detail detail) const;
+
+    /// adds the use counts of this frame to the stats, called once every broadcast job for the frame is done
+    void finishFrame();
+
+    /// returns the stats since the last call and starts over, only call it from the broadcast thread
+    Stats takeStats();
+
+private:
+    struct Entry {
+        QByteArray payloads[NUM_DETAILS];
+        bool isEncoded[NUM_DETAILS];
+        mutable std::atomic<int> numUses[NUM_DETAILS];
+    };
+
+    // entries are kept between frames, so that their payloads can re-use their allocations
+    std::vector<std::unique_ptr<Entry>> _entries;
+    int _numAvatars;
+
+    Stats _stats;
+};
+
+#endif // hifi_AvatarDataCache_h
@@ -34,9 +34,14 @@ const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
 
+const int DEFAULT_NUM_BROADCAST_THREADS = 1;
+
 AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _broadcastThread(),
+    _broadcastThreadPool(this),
+    _sumUsecsBroadcastingFrames(0),
+    _sumUsecsTakingSnapshots(0),
     _lastFrameTimestamp(QDateTime::currentMSecsSinceEpoch()),
     _trailingSleepRatio(1.0f),
     _performanceThrottlingRatio(0.0f),
@@ -53,6 +58,10 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::AvatarBillboard, this, "handleAvatarBillboardPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "handleKillAvatarPacket");
+
+    // the broadcast threads are busy every frame, don't let them expire between frames
+    _broadcastThreadPool.setExpiryTimeout(-1);
+    setNumBroadcastThreads(DEFAULT_NUM_BROADCAST_THREADS);
 }
 
 AvatarMixer::~AvatarMixer() {
@@ -130,262 +139,365 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    // copy the state of every avatar once, so the broadcast jobs never have to lock another avatar
+    quint64 snapshotStart = usecTimestampNow();
+    takeAvatarSnapshots();
+    _sumUsecsTakingSnapshots += usecTimestampNow() - snapshotStart;
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
-                return false;
-            }
-            if (node->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!node->getActiveSocket()) {
-                return false;
+    runBroadcastJobs();
+
+    // send everything the jobs built from this thread, once they are all done
+    for (size_t jobIndex = 0; jobIndex < _broadcastJobs.size(); ++jobIndex) {
+        AvatarMixerJob& job = *_broadcastJobs[jobIndex];
+        const std::vector<int>& jobListeners = job.getListeners();
+
+        for (size_t i = 0; i < jobListeners.size(); ++i) {
+            const SharedNodePointer& node = _avatarSnapshots[jobListeners[i]].node;
+
+            for (auto& packet : job.getPackets((int)i)) {
+                nodeList->batchPacket(std::move(packet), *node, _broadcastPacketBatch);
             }
-            return true;
-        },
-        [&](const SharedNodePointer& node) {
-            AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
+
+            // the listener was skipped if its node data was busy
+            if (job.getAvatarPacketList((int)i)) {
+                nodeList->batchPacketList(std::move(job.getAvatarPacketList((int)i)), *node, _broadcastPacketBatch);
             }
-            ++_sumListeners;
+        }
 
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getClientGlobalPosition();
+        _sumListeners += job.getNumListenersBroadcastTo();
+        _sumBillboardPackets += job.getNumBillboardPackets();
+        _sumIdentityPackets += job.getNumIdentityPackets();
+        {
+            QMutexLocker statsLocker(&_broadcastStatsMutex);
+            _sumListenersPerThread[jobIndex] += job.getNumListenersBroadcastTo();
+            _sumUsecsBroadcastingPerThread[jobIndex] += job.getUsecsBroadcasting();
+        }
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
+        // drop our references to the packets until the next frame
+        job.clearListeners();
+    }
 
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
+    // everything for every listener goes out together
+    nodeList->sendBatch(_broadcastPacketBatch);
 
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+    _avatarDataCache.finishFrame();
+    {
+        QMutexLocker statsLocker(&_broadcastStatsMutex);
+        _avatarDataCacheStats += _avatarDataCache.takeStats();
+    }
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
+    // the snapshots hold on to the nodes, let them go until the next frame
+    _avatarSnapshots.clear();
 
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+void AvatarMixer::takeAvatarSnapshots() {
+    _avatarSnapshots.clear();
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+    auto nodeList = DependencyManager::get<NodeList>();
+    _avatarDataCache.startFrame();
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+        MutexTryLocker lock(nodeData->getMutex());
+        if (!lock.isLocked()) {
+            return;
+        }
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+        AvatarData& avatar = nodeData->getAvatar();
 
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+        AvatarSnapshot snapshot;
+        snapshot.node = node;
+        snapshot.nodeData = nodeData;
+        snapshot.isListener = node->getType() == NodeType::Agent && node->getActiveSocket();
+        snapshot.position = avatar.getClientGlobalPosition();
+        snapshot.lastReceivedSequenceNumber = nodeData->getLastReceivedSequenceNumber();
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+        snapshot.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+        if (snapshot.billboardChangeTimestamp > 0) {
+            snapshot.billboard = avatar.getBillboard();
+        }
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+        snapshot.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+        if (snapshot.identityChangeTimestamp > 0) {
+            snapshot.identity = avatar.identityByteArray();
+            snapshot.identity.replace(0, NUM_BYTES_RFC4122_UUID, node->getUUID().toRfc4122());
+        }
 
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+        // the avatar is encoded once for every listener, so every listener gets the full update in the same frame
+        snapshot.detail = (randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO)
+            ? AvatarDataCache::AllJoints : AvatarDataCache::ChangedJoints;
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+        int avatarIndex = (int)_avatarSnapshots.size();
+        _avatarSnapshots.push_back(snapshot);
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+        _avatarDataCache.encode(avatarIndex, avatar, snapshot.detail);
+        if (_positionOnlyDistance > 0.0f) {
+            _avatarDataCache.encode(avatarIndex, avatar, AvatarDataCache::PositionOnly);
+        }
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+        // We're done encoding this version of the avatar.  Update its "lastSent" joint-states so
+        // that we can notice differences, next time around.
+        // Listeners that only got its position miss the changes, until the next full update.
+        if (snapshot.isListener) {
+            avatar.doneEncoding(false);
+        }
+    });
+}
 
-            // setup a PacketList for the avatarPackets
-            auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+void AvatarMixer::runBroadcastJobs() {
+    int numJobs = (int)_broadcastJobs.size();
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+    // deal the listeners out round-robin so that every job gets a similar share of the frame
+    for (auto& job : _broadcastJobs) {
+        job->clearListeners();
+    }
+    int numListeners = 0;
+    for (size_t i = 0; i < _avatarSnapshots.size(); ++i) {
+        if (_avatarSnapshots[i].isListener) {
+            _broadcastJobs[numListeners++ % numJobs]->addListener((int)i);
+        }
+    }
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
+    quint64 start = usecTimestampNow();
 
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
+    // hand every job but the first to the pool, and run the first one right here on the broadcast thread
+    for (int i = 1; i < numJobs; ++i) {
+        if (!_broadcastJobs[i]->getListeners().empty()) {
+            _broadcastThreadPool.start(_broadcastJobs[i].get());
+        }
+    }
 
-                    // make sure we send out identity and billboard packets to and from new arrivals.
-                    bool forceSend = !otherNodeData->checkAndSetHasReceivedFirstPacketsFrom(node->getUUID());
+    _broadcastJobs[0]->run();
 
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    if (numJobs > 1) {
+        _broadcastThreadPool.waitForDone();
+    }
 
-                        QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
-                        QByteArray billboard = otherNodeData->getAvatar().getBillboard();
+    _sumUsecsBroadcastingFrames += usecTimestampNow() - start;
+}
 
-                        auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
-                        billboardPacket->write(rfcUUID);
-                        billboardPacket->write(billboard);
+void AvatarMixer::prepareBroadcastForListener(AvatarMixerJob& job, int listenerIndex) {
+    const AvatarSnapshot& listener = _avatarSnapshots[job.getListeners()[listenerIndex]];
+    const SharedNodePointer& node = listener.node;
+    AvatarMixerClientData* nodeData = listener.nodeData;
 
-                        nodeList->sendPacket(std::move(billboardPacket), *node);
+    // the only node data this touches is the listener's own, and this job is the only one with this listener
+    MutexTryLocker lock(nodeData->getMutex());
+    if (!lock.isLocked()) {
+        return;
+    }
+    ++job._numListenersBroadcastTo;
 
-                        ++_sumBillboardPackets;
-                    }
+    glm::vec3 myPosition = listener.position;
 
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    // reset the internal state for correct random number distribution
+    std::uniform_real_distribution<float>& distribution = job._distribution;
+    std::mt19937& generator = job._generator;
+    distribution.reset();
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
 
-                        identityPacket->write(individualData);
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-                        ++_sumIdentityPackets;
-                    }
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+    // use the data rate specifically for avatar data for FRD adjustment checks
+    float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getClientGlobalPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+    // Check if it is time to adjust what we send this client based on the observed
+    // bandwidth to this node. We do this once a second, which is also the window for
+    // the bandwidth reported by node->getOutboundBandwidth();
+    if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+        const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
+        const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
+        const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+        // get the current full rate distance so we can work with it
+        float currentFullRateDistance = nodeData->getFullRateDistance();
 
-                    AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+        if (avatarDataRateLastSecond > _maxKbpsPerNode) {
 
-                    if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
-                        // we got out out of order packets from the sender, track it
-                        otherNodeData->incrementNumOutOfOrderSends();
-                    }
+            // is the FRD greater than the farthest avatar?
+            // if so, before we calculate anything, set it to that distance
+            currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+            // we're adjusting the full rate distance to target a bandwidth in the middle
+            // of the hysterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                    // we're going to send this avatar
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
+                   && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
+            // we are constrained AND we've recovered to below the acceptable ratio
+            // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        }
+    } else {
+        nodeData->incrementNumFramesSinceFRDAdjustment();
+    }
+
+    std::vector<std::unique_ptr<NLPacket>>& packets = job.getPackets(listenerIndex);
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                                                             otherNodeData->getLastReceivedSequenceNumber());
+    // setup a PacketList for the avatarPackets
+    auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList->startSegment();
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    for (size_t otherIndex = 0; otherIndex < _avatarSnapshots.size(); ++otherIndex) {
+        const AvatarSnapshot& other = _avatarSnapshots[otherIndex];
+        const SharedNodePointer& otherNode = other.node;
+        if (otherNode->getUUID() == node->getUUID()) {
+            continue;
+        }
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes +=
-                        avatarPacketList->write(otherAvatar.toByteArray(false, distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO));
+        ++numOtherAvatars;
 
-                    avatarPacketList->endSegment();
-            });
+        // make sure we send out identity and billboard packets to and from new arrivals.
+        bool forceSend = !nodeData->checkAndSetHasReceivedFirstPacketsFrom(otherNode->getUUID());
 
-            // close the current packet so that we're always sending something
-            avatarPacketList->closeCurrentPacket(true);
+        // we will also force a send of billboard or identity packet
+        // if either has changed in the last frame
+        if (other.billboardChangeTimestamp > 0
+            && (forceSend
+                || other.billboardChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(std::move(avatarPacketList), *node);
+            QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+            auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + other.billboard.size());
+            billboardPacket->write(rfcUUID);
+            billboardPacket->write(other.billboard);
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+            packets.push_back(std::move(billboardPacket));
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
-            }
+            ++job._numBillboardPackets;
         }
-    );
-
-    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
-    // that we can notice differences, next time around.
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& otherNode)->bool {
-            if (!otherNode->getLinkedData()) {
-                return false;
-            }
-            if (otherNode->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!otherNode->getActiveSocket()) {
-                return false;
-            }
-            return true;
-        },
-        [&](const SharedNodePointer& otherNode) {
-            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-            MutexTryLocker lock(otherNodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
-            }
-            AvatarData& otherAvatar = otherNodeData->getAvatar();
-            otherAvatar.doneEncoding(false);
-        });
 
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+        if (other.identityChangeTimestamp > 0
+            && (forceSend
+                || other.identityChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+
+            auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, other.identity.size());
+
+            identityPacket->write(other.identity);
+
+            packets.push_back(std::move(identityPacket));
+
+            ++job._numIdentityPackets;
+        }
+
+        //  Decide whether to send this avatar's data based on it's distance from us
+
+        //  The full rate distance is the distance at which EVERY update will be sent for this avatar
+        //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
+        float distanceToAvatar = glm::length(myPosition - other.position);
+
+        // potentially update the max full rate distance for this frame
+        maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+
+        if (distanceToAvatar != 0.0f
+            && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
+            continue;
+        }
+
+        AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
+        AvatarDataSequenceNumber lastSeqFromSender = other.lastReceivedSequenceNumber;
+
+        if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
+            // we got out out of order packets from the sender, track it
+            other.nodeData->incrementNumOutOfOrderSends();
+        }
+
+        // make sure we haven't already sent this data from this sender to this receiver
+        // or that somehow we haven't sent
+        if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+            ++numAvatarsHeldBack;
+            continue;
+        } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+            // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+            ++numAvatarsWithSkippedFrames;
+        }
+
+        // we're going to send this avatar
+
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
+
+        // set the last sent sequence number for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(), lastSeqFromSender);
+
+        // start a new segment in the PacketList for this avatar
+        avatarPacketList->startSegment();
+
+        numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
+        AvatarDataCache::Detail detail = (_positionOnlyDistance > 0.0f && distanceToAvatar > _positionOnlyDistance)
+            ? AvatarDataCache::PositionOnly : other.detail;
+        numAvatarDataBytes += avatarPacketList->write(_avatarDataCache.use((int)otherIndex, detail));
+
+        avatarPacketList->endSegment();
+    }
+
+    // close the current packet so that we're always sending something
+    avatarPacketList->closeCurrentPacket(true);
+
+    // the mixer sends the avatar data PacketList once every job is done
+    job.getAvatarPacketList(listenerIndex) = std::move(avatarPacketList);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
+}
+
+void AvatarMixer::setNumBroadcastThreads(int numThreads) {
+    if (numThreads < 1) {
+        numThreads = QThread::idealThreadCount();
+    }
+    numThreads = std::max(numThreads, 1);
+
+    _broadcastJobs.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        _broadcastJobs.emplace_back(new AvatarMixerJob(this));
+    }
+
+    // the broadcast thread runs the first job, so the pool only needs threads for the rest
+    _broadcastThreadPool.setMaxThreadCount(std::max(numThreads - 1, 1));
+
+    QMutexLocker statsLocker(&_broadcastStatsMutex);
+    _sumUsecsBroadcastingPerThread.assign(numThreads, 0);
+    _sumListenersPerThread.assign(numThreads, 0);
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -472,6 +584,66 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
+    // broadcast thread stats - the busy percentage is how much of the broadcast phase the pool as a whole spent working
+    std::vector<quint64> sumUsecsBroadcastingPerThread;
+    std::vector<int> sumListenersPerThread;
+    AvatarDataCache::Stats cacheStats;
+    {
+        // take what the broadcast thread added up since the last stats packet
+        QMutexLocker statsLocker(&_broadcastStatsMutex);
+        sumUsecsBroadcastingPerThread.swap(_sumUsecsBroadcastingPerThread);
+        sumListenersPerThread.swap(_sumListenersPerThread);
+        _sumUsecsBroadcastingPerThread.assign(sumUsecsBroadcastingPerThread.size(), 0);
+        _sumListenersPerThread.assign(sumListenersPerThread.size(), 0);
+        cacheStats = _avatarDataCacheStats;
+        _avatarDataCacheStats = AvatarDataCache::Stats();
+    }
+    size_t numThreads = sumListenersPerThread.size();
+
+    QJsonObject broadcastThreadsStats;
+    broadcastThreadsStats["num_threads"] = (int) numThreads;
+
+    quint64 sumUsecsBroadcastingAllThreads = 0;
+    for (size_t i = 0; i < numThreads; ++i) {
+        QJsonObject threadStats;
+        threadStats["average_listeners_per_frame"] = (_numStatFrames > 0)
+            ? (float) sumListenersPerThread[i] / (float) _numStatFrames : 0.0f;
+        threadStats["average_usecs_per_frame"] = (_numStatFrames > 0)
+            ? (float) sumUsecsBroadcastingPerThread[i] / (float) _numStatFrames : 0.0f;
+        broadcastThreadsStats["thread_" + QString::number(i)] = threadStats;
+
+        sumUsecsBroadcastingAllThreads += sumUsecsBroadcastingPerThread[i];
+    }
+
+    broadcastThreadsStats["average_usecs_taking_snapshots_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumUsecsTakingSnapshots / (float) _numStatFrames : 0.0f;
+    broadcastThreadsStats["average_usecs_broadcasting_per_frame"] = (_numStatFrames > 0)
+        ? (float) _sumUsecsBroadcastingFrames / (float) _numStatFrames : 0.0f;
+    broadcastThreadsStats["busy_percentage"] = (_sumUsecsBroadcastingFrames > 0)
+        ? (float) sumUsecsBroadcastingAllThreads / (float) (_sumUsecsBroadcastingFrames * numThreads) * 100.0f
+        : 0.0f;
+
+    statsObject["broadcast_threads"] = broadcastThreadsStats;
+
+    // avatar data cache stats - every hit is an encode of an avatar that we did not have to do
+    QJsonObject avatarDataCacheStats;
+    avatarDataCacheStats["average_encodes_per_frame"] = (_numStatFrames > 0)
+        ? (float) cacheStats.numEncodes / (float) _numStatFrames : 0.0f;
+    avatarDataCacheStats["average_unused_encodes_per_frame"] = (_numStatFrames > 0)
+        ? (float) cacheStats.numUnusedEncodes / (float) _numStatFrames : 0.0f;
+    for (int detail = 0; detail < AvatarDataCache::NUM_DETAILS; ++detail) {
+        avatarDataCacheStats[QString("average_") + AvatarDataCache::getDetailName((AvatarDataCache::Detail)detail)
+                             + "_sends_per_frame"] = (_numStatFrames > 0)
+            ? (float) cacheStats.numUses[detail] / (float) _numStatFrames : 0.0f;
+    }
+    avatarDataCacheStats["hit_ratio"] = cacheStats.getHitRatio();
+    avatarDataCacheStats["average_bytes_encoded_per_frame"] = (_numStatFrames > 0)
+        ? (float) cacheStats.bytesEncoded / (float) _numStatFrames : 0.0f;
+    avatarDataCacheStats["average_bytes_saved_per_frame"] = (_numStatFrames > 0)
+        ? (float) cacheStats.bytesSaved / (float) _numStatFrames : 0.0f;
+
+    statsObject["avatar_data_cache"] = avatarDataCacheStats;
+
     QJsonObject avatarsObject;
 
     auto nodeList = DependencyManager::get<NodeList>();
@@ -509,6 +681,8 @@ void AvatarMixer::sendStatsPacket() {
     _sumListeners = 0;
     _sumBillboardPackets = 0;
     _sumIdentityPackets = 0;
+    _sumUsecsBroadcastingFrames = 0;
+    _sumUsecsTakingSnapshots = 0;
     _numStatFrames = 0;
 }
 
@@ -560,4 +734,19 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
+
+    const QString POSITION_ONLY_DISTANCE_KEY = "position_only_distance";
+    _positionOnlyDistance = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[POSITION_ONLY_DISTANCE_KEY].toDouble(0.0);
+    if (_positionOnlyDistance > 0.0f) {
+        qDebug() << "Avatars further than" << _positionOnlyDistance << "m from a listener are sent without joints.";
+    }
+
+    const QString BROADCAST_THREADS_KEY = "broadcast_threads";
+    bool ok = false;
+    int numBroadcastThreads = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_THREADS_KEY].toString().toInt(&ok);
+    if (!ok) {
+        numBroadcastThreads = DEFAULT_NUM_BROADCAST_THREADS;
+    }
+    setNumBroadcastThreads(numBroadcastThreads);
+    qDebug() << "Broadcasting with" << _broadcastJobs.size() << "broadcast threads";
 }
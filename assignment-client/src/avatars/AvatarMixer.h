@@ -15,7 +15,23 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <memory>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+
+#include <glm/glm.hpp>
+
+#include <AvatarData.h>
+#include <Node.h>
 #include <ThreadedAssignment.h>
+#include <udt/PacketBatch.h>
+
+#include "AvatarDataCache.h"
+#include "AvatarMixerJob.h"
+
+class AvatarMixerClientData;
 
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
@@ -39,10 +55,58 @@ private slots:
     void domainSettingsRequestComplete();
     
 private:
+    friend class AvatarMixerJob;
+
+    /// the state of one avatar, copied at the start of each frame while holding the mutex of its node data,
+    /// so that the broadcast jobs can read every avatar without locking
+    struct AvatarSnapshot {
+        SharedNodePointer node;
+        AvatarMixerClientData* nodeData;
+        bool isListener;
+        glm::vec3 position;
+        AvatarDataSequenceNumber lastReceivedSequenceNumber;
+        quint64 billboardChangeTimestamp;
+        quint64 identityChangeTimestamp;
+        QByteArray billboard;
+        QByteArray identity;
+        AvatarDataCache::Detail detail; // what listeners in full rate distance get this frame, the avatar data is cached
+    };
+
     void broadcastAvatarData();
     void parseDomainServerSettings(const QJsonObject& domainSettings);
-    
+
+    /// fills _avatarSnapshots with every avatar we can lock this frame
+    void takeAvatarSnapshots();
+
+    /// splits this frame's listeners across the broadcast jobs and runs them, returns once every job is done
+    void runBroadcastJobs();
+
+    /// decides what a listener of the given job is sent this frame and builds its packets, called from broadcast jobs
+    void prepareBroadcastForListener(AvatarMixerJob& job, int listenerIndex);
+
+    void setNumBroadcastThreads(int numThreads);
+
     QThread _broadcastThread;
+
+    std::vector<AvatarSnapshot> _avatarSnapshots;
+    AvatarDataCache _avatarDataCache;
+
+    // one job per broadcast thread - the first job is always run on the broadcast thread itself,
+    // the others are handed to the pool which has one less thread than we have jobs
+    std::vector<std::unique_ptr<AvatarMixerJob>> _broadcastJobs;
+    QThreadPool _broadcastThreadPool;
+
+    // the packets of a frame, sent out together once every listener has been broadcast to
+    udt::PacketBatch _broadcastPacketBatch;
+
+    // per broadcast thread and avatar data cache stats, added to by the broadcast thread every frame and taken by
+    // sendStatsPacket
+    QMutex _broadcastStatsMutex;
+    std::vector<quint64> _sumUsecsBroadcastingPerThread;
+    std::vector<int> _sumListenersPerThread;
+    AvatarDataCache::Stats _avatarDataCacheStats;
+    quint64 _sumUsecsBroadcastingFrames;
+    quint64 _sumUsecsTakingSnapshots;
     
     quint64 _lastFrameTimestamp;
     
@@ -56,6 +120,9 @@ private:
 
     float _maxKbpsPerNode = 0.0f;
 
+    // listeners further than this from an avatar are only sent its position, 0 sends every listener the joints
+    float _positionOnlyDistance = 0.0f;
+
     QTimer* _broadcastTimer = nullptr;
 };
 
@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <unordered_map>
 #include <unordered_set>
@@ -97,7 +98,8 @@ private:
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    // incremented by the broadcast jobs of every listener that is sent this avatar
+    std::atomic<int> _numOutOfOrderSends { 0 };
 
     SimpleMovingAverage _avgOtherAvatarDataRate;
 };
@@ -0,0 +1,51 @@
+//
+//  AvatarMixerJob.cpp
+//  assignment-client/src/avatars
+//
+//  Created by High Fidelity on 1/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <SharedUtil.h>
+
+#include "AvatarMixer.h"
+
+#include "AvatarMixerJob.h"
+
+AvatarMixerJob::AvatarMixerJob(AvatarMixer* mixer) :
+    QRunnable(),
+    _mixer(mixer),
+    _generator(std::random_device()())
+{
+    // jobs are re-used every frame, the mixer owns them
+    setAutoDelete(false);
+
+    clearListeners();
+}
+
+void AvatarMixerJob::clearListeners() {
+    _listeners.clear();
+    _packets.clear();
+    _avatarPacketLists.clear();
+
+    _numListenersBroadcastTo = 0;
+    _numBillboardPackets = 0;
+    _numIdentityPackets = 0;
+    _usecsBroadcasting = 0;
+}
+
+void AvatarMixerJob::run() {
+    quint64 start = usecTimestampNow();
+
+    _packets.resize(_listeners.size());
+    _avatarPacketLists.resize(_listeners.size());
+
+    for (size_t i = 0; i < _listeners.size(); ++i) {
+        _mixer->prepareBroadcastForListener(*this, (int)i);
+    }
+
+    _usecsBroadcasting = usecTimestampNow() - start;
+}
@@ -0,0 +1,70 @@
+//
+//  AvatarMixerJob.h
+//  assignment-client/src/avatars
+//
+//  Created by High Fidelity on 1/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerJob_h
+#define hifi_AvatarMixerJob_h
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QtCore/QRunnable>
+
+#include <NLPacket.h>
+#include <NLPacketList.h>
+
+class AvatarMixer;
+
+/// One slice of a frame's listeners. Each worker in the AvatarMixer pool runs one job, which decides what every one of
+/// its listeners is sent this frame from the avatar snapshots the mixer took at the start of the frame.
+/// The job only builds the packets - they are sent by the mixer once every job for the frame is done.
+class AvatarMixerJob : public QRunnable {
+public:
+    AvatarMixerJob(AvatarMixer* mixer);
+
+    void run();
+
+    void clearListeners();
+    void addListener(int snapshotIndex) { _listeners.push_back(snapshotIndex); }
+
+    /// the listeners of this job, as indices into the avatar snapshots of the frame
+    const std::vector<int>& getListeners() const { return _listeners; }
+
+    std::vector<std::unique_ptr<NLPacket>>& getPackets(int listenerIndex) { return _packets[listenerIndex]; }
+    std::unique_ptr<NLPacketList>& getAvatarPacketList(int listenerIndex) { return _avatarPacketLists[listenerIndex]; }
+
+    int getNumListenersBroadcastTo() const { return _numListenersBroadcastTo; }
+    int getNumBillboardPackets() const { return _numBillboardPackets; }
+    int getNumIdentityPackets() const { return _numIdentityPackets; }
+    quint64 getUsecsBroadcasting() const { return _usecsBroadcasting; }
+
+private:
+    friend class AvatarMixer;
+
+    AvatarMixer* _mixer;
+
+    std::vector<int> _listeners;
+
+    // identity and billboard packets, and the bulk avatar data, for each listener
+    std::vector<std::vector<std::unique_ptr<NLPacket>>> _packets;
+    std::vector<std::unique_ptr<NLPacketList>> _avatarPacketLists;
+
+    // every job has its own random state, so jobs never share a generator
+    std::mt19937 _generator;
+    std::uniform_real_distribution<float> _distribution;
+
+    int _numListenersBroadcastTo;
+    int _numBillboardPackets;
+    int _numIdentityPackets;
+    quint64 _usecsBroadcasting;
+};
+
+#endif // hifi_AvatarMixerJob_h
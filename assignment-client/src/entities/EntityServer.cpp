@@ -55,6 +55,8 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+    // the server answers no spatial queries, so it doesn't pay to keep the spatial index up to date
+    tree->setWantSpatialIndex(false);
     if (!_entitySimulation) {
         SimpleEntitySimulation* simpleSimulation = new SimpleEntitySimulation();
         simpleSimulation->setEntityTree(tree);
@@ -270,6 +272,11 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
+
+    int simulationThreads = 0;
+    readOptionInt(QString("simulationThreads"), settingsSectionObject, simulationThreads);
+    _entitySimulation->setNumSimulationThreads(simulationThreads);
+    qDebug("simulationThreads=%d", _entitySimulation->getNumSimulationThreads());
 }
 
 
@@ -282,6 +289,10 @@ void EntityServer::trackSend(const QUuid& dataID, quint64 dataLastEdited, const
     _viewerSendingStats[viewerNode][dataID] = { usecTimestampNow(), dataLastEdited };
 }
 
+void EntityServer::resetServerSubclassStats() {
+    std::static_pointer_cast<EntityTree>(_tree)->getEncodeCache().resetStats();
+}
+
 void EntityServer::trackViewerGone(const QUuid& viewerNode) {
     QWriteLocker locker(&_viewerSendingStatsLock);
     _viewerSendingStats.remove(viewerNode);
@@ -297,6 +308,35 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // display how often the send threads shared an entity encoding
+    EntityEncodeCache& encodeCache = std::static_pointer_cast<EntityTree>(_tree)->getEncodeCache();
+    statsString += "<b>Entity Server Encode Cache Statistics</b>\r\n";
+    statsString += QString("           Hits: %1\r\n").arg(locale.toString(encodeCache.getHits()));
+    statsString += QString("         Misses: %1\r\n").arg(locale.toString(encodeCache.getMisses()));
+    statsString += QString("      Hit Ratio: %1%\r\n").arg(locale.toString(encodeCache.getHitRatio() * 100.0f, 'f', 2));
+    statsString += QString("   Bytes Reused: %1 bytes\r\n").arg(locale.toString(encodeCache.getBytesReused()));
+    statsString += QString("        Entries: %1\r\n").arg(locale.toString(encodeCache.getNumEntries()));
+    statsString += QString("   Bytes Cached: %1 bytes\r\n").arg(locale.toString(encodeCache.getBytesCached()));
+    statsString += "\r\n\r\n";
+
+    // display how long the last snapshot of the tree (taken to persist it) kept the tree locked
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    statsString += "<b>Entity Server Last Snapshot Statistics</b>\r\n";
+    statsString += QString("         Entities: %1\r\n").arg(locale.toString(tree->getSnapshotNumEntities()));
+    statsString += QString("  Shared Entities: %1\r\n").arg(locale.toString(tree->getSnapshotNumShared()));
+    statsString += QString("   Tree Lock Wait: %1 usecs\r\n").arg(locale.toString(tree->getSnapshotLockWaitTime()));
+    statsString += QString("   Tree Lock Held: %1 usecs\r\n").arg(locale.toString(tree->getSnapshotLockHoldTime()));
+    statsString += "\r\n\r\n";
+
+    // display how the last simulation frame was spread across the simulation threads
+    statsString += "<b>Entity Server Last Simulation Frame Statistics</b>\r\n";
+    statsString += QString("          Threads: %1\r\n").arg(locale.toString(_entitySimulation->getNumSimulationThreads()));
+    statsString += QString("        Simulated: %1 entities\r\n").arg(locale.toString(_entitySimulation->getNumEntitiesSimulated()));
+    statsString += QString("         Resorted: %1 entities\r\n").arg(locale.toString(_entitySimulation->getNumEntitiesResorted()));
+    statsString += QString("       Simulating: %1 usecs\r\n").arg(locale.toString(_entitySimulation->getUsecsSimulating()));
+    statsString += QString("          Sorting: %1 usecs\r\n").arg(locale.toString(_entitySimulation->getUsecsSorting()));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
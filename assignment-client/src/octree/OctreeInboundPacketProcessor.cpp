@@ -22,6 +22,12 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// decoded edits are applied once every queued packet is decoded, or once this many are waiting
+const int MAX_EDITS_PER_BATCH = 1000;
+
+// a batch gives the tree lock up after this long, so the send threads get a turn during a large batch
+const quint64 MAX_BATCH_LOCK_HOLD_USECS = 5 * USECS_PER_MSEC;
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -30,6 +36,12 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalBatches(0),
+    _totalBatchEdits(0),
+    _maxBatchEdits(0),
+    _totalLockSections(0),
+    _totalLockHoldTime(0),
+    _maxLockHoldTime(0),
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
@@ -41,6 +53,12 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
+    _totalBatches = 0;
+    _totalBatchEdits = 0;
+    _maxBatchEdits = 0;
+    _totalLockSections = 0;
+    _totalLockHoldTime = 0;
+    _maxLockHoldTime = 0;
     _lastNackTime = usecTimestampNow();
 
     QWriteLocker locker(&_senderStatsLock);
@@ -73,6 +91,15 @@ void OctreeInboundPacketProcessor::midProcess() {
         _lastNackTime = now;
         sendNackPackets();
     }
+
+    if ((int)_pendingEdits.size() >= MAX_EDITS_PER_BATCH) {
+        applyPendingEdits();
+    }
+}
+
+void OctreeInboundPacketProcessor::postProcess() {
+    // every queued packet has been decoded
+    applyPendingEdits();
 }
 
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -81,6 +108,8 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         return;
     }
 
+    PerformanceTimer perfTimer("processPacket");
+
     bool debugProcessPacket = _myServer->wantsVerboseDebug();
 
     if (debugProcessPacket) {
@@ -111,10 +140,10 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             sentAt = arrivedAt;
         }
 
-        quint64 transitTime = arrivedAt - sentAt;
-        int editsInPacket = 0;
-        quint64 processTime = 0;
-        quint64 lockWaitTime = 0;
+        PendingPacket packet;
+        packet.sequence = sequence;
+        packet.transitTime = arrivedAt - sentAt;
+        quint64 transitTime = packet.transitTime;
 
         if (debugProcessPacket || _myServer->wantsDebugReceiving()) {
             qDebug() << "PROCESSING THREAD: got '" << packetType << "' packet - " << _receivedPacketCount << " command from client";
@@ -141,10 +170,13 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
         }
         
         const unsigned char* editData = nullptr;
-        
+
+        // edits are single packets, so this points into the received packet instead of a copy of it
+        const char* rawMessage = message->getRawMessage();
+
         while (message->getBytesLeftToRead() > 0) {
 
-            editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+            editData = reinterpret_cast<const unsigned char*>(rawMessage + message->getPosition());
 
             int maxSize = message->getBytesLeftToRead();
 
@@ -157,33 +189,48 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                         message->getPosition(), maxSize);
             }
 
-            quint64 startProcess, startLock = usecTimestampNow();
-            int editDataBytesRead;
-            _myServer->getOctree()->withWriteLock([&] {
-                startProcess = usecTimestampNow();
-                editDataBytesRead =
-                    _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
-            });
-            quint64 endProcess = usecTimestampNow();
+            // decode the edit now, it is applied with the rest of the batch once every queued packet is decoded
+            quint64 startDecode = usecTimestampNow();
+            OctreeDecodedEditPointer edit;
+            int editDataBytesRead = _myServer->getOctree()->decodeEditPacketData(*message, editData, maxSize, edit);
+
+            if (editDataBytesRead >= 0) {
+                packet.processTime += usecTimestampNow() - startDecode;
+                if (edit) {
+                    _pendingEdits.push_back({ std::move(edit), sendingNode, (int)_pendingPackets.size() });
+                }
+            } else {
+                // this tree can only decode an edit while applying it, which it does under the lock right away
+                applyPendingEdits();
+
+                quint64 startProcess, startLock = usecTimestampNow();
+                _myServer->getOctree()->withWriteLock([&] {
+                    startProcess = usecTimestampNow();
+                    editDataBytesRead =
+                        _myServer->getOctree()->processEditPacketData(*message, editData, maxSize, sendingNode);
+                });
+                quint64 endProcess = usecTimestampNow();
+
+                quint64 thisLockWaitTime = startProcess - startLock;
+                packet.processTime += endProcess - startProcess;
+                packet.lockWaitTime += thisLockWaitTime;
+                OctreeServer::trackProcessWaitTime((float)thisLockWaitTime);
+            }
 
             if (debugProcessPacket) {
-                qDebug() << "OctreeInboundPacketProcessor::processPacket() after processEditPacketData()..."
+                qDebug() << "OctreeInboundPacketProcessor::processPacket() after decodeEditPacketData()..."
                     << "editDataBytesRead=" << editDataBytesRead;
             }
 
-            editsInPacket++;
-            quint64 thisProcessTime = endProcess - startProcess;
-            quint64 thisLockWaitTime = startProcess - startLock;
-            processTime += thisProcessTime;
-            lockWaitTime += thisLockWaitTime;
+            packet.editsInPacket++;
 
             // skip to next edit record in the packet
             message->seek(message->getPosition() + editDataBytesRead);
 
             if (debugProcessPacket) {
                 qDebug() << "    editDataBytesRead=" << editDataBytesRead;
-                qDebug() << "    AFTER processEditPacketData payload position=" << message->getPosition();
-                qDebug() << "    AFTER processEditPacketData payload size=" << message->getSize();
+                qDebug() << "    AFTER decodeEditPacketData payload position=" << message->getPosition();
+                qDebug() << "    AFTER decodeEditPacketData payload size=" << message->getSize();
             }
 
         }
@@ -206,12 +253,77 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                 qDebug() << "sender has no known nodeUUID.";
             }
         }
-        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+        packet.nodeUUID = nodeUUID;
+
+        // the packet is tracked once its edits have been applied
+        _pendingPackets.push_back(packet);
     } else {
         qDebug("unknown packet ignored... packetType=%hhu", packetType);
     }
 }
 
+void OctreeInboundPacketProcessor::applyPendingEdits() {
+    if (_pendingPackets.empty() && _pendingEdits.empty()) {
+        return;
+    }
+
+    PerformanceTimer perfTimer("applyPendingEdits");
+
+    auto tree = _myServer->getOctree();
+    size_t nextEdit = 0;
+
+    while (nextEdit < _pendingEdits.size()) {
+        size_t sectionStart = nextEdit;
+
+        quint64 startProcess, endProcess, startLock = usecTimestampNow();
+        tree->withWriteLock([&] {
+            startProcess = usecTimestampNow();
+            quint64 startEdit = startProcess;
+            do {
+                PendingEdit& pending = _pendingEdits[nextEdit++];
+                tree->applyDecodedEdit(*pending.edit, pending.sendingNode);
+
+                quint64 endEdit = usecTimestampNow();
+                _pendingPackets[pending.packetIndex].processTime += endEdit - startEdit;
+                startEdit = endEdit;
+            } while (nextEdit < _pendingEdits.size() && startEdit - startProcess < MAX_BATCH_LOCK_HOLD_USECS);
+            endProcess = startEdit;
+        });
+
+        quint64 lockWaitTime = startProcess - startLock;
+        quint64 lockHoldTime = endProcess - startProcess;
+        OctreeServer::trackProcessWaitTime((float)lockWaitTime);
+
+        // the edits of a section share the wait for its lock
+        quint64 lockWaitTimePerEdit = lockWaitTime / (nextEdit - sectionStart);
+        for (size_t i = sectionStart; i < nextEdit; ++i) {
+            _pendingPackets[_pendingEdits[i].packetIndex].lockWaitTime += lockWaitTimePerEdit;
+        }
+
+        _totalLockSections++;
+        _totalLockHoldTime += lockHoldTime;
+        if (lockHoldTime > _maxLockHoldTime) {
+            _maxLockHoldTime = lockHoldTime;
+        }
+    }
+
+    if (!_pendingEdits.empty()) {
+        _totalBatches++;
+        _totalBatchEdits += _pendingEdits.size();
+        if (_pendingEdits.size() > _maxBatchEdits) {
+            _maxBatchEdits = _pendingEdits.size();
+        }
+    }
+
+    for (auto& packet : _pendingPackets) {
+        trackInboundPacket(packet.nodeUUID, packet.sequence, packet.transitTime, packet.editsInPacket,
+                           packet.processTime, packet.lockWaitTime);
+    }
+
+    _pendingEdits.clear();
+    _pendingPackets.clear();
+}
+
 void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
 
@@ -14,6 +14,9 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <vector>
+
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -70,6 +73,14 @@ public:
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
 
+    // edits are applied in batches, each batch takes the tree lock for one or more sections of bounded length
+    quint64 getTotalBatches() const { return _totalBatches; }
+    quint64 getAverageEditsPerBatch() const { return _totalBatches == 0 ? 0 : _totalBatchEdits / _totalBatches; }
+    quint64 getMaxEditsPerBatch() const { return _maxBatchEdits; }
+    quint64 getAverageLockSectionsPerBatch() const { return _totalBatches == 0 ? 0 : _totalLockSections / _totalBatches; }
+    quint64 getAverageLockHoldTime() const { return _totalLockSections == 0 ? 0 : _totalLockHoldTime / _totalLockSections; }
+    quint64 getMaxLockHoldTime() const { return _maxLockHoldTime; }
+
     void resetStats();
 
     NodeToSenderStatsMap getSingleSenderStats() { QReadLocker locker(&_senderStatsLock); return _singleSenderStats; }
@@ -83,22 +94,51 @@ protected:
     virtual unsigned long getMaxWait() const;
     virtual void preProcess();
     virtual void midProcess();
+    virtual void postProcess();
 
 private:
     int sendNackPackets();
 
+    // applies every decoded edit to the tree
+    void applyPendingEdits();
+
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
 
+    struct PendingPacket {
+        QUuid nodeUUID;
+        unsigned short int sequence { 0 };
+        quint64 transitTime { 0 };
+        int editsInPacket { 0 };
+        quint64 processTime { 0 };
+        quint64 lockWaitTime { 0 };
+    };
+
+    struct PendingEdit {
+        OctreeDecodedEditPointer edit;
+        SharedNodePointer sendingNode;
+        int packetIndex; // in _pendingPackets
+    };
+
     OctreeServer* _myServer;
     int _receivedPacketCount;
+
+    std::vector<PendingPacket> _pendingPackets;
+    std::vector<PendingEdit> _pendingEdits;
     
     std::atomic<uint64_t> _totalTransitTime;
     std::atomic<uint64_t> _totalProcessTime;
     std::atomic<uint64_t> _totalLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
+
+    std::atomic<uint64_t> _totalBatches;
+    std::atomic<uint64_t> _totalBatchEdits;
+    std::atomic<uint64_t> _maxBatchEdits;
+    std::atomic<uint64_t> _totalLockSections;
+    std::atomic<uint64_t> _totalLockHoldTime;
+    std::atomic<uint64_t> _maxLockHoldTime;
     
     NodeToSenderStatsMap _singleSenderStats;
     QReadWriteLock _senderStatsLock;
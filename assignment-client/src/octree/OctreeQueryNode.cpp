@@ -18,7 +18,9 @@
 #include <SharedUtil.h>
 #include <UUID.h>
 
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
+#include "OctreeServer.h"
 
 OctreeQueryNode::OctreeQueryNode() :
     _viewSent(false),
@@ -34,6 +36,7 @@ OctreeQueryNode::OctreeQueryNode() :
     _viewFrustumChanging(false),
     _viewFrustumJustStoppedChanging(true),
     _octreeSendThread(NULL),
+    _octreeSendScheduler(NULL),
     _lastClientBoundaryLevelAdjust(0),
     _lastClientOctreeSizeScale(DEFAULT_OCTREE_SIZE_SCALE),
     _lodChanged(false),
@@ -67,12 +70,12 @@ void OctreeQueryNode::nodeKilled() {
 void OctreeQueryNode::forceNodeShutdown() {
     _isShuttingDown = true;
     if (_octreeSendThread) {
-        // we really need to force our thread to shutdown, this is synchronous, we will block while the thread actually
-        // shuts down because we really need it to shutdown, and it's ok if we wait for it to complete
+        // we really need to force our send to shutdown, this is synchronous, we will block while a send worker finishes
+        // the slice it may be in the middle of, because we really need it to shutdown, and it's ok if we wait for it
         OctreeSendThread* sendThread = _octreeSendThread;
         _octreeSendThread = NULL;
         sendThread->setIsShuttingDown();
-        sendThread->terminate();
+        _octreeSendScheduler->removeSend(sendThread);
         delete sendThread;
     }
 }
@@ -90,10 +93,11 @@ void OctreeQueryNode::sendThreadFinished() {
 
 void OctreeQueryNode::initializeOctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) {
     _octreeSendThread = new OctreeSendThread(myServer, node);
+    _octreeSendScheduler = myServer->getSendScheduler();
 
-    // we want to be notified when the thread finishes
+    // we want to be notified when the send finishes, this is signalled from a send worker
     connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
-    _octreeSendThread->initialize(true);
+    _octreeSendScheduler->addSend(_octreeSendThread);
 }
 
 bool OctreeQueryNode::packetIsDuplicate() const {
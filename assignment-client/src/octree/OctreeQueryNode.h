@@ -23,6 +23,7 @@
 #include "SentPacketHistory.h"
 #include <qqueue.h>
 
+class OctreeSendScheduler;
 class OctreeSendThread;
 class OctreeServer;
 
@@ -129,6 +130,7 @@ private:
     bool _viewFrustumJustStoppedChanging;
 
     OctreeSendThread* _octreeSendThread;
+    OctreeSendScheduler* _octreeSendScheduler;
 
     // watch for LOD changes
     int _lastClientBoundaryLevelAdjust;
@@ -0,0 +1,197 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Created by High Fidelity on 1/27/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+#include "OctreeSendScheduler.h"
+
+OctreeSendWorker::OctreeSendWorker(OctreeSendScheduler* scheduler, int index) :
+    _scheduler(scheduler),
+    _index(index)
+{
+    // set our QThread object name so we can identify this thread while debugging
+    setObjectName(QString("Octree Send Worker %1").arg(index));
+
+    resetStats();
+}
+
+bool OctreeSendWorker::process() {
+    quint64 dueTime = 0;
+    OctreeSendThread* send = _scheduler->takeNextDueSend(dueTime);
+    if (!send) {
+        return false; // the scheduler is stopping
+    }
+
+    quint64 start = usecTimestampNow();
+    if (start > dueTime) {
+        _averageLateness.updateAverage((float)(start - dueTime));
+    } else {
+        _averageLateness.updateAverage(0.0f);
+    }
+
+    bool keepSending = send->process();
+
+    quint64 end = usecTimestampNow();
+    _averageSliceTime.updateAverage((float)(end - start));
+    _averageTreeWaitTime.updateAverage(send->getSliceTreeWaitTime());
+    _averageEncodeTime.updateAverage(send->getSliceEncodeTime());
+    _usecsBusy += end - start;
+    ++_totalSlices;
+
+    _scheduler->finishSend(send, keepSending, start + OCTREE_SEND_INTERVAL_USECS);
+
+    return isStillRunning();
+}
+
+float OctreeSendWorker::getBusyPercentage() const {
+    quint64 elapsed = usecTimestampNow() - _statsStart;
+    const float AS_PERCENT = 100.0f;
+    return (elapsed > 0) ? (float)_usecsBusy / (float)elapsed * AS_PERCENT : 0.0f;
+}
+
+void OctreeSendWorker::resetStats() {
+    _totalSlices = 0;
+    _usecsBusy = 0;
+    _statsStart = usecTimestampNow();
+    _averageSliceTime.reset();
+    _averageLateness.reset();
+    _averageTreeWaitTime.reset();
+    _averageEncodeTime.reset();
+}
+
+OctreeSendScheduler::OctreeSendScheduler(int numWorkers) :
+    _nextOrder(0),
+    _isStopping(false)
+{
+    if (numWorkers < 1) {
+        numWorkers = QThread::idealThreadCount();
+    }
+    numWorkers = std::max(numWorkers, 1);
+
+    for (int i = 0; i < numWorkers; ++i) {
+        _workers.emplace_back(new OctreeSendWorker(this, i));
+        _workers.back()->initialize(true);
+    }
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    {
+        QMutexLocker locker(&_mutex);
+        _isStopping = true;
+        _sendsChanged.wakeAll();
+    }
+
+    // waits for each worker to finish the slice it is in
+    for (auto& worker : _workers) {
+        worker->terminate();
+    }
+    _workers.clear();
+}
+
+void OctreeSendScheduler::addSend(OctreeSendThread* send) {
+    QMutexLocker locker(&_mutex);
+    _removed.remove(send);
+    queueSend(send, usecTimestampNow());
+}
+
+void OctreeSendScheduler::removeSend(OctreeSendThread* send) {
+    QMutexLocker locker(&_mutex);
+
+    auto it = std::find_if(_queue.begin(), _queue.end(), [send](const ScheduledSend& scheduled) {
+        return scheduled.send == send;
+    });
+    if (it != _queue.end()) {
+        _queue.erase(it);
+        std::make_heap(_queue.begin(), _queue.end());
+    }
+
+    if (_running.contains(send)) {
+        // a worker is in the middle of a slice of this send, it will drop it instead of queueing it again
+        _removed.insert(send);
+        while (_running.contains(send)) {
+            _sendsChanged.wait(&_mutex);
+        }
+        _removed.remove(send);
+    }
+}
+
+int OctreeSendScheduler::getNumSends() {
+    QMutexLocker locker(&_mutex);
+    return (int)_queue.size() + _running.size();
+}
+
+void OctreeSendScheduler::resetStats() {
+    for (auto& worker : _workers) {
+        worker->resetStats();
+    }
+}
+
+OctreeSendThread* OctreeSendScheduler::takeNextDueSend(quint64& dueTime) {
+    QMutexLocker locker(&_mutex);
+
+    while (!_isStopping) {
+        if (_queue.empty()) {
+            _sendsChanged.wait(&_mutex);
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        const ScheduledSend& next = _queue.front();
+        if (next.dueTime > now) {
+            // sleep until the next send is due, or until a send is added that is due sooner
+            unsigned long msecsToWait = (unsigned long)((next.dueTime - now + USECS_PER_MSEC - 1) / USECS_PER_MSEC);
+            _sendsChanged.wait(&_mutex, msecsToWait);
+            continue;
+        }
+
+        OctreeSendThread* send = next.send;
+        dueTime = next.dueTime;
+
+        std::pop_heap(_queue.begin(), _queue.end());
+        _queue.pop_back();
+
+        _running.insert(send);
+        return send;
+    }
+
+    return nullptr;
+}
+
+void OctreeSendScheduler::finishSend(OctreeSendThread* send, bool keepSending, quint64 nextDueTime) {
+    QMutexLocker locker(&_mutex);
+    _running.remove(send);
+
+    if (_removed.contains(send)) {
+        // whoever removed it is waiting for us to be done with it
+        _sendsChanged.wakeAll();
+    } else if (keepSending) {
+        queueSend(send, nextDueTime);
+    } else {
+        // the send is shutting down, let its owner know that it can delete it
+        emit send->finished();
+    }
+}
+
+void OctreeSendScheduler::queueSend(OctreeSendThread* send, quint64 dueTime) {
+    _queue.push_back({ dueTime, _nextOrder++, send });
+    std::push_heap(_queue.begin(), _queue.end());
+
+    // wakes every worker, since the one that is waiting might be waiting for a send that is due later than this one
+    _sendsChanged.wakeAll();
+}
@@ -0,0 +1,120 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Created by High Fidelity on 1/27/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QWaitCondition>
+
+#include <GenericThread.h>
+#include <SimpleMovingAverage.h>
+
+class OctreeSendScheduler;
+class OctreeSendThread;
+
+/// One of the threads of an OctreeSendScheduler. Each call to process() runs one send interval of whichever
+/// client is due next, and keeps the timing of those slices for the server stats.
+class OctreeSendWorker : public GenericThread {
+    Q_OBJECT
+public:
+    OctreeSendWorker(OctreeSendScheduler* scheduler, int index);
+
+    int getIndex() const { return _index; }
+
+    quint64 getTotalSlices() const { return _totalSlices; }
+    float getAverageSliceTime() const { return _averageSliceTime.getAverage(); }
+    float getAverageLateness() const { return _averageLateness.getAverage(); }
+    float getAverageTreeWaitTime() const { return _averageTreeWaitTime.getAverage(); }
+    float getAverageEncodeTime() const { return _averageEncodeTime.getAverage(); }
+
+    /// how much of the time since the last resetStats this worker spent sending
+    float getBusyPercentage() const;
+
+    void resetStats();
+
+protected:
+    virtual bool process() override;
+
+private:
+    OctreeSendScheduler* _scheduler;
+    int _index;
+
+    quint64 _totalSlices;
+    quint64 _usecsBusy;
+    quint64 _statsStart;
+    SimpleMovingAverage _averageSliceTime;
+    SimpleMovingAverage _averageLateness;
+    SimpleMovingAverage _averageTreeWaitTime;
+    SimpleMovingAverage _averageEncodeTime;
+};
+
+/// Multiplexes the OctreeSendThread of every connected client over a fixed number of worker threads.
+/// Sends are run earliest deadline first: each one is due OCTREE_SEND_INTERVAL_USECS after its last slice started,
+/// and is only ever run by one worker at a time, so every client gets its turn no matter how many are connected.
+class OctreeSendScheduler {
+public:
+    /// \param numWorkers number of worker threads, 0 for one per core
+    OctreeSendScheduler(int numWorkers);
+    ~OctreeSendScheduler();
+
+    /// starts scheduling slices for a send, the first one is due right away
+    void addSend(OctreeSendThread* send);
+
+    /// stops scheduling a send, waiting for a worker that is in the middle of a slice of it.
+    /// Once this returns the caller is free to delete the send.
+    void removeSend(OctreeSendThread* send);
+
+    int getNumSends();
+    int getNumWorkers() const { return (int)_workers.size(); }
+    const OctreeSendWorker& getWorker(int index) const { return *_workers[index]; }
+
+    void resetStats();
+
+private:
+    friend class OctreeSendWorker;
+
+    struct ScheduledSend {
+        quint64 dueTime;
+        quint64 order;      // breaks ties between sends due at the same time in the order they were queued
+        OctreeSendThread* send;
+
+        // std heaps keep the largest element on top, so the earliest due send has to compare greatest
+        bool operator<(const ScheduledSend& other) const {
+            return (dueTime != other.dueTime) ? dueTime > other.dueTime : order > other.order;
+        }
+    };
+
+    /// waits for the next send that is due, returns nullptr if the scheduler is stopping
+    OctreeSendThread* takeNextDueSend(quint64& dueTime);
+
+    /// hands a send back after a slice, it is due again at nextDueTime unless it is done or was removed
+    void finishSend(OctreeSendThread* send, bool keepSending, quint64 nextDueTime);
+
+    void queueSend(OctreeSendThread* send, quint64 dueTime);
+
+    QMutex _mutex;
+    QWaitCondition _sendsChanged;
+
+    std::vector<ScheduledSend> _queue;
+    QSet<OctreeSendThread*> _running;
+    QSet<OctreeSendThread*> _removed;   // removed while a worker was running them
+    quint64 _nextOrder;
+    bool _isStopping;
+
+    std::vector<std::unique_ptr<OctreeSendWorker>> _workers;
+};
+
+#endif // hifi_OctreeSendScheduler_h
@@ -28,7 +28,9 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     _nodeUUID(node->getUUID()),
     _packetData(),
     _nodeMissingCount(0),
-    _isShuttingDown(false)
+    _isShuttingDown(false),
+    _sliceTreeWaitTime(0.0f),
+    _sliceEncodeTime(0.0f)
 {
     QString safeServerName("Octree");
 
@@ -40,7 +42,7 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client connected "
-                                            "- starting sending thread [" << this << "]";
+                                            "- starting send [" << this << "]";
 
     OctreeServer::clientConnected();
 }
@@ -52,7 +54,7 @@ OctreeSendThread::~OctreeSendThread() {
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
-                                            "- ending sending thread [" << this << "]";
+                                            "- ending send [" << this << "]";
 
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
@@ -72,7 +74,11 @@ bool OctreeSendThread::process() {
 
     OctreeServer::didProcess(this);
 
+    PerformanceTimer perfTimer("process");
+
     quint64  start = usecTimestampNow();
+    _sliceTreeWaitTime = 0.0f;
+    _sliceEncodeTime = 0.0f;
 
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
@@ -95,8 +101,9 @@ bool OctreeSendThread::process() {
         return false; // exit early if we're shutting down
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
+    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap.
+    // When we're run by the send scheduler it is the one that waits until we're due again.
+    if (isStillRunning() && isThreaded()) {
         // dynamically sleep until we need to fire off the next set of octree elements
         int elapsed = (usecTimestampNow() - start);
         int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
@@ -297,6 +304,8 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
 
     OctreeServer::didPacketDistributor(this);
 
+    PerformanceTimer perfTimer("packetDistributor");
+
     // if shutting down, exit early
     if (nodeData->isShuttingDown()) {
         return 0;
@@ -521,6 +530,12 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             }
             OctreeServer::trackTreeWaitTime(lockWaitElapsedUsec);
             OctreeServer::trackEncodeTime(encodeElapsedUsec);
+            if (lockWaitElapsedUsec != OctreeServer::SKIP_TIME) {
+                _sliceTreeWaitTime += lockWaitElapsedUsec;
+            }
+            if (encodeElapsedUsec != OctreeServer::SKIP_TIME) {
+                _sliceEncodeTime += encodeElapsedUsec;
+            }
             OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
             OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
 
@@ -24,7 +24,8 @@ class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
+/// Processor for sending octree packets to a single client. Runs non-threaded, each call to process() sends one
+/// interval worth of packets and is made by a worker of the server's OctreeSendScheduler.
 class OctreeSendThread : public GenericThread {
     Q_OBJECT
 public:
@@ -43,11 +44,17 @@ public:
     static AtomicUIntStat _usleepTime;
     static AtomicUIntStat _usleepCalls;
 
+    /// time spent waiting for the tree lock and encoding during the last call to process()
+    float getSliceTreeWaitTime() const { return _sliceTreeWaitTime; }
+    float getSliceEncodeTime() const { return _sliceEncodeTime; }
+
 protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process();
 
 private:
+    friend class OctreeSendWorker;
+
     OctreeServer* _myServer;
     SharedNodePointer _node;
     QUuid _nodeUUID;
@@ -58,7 +65,10 @@ private:
     OctreePacketData _packetData;
 
     int _nodeMissingCount;
-    bool _isShuttingDown;
+    std::atomic<bool> _isShuttingDown;
+
+    float _sliceTreeWaitTime;
+    float _sliceEncodeTime;
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -21,6 +21,7 @@
 #include <LogHandler.h>
 #include <NetworkingConstants.h>
 #include <NumericalConstants.h>
+#include <Trace.h>
 #include <UUID.h>
 
 #include "../AssignmentClient.h"
@@ -122,6 +123,10 @@ void OctreeServer::resetSendingStats() {
     _longProcessWait = 0;
     _shortProcessWait = 0;
     _noProcessWait = 0;
+
+    if (_sendScheduler) {
+        _sendScheduler->resetStats();
+    }
 }
 
 void OctreeServer::trackEncodeTime(float time) {
@@ -219,6 +224,7 @@ OctreeServer::OctreeServer(ReceivedMessage& message) :
     _statusPort(0),
     _packetsPerClientPerInterval(10),
     _packetsTotalPerInterval(DEFAULT_PACKETS_PER_INTERVAL),
+    _numSendWorkers(DEFAULT_NUM_SEND_WORKERS),
     _tree(NULL),
     _wantPersist(true),
     _debugSending(false),
@@ -273,6 +279,9 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    // every send has been removed by aboutToFinish, this waits for the send workers to stop
+    _sendScheduler.reset();
+
     delete _jurisdiction;
     _jurisdiction = NULL;
 
@@ -326,7 +335,18 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             _octreeInboundPacketProcessor->resetStats();
             _tree->resetEditStats();
             resetSendingStats();
+            resetServerSubclassStats();
+            showStats = true;
+        } else if (url.path() == "/startTrace") {
+            Tracer::setTracing(true);
+            showStats = true;
+        } else if (url.path() == "/stopTrace") {
+            Tracer::setTracing(false);
             showStats = true;
+        } else if (url.path() == "/trace.json") {
+            // the scopes still in the trace buffers, for chrome://tracing or Perfetto
+            connection->respond(HTTPConnection::StatusCode200, Tracer::exportChromeTrace(), "application/json");
+            return true;
         } else if ((url.path() == persistFile) || (url.path() == persistFile + "/")) {
             if (_persistFileDownload) {
                 QByteArray persistFileContents = getPersistFileContents();
@@ -390,6 +410,13 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             statsString += "Octree file not yet loaded...\r\n";
         }
 
+        statsString += "\r\n";
+        if (Tracer::isTracing()) {
+            statsString += "Tracing... <a href='/trace.json'>[DOWNLOAD TRACE]</a> <a href='/stopTrace'>[STOP]</a>\r\n";
+        } else {
+            statsString += "Not tracing... <a href='/startTrace'>[START TRACE]</a>\r\n";
+        }
+
         statsString += "\r\n\r\n";
         statsString += "<b>Configuration:</b>\r\n";
         statsString += getConfiguration() + "\r\n"; //one to end the config line
@@ -461,6 +488,24 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          "                 samples: %12d \r\n\r\n",
                                          (double)averageInsideTime, _averageInsideTime.getSampleCount());
 
+        // display the timing of each send worker
+        if (_sendScheduler) {
+            statsString += QString("             Send workers: %1 threads sending to %2 clients\r\n")
+                .arg(locale.toString((uint)_sendScheduler->getNumWorkers()).rightJustified(COLUMN_WIDTH, ' '))
+                .arg(_sendScheduler->getNumSends());
+
+            for (int i = 0; i < _sendScheduler->getNumWorkers(); i++) {
+                const OctreeSendWorker& worker = _sendScheduler->getWorker(i);
+                statsString += QString().sprintf("    Worker %2d: slices: %12llu  busy: %6.2f%%  slice: %9.2f usecs"
+                                                 "  late: %9.2f usecs  tree wait: %9.2f usecs  encode: %9.2f usecs\r\n",
+                                                 worker.getIndex(), (unsigned long long)worker.getTotalSlices(),
+                                                 (double)worker.getBusyPercentage(), (double)worker.getAverageSliceTime(),
+                                                 (double)worker.getAverageLateness(), (double)worker.getAverageTreeWaitTime(),
+                                                 (double)worker.getAverageEncodeTime());
+            }
+            statsString += "\r\n";
+        }
+
 
         // Process Wait
         {
@@ -709,6 +754,19 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("            Average Logging Time: %1 usecs\r\n")
             .arg(locale.toString((uint)averageLoggingTime).rightJustified(COLUMN_WIDTH, ' '));
 
+        statsString += QString("              Total Edit Batches: %1 batches\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getTotalBatches()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("             Average Edits/Batch: %1 edits\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageEditsPerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("                 Max Edits/Batch: %1 edits\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getMaxEditsPerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("     Average Lock Sections/Batch: %1 sections\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageLockSectionsPerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("          Average Lock Hold Time: %1 usecs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageLockHoldTime()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("              Max Lock Hold Time: %1 usecs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getMaxLockHoldTime()).rightJustified(COLUMN_WIDTH, ' '));
+
 
         int senderNumber = 0;
         NodeToSenderStatsMap allSenderStats = _octreeInboundPacketProcessor->getSingleSenderStats();
@@ -886,7 +944,7 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         nodeList->updateNodeWithDataFromPacket(message, senderNode);
         
         OctreeQueryNode* nodeData = dynamic_cast<OctreeQueryNode*>(senderNode->getLinkedData());
-        if (nodeData && !nodeData->isOctreeSendThreadInitalized()) {
+        if (nodeData && !nodeData->isOctreeSendThreadInitalized() && _sendScheduler) {
             nodeData->initializeOctreeSendThread(this, senderNode);
         }
     }
@@ -1022,7 +1080,10 @@ void OctreeServer::readConfiguration() {
         strcpy(_persistFilename, qPrintable(persistFilename));
         qDebug("persistFilename=%s", _persistFilename);
 
-        _persistAsFileType = "json.gz";
+        bool persistBinary;
+        readOptionBool(QString("persistBinary"), settingsSectionObject, persistBinary);
+        _persistAsFileType = persistBinary ? "hfb" : "json.gz";
+        qDebug() << "persistAsFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1071,6 +1132,10 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // Check to see if the user passed in an option for the number of threads that send to clients
+    readOptionInt(QString("sendThreads"), settingsSectionObject, _numSendWorkers);
+    qDebug("sendThreads=%d", _numSendWorkers);
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1107,6 +1172,10 @@ void OctreeServer::domainSettingsRequestComplete() {
     packetReceiver.registerListener(PacketType::JurisdictionRequest, this, "handleJurisdictionRequestPacket");
     
     readConfiguration();
+
+    // every client's sends are multiplexed over the send workers, rather than each client having its own thread
+    _sendScheduler.reset(new OctreeSendScheduler(_numSendWorkers));
+    qDebug() << qPrintable(_safeServerName) << "server sending with" << _sendScheduler->getNumWorkers() << "send workers";
     
     beforeRun(); // after payload has been processed
     
@@ -1357,6 +1426,23 @@ void OctreeServer::sendStatsPacket() {
     threadsStats["2. packetDistributor"] = (double)howManyThreadsDidPacketDistributor(oneSecondAgo);
     threadsStats["3. handlePacektSend"] = (double)howManyThreadsDidHandlePacketSend(oneSecondAgo);
     threadsStats["4. writeDatagram"] = (double)howManyThreadsDidCallWriteDatagram(oneSecondAgo);
+
+    if (_sendScheduler) {
+        QJsonObject sendWorkersStats;
+        for (int i = 0; i < _sendScheduler->getNumWorkers(); i++) {
+            const OctreeSendWorker& worker = _sendScheduler->getWorker(i);
+
+            QJsonObject workerStats;
+            workerStats["1. totalSlices"] = (double)worker.getTotalSlices();
+            workerStats["2. busyPercentage"] = worker.getBusyPercentage();
+            workerStats["3. avgSliceTime"] = worker.getAverageSliceTime();
+            workerStats["4. avgLateness"] = worker.getAverageLateness();
+            workerStats["5. avgTreeLockTime"] = worker.getAverageTreeWaitTime();
+            workerStats["6. avgEncodeTime"] = worker.getAverageEncodeTime();
+            sendWorkersStats[QString("worker %1").arg(i)] = workerStats;
+        }
+        threadsStats["5. sendWorkers"] = sendWorkersStats;
+    }
     
     QJsonObject statsArray1;
     statsArray1["1. configuration"] = getConfiguration();
@@ -1402,12 +1488,17 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        dataArray2["4. totalBatches"] = (double)_octreeInboundPacketProcessor->getTotalBatches();
+        dataArray2["5. avgEditsPerBatch"] = (double)_octreeInboundPacketProcessor->getAverageEditsPerBatch();
+        dataArray2["6. maxEditsPerBatch"] = (double)_octreeInboundPacketProcessor->getMaxEditsPerBatch();
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
         timingArray2["3. avgLockWaitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerPacket();
         timingArray2["4. avgProcessTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerElement();
         timingArray2["5. avgLockWaitTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
+        timingArray2["6. avgLockHoldTimePerSection"] = (double)_octreeInboundPacketProcessor->getAverageLockHoldTime();
+        timingArray2["7. maxLockHoldTimePerSection"] = (double)_octreeInboundPacketProcessor->getMaxLockHoldTime();
     }
     
     QJsonObject statsObject3;
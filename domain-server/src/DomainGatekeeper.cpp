@@ -114,6 +114,8 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
     }
 }
 
+const QString TRUSTED_ASSIGNMENT_CLIENTS_SETTINGS_KEYPATH = "security.trusted_assignment_clients";
+
 SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                                     const PendingAssignedNodeData& pendingAssignment) {
     
@@ -157,6 +159,19 @@ SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeCo
     // always allow assignment clients to create and destroy entities
     newNode->setCanAdjustLocks(true);
     newNode->setCanRez(true);
+
+    // assignment clients on a network we were told is private don't hash the packets they send each other
+    const QVariant* trustedAddressesVariant =
+        valueForKeyPath(_server->_settingsManager.getSettingsMap(), TRUSTED_ASSIGNMENT_CLIENTS_SETTINGS_KEYPATH);
+    QStringList trustedAddresses = trustedAddressesVariant ? trustedAddressesVariant->toStringList() : QStringList();
+
+    QHostAddress senderAddress = nodeConnection.senderSockAddr.getAddress();
+    foreach(const QString& trustedAddress, trustedAddresses) {
+        if (QHostAddress(trustedAddress) == senderAddress) {
+            newNode->setIsTrusted(true);
+            break;
+        }
+    }
     
     return newNode;
 }
@@ -301,7 +316,9 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     
     SharedNodePointer newNode = limitedNodeList->addOrUpdateNode(nodeUUID, nodeConnection.nodeType,
-                                                                 nodeConnection.publicSockAddr, nodeConnection.localSockAddr);
+                                                                 nodeConnection.publicSockAddr, nodeConnection.localSockAddr,
+                                                                 false, false, QUuid(),
+                                                                 nodeConnection.supportedHashTypes);
     
     // So that we can send messages to this node at will - we need to activate the correct socket on this node now
     newNode->activateMatchingOrNewSymmetricSocket(discoveredSocket);
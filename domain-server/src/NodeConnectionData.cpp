@@ -23,7 +23,8 @@ NodeConnectionData NodeConnectionData::fromDataStream(QDataStream& dataStream, c
     
     dataStream >> newHeader.nodeType
         >> newHeader.publicSockAddr >> newHeader.localSockAddr
-        >> newHeader.interestList;
+        >> newHeader.interestList
+        >> newHeader.supportedHashTypes;
 
     newHeader.senderSockAddr = senderSockAddr;
     
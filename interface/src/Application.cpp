@@ -18,6 +18,8 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QTimer>
@@ -95,6 +97,7 @@
 #include <SoundCache.h>
 #include <TextureCache.h>
 #include <Tooltip.h>
+#include <Trace.h>
 #include <udt/PacketHeaders.h>
 #include <UserActivityLogger.h>
 #include <UUID.h>
@@ -1280,7 +1283,7 @@ void Application::paintGL() {
     auto framebufferCache = DependencyManager::get<FramebufferCache>();
     const QSize size = framebufferCache->getFrameBufferSize();
     {
-        PROFILE_RANGE(__FUNCTION__ "/mainRender");
+        PROFILE_RANGE("paintGL/mainRender");
         PerformanceTimer perfTimer("mainRender");
         // Viewport is assigned to the size of the framebuffer
         renderArgs._viewport = ivec4(0, 0, size.width(), size.height());
@@ -1340,7 +1343,7 @@ void Application::paintGL() {
     // Overlay Composition, needs to occur after screen space effects have completed
     // FIXME migrate composition into the display plugins
     {
-        PROFILE_RANGE(__FUNCTION__ "/compositor");
+        PROFILE_RANGE("paintGL/compositor");
         PerformanceTimer perfTimer("compositor");
         auto primaryFbo = framebufferCache->getPrimaryFramebuffer();
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gpu::GLBackend::getFramebufferID(primaryFbo));
@@ -1365,7 +1368,7 @@ void Application::paintGL() {
 
     // deliver final composited scene to the display plugin
     {
-        PROFILE_RANGE(__FUNCTION__ "/pluginOutput");
+        PROFILE_RANGE("paintGL/pluginOutput");
         PerformanceTimer perfTimer("pluginOutput");
         auto primaryFramebuffer = framebufferCache->getPrimaryFramebuffer();
         auto scratchFramebuffer = framebufferCache->getFramebuffer();
@@ -1387,7 +1390,7 @@ void Application::paintGL() {
 
         Q_ASSERT(isCurrentContext(_offscreenContext->getContext()));
         {
-            PROFILE_RANGE(__FUNCTION__ "/pluginSubmitScene");
+            PROFILE_RANGE("paintGL/pluginSubmitScene");
             PerformanceTimer perfTimer("pluginSubmitScene");
             displayPlugin->submitSceneTexture(_frameCount, finalTexture, toGlm(size));
         }
@@ -1418,6 +1421,28 @@ void Application::runTests() {
     runUnitTests();
 }
 
+void Application::setTracing(bool tracing) {
+    Tracer::setTracing(tracing);
+}
+
+void Application::exportTrace() {
+    QString filename = QFileDialog::getSaveFileName(_window, "Export Trace", QDir::homePath() + "/interface-trace.json",
+                                                    "Trace (*.json)");
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(interfaceapp) << "Unable to write trace to" << filename;
+        return;
+    }
+
+    // the file loads in chrome://tracing or Perfetto
+    file.write(Tracer::exportChromeTrace());
+    qCDebug(interfaceapp) << "Exported trace to" << filename;
+}
+
 void Application::audioMuteToggled() {
     QAction* muteAction = Menu::getInstance()->getActionForOption(MenuOption::MuteAudio);
     Q_CHECK_PTR(muteAction);
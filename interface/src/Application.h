@@ -307,6 +307,9 @@ public slots:
     void rotationModeChanged();
     
     void runTests();
+
+    void setTracing(bool tracing);
+    void exportTrace();
     
 private slots:
     void clearDomainOctreeDetails();
@@ -497,6 +497,9 @@ Menu::Menu() {
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::LogExtraTimings);
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::SuppressShortTimings);
     addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::ShowRealtimeEntityStats);
+    addCheckableActionToQMenuAndActionHash(timingMenu, MenuOption::RecordTrace, 0, false,
+                                           qApp, SLOT(setTracing(bool)));
+    addActionToQMenuAndActionHash(timingMenu, MenuOption::ExportTrace, 0, qApp, SLOT(exportTrace()));
 
     auto audioIO = DependencyManager::get<AudioClient>();
     MenuWrapper* audioDebugMenu = developerMenu->addMenu("Audio");
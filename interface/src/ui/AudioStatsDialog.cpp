@@ -14,6 +14,7 @@
 #include <cstdio>
 
 #include <AudioClient.h>
+#include <AudioCodec.h>
 #include <AudioConstants.h>
 #include <AudioIOStats.h>
 #include <DependencyManager.h>
@@ -161,11 +162,19 @@ void AudioStatsDialog::renderStats() {
     _upstreamClientStats.push_back(
                                     QString("Inter-packet timegaps (last 30s) | min: %1, max: %2, avg: %3").arg(formatUsecTime(packetSentTimeGaps.getWindowMin()).toLatin1().data()).arg(formatUsecTime(packetSentTimeGaps.getWindowMax()).toLatin1().data()).arg(formatUsecTime(packetSentTimeGaps.getWindowAverage()).toLatin1().data()));
     
+    // what the codec saves, the bytes on the wire against the bytes of the samples they carry
+    const char* codecName = AudioCodec::getCodec(DependencyManager::get<AudioClient>()->getCodecType())->getName();
+    _upstreamClientStats.push_back(QString("Codec: %1 | sent %2 bytes of audio for %3 bytes of samples")
+                                   .arg(codecName).arg(_stats->getAudioBytesSent()).arg(_stats->getRawAudioBytesSent()));
+
     _upstreamMixerStats.push_back(QString("\nUpstream mic audio stats (received and reported by audio-mixer):"));
         
     renderAudioStreamStats(&_stats->getMixerAvatarStreamStats(), &_upstreamMixerStats, true);
     
     _downstreamStats.push_back(QString("\nDownstream mixed audio stats:"));
+    _downstreamStats.push_back(QString("Codec: %1 | received %2 bytes of audio for %3 bytes of samples")
+                               .arg(codecName).arg(_stats->getAudioBytesReceived())
+                               .arg(_stats->getRawAudioBytesReceived()));
         
     AudioStreamStats downstreamStats = _stats->getMixerDownstreamStats();
     
@@ -57,9 +57,9 @@ void AnimBlendLinear::evaluateAndBlendChildren(const AnimVariantMap& animVars, T
         // this can happen if alpha is on an integer boundary
         _poses = _children[prevPoseIndex]->evaluate(animVars, dt, triggersOut);
     } else {
-        // need to eval and blend between two children.
-        auto prevPoses = _children[prevPoseIndex]->evaluate(animVars, dt, triggersOut);
-        auto nextPoses = _children[nextPoseIndex]->evaluate(animVars, dt, triggersOut);
+        // need to eval and blend between two children, each keeps its own poses so there is no need to copy them.
+        const AnimPoseVec& prevPoses = _children[prevPoseIndex]->evaluate(animVars, dt, triggersOut);
+        const AnimPoseVec& nextPoses = _children[nextPoseIndex]->evaluate(animVars, dt, triggersOut);
 
         if (prevPoses.size() > 0 && prevPoses.size() == nextPoses.size()) {
             _poses.resize(prevPoses.size());
@@ -18,7 +18,8 @@ AnimBlendLinearMove::AnimBlendLinearMove(const QString& id, float alpha, float d
     AnimNode(AnimNode::Type::BlendLinearMove, id),
     _alpha(alpha),
     _desiredSpeed(desiredSpeed),
-    _characteristicSpeeds(characteristicSpeeds) {
+    _characteristicSpeeds(characteristicSpeeds),
+    _loopTrigger(id + "Loop") {
 
 }
 
@@ -69,9 +70,9 @@ void AnimBlendLinearMove::evaluateAndBlendChildren(const AnimVariantMap& animVar
         // this can happen if alpha is on an integer boundary
         _poses = _children[prevPoseIndex]->evaluate(animVars, prevDeltaTime, triggersOut);
     } else {
-        // need to eval and blend between two children.
-        auto prevPoses = _children[prevPoseIndex]->evaluate(animVars, prevDeltaTime, triggersOut);
-        auto nextPoses = _children[nextPoseIndex]->evaluate(animVars, nextDeltaTime, triggersOut);
+        // need to eval and blend between two children, each keeps its own poses so there is no need to copy them.
+        const AnimPoseVec& prevPoses = _children[prevPoseIndex]->evaluate(animVars, prevDeltaTime, triggersOut);
+        const AnimPoseVec& nextPoses = _children[nextPoseIndex]->evaluate(animVars, nextDeltaTime, triggersOut);
 
         if (prevPoses.size() > 0 && prevPoses.size() == nextPoses.size()) {
             _poses.resize(prevPoses.size());
@@ -109,7 +110,7 @@ void AnimBlendLinearMove::setFrameAndPhase(float dt, float alpha, int prevPoseIn
 
     // detect loop trigger events
     if (_phase >= 1.0f) {
-        triggersOut.push_back(_id + "Loop");
+        triggersOut.push_back(_loopTrigger);
         _phase = glm::fract(_phase);
     }
 
@@ -64,11 +64,13 @@ protected:
 
     float _phase = 0.0f;
 
-    QString _alphaVar;
-    QString _desiredSpeedVar;
+    AnimVariantKey _alphaVar;
+    AnimVariantKey _desiredSpeedVar;
 
     std::vector<float> _characteristicSpeeds;
 
+    AnimVariantKey _loopTrigger;
+
     // no copies
     AnimBlendLinearMove(const AnimBlendLinearMove&) = delete;
     AnimBlendLinearMove& operator=(const AnimBlendLinearMove&) = delete;
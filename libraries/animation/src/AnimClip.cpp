@@ -19,7 +19,9 @@ AnimClip::AnimClip(const QString& id, const QString& url, float startFrame, floa
     _endFrame(endFrame),
     _timeScale(timeScale),
     _loopFlag(loopFlag),
-    _frame(startFrame)
+    _frame(startFrame),
+    _onLoopTrigger(id + "OnLoop"),
+    _onDoneTrigger(id + "OnDone")
 {
     loadURL(url);
 }
@@ -37,7 +39,8 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
     _loopFlag = animVars.lookup(_loopFlagVar, _loopFlag);
     float frame = animVars.lookup(_frameVar, _frame);
 
-    _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame, dt, _loopFlag, _id, triggersOut);
+    _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame, dt, _loopFlag,
+                              _onLoopTrigger, _onDoneTrigger, triggersOut);
 
     // poll network anim to see if it's finished loading yet.
     if (_networkAnim && _networkAnim->isLoaded() && _skeleton) {
@@ -61,11 +64,11 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, float dt,
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
 
-        const AnimPoseVec& prevFrame = _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _anim[nextIndex];
+        const AnimPoseBuffer& prevFrame = _anim[prevIndex];
+        const AnimPoseBuffer& nextFrame = _anim[nextIndex];
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        AnimPoseBuffer::blend(prevFrame, nextFrame, alpha, &_poses[0]);
     }
 
     return _poses;
@@ -81,7 +84,8 @@ void AnimClip::setCurrentFrameInternal(float frame) {
     // because dt is 0, we should not encounter any triggers
     const float dt = 0.0f;
     Triggers triggers;
-    _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame + _startFrame, dt, _loopFlag, _id, triggers);
+    _frame = ::accumulateTime(_startFrame, _endFrame, _timeScale, frame + _startFrame, dt, _loopFlag,
+                              _onLoopTrigger, _onDoneTrigger, triggers);
 }
 
 void AnimClip::copyFromNetworkAnim() {
@@ -105,16 +109,13 @@ void AnimClip::copyFromNetworkAnim() {
     }
 
     const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
+    _anim.reserve(frameCount);
 
     for (int frame = 0; frame < frameCount; frame++) {
 
         // init all joints in animation to default pose
         // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
-        for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
-        }
+        AnimPoseVec framePoses = _skeleton->getRelativeDefaultPoses();
 
         for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
             int skeletonJoint = jointMap[animJoint];
@@ -139,7 +140,7 @@ void AnimClip::copyFromNetworkAnim() {
                 // will be adjusted when played on a skeleton with short limbs.
                 float limbLengthScale = fabsf(glm::length(fbxZeroTrans)) <= 0.0001f ? 1.0f : (glm::length(relDefaultPose.trans) / glm::length(fbxZeroTrans));
 
-                AnimPose& pose = _anim[frame][skeletonJoint];
+                AnimPose& pose = framePoses[skeletonJoint];
                 const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
 
                 // rotation in fbxAnimationFrame is a delta from its preRotation.
@@ -151,6 +152,7 @@ void AnimClip::copyFromNetworkAnim() {
                 pose.trans = relDefaultPose.trans + limbLengthScale * (fbxTrans - fbxZeroTrans);
             }
         }
+        _anim.push_back(AnimPoseBuffer(framePoses));
     }
 
     _poses.resize(skeletonJointCount);
@@ -14,6 +14,7 @@
 #include <string>
 #include "AnimationCache.h"
 #include "AnimNode.h"
+#include "AnimPoseBuffer.h"
 
 // Playback a single animation timeline.
 // url determines the location of the fbx file to use within this clip.
@@ -60,8 +61,8 @@ protected:
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
+    // _anim[frame].getPose(joint)
+    std::vector<AnimPoseBuffer> _anim;
 
     QString _url;
     float _startFrame;
@@ -70,11 +71,14 @@ protected:
     bool _loopFlag;
     float _frame;
 
-    QString _startFrameVar;
-    QString _endFrameVar;
-    QString _timeScaleVar;
-    QString _loopFlagVar;
-    QString _frameVar;
+    AnimVariantKey _startFrameVar;
+    AnimVariantKey _endFrameVar;
+    AnimVariantKey _timeScaleVar;
+    AnimVariantKey _loopFlagVar;
+    AnimVariantKey _frameVar;
+
+    AnimVariantKey _onLoopTrigger;
+    AnimVariantKey _onDoneTrigger;
 
     // no copies
     AnimClip(const AnimClip&) = delete;
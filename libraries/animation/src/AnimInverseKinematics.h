@@ -65,9 +65,9 @@ protected:
             jointIndex(-1)
         {}
 
-        QString positionVar;
-        QString rotationVar;
-        QString typeVar;
+        AnimVariantKey positionVar;
+        AnimVariantKey rotationVar;
+        AnimVariantKey typeVar;
         QString jointName;
         int jointIndex; // cached joint index
     };
@@ -47,7 +47,7 @@ public:
     };
     using Pointer = std::shared_ptr<AnimNode>;
     using ConstPointer = std::shared_ptr<const AnimNode>;
-    using Triggers = std::vector<QString>;
+    using Triggers = std::vector<AnimVariantKey>;
 
     friend class AnimDebugDraw;
     friend void buildChildMap(std::map<QString, Pointer>& map, Pointer node);
@@ -44,6 +44,14 @@ glm::vec3 AnimPose::xformVector(const glm::vec3& rhs) const {
 }
 
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    // a uniform positive scale commutes with the rotation, so the product is the product of the parts. This is the
+    // common case when accumulating relative poses into absolute ones, and skips building and decomposing matrices.
+    const float UNIFORM_SCALE_EPSILON = 0.0001f;
+    float epsilon = UNIFORM_SCALE_EPSILON * scale.x;
+    bool isUniform = scale.x > 0.0f && fabsf(scale.y - scale.x) <= epsilon && fabsf(scale.z - scale.x) <= epsilon;
+    if (isUniform && rhs.scale.x > 0.0f && rhs.scale.y > 0.0f && rhs.scale.z > 0.0f) {
+        return AnimPose(scale.x * rhs.scale, glm::normalize(rot * rhs.rot), trans + rot * (scale.x * rhs.trans));
+    }
     return AnimPose(static_cast<glm::mat4>(*this) * static_cast<glm::mat4>(rhs));
 }
 
@@ -0,0 +1,129 @@
+//
+//  AnimPoseBuffer.cpp
+//
+//  Created by High Fidelity on 2/23/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimPoseBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "AnimUtil.h"
+
+static const int POSES_PER_BLOCK = 4;
+
+AnimPoseBuffer::AnimPoseBuffer(const AnimPoseVec& poses) :
+    _size((int)poses.size()),
+    _stride(((int)poses.size() + POSES_PER_BLOCK - 1) / POSES_PER_BLOCK * POSES_PER_BLOCK) {
+
+    // the padding holds identity poses, so that blending it stays finite
+    _data.resize(NumComponents * _stride, 0.0f);
+    std::fill_n(getComponent(ScaleX), 3 * _stride, 1.0f);
+    std::fill_n(getComponent(RotW), _stride, 1.0f);
+
+    for (int i = 0; i < _size; i++) {
+        const AnimPose& pose = poses[i];
+        for (int j = 0; j < 3; j++) {
+            getComponent(ScaleX + j)[i] = pose.scale[j];
+            getComponent(TransX + j)[i] = pose.trans[j];
+        }
+        getComponent(RotX)[i] = pose.rot.x;
+        getComponent(RotY)[i] = pose.rot.y;
+        getComponent(RotZ)[i] = pose.rot.z;
+        getComponent(RotW)[i] = pose.rot.w;
+    }
+}
+
+AnimPose AnimPoseBuffer::getPose(int index) const {
+    assert(index >= 0 && index < _size);
+    return AnimPose(glm::vec3(getComponent(ScaleX)[index], getComponent(ScaleY)[index], getComponent(ScaleZ)[index]),
+                    glm::quat(getComponent(RotW)[index], getComponent(RotX)[index],
+                              getComponent(RotY)[index], getComponent(RotZ)[index]),
+                    glm::vec3(getComponent(TransX)[index], getComponent(TransY)[index], getComponent(TransZ)[index]));
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+void AnimPoseBuffer::blend(const AnimPoseBuffer& a, const AnimPoseBuffer& b, float alpha, AnimPose* result) {
+    // the stores below write the floats of an AnimPose in the order of the components
+    static_assert(sizeof(AnimPose) == NumComponents * sizeof(float), "AnimPose is not packed");
+    assert(a.size() == b.size());
+
+    const __m128 alphas = _mm_set1_ps(alpha);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (int i = 0; i < a._size; i += POSES_PER_BLOCK) {
+
+        // take the shorter path between the rotations, by flipping b's where the dot product is negative
+        __m128 dot = zero;
+        for (int component = RotX; component <= RotW; component++) {
+            __m128 aRot = _mm_loadu_ps(a.getComponent(component) + i);
+            __m128 bRot = _mm_loadu_ps(b.getComponent(component) + i);
+            dot = _mm_add_ps(dot, _mm_mul_ps(aRot, bRot));
+        }
+        __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask);
+
+        __m128 blended[NumComponents];
+        for (int component = 0; component < NumComponents; component++) {
+            __m128 aValue = _mm_loadu_ps(a.getComponent(component) + i);
+            __m128 bValue = _mm_loadu_ps(b.getComponent(component) + i);
+            if (component >= RotX && component <= RotW) {
+                bValue = _mm_xor_ps(bValue, flip);
+            }
+            blended[component] = _mm_add_ps(aValue, _mm_mul_ps(_mm_sub_ps(bValue, aValue), alphas));
+        }
+
+        __m128 lengthSquared = zero;
+        for (int component = RotX; component <= RotW; component++) {
+            lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(blended[component], blended[component]));
+        }
+        __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+        for (int component = RotX; component <= RotW; component++) {
+            blended[component] = _mm_mul_ps(blended[component], inverseLength);
+        }
+
+        // transpose back to one pose per register: (sx sy sz rx) (ry rz rw tx) (ty tz)
+        __m128 first0 = blended[ScaleX], first1 = blended[ScaleY], first2 = blended[ScaleZ], first3 = blended[RotX];
+        _MM_TRANSPOSE4_PS(first0, first1, first2, first3);
+        __m128 second0 = blended[RotY], second1 = blended[RotZ], second2 = blended[RotW], second3 = blended[TransX];
+        _MM_TRANSPOSE4_PS(second0, second1, second2, second3);
+        __m128 third0 = blended[TransY], third1 = blended[TransZ], third2 = zero, third3 = zero;
+        _MM_TRANSPOSE4_PS(third0, third1, third2, third3);
+
+        const __m128 firsts[POSES_PER_BLOCK] = { first0, first1, first2, first3 };
+        const __m128 seconds[POSES_PER_BLOCK] = { second0, second1, second2, second3 };
+        const __m128 thirds[POSES_PER_BLOCK] = { third0, third1, third2, third3 };
+        int numPoses = std::min(POSES_PER_BLOCK, a._size - i);
+        for (int j = 0; j < numPoses; j++) {
+            float* pose = reinterpret_cast<float*>(&result[i + j]);
+            _mm_storeu_ps(pose, firsts[j]);
+            _mm_storeu_ps(pose + 4, seconds[j]);
+            _mm_storel_pi(reinterpret_cast<__m64*>(pose + 8), thirds[j]);
+        }
+    }
+}
+
+#else
+
+void AnimPoseBuffer::blend(const AnimPoseBuffer& a, const AnimPoseBuffer& b, float alpha, AnimPose* result) {
+    assert(a.size() == b.size());
+    for (int i = 0; i < a._size; i++) {
+        AnimPose aPose = a.getPose(i);
+        AnimPose bPose = b.getPose(i);
+        ::blend(1, &aPose, &bPose, alpha, &result[i]);
+    }
+}
+
+#endif
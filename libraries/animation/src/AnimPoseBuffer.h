@@ -0,0 +1,59 @@
+//
+//  AnimPoseBuffer.h
+//
+//  Created by High Fidelity on 2/23/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimPoseBuffer_h
+#define hifi_AnimPoseBuffer_h
+
+#include <vector>
+
+#include "AnimPose.h"
+
+// Poses stored as a structure of arrays: each component of the scales, rotations and translations of the joints is
+// kept in its own array, padded with identity poses to a multiple of four joints, so that blending works on four
+// joints at a time.
+//
+// AnimClip keeps its keyframes in this form. Blending writes straight out to AnimPoses, which is what the rest of the
+// graph passes around.
+class AnimPoseBuffer {
+public:
+    AnimPoseBuffer() {}
+    explicit AnimPoseBuffer(const AnimPoseVec& poses);
+
+    int size() const { return _size; }
+    AnimPose getPose(int index) const;
+
+    // result[i] = the lerp of the scales and translations and the nlerp of the rotations of a[i] and b[i], for each
+    // pose in a. a and b must be the same size.
+    static void blend(const AnimPoseBuffer& a, const AnimPoseBuffer& b, float alpha, AnimPose* result);
+
+private:
+    enum Component {
+        ScaleX = 0,
+        ScaleY,
+        ScaleZ,
+        RotX,
+        RotY,
+        RotZ,
+        RotW,
+        TransX,
+        TransY,
+        TransZ,
+        NumComponents
+    };
+
+    const float* getComponent(int component) const { return _data.data() + component * _stride; }
+    float* getComponent(int component) { return _data.data() + component * _stride; }
+
+    std::vector<float> _data; // NumComponents arrays of _stride floats
+    int _size { 0 };
+    int _stride { 0 };
+};
+
+#endif // hifi_AnimPoseBuffer_h
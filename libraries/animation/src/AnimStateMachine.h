@@ -51,7 +51,7 @@ protected:
             friend AnimStateMachine;
             Transition(const QString& var, State::Pointer state) : _var(var), _state(state) {}
         protected:
-            QString _var;
+            AnimVariantKey _var;
             State::Pointer _state;
         };
 
@@ -79,8 +79,8 @@ protected:
         float _interpTarget;  // frames
         float _interpDuration; // frames
 
-        QString _interpTargetVar;
-        QString _interpDurationVar;
+        AnimVariantKey _interpTargetVar;
+        AnimVariantKey _interpDurationVar;
 
         std::vector<Transition> _transitions;
 
@@ -123,7 +123,7 @@ protected:
     State::Pointer _currentState;
     std::vector<State::Pointer> _states;
 
-    QString _currentStateVar;
+    AnimVariantKey _currentStateVar;
 
 private:
     // no copies
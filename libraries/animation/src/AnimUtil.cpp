@@ -11,30 +11,91 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// An AnimPose is 10 floats: (sx sy sz) (rx ry rz rw) (tx ty tz). The rotation is blended from floats 3-6, the scale and
+// translation from floats 0-3 and 6-9, and the rotation is stored last, over the lanes those lerped.
+static inline void blendPose(const float* a, const float* b, __m128 alpha, float* result) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 aFirst = _mm_loadu_ps(a);
+    __m128 bFirst = _mm_loadu_ps(b);
+    __m128 aLast = _mm_loadu_ps(a + 6);
+    __m128 bLast = _mm_loadu_ps(b + 6);
+    __m128 aRot = _mm_loadu_ps(a + 3);
+    __m128 bRot = _mm_loadu_ps(b + 3);
+
+    // the dot product of the rotations, in every lane
+    __m128 dot = _mm_mul_ps(aRot, bRot);
+    dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+    dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+    bRot = _mm_xor_ps(bRot, _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), signMask));
+
+    __m128 rot = _mm_add_ps(aRot, _mm_mul_ps(_mm_sub_ps(bRot, aRot), alpha));
+    __m128 lengthSquared = _mm_mul_ps(rot, rot);
+    lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(2, 3, 0, 1)));
+    lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+    rot = _mm_div_ps(rot, _mm_sqrt_ps(lengthSquared));
+
+    _mm_storeu_ps(result, _mm_add_ps(aFirst, _mm_mul_ps(_mm_sub_ps(bFirst, aFirst), alpha)));
+    _mm_storeu_ps(result + 6, _mm_add_ps(aLast, _mm_mul_ps(_mm_sub_ps(bLast, aLast), alpha)));
+    _mm_storeu_ps(result + 3, rot);
+}
 
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    static_assert(sizeof(AnimPose) == 10 * sizeof(float), "AnimPose is not packed");
+    __m128 alphas = _mm_set1_ps(alpha);
     for (size_t i = 0; i < numPoses; i++) {
-        const AnimPose& aPose = a[i];
-        const AnimPose& bPose = b[i];
-
-        // adjust signs if necessary
-        const glm::quat& q1 = aPose.rot;
-        glm::quat q2 = bPose.rot;
-        float dot = glm::dot(q1, q2);
-        if (dot < 0.0f) {
-            q2 = -q2;
-        }
+        blendPose(reinterpret_cast<const float*>(&a[i]), reinterpret_cast<const float*>(&b[i]), alphas,
+                  reinterpret_cast<float*>(&result[i]));
+    }
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights, AnimPose* result) {
+    for (size_t i = 0; i < numPoses; i++) {
+        blendPose(reinterpret_cast<const float*>(&a[i]), reinterpret_cast<const float*>(&b[i]),
+                  _mm_set1_ps(weights[i] * alpha), reinterpret_cast<float*>(&result[i]));
+    }
+}
+
+#else
+
+static void blendPose(const AnimPose& aPose, const AnimPose& bPose, float alpha, AnimPose& result) {
+    // adjust signs if necessary
+    const glm::quat& q1 = aPose.rot;
+    glm::quat q2 = bPose.rot;
+    float dot = glm::dot(q1, q2);
+    if (dot < 0.0f) {
+        q2 = -q2;
+    }
+
+    result.scale = lerp(aPose.scale, bPose.scale, alpha);
+    result.rot = glm::normalize(glm::lerp(aPose.rot, q2, alpha));
+    result.trans = lerp(aPose.trans, bPose.trans, alpha);
+}
 
-        result[i].scale = lerp(aPose.scale, bPose.scale, alpha);
-        result[i].rot = glm::normalize(glm::lerp(aPose.rot, q2, alpha));
-        result[i].trans = lerp(aPose.trans, bPose.trans, alpha);
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    for (size_t i = 0; i < numPoses; i++) {
+        blendPose(a[i], b[i], alpha, result[i]);
     }
 }
 
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights, AnimPose* result) {
+    for (size_t i = 0; i < numPoses; i++) {
+        blendPose(a[i], b[i], weights[i] * alpha, result[i]);
+    }
+}
+
+#endif
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
-                     const QString& id, AnimNode::Triggers& triggersOut) {
+                     const AnimVariantKey& onLoopTrigger, const AnimVariantKey& onDoneTrigger,
+                     AnimNode::Triggers& triggersOut) {
 
     float frame = currentFrame;
     const float clampedStartFrame = std::min(startFrame, endFrame);
@@ -53,12 +114,12 @@ float accumulateTime(float startFrame, float endFrame, float timeScale, float cu
             if (framesRemaining >= framesTillEnd) {
                 if (loopFlag) {
                     // anim loop
-                    triggersOut.push_back(id + "OnLoop");
+                    triggersOut.push_back(onLoopTrigger);
                     framesRemaining -= framesTillEnd;
                     frame = clampedStartFrame;
                 } else {
                     // anim end
-                    triggersOut.push_back(id + "OnDone");
+                    triggersOut.push_back(onDoneTrigger);
                     frame = endFrame;
                     framesRemaining = 0.0f;
                 }
@@ -16,8 +16,12 @@
 // this is where the magic happens
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
+// blend with the alpha of each pose scaled by its weight
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, const float* weights, AnimPose* result);
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
-                     const QString& id, AnimNode::Triggers& triggersOut);
+                     const AnimVariantKey& onLoopTrigger, const AnimVariantKey& onDoneTrigger,
+                     AnimNode::Triggers& triggersOut);
 
 #endif
 
@@ -9,12 +9,86 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <QHash>
+#include <QMutex>
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
 #include <RegisteredMetaTypes.h>
 #include "AnimVariant.h" // which has AnimVariant/AnimVariantMap
 
+// Maps the names of anim vars to their slots. Names are interned while graphs are built and scripts set vars, which can
+// be on any thread, so every access locks.
+class AnimVariantKeyRegistry {
+public:
+    static AnimVariantKeyRegistry& getInstance() {
+        static AnimVariantKeyRegistry instance;
+        return instance;
+    }
+
+    int intern(const QString& name);
+    int find(const QString& name);
+    QVector<QString> getNames();
+    int getNumKeys();
+
+private:
+    QMutex _mutex;
+    QHash<QString, int> _slots;
+    QVector<QString> _names;
+};
+
+int AnimVariantKeyRegistry::intern(const QString& name) {
+    QMutexLocker locker(&_mutex);
+    auto iter = _slots.find(name);
+    if (iter != _slots.end()) {
+        return iter.value();
+    }
+    int slot = _names.size();
+    _names.append(name);
+    _slots.insert(name, slot);
+    return slot;
+}
+
+int AnimVariantKeyRegistry::find(const QString& name) {
+    QMutexLocker locker(&_mutex);
+    return _slots.value(name, -1);
+}
+
+QVector<QString> AnimVariantKeyRegistry::getNames() {
+    QMutexLocker locker(&_mutex);
+    return _names;
+}
+
+int AnimVariantKeyRegistry::getNumKeys() {
+    QMutexLocker locker(&_mutex);
+    return _names.size();
+}
+
+AnimVariantKey::AnimVariantKey(const QString& name) :
+    _slot(name.isEmpty() ? -1 : AnimVariantKeyRegistry::getInstance().intern(name)) {
+}
+
+AnimVariantKey AnimVariantKey::find(const QString& name) {
+    return AnimVariantKey(name.isEmpty() ? -1 : AnimVariantKeyRegistry::getInstance().find(name));
+}
+
+QVector<QString> AnimVariantKey::getNames() {
+    return AnimVariantKeyRegistry::getInstance().getNames();
+}
+
+int AnimVariantKey::getNumKeys() {
+    return AnimVariantKeyRegistry::getInstance().getNumKeys();
+}
+
+QString AnimVariantKey::getName() const {
+    return isValid() ? getNames().at(_slot) : QString();
+}
+
+QDebug operator<<(QDebug debug, const AnimVariantKey& key) {
+    debug << key.getName();
+    return debug;
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -49,24 +123,35 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) {
-                setOne(name, search->second);
-            } else if (_triggers.count(name) == 1) {
+            // don't intern names that were never set
+            AnimVariantKey key = AnimVariantKey::find(name);
+            const AnimVariant* value = find(key);
+            if (value) {
+                setOne(name, *value);
+            } else if (isTriggered(key)) {
                 target.setProperty(name, true);
             } // scripts are allowed to request names that do not exist
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        QVector<QString> keyNames = AnimVariantKey::getNames();
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            if (_isSet[slot]) {
+                setOne(keyNames[slot], _values[slot]);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    if (other._values.size() > _values.size()) {
+        growTo((int)other._values.size() - 1);
+    }
+    for (size_t slot = 0; slot < other._values.size(); slot++) {
+        if (other._isSet[slot]) {
+            _values[slot] = other._values[slot];
+            _isSet[slot] = true;
+        }
     }
 }
 
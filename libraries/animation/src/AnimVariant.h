@@ -11,13 +11,18 @@
 #ifndef hifi_AnimVariant_h
 #define hifi_AnimVariant_h
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <map>
 #include <set>
+#include <vector>
+#include <QDebug>
 #include <QScriptValue>
+#include <QString>
+#include <QVector>
 #include <StreamUtils.h>
 #include <GLMHelpers.h>
 #include "AnimationLogging.h"
@@ -75,102 +80,116 @@ protected:
     } _val;
 };
 
+// The name of an anim var, interned to a slot that indexes the values of every AnimVariantMap. Nodes resolve the names
+// of the vars they read when the graph is built, so that evaluating it doesn't compare or hash strings.
+// Keys are shared by all threads and are never released.
+class AnimVariantKey {
+public:
+    AnimVariantKey() {}
+    AnimVariantKey(const QString& name); // interns the name, the empty name is the invalid key
+    AnimVariantKey(const char* name) : AnimVariantKey(QString(name)) {}
+
+    // the key of an already interned name, or the invalid key
+    static AnimVariantKey find(const QString& name);
+
+    // the names of all the keys, indexed by slot
+    static QVector<QString> getNames();
+    static int getNumKeys();
+
+    bool isValid() const { return _slot != -1; }
+    int getSlot() const { return _slot; }
+    QString getName() const;
+
+    bool operator==(const AnimVariantKey& other) const { return _slot == other._slot; }
+    bool operator!=(const AnimVariantKey& other) const { return _slot != other._slot; }
+
+private:
+    explicit AnimVariantKey(int slot) : _slot(slot) {}
+
+    int _slot { -1 };
+};
+
+QDebug operator<<(QDebug debug, const AnimVariantKey& key);
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVariantKey& key, bool defaultValue) const {
         // check triggers first, then map
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        if (isTriggered(key)) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            const AnimVariant* value = find(key);
+            return value ? value->getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVariantKey& key, int defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVariantKey& key, float defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookupRaw(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getVec3() : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformPoint(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometry(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? transformPoint(_rigToGeometryMat, value->getVec3()) : defaultValue;
     }
 
-    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookupRaw(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getQuat() : defaultValue;
     }
 
-    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? _rigToGeometryRot * iter->second.getQuat() : defaultValue;
-        }
+    glm::quat lookupRigToGeometry(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? _rigToGeometryRot * value->getQuat() : defaultValue;
     }
 
-    const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+    const QString& lookup(const AnimVariantKey& key, const QString& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getString() : defaultValue;
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
+    void set(const AnimVariantKey& key, bool value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, int value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, float value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::vec3& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::quat& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const QString& value) { setVariant(key, AnimVariant(value)); }
+    void unset(const AnimVariantKey& key) {
+        if (hasKey(key)) {
+            _isSet[key.getSlot()] = false;
+            _values[key.getSlot()] = AnimVariant();
+        }
+    }
 
-    void setTrigger(const QString& key) { _triggers.insert(key); }
-    void clearTriggers() { _triggers.clear(); }
+    void setTrigger(const AnimVariantKey& key) {
+        if (key.isValid()) {
+            growTo(key.getSlot());
+            _triggers[key.getSlot()] = true;
+        }
+    }
+    void clearTriggers() { _triggers.assign(_triggers.size(), false); }
 
     void setRigToGeometryTransform(const glm::mat4& rigToGeometry) {
         _rigToGeometryMat = rigToGeometry;
         _rigToGeometryRot = glmExtractRotation(rigToGeometry);
     }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
+    void clearMap() {
+        _values.assign(_values.size(), AnimVariant());
+        _isSet.assign(_isSet.size(), false);
+    }
+    bool hasKey(const AnimVariantKey& key) const { return find(key) != nullptr; }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
     QScriptValue animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const;
@@ -181,25 +200,31 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        QVector<QString> names = AnimVariantKey::getNames();
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            if (!_isSet[slot]) {
+                continue;
+            }
+            const QString& name = names[slot];
+            const AnimVariant& value = _values[slot];
+            switch (value.getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << value.getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << value.getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << value.getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << value.getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << value.getQuat();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << value.getString();
                 break;
             default:
                 assert("AnimVariant::Type" == "valid");
@@ -209,8 +234,38 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    const AnimVariant* find(const AnimVariantKey& key) const {
+        int slot = key.getSlot();
+        return (slot >= 0 && slot < (int)_isSet.size() && _isSet[slot]) ? &_values[slot] : nullptr;
+    }
+
+    bool isTriggered(const AnimVariantKey& key) const {
+        int slot = key.getSlot();
+        return slot >= 0 && slot < (int)_triggers.size() && _triggers[slot];
+    }
+
+    void setVariant(const AnimVariantKey& key, const AnimVariant& value) {
+        if (key.isValid()) {
+            growTo(key.getSlot());
+            _values[key.getSlot()] = value;
+            _isSet[key.getSlot()] = true;
+        }
+    }
+
+    // make room for the given slot, and the keys interned so far
+    void growTo(int slot) {
+        if (slot >= (int)_values.size()) {
+            size_t size = std::max((size_t)slot + 1, (size_t)AnimVariantKey::getNumKeys());
+            _values.resize(size);
+            _isSet.resize(size, false);
+            _triggers.resize(size, false);
+        }
+    }
+
+    // indexed by key slot
+    std::vector<AnimVariant> _values;
+    std::vector<bool> _isSet;
+    std::vector<bool> _triggers;
     glm::mat4 _rigToGeometryMat;
     glm::quat _rigToGeometryRot;
 };
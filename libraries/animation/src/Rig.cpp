@@ -54,6 +54,58 @@ const glm::vec3 DEFAULT_LEFT_EYE_POS(0.3f, 0.9f, 0.0f);
 const glm::vec3 DEFAULT_HEAD_POS(0.0f, 0.75f, 0.0f);
 const glm::vec3 DEFAULT_NECK_POS(0.0f, 0.70f, 0.0f);
 
+// the anim vars the rig sets, interned once rather than on every update
+static const AnimVariantKey USER_ANIM_NONE_VAR("userAnimNone");
+static const AnimVariantKey USER_ANIM_A_VAR("userAnimA");
+static const AnimVariantKey USER_ANIM_B_VAR("userAnimB");
+static const AnimVariantKey SINE_VAR("sine");
+static const AnimVariantKey MOVE_FORWARD_SPEED_VAR("moveForwardSpeed");
+static const AnimVariantKey MOVE_FORWARD_ALPHA_VAR("moveForwardAlpha");
+static const AnimVariantKey MOVE_BACKWARD_SPEED_VAR("moveBackwardSpeed");
+static const AnimVariantKey MOVE_BACKWARD_ALPHA_VAR("moveBackwardAlpha");
+static const AnimVariantKey MOVE_LATERAL_SPEED_VAR("moveLateralSpeed");
+static const AnimVariantKey MOVE_LATERAL_ALPHA_VAR("moveLateralAlpha");
+static const AnimVariantKey IS_MOVING_FORWARD_VAR("isMovingForward");
+static const AnimVariantKey IS_MOVING_BACKWARD_VAR("isMovingBackward");
+static const AnimVariantKey IS_MOVING_RIGHT_VAR("isMovingRight");
+static const AnimVariantKey IS_MOVING_LEFT_VAR("isMovingLeft");
+static const AnimVariantKey IS_NOT_MOVING_VAR("isNotMoving");
+static const AnimVariantKey IS_TURNING_LEFT_VAR("isTurningLeft");
+static const AnimVariantKey IS_TURNING_RIGHT_VAR("isTurningRight");
+static const AnimVariantKey IS_NOT_TURNING_VAR("isNotTurning");
+static const AnimVariantKey LEAN_VAR("lean");
+static const AnimVariantKey IS_TALKING_VAR("isTalking");
+static const AnimVariantKey NOT_IS_TALKING_VAR("notIsTalking");
+static const AnimVariantKey HEAD_POSITION_VAR("headPosition");
+static const AnimVariantKey HEAD_ROTATION_VAR("headRotation");
+static const AnimVariantKey HEAD_TYPE_VAR("headType");
+static const AnimVariantKey NECK_POSITION_VAR("neckPosition");
+static const AnimVariantKey NECK_ROTATION_VAR("neckRotation");
+static const AnimVariantKey NECK_TYPE_VAR("neckType");
+static const AnimVariantKey HEAD_AND_NECK_TYPE_VAR("headAndNeckType");
+static const AnimVariantKey LEFT_HAND_POSITION_VAR("leftHandPosition");
+static const AnimVariantKey LEFT_HAND_ROTATION_VAR("leftHandRotation");
+static const AnimVariantKey LEFT_HAND_TYPE_VAR("leftHandType");
+static const AnimVariantKey RIGHT_HAND_POSITION_VAR("rightHandPosition");
+static const AnimVariantKey RIGHT_HAND_ROTATION_VAR("rightHandRotation");
+static const AnimVariantKey RIGHT_HAND_TYPE_VAR("rightHandType");
+static const AnimVariantKey IS_LEFT_HAND_IDLE_VAR("isLeftHandIdle");
+static const AnimVariantKey IS_LEFT_HAND_POINT_VAR("isLeftHandPoint");
+static const AnimVariantKey IS_LEFT_HAND_GRAB_VAR("isLeftHandGrab");
+static const AnimVariantKey LEFT_HAND_OVERLAY_ALPHA_VAR("leftHandOverlayAlpha");
+static const AnimVariantKey LEFT_HAND_GRAB_BLEND_VAR("leftHandGrabBlend");
+static const AnimVariantKey IS_RIGHT_HAND_IDLE_VAR("isRightHandIdle");
+static const AnimVariantKey IS_RIGHT_HAND_POINT_VAR("isRightHandPoint");
+static const AnimVariantKey IS_RIGHT_HAND_GRAB_VAR("isRightHandGrab");
+static const AnimVariantKey RIGHT_HAND_OVERLAY_ALPHA_VAR("rightHandOverlayAlpha");
+static const AnimVariantKey RIGHT_HAND_GRAB_BLEND_VAR("rightHandGrabBlend");
+static const AnimVariantKey LEFT_FOOT_POSITION_VAR("leftFootPosition");
+static const AnimVariantKey LEFT_FOOT_ROTATION_VAR("leftFootRotation");
+static const AnimVariantKey LEFT_FOOT_TYPE_VAR("leftFootType");
+static const AnimVariantKey RIGHT_FOOT_POSITION_VAR("rightFootPosition");
+static const AnimVariantKey RIGHT_FOOT_ROTATION_VAR("rightFootRotation");
+static const AnimVariantKey RIGHT_FOOT_TYPE_VAR("rightFootType");
+
 void Rig::overrideAnimation(const QString& url, float fps, bool loop, float firstFrame, float lastFrame) {
 
     // find an unused AnimClip clipNode
@@ -78,18 +130,18 @@ void Rig::overrideAnimation(const QString& url, float fps, bool loop, float firs
     _currentUserAnimURL = url;
 
     // notify the userAnimStateMachine the desired state.
-    _animVars.set("userAnimNone", false);
-    _animVars.set("userAnimA", _userAnimState == UserAnimState::A);
-    _animVars.set("userAnimB", _userAnimState == UserAnimState::B);
+    _animVars.set(USER_ANIM_NONE_VAR, false);
+    _animVars.set(USER_ANIM_A_VAR, _userAnimState == UserAnimState::A);
+    _animVars.set(USER_ANIM_B_VAR, _userAnimState == UserAnimState::B);
 }
 
 void Rig::restoreAnimation() {
     if (_currentUserAnimURL != "") {
         _currentUserAnimURL = "";
         // notify the userAnimStateMachine the desired state.
-        _animVars.set("userAnimNone", true);
-        _animVars.set("userAnimA", false);
-        _animVars.set("userAnimB", false);
+        _animVars.set(USER_ANIM_NONE_VAR, true);
+        _animVars.set(USER_ANIM_A_VAR, false);
+        _animVars.set(USER_ANIM_B_VAR, false);
     }
 }
 
@@ -512,7 +564,7 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
 
         // sine wave LFO var for testing.
         static float t = 0.0f;
-        _animVars.set("sine", 2.0f * static_cast<float>(0.5 * sin(t) + 0.5));
+        _animVars.set(SINE_VAR, 2.0f * static_cast<float>(0.5 * sin(t) + 0.5));
 
         float moveForwardAlpha = 0.0f;
         float moveBackwardAlpha = 0.0f;
@@ -523,14 +575,14 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
         calcAnimAlpha(-_averageForwardSpeed.getAverage(), BACKWARD_SPEEDS, &moveBackwardAlpha);
         calcAnimAlpha(fabsf(_averageLateralSpeed.getAverage()), LATERAL_SPEEDS, &moveLateralAlpha);
 
-        _animVars.set("moveForwardSpeed", _averageForwardSpeed.getAverage());
-        _animVars.set("moveForwardAlpha", moveForwardAlpha);
+        _animVars.set(MOVE_FORWARD_SPEED_VAR, _averageForwardSpeed.getAverage());
+        _animVars.set(MOVE_FORWARD_ALPHA_VAR, moveForwardAlpha);
 
-        _animVars.set("moveBackwardSpeed", -_averageForwardSpeed.getAverage());
-        _animVars.set("moveBackwardAlpha", moveBackwardAlpha);
+        _animVars.set(MOVE_BACKWARD_SPEED_VAR, -_averageForwardSpeed.getAverage());
+        _animVars.set(MOVE_BACKWARD_ALPHA_VAR, moveBackwardAlpha);
 
-        _animVars.set("moveLateralSpeed", fabsf(_averageLateralSpeed.getAverage()));
-        _animVars.set("moveLateralAlpha", moveLateralAlpha);
+        _animVars.set(MOVE_LATERAL_SPEED_VAR, fabsf(_averageLateralSpeed.getAverage()));
+        _animVars.set(MOVE_LATERAL_ALPHA_VAR, moveLateralAlpha);
 
         const float MOVE_ENTER_SPEED_THRESHOLD = 0.2f; // m/sec
         const float MOVE_EXIT_SPEED_THRESHOLD = 0.07f;  // m/sec
@@ -584,68 +636,68 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
                 if (fabsf(forwardSpeed) > 0.5f * fabsf(lateralSpeed)) {
                     if (forwardSpeed > 0.0f) {
                         // forward
-                        _animVars.set("isMovingForward", true);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, true);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
 
                     } else {
                         // backward
-                        _animVars.set("isMovingBackward", true);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, true);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     }
                 } else {
                     if (lateralSpeed > 0.0f) {
                         // right
-                        _animVars.set("isMovingRight", true);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, true);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     } else {
                         // left
-                        _animVars.set("isMovingLeft", true);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, true);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     }
                 }
-                _animVars.set("isTurningLeft", false);
-                _animVars.set("isTurningRight", false);
-                _animVars.set("isNotTurning", true);
+                _animVars.set(IS_TURNING_LEFT_VAR, false);
+                _animVars.set(IS_TURNING_RIGHT_VAR, false);
+                _animVars.set(IS_NOT_TURNING_VAR, true);
             }
         } else if (_state == RigRole::Turn) {
             if (turningSpeed > 0.0f) {
                 // turning right
-                _animVars.set("isTurningRight", true);
-                _animVars.set("isTurningLeft", false);
-                _animVars.set("isNotTurning", false);
+                _animVars.set(IS_TURNING_RIGHT_VAR, true);
+                _animVars.set(IS_TURNING_LEFT_VAR, false);
+                _animVars.set(IS_NOT_TURNING_VAR, false);
             } else {
                 // turning left
-                _animVars.set("isTurningLeft", true);
-                _animVars.set("isTurningRight", false);
-                _animVars.set("isNotTurning", false);
+                _animVars.set(IS_TURNING_LEFT_VAR, true);
+                _animVars.set(IS_TURNING_RIGHT_VAR, false);
+                _animVars.set(IS_NOT_TURNING_VAR, false);
             }
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isNotMoving", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
         } else {
             // default anim vars to notMoving and notTurning
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
         }
 
         t += deltaTime;
@@ -806,12 +858,12 @@ void Rig::updateFromHeadParameters(const HeadParameters& params, float dt) {
     if (params.enableLean) {
         updateLeanJoint(params.leanJointIndex, params.leanSideways, params.leanForward, params.torsoTwist);
     } else {
-        _animVars.unset("lean");
+        _animVars.unset(LEAN_VAR);
     }
     updateNeckJoint(params.neckJointIndex, params);
 
-    _animVars.set("isTalking", params.isTalking);
-    _animVars.set("notIsTalking", !params.isTalking);
+    _animVars.set(IS_TALKING_VAR, params.isTalking);
+    _animVars.set(NOT_IS_TALKING_VAR, !params.isTalking);
 }
 
 void Rig::updateFromEyeParameters(const EyeParameters& params) {
@@ -830,7 +882,7 @@ void Rig::updateLeanJoint(int index, float leanSideways, float leanForward, floa
         glm::quat absRot = (glm::angleAxis(-RADIANS_PER_DEGREE * leanSideways, Z_AXIS) *
                             glm::angleAxis(-RADIANS_PER_DEGREE * leanForward, X_AXIS) *
                             glm::angleAxis(RADIANS_PER_DEGREE * torsoTwist, Y_AXIS));
-        _animVars.set("lean", absRot);
+        _animVars.set(LEAN_VAR, absRot);
     }
 }
 
@@ -893,21 +945,21 @@ void Rig::updateNeckJoint(int index, const HeadParameters& params) {
             DebugDraw::getInstance().addMyAvatarMarker("neckTarget", neckPose.rot, neckPose.trans, green);
 #endif
 
-            _animVars.set("headPosition", headPos);
-            _animVars.set("headRotation", headRot);
-            _animVars.set("headType", (int)IKTarget::Type::HmdHead);
-            _animVars.set("neckPosition", neckPos);
-            _animVars.set("neckRotation", neckRot);
-            _animVars.set("neckType", (int)IKTarget::Type::Unknown); // 'Unknown' disables the target
+            _animVars.set(HEAD_POSITION_VAR, headPos);
+            _animVars.set(HEAD_ROTATION_VAR, headRot);
+            _animVars.set(HEAD_TYPE_VAR, (int)IKTarget::Type::HmdHead);
+            _animVars.set(NECK_POSITION_VAR, neckPos);
+            _animVars.set(NECK_ROTATION_VAR, neckRot);
+            _animVars.set(NECK_TYPE_VAR, (int)IKTarget::Type::Unknown); // 'Unknown' disables the target
 
         } else {
-            _animVars.unset("headPosition");
-            _animVars.set("headRotation", params.rigHeadOrientation * yFlip180);
-            _animVars.set("headAndNeckType", (int)IKTarget::Type::RotationOnly);
-            _animVars.set("headType", (int)IKTarget::Type::RotationOnly);
-            _animVars.unset("neckPosition");
-            _animVars.unset("neckRotation");
-            _animVars.set("neckType", (int)IKTarget::Type::RotationOnly);
+            _animVars.unset(HEAD_POSITION_VAR);
+            _animVars.set(HEAD_ROTATION_VAR, params.rigHeadOrientation * yFlip180);
+            _animVars.set(HEAD_AND_NECK_TYPE_VAR, (int)IKTarget::Type::RotationOnly);
+            _animVars.set(HEAD_TYPE_VAR, (int)IKTarget::Type::RotationOnly);
+            _animVars.unset(NECK_POSITION_VAR);
+            _animVars.unset(NECK_ROTATION_VAR);
+            _animVars.set(NECK_TYPE_VAR, (int)IKTarget::Type::RotationOnly);
         }
     }
 }
@@ -932,62 +984,62 @@ void Rig::updateFromHandParameters(const HandParameters& params, float dt) {
 
     if (_animSkeleton && _animNode) {
         if (params.isLeftEnabled) {
-            _animVars.set("leftHandPosition", params.leftPosition);
-            _animVars.set("leftHandRotation", params.leftOrientation);
-            _animVars.set("leftHandType", (int)IKTarget::Type::RotationAndPosition);
+            _animVars.set(LEFT_HAND_POSITION_VAR, params.leftPosition);
+            _animVars.set(LEFT_HAND_ROTATION_VAR, params.leftOrientation);
+            _animVars.set(LEFT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
         } else {
-            _animVars.unset("leftHandPosition");
-            _animVars.unset("leftHandRotation");
-            _animVars.set("leftHandType", (int)IKTarget::Type::HipsRelativeRotationAndPosition);
+            _animVars.unset(LEFT_HAND_POSITION_VAR);
+            _animVars.unset(LEFT_HAND_ROTATION_VAR);
+            _animVars.set(LEFT_HAND_TYPE_VAR, (int)IKTarget::Type::HipsRelativeRotationAndPosition);
         }
         if (params.isRightEnabled) {
-            _animVars.set("rightHandPosition", params.rightPosition);
-            _animVars.set("rightHandRotation", params.rightOrientation);
-            _animVars.set("rightHandType", (int)IKTarget::Type::RotationAndPosition);
+            _animVars.set(RIGHT_HAND_POSITION_VAR, params.rightPosition);
+            _animVars.set(RIGHT_HAND_ROTATION_VAR, params.rightOrientation);
+            _animVars.set(RIGHT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
         } else {
-            _animVars.unset("rightHandPosition");
-            _animVars.unset("rightHandRotation");
-            _animVars.set("rightHandType", (int)IKTarget::Type::HipsRelativeRotationAndPosition);
+            _animVars.unset(RIGHT_HAND_POSITION_VAR);
+            _animVars.unset(RIGHT_HAND_ROTATION_VAR);
+            _animVars.set(RIGHT_HAND_TYPE_VAR, (int)IKTarget::Type::HipsRelativeRotationAndPosition);
         }
 
         // set leftHand grab vars
-        _animVars.set("isLeftHandIdle", false);
-        _animVars.set("isLeftHandPoint", false);
-        _animVars.set("isLeftHandGrab", false);
+        _animVars.set(IS_LEFT_HAND_IDLE_VAR, false);
+        _animVars.set(IS_LEFT_HAND_POINT_VAR, false);
+        _animVars.set(IS_LEFT_HAND_GRAB_VAR, false);
 
         // Split the trigger range into three zones.
         bool rampOut = false;
         if (params.leftTrigger > 0.6666f) {
-            _animVars.set("isLeftHandGrab", true);
+            _animVars.set(IS_LEFT_HAND_GRAB_VAR, true);
         } else if (params.leftTrigger > 0.3333f) {
-            _animVars.set("isLeftHandPoint", true);
+            _animVars.set(IS_LEFT_HAND_POINT_VAR, true);
         } else {
-            _animVars.set("isLeftHandIdle", true);
+            _animVars.set(IS_LEFT_HAND_IDLE_VAR, true);
             rampOut = true;
         }
         const float OVERLAY_RAMP_OUT_SPEED = 6.0f;  // ramp in and out over 1/6th of a sec
         _leftHandOverlayAlpha = glm::clamp(_leftHandOverlayAlpha + (rampOut ? -1.0f : 1.0f) * OVERLAY_RAMP_OUT_SPEED * dt, 0.0f, 1.0f);
-        _animVars.set("leftHandOverlayAlpha", _leftHandOverlayAlpha);
-        _animVars.set("leftHandGrabBlend", params.leftTrigger);
+        _animVars.set(LEFT_HAND_OVERLAY_ALPHA_VAR, _leftHandOverlayAlpha);
+        _animVars.set(LEFT_HAND_GRAB_BLEND_VAR, params.leftTrigger);
 
         // set leftHand grab vars
-        _animVars.set("isRightHandIdle", false);
-        _animVars.set("isRightHandPoint", false);
-        _animVars.set("isRightHandGrab", false);
+        _animVars.set(IS_RIGHT_HAND_IDLE_VAR, false);
+        _animVars.set(IS_RIGHT_HAND_POINT_VAR, false);
+        _animVars.set(IS_RIGHT_HAND_GRAB_VAR, false);
 
         // Split the trigger range into three zones
         rampOut = false;
         if (params.rightTrigger > 0.6666f) {
-            _animVars.set("isRightHandGrab", true);
+            _animVars.set(IS_RIGHT_HAND_GRAB_VAR, true);
         } else if (params.rightTrigger > 0.3333f) {
-            _animVars.set("isRightHandPoint", true);
+            _animVars.set(IS_RIGHT_HAND_POINT_VAR, true);
         } else {
-            _animVars.set("isRightHandIdle", true);
+            _animVars.set(IS_RIGHT_HAND_IDLE_VAR, true);
             rampOut = true;
         }
         _rightHandOverlayAlpha = glm::clamp(_rightHandOverlayAlpha + (rampOut ? -1.0f : 1.0f) * OVERLAY_RAMP_OUT_SPEED * dt, 0.0f, 1.0f);
-        _animVars.set("rightHandOverlayAlpha", _rightHandOverlayAlpha);
-        _animVars.set("rightHandGrabBlend", params.rightTrigger);
+        _animVars.set(RIGHT_HAND_OVERLAY_ALPHA_VAR, _rightHandOverlayAlpha);
+        _animVars.set(RIGHT_HAND_GRAB_BLEND_VAR, params.rightTrigger);
     }
 }
 
@@ -1126,24 +1178,24 @@ void Rig::computeAvatarBoundingCapsule(
     AnimPose hips = geometryToRig * _animSkeleton->getAbsoluteBindPose(_animSkeleton->nameToJointIndex("Hips"));
     AnimVariantMap animVars;
     glm::quat handRotation = glm::angleAxis(PI, Vectors::UNIT_X);
-    animVars.set("leftHandPosition", hips.trans);
-    animVars.set("leftHandRotation", handRotation);
-    animVars.set("leftHandType", (int)IKTarget::Type::RotationAndPosition);
-    animVars.set("rightHandPosition", hips.trans);
-    animVars.set("rightHandRotation", handRotation);
-    animVars.set("rightHandType", (int)IKTarget::Type::RotationAndPosition);
+    animVars.set(LEFT_HAND_POSITION_VAR, hips.trans);
+    animVars.set(LEFT_HAND_ROTATION_VAR, handRotation);
+    animVars.set(LEFT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
+    animVars.set(RIGHT_HAND_POSITION_VAR, hips.trans);
+    animVars.set(RIGHT_HAND_ROTATION_VAR, handRotation);
+    animVars.set(RIGHT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
 
     int rightFootIndex = _animSkeleton->nameToJointIndex("RightFoot");
     int leftFootIndex = _animSkeleton->nameToJointIndex("LeftFoot");
     if (rightFootIndex != -1 && leftFootIndex != -1) {
         glm::vec3 foot = Vectors::ZERO;
         glm::quat footRotation = glm::angleAxis(0.5f * PI, Vectors::UNIT_X);
-        animVars.set("leftFootPosition", foot);
-        animVars.set("leftFootRotation", footRotation);
-        animVars.set("leftFootType", (int)IKTarget::Type::RotationAndPosition);
-        animVars.set("rightFootPosition", foot);
-        animVars.set("rightFootRotation", footRotation);
-        animVars.set("rightFootType", (int)IKTarget::Type::RotationAndPosition);
+        animVars.set(LEFT_FOOT_POSITION_VAR, foot);
+        animVars.set(LEFT_FOOT_ROTATION_VAR, footRotation);
+        animVars.set(LEFT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
+        animVars.set(RIGHT_FOOT_POSITION_VAR, foot);
+        animVars.set(RIGHT_FOOT_ROTATION_VAR, footRotation);
+        animVars.set(RIGHT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
     }
 
     // call overlay twice: once to verify AnimPoseVec joints and again to do the IK
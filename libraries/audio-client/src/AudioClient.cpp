@@ -42,7 +42,9 @@
 #include <Transform.h>
 
 #include "AudioInjector.h"
+#include "AudioCodec.h"
 #include "AudioConstants.h"
+#include "AudioMixKernels.h"
 #include "PositionalAudioStream.h"
 #include "AudioClientLogging.h"
 
@@ -61,6 +63,7 @@ Setting::Handle<int> windowSecondsForDesiredCalcOnTooManyStarves("windowSecondsF
 Setting::Handle<int> windowSecondsForDesiredReduction("windowSecondsForDesiredReduction",
                                                       DEFAULT_WINDOW_SECONDS_FOR_DESIRED_REDUCTION);
 Setting::Handle<bool> repetitionWithFade("repetitionWithFade", DEFAULT_REPETITION_WITH_FADE);
+Setting::Handle<QString> audioCodec("audioCodec", "ima_adpcm");
 
 AudioClient::AudioClient() :
     AbstractAudioInterface(),
@@ -78,6 +81,7 @@ AudioClient::AudioClient() :
     _inputRingBuffer(0),
     _receivedAudioStream(0, RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES, InboundAudioStream::Settings()),
     _isStereoInput(false),
+    _codecType(AudioCodec::IMA_ADPCM),
     _outputStarveDetectionStartTimeMsec(0),
     _outputStarveDetectionCount(0),
     _outputBufferSizeFrames("audioOutputBufferSize", DEFAULT_AUDIO_OUTPUT_BUFFER_SIZE_FRAMES),
@@ -348,10 +352,8 @@ bool sampleChannelConversion(const int16_t* sourceSamples, int16_t* destinationS
         return true;
     } else if (sourceAudioFormat.channelCount() == 1 && destinationAudioFormat.channelCount() == 2) {
 
-        // loop through the mono input audio and repeat each sample twice
-        for (uint i = 0; i < numSourceSamples; ++i) {
-            destinationSamples[i * 2] = destinationSamples[(i * 2) + 1] = sourceSamples[i];
-        }
+        // repeat each mono input sample into both output channels
+        AudioMixKernels::panMonoToStereo(sourceSamples, destinationSamples, numSourceSamples, 1.0f, 1.0f);
 
         return true;
     }
@@ -806,8 +808,9 @@ void AudioClient::handleAudioInput() {
         audioTransform.setTranslation(_positionGetter());
         audioTransform.setRotation(_orientationGetter());
         // FIXME find a way to properly handle both playback audio and user audio concurrently
-        emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber, audioTransform, packetType);
-        _stats.sentPacket();
+        int audioBytes = emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber,
+                                         audioTransform, packetType, _codecType);
+        _stats.sentPacket(audioBytes, audioBytes > 0 ? numNetworkBytes : 0);
     }
 }
 
@@ -816,7 +819,8 @@ void AudioClient::handleRecordedAudioInput(const QByteArray& audio) {
     audioTransform.setTranslation(_positionGetter());
     audioTransform.setRotation(_orientationGetter());
     // FIXME check a flag to see if we should echo audio?
-    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform, PacketType::MicrophoneAudioWithEcho);
+    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform,
+                    PacketType::MicrophoneAudioWithEcho, _codecType);
 }
 
 void AudioClient::processReceivedSamples(const QByteArray& inputBuffer, QByteArray& outputBuffer) {
@@ -1231,6 +1235,7 @@ void AudioClient::loadSettings() {
                                                                         windowSecondsForDesiredCalcOnTooManyStarves.get());
     _receivedAudioStream.setWindowSecondsForDesiredReduction(windowSecondsForDesiredReduction.get());
     _receivedAudioStream.setRepetitionWithFade(repetitionWithFade.get());
+    _codecType = AudioCodec::getTypeForName(audioCodec.get());
 }
 
 void AudioClient::saveSettings() {
@@ -1242,4 +1247,5 @@ void AudioClient::saveSettings() {
                                                     getWindowSecondsForDesiredCalcOnTooManyStarves());
     windowSecondsForDesiredReduction.set(_receivedAudioStream.getWindowSecondsForDesiredReduction());
     repetitionWithFade.set(_receivedAudioStream.getRepetitionWithFade());
+    audioCodec.set(AudioCodec::getCodec(_codecType)->getName());
 }
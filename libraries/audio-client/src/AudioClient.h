@@ -122,6 +122,10 @@ public:
 
     int getOutputBufferSize() { return _outputBufferSizeFrames.get(); }
 
+    /// the codec our audio is sent in, from the audioCodec setting - the audio mixer sends our mix back in the same
+    /// codec
+    AudioCodec::Type getCodecType() const { return _codecType; }
+
     bool getOutputStarveDetectionEnabled() { return _outputStarveDetectionEnabled.get(); }
     void setOutputStarveDetectionEnabled(bool enabled) { _outputStarveDetectionEnabled.set(enabled); }
 
@@ -232,6 +236,7 @@ private:
     AudioRingBuffer _inputRingBuffer;
     MixedProcessedAudioStream _receivedAudioStream;
     bool _isStereoInput;
+    AudioCodec::Type _codecType;
 
     QString _inputAudioDeviceName;
     QString _outputAudioDeviceName;
@@ -29,7 +29,9 @@ AudioIOStats::AudioIOStats(MixedProcessedAudioStream* receivedAudioStream) :
     _inputRingBufferMsecsAvailableStats(1, FRAMES_AVAILABLE_STATS_WINDOW_SECONDS),
     _audioOutputMsecsUnplayedStats(1, FRAMES_AVAILABLE_STATS_WINDOW_SECONDS),
     _lastSentAudioPacket(0),
-    _packetSentTimeGaps(1, APPROXIMATELY_30_SECONDS_OF_AUDIO_PACKETS)
+    _packetSentTimeGaps(1, APPROXIMATELY_30_SECONDS_OF_AUDIO_PACKETS),
+    _audioBytesSent(0),
+    _rawAudioBytesSent(0)
 {
 
 }
@@ -49,9 +51,23 @@ void AudioIOStats::reset() {
 
     _audioOutputMsecsUnplayedStats.reset();
     _packetSentTimeGaps.reset();
+
+    _audioBytesSent = 0;
+    _rawAudioBytesSent = 0;
+}
+
+quint64 AudioIOStats::getAudioBytesReceived() const {
+    return _receivedAudioStream->getEncodedBytesReceived();
 }
 
-void AudioIOStats::sentPacket() {
+quint64 AudioIOStats::getRawAudioBytesReceived() const {
+    return _receivedAudioStream->getDecodedBytesReceived();
+}
+
+void AudioIOStats::sentPacket(int audioBytes, int rawAudioBytes) {
+    _audioBytesSent += audioBytes;
+    _rawAudioBytesSent += rawAudioBytes;
+
     // first time this is 0
     if (_lastSentAudioPacket == 0) {
         _lastSentAudioPacket = usecTimestampNow();
@@ -30,7 +30,7 @@ public:
     void reset();
     
     void updateInputMsecsRead(float msecsRead) { _audioInputMsecsReadStats.update(msecsRead); }
-    void sentPacket();
+    void sentPacket(int audioBytes, int rawAudioBytes);
     
     AudioStreamStats getMixerDownstreamStats() const;
     const AudioStreamStats& getMixerAvatarStreamStats() const {  return _mixerAvatarStreamStats; }
@@ -41,6 +41,12 @@ public:
     const MovingMinMaxAvg<float>& getAudioOutputMsecsUnplayedStats() const { return _audioOutputMsecsUnplayedStats; }
     
     const MovingMinMaxAvg<quint64>& getPacketSentTimeGaps() const { return _packetSentTimeGaps; }
+
+    // bandwidth of the audio codec, the bytes on the wire against the bytes of the raw samples
+    quint64 getAudioBytesSent() const { return _audioBytesSent; }
+    quint64 getRawAudioBytesSent() const { return _rawAudioBytesSent; }
+    quint64 getAudioBytesReceived() const;
+    quint64 getRawAudioBytesReceived() const;
     
     void sendDownstreamAudioStatsPacket();
 
@@ -60,6 +66,9 @@ private:
     
     quint64 _lastSentAudioPacket;
     MovingMinMaxAvg<quint64> _packetSentTimeGaps;
+
+    quint64 _audioBytesSent;
+    quint64 _rawAudioBytesSent;
 };
 
 #endif // hifi_AudioIOStats_h
@@ -19,15 +19,25 @@
 
 #include "AudioConstants.h"
 
-void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType) {
+int AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber,
+                                            const Transform& transform, PacketType packetType, AudioCodec::Type codecType) {
     static std::mutex _mutex;
     using Locker = std::unique_lock<std::mutex>;
     auto nodeList = DependencyManager::get<NodeList>();
     SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    int audioBytes = 0;
     if (audioMixer && audioMixer->getActiveSocket()) {
         Locker lock(_mutex);
         static std::unique_ptr<NLPacket> audioPacket = NLPacket::create(PacketType::Unknown);
         quint8 isStereo = bytes == AudioConstants::NETWORK_FRAME_BYTES_STEREO ? 1 : 0;
+        int numChannels = isStereo ? 2 : 1;
+        int numFrames = (int)(bytes / (sizeof(int16_t) * numChannels));
+
+        // the codec we want the mixed audio in, which is also the codec of the audio we send
+        // unless it can't encode this frame - then the audio falls back to PCM
+        const AudioCodec* codec = AudioCodec::getCodec(codecType);
+        const AudioCodec* audioCodec = codec->canEncode(numFrames) ? codec : AudioCodec::getCodec(AudioCodec::PCM);
+
         audioPacket->setType(packetType);
         // reset the audio packet so we can start writing
         audioPacket->reset();
@@ -39,9 +49,11 @@ void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes
                 AudioConstants::NETWORK_FRAME_SAMPLES_STEREO :
                 AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
             audioPacket->writePrimitive(numSilentSamples);
+            audioPacket->writePrimitive((quint8)codec->getType());
         } else {
             // set the mono/stereo byte
             audioPacket->writePrimitive(isStereo);
+            audioPacket->writePrimitive((quint8)audioCodec->getType());
         }
 
         // pack the three float positions
@@ -50,12 +62,15 @@ void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes
         audioPacket->writePrimitive(transform.getRotation());
 
         if (audioPacket->getType() != PacketType::SilentAudioFrame) {
-            // audio samples have already been packed (written to networkAudioSamples)
-            audioPacket->setPayloadSize(audioPacket->getPayloadSize() + bytes);
-            static const int leadingBytes = sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(quint8);
-            memcpy(audioPacket->getPayload() + leadingBytes, audioData, bytes);
+            // encode the audio samples straight into the packet
+            qint64 leadingBytes = audioPacket->getPayloadSize();
+            audioBytes = audioCodec->getEncodedBytes(numFrames, numChannels);
+            audioPacket->setPayloadSize(leadingBytes + audioBytes);
+            audioCodec->encode(reinterpret_cast<const int16_t*>(audioData), numFrames, numChannels,
+                               audioPacket->getPayload() + leadingBytes);
         }
         nodeList->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendAudioPacket);
         nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
     }
+    return audioBytes;
 }
@@ -17,6 +17,7 @@
 
 #include <udt/PacketHeaders.h>
 
+#include "AudioCodec.h"
 #include "AudioInjectorOptions.h"
 
 class AudioInjector;
@@ -28,7 +29,9 @@ class AbstractAudioInterface : public QObject {
 public:
     AbstractAudioInterface(QObject* parent = 0) : QObject(parent) {};
     
-    static void emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType);
+    /// sends a frame of audio to the audio mixer, returns the number of bytes of (encoded) audio that were sent
+    static int emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform,
+                               PacketType packetType, AudioCodec::Type codecType = AudioCodec::PCM);
 
 public slots:
     virtual bool outputLocalInjector(bool isStereo, AudioInjector* injector) = 0;
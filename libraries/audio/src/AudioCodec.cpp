@@ -0,0 +1,222 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Created by High Fidelity on 1/20/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "AudioCodec.h"
+
+static const PCMAudioCodec PCM_CODEC;
+static const IMAADPCMAudioCodec IMA_ADPCM_CODEC;
+
+const AudioCodec* AudioCodec::getCodec(uint8_t type) {
+    switch (type) {
+        case PCM:
+            return &PCM_CODEC;
+        case IMA_ADPCM:
+            return &IMA_ADPCM_CODEC;
+        default:
+            return nullptr;
+    }
+}
+
+AudioCodec::Type AudioCodec::getTypeForName(const QString& name) {
+    for (uint8_t type = 0; type < NUM_TYPES; ++type) {
+        if (name == getCodec(type)->getName()) {
+            return (Type)type;
+        }
+    }
+    return PCM;
+}
+
+int PCMAudioCodec::getEncodedBytes(int numFrames, int numChannels) const {
+    return numFrames * numChannels * sizeof(int16_t);
+}
+
+int PCMAudioCodec::getDecodedSamples(int numEncodedBytes, int numChannels) const {
+    return numEncodedBytes / sizeof(int16_t);
+}
+
+int PCMAudioCodec::encode(const int16_t* samples, int numFrames, int numChannels, char* encoded) const {
+    int numBytes = getEncodedBytes(numFrames, numChannels);
+    memcpy(encoded, samples, numBytes);
+    return numBytes;
+}
+
+int PCMAudioCodec::decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const {
+    int numSamples = getDecodedSamples(numEncodedBytes, numChannels);
+    memcpy(samples, encoded, numSamples * sizeof(int16_t));
+    return numSamples;
+}
+
+// the standard IMA-ADPCM tables
+static const int ADPCM_STEP_TABLE_SIZE = 89;
+
+static const int16_t ADPCM_STEP_TABLE[ADPCM_STEP_TABLE_SIZE] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+    5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767
+};
+
+static const int ADPCM_INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// the state shared by the encoder and the decoder, updating it from the same nibble keeps both in lock step
+struct ADPCMChannelState {
+    int predictor;
+    int stepIndex;
+
+    void update(int nibble) {
+        int step = ADPCM_STEP_TABLE[stepIndex];
+
+        int delta = step >> 3;
+        if (nibble & 4) {
+            delta += step;
+        }
+        if (nibble & 2) {
+            delta += step >> 1;
+        }
+        if (nibble & 1) {
+            delta += step >> 2;
+        }
+
+        predictor += (nibble & 8) ? -delta : delta;
+        predictor = std::min(std::max(predictor, (int)std::numeric_limits<int16_t>::min()),
+                             (int)std::numeric_limits<int16_t>::max());
+
+        stepIndex = std::min(std::max(stepIndex + ADPCM_INDEX_TABLE[nibble], 0), ADPCM_STEP_TABLE_SIZE - 1);
+    }
+
+    int encode(int sample) {
+        int step = ADPCM_STEP_TABLE[stepIndex];
+        int difference = sample - predictor;
+
+        int nibble = 0;
+        if (difference < 0) {
+            nibble = 8;
+            difference = -difference;
+        }
+        if (difference >= step) {
+            nibble |= 4;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 2;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 1;
+        }
+
+        update(nibble);
+        return nibble;
+    }
+};
+
+// since every block starts from scratch, start with the step that fits the average change between samples,
+// rather than ramping up from the smallest step and smearing the start of every packet
+static int initialStepIndex(const int16_t* samples, int numFrames, int numChannels) {
+    int sumDifferences = 0;
+    for (int i = 1; i < numFrames; ++i) {
+        sumDifferences += abs(samples[i * numChannels] - samples[(i - 1) * numChannels]);
+    }
+    int averageDifference = (numFrames > 1) ? sumDifferences / (numFrames - 1) : 0;
+
+    int stepIndex = 0;
+    while (stepIndex < ADPCM_STEP_TABLE_SIZE - 1 && ADPCM_STEP_TABLE[stepIndex] < averageDifference) {
+        ++stepIndex;
+    }
+    return stepIndex;
+}
+
+int IMAADPCMAudioCodec::getEncodedBytes(int numFrames, int numChannels) const {
+    return numChannels * (BLOCK_HEADER_BYTES + numFrames / 2);
+}
+
+int IMAADPCMAudioCodec::getDecodedSamples(int numEncodedBytes, int numChannels) const {
+    int blockBytes = numEncodedBytes / numChannels;
+    if (blockBytes < BLOCK_HEADER_BYTES) {
+        return 0;
+    }
+    return numChannels * (blockBytes - BLOCK_HEADER_BYTES) * 2;
+}
+
+int IMAADPCMAudioCodec::encode(const int16_t* samples, int numFrames, int numChannels, char* encoded) const {
+    assert(canEncode(numFrames));
+
+    uint8_t* output = reinterpret_cast<uint8_t*>(encoded);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const int16_t* channelSamples = samples + channel;
+
+        ADPCMChannelState state;
+        state.predictor = channelSamples[0];
+        state.stepIndex = initialStepIndex(channelSamples, numFrames, numChannels);
+
+        // block header: initial predictor, initial step index and a reserved byte
+        int16_t predictor = (int16_t)state.predictor;
+        memcpy(output, &predictor, sizeof(int16_t));
+        output[2] = (uint8_t)state.stepIndex;
+        output[3] = 0;
+        output += BLOCK_HEADER_BYTES;
+
+        for (int i = 0; i < numFrames; i += 2) {
+            int lowNibble = state.encode(channelSamples[i * numChannels]);
+            int highNibble = state.encode(channelSamples[(i + 1) * numChannels]);
+            *output++ = (uint8_t)(lowNibble | (highNibble << 4));
+        }
+    }
+
+    return getEncodedBytes(numFrames, numChannels);
+}
+
+int IMAADPCMAudioCodec::decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const {
+    int numSamples = getDecodedSamples(numEncodedBytes, numChannels);
+    int numFrames = numSamples / numChannels;
+    int blockBytes = numEncodedBytes / numChannels;
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(encoded);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const uint8_t* block = input + channel * blockBytes;
+        int16_t* channelSamples = samples + channel;
+
+        int16_t predictor;
+        memcpy(&predictor, block, sizeof(int16_t));
+
+        ADPCMChannelState state;
+        state.predictor = predictor;
+        state.stepIndex = std::min((int)block[2], ADPCM_STEP_TABLE_SIZE - 1);
+
+        const uint8_t* nibbles = block + BLOCK_HEADER_BYTES;
+        for (int i = 0; i < numFrames; i += 2) {
+            uint8_t byte = *nibbles++;
+
+            state.update(byte & 0x0F);
+            channelSamples[i * numChannels] = (int16_t)state.predictor;
+
+            state.update(byte >> 4);
+            channelSamples[(i + 1) * numChannels] = (int16_t)state.predictor;
+        }
+    }
+
+    return numSamples;
+}
@@ -0,0 +1,95 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Created by High Fidelity on 1/20/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <stdint.h>
+
+#include <QtCore/QString>
+
+/// Encoder and decoder for the audio carried by MicrophoneAudio, MixedAudio and SilentAudioFrame packets.
+///
+/// Every one of those packets carries the codec type in a single byte. For audio packets it is the codec of the
+/// payload, and for both audio and silent packets sent by a client it is also the codec the client asks the mixer to
+/// use for the mix sent back to it.
+///
+/// Codecs are stateless - each packet can be decoded on its own, so a lost packet never corrupts the next one, and a
+/// single codec instance can be shared by every stream and every mix thread.
+class AudioCodec {
+public:
+    enum Type : uint8_t {
+        PCM = 0,
+        IMA_ADPCM,
+        NUM_TYPES
+    };
+
+    virtual ~AudioCodec() {}
+
+    /// returns the codec for a type, or nullptr if the type is not one that this build knows about
+    static const AudioCodec* getCodec(uint8_t type);
+
+    /// returns the codec type with the given name, or PCM if no codec has that name
+    static Type getTypeForName(const QString& name);
+
+    virtual Type getType() const = 0;
+    virtual const char* getName() const = 0;
+
+    /// whether a frame of numFrames can be encoded, if not the sender should fall back to PCM
+    virtual bool canEncode(int numFrames) const { return true; }
+
+    /// the number of bytes encode will write for numFrames of numChannels interleaved samples
+    virtual int getEncodedBytes(int numFrames, int numChannels) const = 0;
+
+    /// the number of samples (for all channels) decode will write for numEncodedBytes
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const = 0;
+
+    /// encodes numFrames of numChannels interleaved samples, returns the number of bytes written to encoded
+    virtual int encode(const int16_t* samples, int numFrames, int numChannels, char* encoded) const = 0;
+
+    /// decodes numEncodedBytes into interleaved samples, returns the number of samples written
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const = 0;
+};
+
+/// the fallback codec, raw 16 bit samples
+class PCMAudioCodec : public AudioCodec {
+public:
+    virtual Type getType() const override { return PCM; }
+    virtual const char* getName() const override { return "pcm"; }
+
+    virtual int getEncodedBytes(int numFrames, int numChannels) const override;
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const override;
+
+    virtual int encode(const int16_t* samples, int numFrames, int numChannels, char* encoded) const override;
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const override;
+};
+
+/// IMA-ADPCM, 4 bits per sample with no lookahead, so it adds no latency.
+/// Each channel is coded as its own block: a header with the initial predictor and step index, followed by
+/// one nibble per sample (low nibble first). A stereo network frame shrinks from 1024 to 264 bytes.
+class IMAADPCMAudioCodec : public AudioCodec {
+public:
+    static const int BLOCK_HEADER_BYTES = 4;
+
+    virtual Type getType() const override { return IMA_ADPCM; }
+    virtual const char* getName() const override { return "ima_adpcm"; }
+
+    // two samples are packed in every byte of a block
+    virtual bool canEncode(int numFrames) const override { return numFrames % 2 == 0; }
+
+    virtual int getEncodedBytes(int numFrames, int numChannels) const override;
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const override;
+
+    virtual int encode(const int16_t* samples, int numFrames, int numChannels, char* encoded) const override;
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const override;
+};
+
+#endif // hifi_AudioCodec_h
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "AudioMixKernels.h"
+
 #include "AudioInjectorLocalBuffer.h"
 
 AudioInjectorLocalBuffer::AudioInjectorLocalBuffer(const QByteArray& rawAudioArray, QObject* parent) :
@@ -41,11 +43,7 @@ void copy(char* to, char* from, int size, qreal factor) {
     int16_t* fromArray = (int16_t*) from;
     int sampleSize = size / sizeof(int16_t);
     
-    for (int i = 0; i < sampleSize; i++) {
-        *toArray = factor * (*fromArray);
-        toArray++;
-        fromArray++;
-    }
+    AudioMixKernels::applyGain(fromArray, toArray, sampleSize, (float)factor);
 }
 
 qint64 AudioInjectorLocalBuffer::readData(char* data, qint64 maxSize) {
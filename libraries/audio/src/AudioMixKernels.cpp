@@ -0,0 +1,353 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Created by High Fidelity on 1/14/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AudioConstants.h"
+
+#include "AudioMixKernels.h"
+
+namespace AudioMixKernels {
+
+//
+// scalar kernels, also used for the samples left over at the end of a buffer by the SIMD kernels
+//
+static inline int16_t saturate(int32_t sample) {
+    return (int16_t)std::min(std::max(sample, AudioConstants::MIN_SAMPLE_VALUE), AudioConstants::MAX_SAMPLE_VALUE);
+}
+
+static inline int16_t scale(int16_t sample, float gain) {
+    float scaled = std::min(std::max((float)sample * gain, (float)AudioConstants::MIN_SAMPLE_VALUE),
+                            (float)AudioConstants::MAX_SAMPLE_VALUE);
+    return (int16_t)scaled;
+}
+
+template<bool ACCUMULATE>
+static inline void store(int16_t& output, int16_t sample) {
+    output = ACCUMULATE ? saturate((int32_t)output + sample) : sample;
+}
+
+template<bool ACCUMULATE>
+static void gainScalar(const int16_t* input, int16_t* output, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; i++) {
+        store<ACCUMULATE>(output[i], scale(input[i], gain));
+    }
+}
+
+template<bool ACCUMULATE>
+static void monoToStereoScalar(const int16_t* input, int16_t* output, int numFrames,
+                               float gainLeft, float gainRight, int delayLeft, int delayRight) {
+    const int16_t* inputLeft = input - delayLeft;
+    const int16_t* inputRight = input - delayRight;
+
+    for (int i = 0; i < numFrames; i++) {
+        store<ACCUMULATE>(output[2 * i], scale(inputLeft[i], gainLeft));
+        store<ACCUMULATE>(output[2 * i + 1], scale(inputRight[i], gainRight));
+    }
+}
+
+static void addScalar(const int16_t* input, int16_t* output, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        output[i] = saturate((int32_t)output[i] + input[i]);
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#define AUDIO_MIX_KERNELS_X86
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+static bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // the OS must save the YMM registers for us to use them
+    __cpuid(info, 1);
+    const int OSXSAVE_BIT = 1 << 27;
+    const int AVX_BIT = 1 << 28;
+    if ((info[2] & OSXSAVE_BIT) == 0 || (info[2] & AVX_BIT) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    const int AVX2_BIT = 1 << 5;
+    return (info[1] & AVX2_BIT) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// sign extend the low and high four int16 of a vector to int32
+static inline __m128i unpackLo16(__m128i samples) {
+    return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+
+static inline __m128i unpackHi16(__m128i samples) {
+    return _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+}
+
+static inline __m128i scale4(__m128i samples, __m128 gain) {
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(samples), gain));
+}
+
+template<bool ACCUMULATE>
+static inline void store8(int16_t* output, __m128i samples) {
+    if (ACCUMULATE) {
+        samples = _mm_adds_epi16(samples, _mm_loadu_si128((const __m128i*)output));
+    }
+    _mm_storeu_si128((__m128i*)output, samples);
+}
+
+template<bool ACCUMULATE>
+static void gainSSE2(const int16_t* input, int16_t* output, int numSamples, float gain) {
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        __m128i lo = scale4(unpackLo16(s), g);
+        __m128i hi = scale4(unpackHi16(s), g);
+
+        store8<ACCUMULATE>(&output[i], _mm_packs_epi32(lo, hi));
+    }
+
+    gainScalar<ACCUMULATE>(input + i, output + i, numSamples - i, gain);
+}
+
+template<bool ACCUMULATE>
+static void monoToStereoSSE2(const int16_t* input, int16_t* output, int numFrames,
+                             float gainLeft, float gainRight, int delayLeft, int delayRight) {
+    const int16_t* inputLeft = input - delayLeft;
+    const int16_t* inputRight = input - delayRight;
+    __m128 gl = _mm_set1_ps(gainLeft);
+    __m128 gr = _mm_set1_ps(gainRight);
+
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m128i l = _mm_loadu_si128((const __m128i*)&inputLeft[i]);
+        __m128i r = _mm_loadu_si128((const __m128i*)&inputRight[i]);
+
+        __m128i l0 = scale4(unpackLo16(l), gl);
+        __m128i l1 = scale4(unpackHi16(l), gl);
+        __m128i r0 = scale4(unpackLo16(r), gr);
+        __m128i r1 = scale4(unpackHi16(r), gr);
+
+        // interleave to L0 R0 L1 R1 ...
+        store8<ACCUMULATE>(&output[2 * i], _mm_packs_epi32(_mm_unpacklo_epi32(l0, r0), _mm_unpackhi_epi32(l0, r0)));
+        store8<ACCUMULATE>(&output[2 * i + 8], _mm_packs_epi32(_mm_unpacklo_epi32(l1, r1), _mm_unpackhi_epi32(l1, r1)));
+    }
+
+    monoToStereoScalar<ACCUMULATE>(input + i, output + 2 * i, numFrames - i, gainLeft, gainRight, delayLeft, delayRight);
+}
+
+static void addSSE2(const int16_t* input, int16_t* output, int numSamples) {
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        store8<true>(&output[i], _mm_loadu_si128((const __m128i*)&input[i]));
+    }
+
+    addScalar(input + i, output + i, numSamples - i);
+}
+
+AVX2_TARGET static inline __m256i scale8(__m128i samples, __m256 gain) {
+    return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples)), gain));
+}
+
+template<bool ACCUMULATE>
+AVX2_TARGET static inline void store16(int16_t* output, __m256i samples) {
+    if (ACCUMULATE) {
+        samples = _mm256_adds_epi16(samples, _mm256_loadu_si256((const __m256i*)output));
+    }
+    _mm256_storeu_si256((__m256i*)output, samples);
+}
+
+template<bool ACCUMULATE>
+AVX2_TARGET static void gainAVX2(const int16_t* input, int16_t* output, int numSamples, float gain) {
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256i a = scale8(_mm_loadu_si128((const __m128i*)&input[i]), g);
+        __m256i b = scale8(_mm_loadu_si128((const __m128i*)&input[i + 8]), g);
+
+        // packs works per 128-bit lane, put the quadwords back in order
+        store16<ACCUMULATE>(&output[i], _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8));
+    }
+
+    gainSSE2<ACCUMULATE>(input + i, output + i, numSamples - i, gain);
+}
+
+template<bool ACCUMULATE>
+AVX2_TARGET static void monoToStereoAVX2(const int16_t* input, int16_t* output, int numFrames,
+                                         float gainLeft, float gainRight, int delayLeft, int delayRight) {
+    const int16_t* inputLeft = input - delayLeft;
+    const int16_t* inputRight = input - delayRight;
+    __m256 gl = _mm256_set1_ps(gainLeft);
+    __m256 gr = _mm256_set1_ps(gainRight);
+
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m256i l = scale8(_mm_loadu_si128((const __m128i*)&inputLeft[i]), gl);
+        __m256i r = scale8(_mm_loadu_si128((const __m128i*)&inputRight[i]), gr);
+
+        // unpack and pack both work per 128-bit lane, which leaves the frames in order
+        store16<ACCUMULATE>(&output[2 * i], _mm256_packs_epi32(_mm256_unpacklo_epi32(l, r), _mm256_unpackhi_epi32(l, r)));
+    }
+
+    monoToStereoScalar<ACCUMULATE>(input + i, output + 2 * i, numFrames - i, gainLeft, gainRight, delayLeft, delayRight);
+}
+
+AVX2_TARGET static void addAVX2(const int16_t* input, int16_t* output, int numSamples) {
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        store16<true>(&output[i], _mm256_loadu_si256((const __m256i*)&input[i]));
+    }
+
+    addSSE2(input + i, output + i, numSamples - i);
+}
+
+#endif
+
+InstructionSet getBestInstructionSet() {
+#ifdef AUDIO_MIX_KERNELS_X86
+    static const InstructionSet best = cpuSupportsAVX2() ? AVX2 : SSE2;
+    return best;
+#else
+    return Scalar;
+#endif
+}
+
+static InstructionSet _instructionSet = getBestInstructionSet();
+
+InstructionSet getInstructionSet() {
+    return _instructionSet;
+}
+
+bool setInstructionSet(InstructionSet instructionSet) {
+    if (instructionSet > getBestInstructionSet()) {
+        return false;
+    }
+    _instructionSet = instructionSet;
+    return true;
+}
+
+const char* getInstructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case AVX2:
+            return "AVX2";
+        case SSE2:
+            return "SSE2";
+        default:
+            return "Scalar";
+    }
+}
+
+void applyGain(const int16_t* input, int16_t* output, int numSamples, float gain) {
+    switch (_instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            gainAVX2<false>(input, output, numSamples, gain);
+            break;
+        case SSE2:
+            gainSSE2<false>(input, output, numSamples, gain);
+            break;
+#endif
+        default:
+            gainScalar<false>(input, output, numSamples, gain);
+            break;
+    }
+}
+
+void addWithGain(const int16_t* input, int16_t* output, int numSamples, float gain) {
+    switch (_instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            gainAVX2<true>(input, output, numSamples, gain);
+            break;
+        case SSE2:
+            gainSSE2<true>(input, output, numSamples, gain);
+            break;
+#endif
+        default:
+            gainScalar<true>(input, output, numSamples, gain);
+            break;
+    }
+}
+
+void panMonoToStereo(const int16_t* input, int16_t* output, int numFrames,
+                     float gainLeft, float gainRight, int delayLeft, int delayRight) {
+    switch (_instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            monoToStereoAVX2<false>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+        case SSE2:
+            monoToStereoSSE2<false>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+#endif
+        default:
+            monoToStereoScalar<false>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+    }
+}
+
+void addMonoToStereo(const int16_t* input, int16_t* output, int numFrames,
+                     float gainLeft, float gainRight, int delayLeft, int delayRight) {
+    switch (_instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            monoToStereoAVX2<true>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+        case SSE2:
+            monoToStereoSSE2<true>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+#endif
+        default:
+            monoToStereoScalar<true>(input, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+            break;
+    }
+}
+
+void addSaturating(const int16_t* input, int16_t* output, int numSamples) {
+    switch (_instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            addAVX2(input, output, numSamples);
+            break;
+        case SSE2:
+            addSSE2(input, output, numSamples);
+            break;
+#endif
+        default:
+            addScalar(input, output, numSamples);
+            break;
+    }
+}
+
+}
@@ -0,0 +1,62 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Created by High Fidelity on 1/14/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+// Vectorized kernels for mixing int16 network frames.
+//
+// Every kernel converts samples to float, scales them, truncates back towards zero and saturates to int16,
+// so the results match the scalar sample-by-sample mixing code they replace (except that they clip instead of wrap).
+// On x86 SSE2 is assumed to be present, AVX2 is used when the CPU supports it. Other architectures use scalar code.
+namespace AudioMixKernels {
+
+    enum InstructionSet {
+        Scalar = 0,
+        SSE2,
+        AVX2
+    };
+
+    /// the best instruction set supported by this CPU, this is what the kernels use unless told otherwise
+    InstructionSet getBestInstructionSet();
+
+    InstructionSet getInstructionSet();
+
+    /// forces the kernels to a given instruction set (e.g. for testing against the scalar path)
+    /// returns false and leaves the current instruction set untouched if the CPU does not support it
+    bool setInstructionSet(InstructionSet instructionSet);
+
+    const char* getInstructionSetName(InstructionSet instructionSet);
+
+    /// output[i] = input[i] * gain
+    /// input and output may be the same buffer
+    void applyGain(const int16_t* input, int16_t* output, int numSamples, float gain);
+
+    /// output[i] += input[i] * gain
+    void addWithGain(const int16_t* input, int16_t* output, int numSamples, float gain);
+
+    /// converts numFrames of mono input to interleaved stereo output with a gain and a delay (in samples) per channel:
+    /// output[2 * i] = input[i - delayLeft] * gainLeft, output[2 * i + 1] = input[i - delayRight] * gainRight
+    /// the caller must make sure the max(delayLeft, delayRight) samples before input are valid history
+    void panMonoToStereo(const int16_t* input, int16_t* output, int numFrames,
+                         float gainLeft, float gainRight, int delayLeft = 0, int delayRight = 0);
+
+    /// same as panMonoToStereo, but the result is added to output
+    void addMonoToStereo(const int16_t* input, int16_t* output, int numFrames,
+                         float gainLeft, float gainRight, int delayLeft = 0, int delayRight = 0);
+
+    /// output[i] += input[i]
+    void addSaturating(const int16_t* input, int16_t* output, int numSamples);
+}
+
+#endif // hifi_AudioMixKernels_h
@@ -12,6 +12,8 @@
 #ifndef hifi_AudioRingBuffer_h
 #define hifi_AudioRingBuffer_h
 
+#include <string.h>
+
 #include "AudioConstants.h"
 
 #include <QtCore/QIODevice>
@@ -141,11 +143,13 @@ public:
         }
 
         void readSamples(int16_t* dest, int numSamples) {
-            int16_t* at = _at;
-            for (int i = 0; i < numSamples; i++) {
-                *dest = *at;
-                ++dest;
-                at = (at == _bufferLast) ? _bufferFirst : at + 1;
+            // copy up to the end of the buffer, then whatever is left from the front of it
+            int samplesToEnd = (int)(_bufferLast - _at) + 1;
+            if (numSamples <= samplesToEnd) {
+                memcpy(dest, _at, numSamples * sizeof(int16_t));
+            } else {
+                memcpy(dest, _at, samplesToEnd * sizeof(int16_t));
+                memcpy(dest + samplesToEnd, _bufferFirst, (numSamples - samplesToEnd) * sizeof(int16_t));
             }
         }
 
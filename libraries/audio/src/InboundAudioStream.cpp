@@ -14,6 +14,7 @@
 #include <NLPacket.h>
 #include <Node.h>
 
+#include "AudioLogging.h"
 #include "InboundAudioStream.h"
 
 const int STARVE_HISTORY_CAPACITY = 50;
@@ -47,7 +48,11 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
-    _hasReverb(false)
+    _hasReverb(false),
+    _codec(AudioCodec::getCodec(AudioCodec::PCM)),
+    _numCodecChannels(1),
+    _encodedBytesReceived(0),
+    _decodedBytesReceived(0)
 {
 }
 
@@ -77,6 +82,8 @@ void InboundAudioStream::resetStats() {
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
+    _encodedBytesReceived = 0;
+    _decodedBytesReceived = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
@@ -165,20 +172,68 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
 }
 
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
+    // mixed audio is always stereo
+    const int MIXED_AUDIO_CHANNELS = 2;
+
     if (type == PacketType::SilentAudioFrame) {
         quint16 numSilentSamples = 0;
         memcpy(&numSilentSamples, packetAfterSeqNum.constData(), sizeof(quint16));
         numAudioSamples = numSilentSamples;
-        return sizeof(quint16);
+        return sizeof(quint16) + parseCodec(packetAfterSeqNum, sizeof(quint16), MIXED_AUDIO_CHANNELS);
     } else {
-        // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
-        return 0;
+        // mixed audio packets only have the codec between the seq num and the audio data.
+        int readBytes = parseCodec(packetAfterSeqNum, 0, MIXED_AUDIO_CHANNELS);
+        numAudioSamples = getNumDecodedSamples(packetAfterSeqNum.size() - readBytes);
+        return readBytes;
     }
 }
 
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int numAudioSamples) {
-    return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
+    QByteArray decodedSamples = decodeAudioData(packetAfterStreamProperties);
+    return _ringBuffer.writeData(decodedSamples.constData(), std::min(decodedSamples.size(),
+                                                                      (int)(numAudioSamples * sizeof(int16_t))));
+}
+
+int InboundAudioStream::parseCodec(const QByteArray& packetAfterSeqNum, int offset, int numChannels) {
+    if (offset >= packetAfterSeqNum.size()) {
+        return 0;
+    }
+
+    quint8 codecType = packetAfterSeqNum.at(offset);
+    const AudioCodec* codec = AudioCodec::getCodec(codecType);
+    if (!codec && _codec) {
+        qCDebug(audio) << "Received audio with an unknown codec" << codecType << "- it will be treated as silence.";
+    }
+
+    _codec = codec;
+    _numCodecChannels = numChannels;
+
+    return sizeof(quint8);
+}
+
+int InboundAudioStream::getNumDecodedSamples(int numEncodedBytes) const {
+    return _codec ? _codec->getDecodedSamples(numEncodedBytes, _numCodecChannels) : 0;
+}
+
+QByteArray InboundAudioStream::decodeAudioData(const QByteArray& packetAfterStreamProperties) {
+    if (!_codec) {
+        return QByteArray();
+    }
+
+    _encodedBytesReceived += packetAfterStreamProperties.size();
+
+    if (_codec->getType() == AudioCodec::PCM) {
+        _decodedBytesReceived += packetAfterStreamProperties.size();
+        return packetAfterStreamProperties;
+    }
+
+    int numSamples = getNumDecodedSamples(packetAfterStreamProperties.size());
+    _decodedSamples.resize(numSamples * sizeof(int16_t));
+    _codec->decode(packetAfterStreamProperties.constData(), packetAfterStreamProperties.size(), _numCodecChannels,
+                   reinterpret_cast<int16_t*>(_decodedSamples.data()));
+
+    _decodedBytesReceived += _decodedSamples.size();
+    return _decodedSamples;
 }
 
 int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
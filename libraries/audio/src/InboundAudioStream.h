@@ -18,6 +18,7 @@
 #include <ReceivedMessage.h>
 #include <StDev.h>
 
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -165,6 +166,13 @@ public:
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
+
+    /// the codec of the last audio packet, or nullptr if it used a codec this build does not know
+    const AudioCodec* getCodec() const { return _codec; }
+
+    /// bandwidth stats - the audio bytes received as they came over the wire, and once decoded
+    quint64 getEncodedBytesReceived() const { return _encodedBytesReceived; }
+    quint64 getDecodedBytesReceived() const { return _decodedBytesReceived; }
     
     bool hasReverb() const { return _hasReverb; }
     float getRevebTime() const { return _reverbTime; }
@@ -207,6 +215,15 @@ protected:
     /// writes the last written frame repeatedly, gradually fading to silence.
     /// used for writing samples for dropped packets.
     virtual int writeLastFrameRepeatedWithFade(int samples);
+
+    /// reads the codec byte at offset in the packet, returns the number of bytes read
+    int parseCodec(const QByteArray& packetAfterSeqNum, int offset, int numChannels);
+
+    /// the number of samples the audio data of a packet decodes to with the current codec
+    int getNumDecodedSamples(int numEncodedBytes) const;
+
+    /// decodes the audio data of a packet to raw samples - for PCM this is the packet data itself
+    QByteArray decodeAudioData(const QByteArray& packetAfterStreamProperties);
     
 protected:
 
@@ -265,6 +282,13 @@ protected:
     bool _hasReverb;
     float _reverbTime;
     float _wetLevel;
+
+    const AudioCodec* _codec;
+    int _numCodecChannels;
+    QByteArray _decodedSamples;
+
+    quint64 _encodedBytesReceived;
+    quint64 _decodedBytesReceived;
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
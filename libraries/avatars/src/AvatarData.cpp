@@ -149,7 +149,7 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
     _handPosition = glm::inverse(getOrientation()) * (handPosition - getPosition());
 }
 
-QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
+QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll, bool sendJoints) {
     // TODO: DRY this up to a shared method
     // that can pack any type given the number of bytes
     // and return the number of bytes to push the pointer
@@ -263,7 +263,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
 
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].rotation != data.rotation) {
+        if (sendJoints && (sendAll || _lastSentJointData[i].rotation != data.rotation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 fabsf(glm::dot(data.rotation, _lastSentJointData[i].rotation)) <= AVATAR_MIN_ROTATION_DOT) {
@@ -311,7 +311,7 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     float maxTranslationDimension = 0.0;
     for (int i=0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].translation != data.translation) {
+        if (sendJoints && (sendAll || _lastSentJointData[i].translation != data.translation)) {
             if (sendAll ||
                 !cullSmallChanges ||
                 glm::distance(data.translation, _lastSentJointData[i].translation) > AVATAR_MIN_TRANSLATION) {
@@ -182,7 +182,8 @@ public:
     glm::vec3 getHandPosition() const;
     void setHandPosition(const glm::vec3& handPosition);
 
-    virtual QByteArray toByteArray(bool cullSmallChanges, bool sendAll);
+    /// \param sendJoints false to leave out every joint, the result then only moves and poses the body of the avatar
+    virtual QByteArray toByteArray(bool cullSmallChanges, bool sendAll, bool sendJoints = true);
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
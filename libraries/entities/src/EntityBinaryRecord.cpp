@@ -0,0 +1,91 @@
+//
+//  EntityBinaryRecord.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QJsonDocument>
+#include <QtEndian>
+#include <QtScript/QScriptEngine>
+
+#include <OctreePacketData.h>
+#include <VariantMapToScriptValue.h>
+
+#include "EntityBinaryRecord.h"
+
+const int CREATED_TIME_BYTES = sizeof(quint64);
+
+QByteArray EntityBinaryRecord::encode(const EntityItemID& entityID, const EntityItemProperties& properties,
+                                      QScriptEngine& scriptEngine) {
+    // the edit packet encoding only includes the properties that changed
+    EntityItemProperties allProperties = properties;
+    allProperties.markAllChanged();
+
+    QByteArray buffer(MAX_OCTREE_UNCOMRESSED_PACKET_SIZE, 0);
+    if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entityID, allProperties, buffer)) {
+        quint64 created = qToLittleEndian(properties.getCreated());
+
+        QByteArray record;
+        record.reserve(1 + CREATED_TIME_BYTES + buffer.size());
+        record.append((char)EditPacket);
+        record.append(reinterpret_cast<const char*>(&created), CREATED_TIME_BYTES);
+        record.append(buffer);
+        return record;
+    }
+
+    // too big for an edit packet, this is rare enough that it can take the slow path
+    QVariant entityVariant = EntityItemPropertiesToScriptValue(&scriptEngine, properties).toVariant();
+    QByteArray record;
+    record.append((char)JSON);
+    record.append(QJsonDocument::fromVariant(entityVariant).toJson(QJsonDocument::Compact));
+    return record;
+}
+
+bool EntityBinaryRecord::decode(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties,
+                                bool wholeRecord) {
+    if (record.size() <= 1 + CREATED_TIME_BYTES || (quint8)record[0] != EditPacket) {
+        return false;
+    }
+
+    quint64 created;
+    memcpy(&created, record.constData() + 1, CREATED_TIME_BYTES);
+
+    const unsigned char* editData = reinterpret_cast<const unsigned char*>(record.constData()) + 1 + CREATED_TIME_BYTES;
+    int editSize = record.size() - 1 - CREATED_TIME_BYTES;
+    int processedBytes = 0;
+    if (!EntityItemProperties::decodeEntityEditPacket(editData, editSize, processedBytes, entityID, properties)) {
+        return false;
+    }
+    if (wholeRecord && processedBytes != editSize) {
+        return false;
+    }
+
+    properties.setCreated(qFromLittleEndian(created));
+    return true;
+}
+
+bool EntityBinaryRecord::decodeJSON(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties,
+                                    QScriptEngine& scriptEngine) {
+    if (!isJSON(record)) {
+        return false;
+    }
+
+    QJsonDocument document = QJsonDocument::fromJson(record.mid(1));
+    if (!document.isObject()) {
+        return false;
+    }
+
+    // the same path as EntityTree::readFromMap
+    QVariantMap entityMap = document.toVariant().toMap();
+    QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+    EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+    entityID = EntityItemID(QUuid(entityMap["id"].toString()));
+    return true;
+}
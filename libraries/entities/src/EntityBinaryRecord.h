@@ -0,0 +1,47 @@
+//
+//  EntityBinaryRecord.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBinaryRecord_h
+#define hifi_EntityBinaryRecord_h
+
+#include <QByteArray>
+
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+class QScriptEngine;
+
+/// One entity of a binary snapshot (see OctreeBinarySnapshot). Entities are stored with the property encoding of
+/// entity edit packets, plus the created time that edit packets leave out. The few entities whose properties do not
+/// fit in an edit packet are stored as JSON instead.
+class EntityBinaryRecord {
+public:
+    enum Encoding : quint8 {
+        EditPacket = 0,
+        JSON = 1
+    };
+
+    static QByteArray encode(const EntityItemID& entityID, const EntityItemProperties& properties,
+                             QScriptEngine& scriptEngine);
+
+    static bool isJSON(const QByteArray& record) { return !record.isEmpty() && (quint8)record[0] == JSON; }
+
+    /// decodes an edit packet record, it does not need a script engine so it can be called from any thread. With
+    /// wholeRecord set, a record that decodes without reaching its end is rejected - a check on records written by
+    /// an older version, whose encoding of a property may since have changed.
+    static bool decode(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties,
+                       bool wholeRecord = false);
+
+    static bool decodeJSON(const QByteArray& record, EntityItemID& entityID, EntityItemProperties& properties,
+                           QScriptEngine& scriptEngine);
+};
+
+#endif // hifi_EntityBinaryRecord_h
@@ -0,0 +1,75 @@
+//
+//  EntityEncodeCache.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 1/29/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityItem.h"
+
+#include "EntityEncodeCache.h"
+
+EntityEncodeCache::Version EntityEncodeCache::versionOf(const EntityItem& entity) {
+    return { entity.getLastEdited(), entity.getLastUpdated(), entity.getLastSimulated(), entity.getLastChangedOnServer() };
+}
+
+bool EntityEncodeCache::find(const EntityItemID& entityID, const Version& version, QByteArray& encoded) const {
+    {
+        QReadLocker locker(&_lock);
+        auto it = _entries.constFind(entityID);
+        if (it != _entries.constEnd() && it->version == version) {
+            encoded = it->encoded;
+            locker.unlock();
+
+            ++_hits;
+            _bytesReused += encoded.size();
+            return true;
+        }
+    }
+    ++_misses;
+    return false;
+}
+
+void EntityEncodeCache::insert(const EntityItemID& entityID, const Version& version, const QByteArray& encoded) {
+    QWriteLocker locker(&_lock);
+    Entry& entry = _entries[entityID];
+    _bytesCached -= entry.encoded.size();
+    entry.version = version;
+    entry.encoded = encoded;
+    _bytesCached += entry.encoded.size();
+}
+
+void EntityEncodeCache::remove(const EntityItemID& entityID) {
+    QWriteLocker locker(&_lock);
+    auto it = _entries.find(entityID);
+    if (it != _entries.end()) {
+        _bytesCached -= it->encoded.size();
+        _entries.erase(it);
+    }
+}
+
+void EntityEncodeCache::clear() {
+    QWriteLocker locker(&_lock);
+    _entries.clear();
+    _bytesCached = 0;
+}
+
+float EntityEncodeCache::getHitRatio() const {
+    quint64 lookups = _hits + _misses;
+    return (lookups > 0) ? (float)_hits / (float)lookups : 0.0f;
+}
+
+void EntityEncodeCache::resetStats() {
+    _hits = 0;
+    _misses = 0;
+    _bytesReused = 0;
+}
+
+int EntityEncodeCache::getNumEntries() const {
+    QReadLocker locker(&_lock);
+    return _entries.size();
+}
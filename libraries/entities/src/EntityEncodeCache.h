@@ -0,0 +1,79 @@
+//
+//  EntityEncodeCache.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 1/29/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCache_h
+#define hifi_EntityEncodeCache_h
+
+#include <atomic>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include "EntityItemID.h"
+
+class EntityItem;
+
+/// The full encoding of each entity as it was last written into an entity packet by the entity server.
+/// An entity with all of its properties encodes to the same bytes no matter which client it is sent to, so the
+/// send threads of every client viewing that entity can share one encode. Entries are versioned by the timestamps
+/// that the entity bumps whenever it changes, a stale entry is simply encoded again.
+class EntityEncodeCache {
+public:
+    struct Version {
+        quint64 lastEdited;
+        quint64 lastUpdated;
+        quint64 lastSimulated;
+        quint64 lastChangedOnServer;
+
+        bool operator==(const Version& other) const {
+            return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated &&
+                lastSimulated == other.lastSimulated && lastChangedOnServer == other.lastChangedOnServer;
+        }
+    };
+
+    static Version versionOf(const EntityItem& entity);
+
+    /// looks up the encoding of the entity at the given version, counting a hit or a miss
+    bool find(const EntityItemID& entityID, const Version& version, QByteArray& encoded) const;
+
+    /// remembers the encoding of the entity at the given version, replacing any older one
+    void insert(const EntityItemID& entityID, const Version& version, const QByteArray& encoded);
+
+    void remove(const EntityItemID& entityID);
+    void clear();
+
+    // stats since the last resetStats, which the entity server's stats page does on [RESET]
+    quint64 getHits() const { return _hits; }
+    quint64 getMisses() const { return _misses; }
+    quint64 getBytesReused() const { return _bytesReused; }
+    float getHitRatio() const;
+    void resetStats();
+
+    int getNumEntries() const;
+    quint64 getBytesCached() const { return _bytesCached; }
+
+private:
+    struct Entry {
+        Version version;
+        QByteArray encoded;
+    };
+
+    mutable QReadWriteLock _lock;
+    QHash<EntityItemID, Entry> _entries;
+
+    mutable std::atomic<quint64> _hits { 0 };
+    mutable std::atomic<quint64> _misses { 0 };
+    mutable std::atomic<quint64> _bytesReused { 0 };
+    std::atomic<quint64> _bytesCached { 0 };
+};
+
+#endif // hifi_EntityEncodeCache_h
@@ -0,0 +1,104 @@
+//
+//  EntityQueryBatch.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/13/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "EntityTree.h"
+
+#include "EntityQueryBatch.h"
+
+// a thread claims this many queries at a time, so that threads don't fight over the next query
+const int QUERIES_PER_CLAIM = 16;
+
+int EntityQueryBatch::addRay(const glm::vec3& origin, const glm::vec3& direction, bool precisionPicking,
+                             const QVector<EntityItemID>& entityIdsToInclude) {
+    _rays.push_back({ origin, direction, precisionPicking, entityIdsToInclude });
+    return (int)_rays.size() - 1;
+}
+
+int EntityQueryBatch::addSphere(const glm::vec3& center, float radius) {
+    _spheres.push_back({ center, radius });
+    return (int)_spheres.size() - 1;
+}
+
+int EntityQueryBatch::addBox(const AABox& box) {
+    _boxes.push_back(box);
+    return (int)_boxes.size() - 1;
+}
+
+void EntityQueryBatch::prepare() {
+    _rayResults.assign(_rays.size(), RayResult());
+    _sphereResults.assign(_spheres.size(), QVector<EntityItemPointer>());
+    _boxResults.assign(_boxes.size(), QVector<EntityItemPointer>());
+
+    // precision picking tests the triangles of models, which fill their caches on the first pick and can't be
+    // picked from several threads at once, so those rays stay on the thread that runs the batch
+    _sharedQueries.clear();
+    _callerQueries.clear();
+    int numQueries = getNumQueries();
+    for (int query = 0; query < numQueries; ++query) {
+        if (query < getNumRays() && _rays[query].precisionPicking) {
+            _callerQueries.push_back(query);
+        } else {
+            _sharedQueries.push_back(query);
+        }
+    }
+
+    _nextSharedQuery = 0;
+    // no earlier run leaves permits behind, but a batch may be run again
+    _sharedQueriesDone.tryAcquire(_sharedQueriesDone.available());
+}
+
+void EntityQueryBatch::runQuery(EntityTree& tree, int query) {
+    if (query < getNumRays()) {
+        const Ray& ray = _rays[query];
+        RayResult& result = _rayResults[query];
+        OctreeElementPointer element;
+        void* intersectedEntity = nullptr;
+        result.intersects = tree.findRayIntersectionWorker(ray.origin, ray.direction, element, result.distance,
+                                                           result.face, result.surfaceNormal, ray.entityIdsToInclude,
+                                                           &intersectedEntity, ray.precisionPicking);
+
+        // the tree is still locked, so take what the results need from the entity before it can go away
+        if (result.intersects && intersectedEntity) {
+            result.entity = static_cast<EntityItem*>(intersectedEntity)->getThisPointer();
+            result.entityID = result.entity->getEntityItemID();
+            result.properties = result.entity->getProperties();
+        } else {
+            result.intersects = false;
+        }
+        return;
+    }
+
+    query -= getNumRays();
+    if (query < getNumSpheres()) {
+        tree.findEntities(_spheres[query].center, _spheres[query].radius, _sphereResults[query]);
+        return;
+    }
+
+    query -= getNumSpheres();
+    tree.findEntities(_boxes[query], _boxResults[query]);
+}
+
+void EntityQueryBatch::runSharedQueries(EntityTree& tree) {
+    int numSharedQueries = (int)_sharedQueries.size();
+    while (true) {
+        int first = _nextSharedQuery.fetch_add(QUERIES_PER_CLAIM);
+        if (first >= numSharedQueries) {
+            return;
+        }
+        int last = std::min(first + QUERIES_PER_CLAIM, numSharedQueries);
+        for (int i = first; i < last; ++i) {
+            runQuery(tree, _sharedQueries[i]);
+        }
+        _sharedQueriesDone.release(last - first);
+    }
+}
@@ -0,0 +1,115 @@
+//
+//  EntityQueryBatch.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/13/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryBatch_h
+#define hifi_EntityQueryBatch_h
+
+#include <atomic>
+#include <float.h>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QSemaphore>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <BoxBase.h>
+
+#include "EntityItem.h"
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+class EntityQueryBatch;
+using EntityQueryBatchPointer = std::shared_ptr<EntityQueryBatch>;
+
+/// Many spatial queries for EntityTree::runQueryBatch() or EntityTree::startQueryBatch() to answer at once. Add the
+/// queries, run the batch, then read the results, which are in the same order as the queries of each kind.
+class EntityQueryBatch {
+public:
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        bool precisionPicking;
+        QVector<EntityItemID> entityIdsToInclude;
+    };
+
+    struct RayResult {
+        bool intersects { false };
+        float distance { FLT_MAX };
+        BoxFace face { UNKNOWN_FACE };
+        glm::vec3 surfaceNormal;
+
+        // read while the tree was locked, the entity may since have been deleted or changed
+        EntityItemPointer entity;
+        EntityItemID entityID;
+        EntityItemProperties properties;
+    };
+
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+    };
+
+    /// \return the index of the query's result
+    int addRay(const glm::vec3& origin, const glm::vec3& direction, bool precisionPicking = false,
+               const QVector<EntityItemID>& entityIdsToInclude = QVector<EntityItemID>());
+    int addSphere(const glm::vec3& center, float radius);
+    int addBox(const AABox& box);
+
+    int getNumRays() const { return (int)_rays.size(); }
+    int getNumSpheres() const { return (int)_spheres.size(); }
+    int getNumBoxes() const { return (int)_boxes.size(); }
+    int getNumQueries() const { return getNumRays() + getNumSpheres() + getNumBoxes(); }
+
+    const Ray& getRay(int index) const { return _rays[index]; }
+
+    // the closest entity each ray intersects
+    const RayResult& getRayResult(int index) const { return _rayResults[index]; }
+
+    // the entities that touch each sphere
+    const QVector<EntityItemPointer>& getSphereResult(int index) const { return _sphereResults[index]; }
+
+    // the entities that touch each box
+    const QVector<EntityItemPointer>& getBoxResult(int index) const { return _boxResults[index]; }
+
+    quint64 getUsecsRunning() const { return _usecsRunning; }
+
+private:
+    friend class EntityTree;
+
+    // makes room for the results and deals the queries out before a run
+    void prepare();
+
+    // queries are numbered rays first, then spheres, then boxes
+    void runQuery(EntityTree& tree, int query);
+
+    // claims shared queries and runs them until there are none left, from any number of threads at once
+    void runSharedQueries(EntityTree& tree);
+
+    std::vector<Ray> _rays;
+    std::vector<Sphere> _spheres;
+    std::vector<AABox> _boxes;
+
+    std::vector<RayResult> _rayResults;
+    std::vector<QVector<EntityItemPointer>> _sphereResults;
+    std::vector<QVector<EntityItemPointer>> _boxResults;
+
+    std::vector<int> _sharedQueries; // can run on any thread
+    std::vector<int> _callerQueries; // must run on the thread that runs the batch
+    std::atomic<int> _nextSharedQuery { 0 };
+    QSemaphore _sharedQueriesDone;
+
+    quint64 _usecsRunning { 0 };
+};
+
+#endif // hifi_EntityQueryBatch_h
@@ -388,6 +388,108 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+void EntityScriptingInterface::findRayIntersections(const QScriptValue& pickRays, QScriptValue callback,
+                                                    bool precisionPicking, const QScriptValue& entityIdsToInclude) {
+    QVector<EntityItemID> entities = qVectorEntityItemIDFromScriptValue(entityIdsToInclude);
+    auto batch = std::make_shared<EntityQueryBatch>();
+    int length = pickRays.property("length").toInt32();
+    for (int i = 0; i < length; i++) {
+        PickRay ray;
+        pickRayFromScriptValue(pickRays.property(i), ray);
+        batch->addRay(ray.origin, ray.direction, precisionPicking, entities);
+    }
+
+    startQueryBatch(batch, callback, [batch](QScriptEngine* engine) {
+        QScriptValue results = engine->newArray(batch->getNumRays());
+        for (int i = 0; i < batch->getNumRays(); i++) {
+            const EntityQueryBatch::Ray& ray = batch->getRay(i);
+            const EntityQueryBatch::RayResult& rayResult = batch->getRayResult(i);
+            RayToEntityIntersectionResult result; // always accurate, the batch waits for the tree lock
+            if (rayResult.intersects) {
+                result.intersects = true;
+                result.entityID = rayResult.entityID;
+                result.properties = rayResult.properties;
+                result.distance = rayResult.distance;
+                result.face = rayResult.face;
+                result.surfaceNormal = rayResult.surfaceNormal;
+                result.intersection = ray.origin + (ray.direction * rayResult.distance);
+            }
+            results.setProperty(i, RayToEntityIntersectionResultToScriptValue(engine, result));
+        }
+        return results;
+    });
+}
+
+static QScriptValue entityListsToScriptValue(QScriptEngine* engine, int numLists,
+                                             std::function<const QVector<EntityItemPointer>&(int)> getList) {
+    QScriptValue lists = engine->newArray(numLists);
+    for (int i = 0; i < numLists; i++) {
+        const QVector<EntityItemPointer>& entities = getList(i);
+        QScriptValue list = engine->newArray(entities.size());
+        for (int j = 0; j < entities.size(); j++) {
+            list.setProperty(j, EntityItemIDtoScriptValue(engine, entities[j]->getEntityItemID()));
+        }
+        lists.setProperty(i, list);
+    }
+    return lists;
+}
+
+void EntityScriptingInterface::findEntitiesInSpheres(const QScriptValue& spheres, QScriptValue callback) {
+    auto batch = std::make_shared<EntityQueryBatch>();
+    int length = spheres.property("length").toInt32();
+    for (int i = 0; i < length; i++) {
+        QScriptValue sphere = spheres.property(i);
+        glm::vec3 center;
+        vec3FromScriptValue(sphere.property("center"), center);
+        batch->addSphere(center, (float)sphere.property("radius").toNumber());
+    }
+
+    startQueryBatch(batch, callback, [batch](QScriptEngine* engine) {
+        return entityListsToScriptValue(engine, batch->getNumSpheres(), [&](int i) -> const QVector<EntityItemPointer>& {
+            return batch->getSphereResult(i);
+        });
+    });
+}
+
+void EntityScriptingInterface::findEntitiesInBoxes(const QScriptValue& boxes, QScriptValue callback) {
+    auto batch = std::make_shared<EntityQueryBatch>();
+    int length = boxes.property("length").toInt32();
+    for (int i = 0; i < length; i++) {
+        QScriptValue box = boxes.property(i);
+        glm::vec3 corner;
+        glm::vec3 dimensions;
+        vec3FromScriptValue(box.property("corner"), corner);
+        vec3FromScriptValue(box.property("dimensions"), dimensions);
+        batch->addBox(AABox(corner, dimensions));
+    }
+
+    startQueryBatch(batch, callback, [batch](QScriptEngine* engine) {
+        return entityListsToScriptValue(engine, batch->getNumBoxes(), [&](int i) -> const QVector<EntityItemPointer>& {
+            return batch->getBoxResult(i);
+        });
+    });
+}
+
+void EntityScriptingInterface::startQueryBatch(EntityQueryBatchPointer batch, QScriptValue callback,
+                                               std::function<QScriptValue(QScriptEngine*)> resultsToScriptValue) {
+    if (!_entityTree || !callback.isFunction()) {
+        return;
+    }
+
+    // the reply is made on the script's thread, so the finished signal the query thread emits is delivered there
+    auto reply = new EntityQueryBatchReply();
+    connect(reply, &EntityQueryBatchReply::finished, reply, [reply, callback, resultsToScriptValue]() mutable {
+        QScriptValueList args;
+        args << resultsToScriptValue(callback.engine());
+        callback.call(QScriptValue(), args);
+        reply->deleteLater();
+    });
+
+    _entityTree->startQueryBatch(batch, [reply] {
+        emit reply->finished();
+    });
+}
+
 void EntityScriptingInterface::setLightsArePickable(bool value) {
     LightEntityItem::setLightsArePickable(value);
 }
@@ -53,6 +53,13 @@ Q_DECLARE_METATYPE(RayToEntityIntersectionResult)
 QScriptValue RayToEntityIntersectionResultToScriptValue(QScriptEngine* engine, const RayToEntityIntersectionResult& results);
 void RayToEntityIntersectionResultFromScriptValue(const QScriptValue& object, RayToEntityIntersectionResult& results);
 
+/// lives on the thread of the script that started a query batch, and tells it when the batch is done
+class EntityQueryBatchReply : public QObject {
+    Q_OBJECT
+signals:
+    void finished();
+};
+
 
 /// handles scripting of Entity commands from JS passed to assigned clients
 class EntityScriptingInterface : public OctreeScriptingInterface, public Dependency  {
@@ -118,6 +125,19 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue());
 
+    /// Finds the ray intersection of each of an array of pick rays on the entity query threads, without blocking.
+    /// Calls back with an array of results in the order of the rays, which all saw the entities at the same time.
+    Q_INVOKABLE void findRayIntersections(const QScriptValue& pickRays, QScriptValue callback, bool precisionPicking = false,
+                                          const QScriptValue& entityIdsToInclude = QScriptValue());
+
+    /// Finds the entities in each of an array of { center, radius } spheres on the entity query threads, without
+    /// blocking. Calls back with an array of arrays of entity IDs in the order of the spheres.
+    Q_INVOKABLE void findEntitiesInSpheres(const QScriptValue& spheres, QScriptValue callback);
+
+    /// Finds the entities in each of an array of { corner, dimensions } boxes on the entity query threads, without
+    /// blocking. Calls back with an array of arrays of entity IDs in the order of the boxes.
+    Q_INVOKABLE void findEntitiesInBoxes(const QScriptValue& boxes, QScriptValue callback);
+
     Q_INVOKABLE void setLightsArePickable(bool value);
     Q_INVOKABLE bool getLightsArePickable() const;
 
@@ -191,6 +211,10 @@ private:
     RayToEntityIntersectionResult findRayIntersectionWorker(const PickRay& ray, Octree::lockType lockType,
                                                             bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude);
 
+    /// starts the batch, and calls back on the calling script's thread with what resultsToScriptValue makes of it
+    void startQueryBatch(EntityQueryBatchPointer batch, QScriptValue callback,
+                         std::function<QScriptValue(QScriptEngine*)> resultsToScriptValue);
+
     EntityTreePointer _entityTree;
     EntitiesScriptEngineProvider* _entitiesScriptEngine = nullptr;
 };
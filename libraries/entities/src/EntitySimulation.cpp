@@ -9,18 +9,49 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
+#include <QtCore/QThread>
+
 #include <AACube.h>
 
 #include "EntitySimulation.h"
 #include "EntitiesLogging.h"
 #include "MovingEntitiesOperator.h"
 
+EntitySimulation::EntitySimulation() :
+    _entityTree(NULL),
+    _nextExpiry(quint64(-1))
+{
+    // the simulation threads are busy every frame, don't let them expire between frames
+    _simulationThreadPool.setExpiryTimeout(-1);
+    setNumSimulationThreads(1);
+}
+
+void EntitySimulation::setNumSimulationThreads(int numThreads) {
+    QMutexLocker lock(&_mutex);
+    if (numThreads < 1) {
+        numThreads = QThread::idealThreadCount();
+    }
+    numThreads = std::max(numThreads, 1);
+
+    _simulationJobs.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        _simulationJobs.emplace_back(new EntitySimulationJob());
+    }
+
+    // the thread calling updateEntities() runs the first job, so the pool only needs threads for the rest
+    _simulationThreadPool.setMaxThreadCount(std::max(numThreads - 1, 1));
+}
+
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
         _mortalEntities.clear();
         _nextExpiry = quint64(-1);
         _entitiesToUpdate.clear();
         _entitiesToSort.clear();
+        _entitiesToResort.clear();
+        _entitiesToReindex.clear();
         _simpleKinematicEntities.clear();
     }
     _entityTree = tree;
@@ -32,10 +63,22 @@ void EntitySimulation::updateEntities() {
 
     // these methods may accumulate entries in _entitiesToBeDeleted
     expireMortalEntities(now);
-    callUpdateOnEntitiesThatNeedIt(now);
-    moveSimpleKinematics(now);
+
+    quint64 startSimulating = usecTimestampNow();
+    if (_simulationJobs.size() > 1) {
+        runSimulationJobs(now);
+    } else {
+        _numEntitiesSimulated = _entitiesToUpdate.size() + _simpleKinematicEntities.size();
+        callUpdateOnEntitiesThatNeedIt(now);
+        moveSimpleKinematics(now);
+    }
+    _usecsSimulating = usecTimestampNow() - startSimulating;
+
     updateEntitiesInternal(now);
+
+    quint64 startSorting = usecTimestampNow();
     sortEntitiesThatMoved();
+    _usecsSorting = usecTimestampNow() - startSorting;
 }
 
 void EntitySimulation::getEntitiesToDelete(VectorOfEntities& entitiesToDelete) {
@@ -108,12 +151,64 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
     }
 }
 
+// protected
+void EntitySimulation::runSimulationJobs(const quint64& now) {
+    PerformanceTimer perfTimer("simulationJobs");
+    int numJobs = (int)_simulationJobs.size();
+    for (auto& job : _simulationJobs) {
+        job->clear();
+        job->setNow(now);
+        job->setSpatialIndex(&_entityTree->getSpatialIndex());
+    }
+
+    // every entity of an island goes to the same job, since moving an entity moves its children and an entity
+    // reads its parent's transform. the root ancestor only picks the job, mix its bits so islands spread evenly
+    auto jobForEntity = [&](const EntityItemPointer& entity) -> EntitySimulationJob& {
+        quint64 key = (quint64)(uintptr_t)entity->getRootAncestor() * 0x9E3779B97F4A7C15ULL;
+        return *_simulationJobs[(key >> 32) % numJobs];
+    };
+    for (auto& entity : _entitiesToUpdate) {
+        jobForEntity(entity).addEntityToUpdate(entity);
+    }
+    for (auto& entity : _simpleKinematicEntities) {
+        jobForEntity(entity).addEntityToMove(entity);
+    }
+
+    // hand every job but the first to the pool, and run the first one right here
+    for (int i = 1; i < numJobs; ++i) {
+        if (!_simulationJobs[i]->isEmpty()) {
+            _simulationThreadPool.start(_simulationJobs[i].get());
+        }
+    }
+    _simulationJobs[0]->run();
+    _simulationThreadPool.waitForDone();
+
+    // apply what the jobs found to the lists, which only this thread touches
+    int numEntitiesSimulated = 0;
+    for (auto& job : _simulationJobs) {
+        numEntitiesSimulated += job->getNumEntities();
+        for (auto& entity : job->getFinishedUpdating()) {
+            _entitiesToUpdate.remove(entity);
+        }
+        for (auto& entity : job->getFinishedMoving()) {
+            _simpleKinematicEntities.remove(entity);
+        }
+        for (auto& entity : job->getOutOfBounds()) {
+            removeEntityOutOfBounds(entity);
+        }
+        _entitiesToResort.insert(_entitiesToResort.end(), job->getToResort().begin(), job->getToResort().end());
+        _entitiesToReindex.insert(_entitiesToReindex.end(), job->getToReindex().begin(), job->getToReindex().end());
+    }
+    _numEntitiesSimulated = numEntitiesSimulated;
+}
+
 // protected
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
     PerformanceTimer perfTimer("sortingEntities");
     MovingEntitiesOperator moveOperator(_entityTree);
+    EntitySpatialIndex& spatialIndex = _entityTree->getSpatialIndex();
     AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
     SetOfEntities::iterator itemItr = _entitiesToSort.begin();
     while (itemItr != _entitiesToSort.end()) {
@@ -121,28 +216,54 @@ void EntitySimulation::sortEntitiesThatMoved() {
         // check to see if this movement has sent the entity outside of the domain.
         AACube newCube = entity->getMaximumAACube();
         if (!domainBounds.touches(newCube)) {
-            qCDebug(entities) << "Entity " << entity->getEntityItemID() << " moved out of domain bounds.";
-            _entitiesToDelete.insert(entity);
-            _mortalEntities.remove(entity);
-            _entitiesToUpdate.remove(entity);
-            _simpleKinematicEntities.remove(entity);
-            removeEntityInternal(entity);
-
-            _allEntities.remove(entity);
-            entity->_simulated = false;
-
             itemItr = _entitiesToSort.erase(itemItr);
+            removeEntityOutOfBounds(entity);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            spatialIndex.updateEntity(entity);
             ++itemItr;
         }
     }
+
+    // the simulation jobs already checked the bounds of the entities they moved, and left out the ones still in their element
+    int numEntitiesResorted = _entitiesToSort.size();
+    for (auto& entityAndCube : _entitiesToResort) {
+        if (entityAndCube.first->_simulated) {
+            moveOperator.addEntityToMoveList(entityAndCube.first, entityAndCube.second);
+            numEntitiesResorted++;
+        }
+    }
+    _numEntitiesResorted = numEntitiesResorted;
+
+    // most moving entities stay inside the margin of their bounds in the spatial index, the jobs list the others
+    for (auto& entity : _entitiesToReindex) {
+        if (entity->_simulated) {
+            spatialIndex.updateEntity(entity);
+        }
+    }
+
+    // every moved entity is reinserted in a single pass through the tree
     if (moveOperator.hasMovingEntities()) {
         PerformanceTimer perfTimer("recurseTreeWithOperator");
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
     _entitiesToSort.clear();
+    _entitiesToResort.clear();
+    _entitiesToReindex.clear();
+}
+
+void EntitySimulation::removeEntityOutOfBounds(EntityItemPointer entity) {
+    qCDebug(entities) << "Entity " << entity->getEntityItemID() << " moved out of domain bounds.";
+    _entitiesToDelete.insert(entity);
+    _mortalEntities.remove(entity);
+    _entitiesToUpdate.remove(entity);
+    _entitiesToSort.remove(entity);
+    _simpleKinematicEntities.remove(entity);
+    removeEntityInternal(entity);
+
+    _allEntities.remove(entity);
+    entity->_simulated = false;
 }
 
 void EntitySimulation::addEntity(EntityItemPointer entity) {
@@ -241,6 +362,8 @@ void EntitySimulation::clearEntities() {
     _nextExpiry = quint64(-1);
     _entitiesToUpdate.clear();
     _entitiesToSort.clear();
+    _entitiesToResort.clear();
+    _entitiesToReindex.clear();
     _simpleKinematicEntities.clear();
     _entitiesToDelete.clear();
 
@@ -12,7 +12,13 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
 #include <QSet>
 #include <QVector>
 
@@ -20,6 +26,7 @@
 
 #include "EntityActionInterface.h"
 #include "EntityItem.h"
+#include "EntitySimulationJob.h"
 #include "EntityTree.h"
 
 typedef QSet<EntityItemPointer> SetOfEntities;
@@ -44,7 +51,7 @@ const int DIRTY_SIMULATION_FLAGS =
 class EntitySimulation : public QObject {
 Q_OBJECT
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(NULL), _nextExpiry(quint64(-1)) { }
+    EntitySimulation();
     virtual ~EntitySimulation() { setEntityTree(NULL); }
 
     /// \param tree pointer to EntityTree which is stored internally
@@ -52,6 +59,17 @@ public:
 
     void updateEntities();
 
+    /// \param numThreads how many threads call update() on and move entities, 0 for one per core
+    /// with a single thread (the default) all of the simulation runs on the thread calling updateEntities()
+    void setNumSimulationThreads(int numThreads);
+    int getNumSimulationThreads() const { return (int)_simulationJobs.size(); }
+
+    // stats of the most recent updateEntities()
+    int getNumEntitiesSimulated() const { return _numEntitiesSimulated; }
+    int getNumEntitiesResorted() const { return _numEntitiesResorted; }
+    quint64 getUsecsSimulating() const { return _usecsSimulating; }
+    quint64 getUsecsSorting() const { return _usecsSorting; }
+
 //    friend class EntityTree;
 
     virtual void addAction(EntityActionPointer action);
@@ -97,11 +115,14 @@ protected:
 
     void expireMortalEntities(const quint64& now);
     void callUpdateOnEntitiesThatNeedIt(const quint64& now);
+    void runSimulationJobs(const quint64& now);
     void sortEntitiesThatMoved();
 
     QMutex _mutex{ QMutex::Recursive };
 
     SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
+    std::vector<std::pair<EntityItemPointer, AACube>> _entitiesToResort; // moved by the simulation jobs out of their element
+    std::vector<EntityItemPointer> _entitiesToReindex; // moved by the simulation jobs out of their spatial index bounds
     SetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
     QList<EntityActionPointer> _actionsToAdd;
     QSet<QUuid> _actionsToRemove;
@@ -109,6 +130,9 @@ protected:
 private:
     void moveSimpleKinematics();
 
+    // drops an entity that left the domain from the simulation, the EntityTree will delete it
+    void removeEntityOutOfBounds(EntityItemPointer entity);
+
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
 
@@ -122,6 +146,13 @@ private:
     SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
     SetOfEntities _entitiesToDelete; // entities simulation decided needed to be deleted (EntityTree will actually delete)
 
+    std::vector<std::unique_ptr<EntitySimulationJob>> _simulationJobs;
+    QThreadPool _simulationThreadPool;
+
+    std::atomic<int> _numEntitiesSimulated { 0 };
+    std::atomic<int> _numEntitiesResorted { 0 };
+    std::atomic<quint64> _usecsSimulating { 0 };
+    std::atomic<quint64> _usecsSorting { 0 };
 };
 
 #endif // hifi_EntitySimulation_h
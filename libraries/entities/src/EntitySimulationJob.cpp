@@ -0,0 +1,75 @@
+//
+//  EntitySimulationJob.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/10/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <SharedUtil.h>
+
+#include "EntityTreeElement.h"
+
+#include "EntitySimulationJob.h"
+
+EntitySimulationJob::EntitySimulationJob() :
+    QRunnable()
+{
+    // jobs are re-used every frame, the simulation owns them
+    setAutoDelete(false);
+}
+
+void EntitySimulationJob::clear() {
+    _entitiesToUpdate.clear();
+    _entitiesToMove.clear();
+
+    _finishedUpdating.clear();
+    _finishedMoving.clear();
+    _outOfBounds.clear();
+    _toResort.clear();
+    _toReindex.clear();
+
+    _usecsSimulating = 0;
+}
+
+void EntitySimulationJob::run() {
+    quint64 start = usecTimestampNow();
+
+    for (auto& entity : _entitiesToUpdate) {
+        if (!entity->needsToCallUpdate()) {
+            _finishedUpdating.push_back(entity);
+        } else {
+            entity->update(_now);
+        }
+    }
+
+    AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
+    for (auto& entity : _entitiesToMove) {
+        if (!entity->isMoving() || entity->getPhysicsInfo()) {
+            _finishedMoving.push_back(entity);
+            continue;
+        }
+
+        entity->simulate(_now);
+
+        // check the new bounds here, so that the simulation only has to sort the entities that left their element
+        AACube newCube = entity->getMaximumAACube();
+        if (!domainBounds.touches(newCube)) {
+            _outOfBounds.push_back(entity);
+        } else {
+            EntityTreeElementPointer element = entity->getElement();
+            AABox newCubeClamped = newCube.clamp((float)-HALF_TREE_SCALE, (float)HALF_TREE_SCALE);
+            if (!element || !element->bestFitBounds(newCubeClamped)) {
+                _toResort.emplace_back(entity, newCube);
+            }
+            if (_spatialIndex && _spatialIndex->needsUpdate(entity)) {
+                _toReindex.push_back(entity);
+            }
+        }
+    }
+
+    _usecsSimulating = usecTimestampNow() - start;
+}
@@ -0,0 +1,77 @@
+//
+//  EntitySimulationJob.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/10/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationJob_h
+#define hifi_EntitySimulationJob_h
+
+#include <utility>
+#include <vector>
+
+#include <QtCore/QRunnable>
+
+#include <AACube.h>
+
+#include "EntityItem.h"
+#include "EntitySpatialIndex.h"
+
+/// One slice of a simulation frame. The EntitySimulation deals whole islands - entities that share a root ancestor,
+/// and so move each other - to its jobs, so that jobs can call update() on and integrate the kinematic motion of their
+/// entities in parallel. A job never touches the simulation's lists, it records what it found for the simulation
+/// to apply once every job for the frame is done.
+class EntitySimulationJob : public QRunnable {
+public:
+    EntitySimulationJob();
+
+    void run();
+
+    void clear();
+    void addEntityToUpdate(const EntityItemPointer& entity) { _entitiesToUpdate.push_back(entity); }
+    void addEntityToMove(const EntityItemPointer& entity) { _entitiesToMove.push_back(entity); }
+
+    void setNow(quint64 now) { _now = now; }
+    void setSpatialIndex(const EntitySpatialIndex* spatialIndex) { _spatialIndex = spatialIndex; }
+
+    bool isEmpty() const { return _entitiesToUpdate.empty() && _entitiesToMove.empty(); }
+    int getNumEntities() const { return (int)(_entitiesToUpdate.size() + _entitiesToMove.size()); }
+    quint64 getUsecsSimulating() const { return _usecsSimulating; }
+
+    // entities that no longer need update() to be called
+    const std::vector<EntityItemPointer>& getFinishedUpdating() const { return _finishedUpdating; }
+
+    // entities that are no longer non-physical-kinematic
+    const std::vector<EntityItemPointer>& getFinishedMoving() const { return _finishedMoving; }
+
+    // entities whose new maximum AACube no longer touches the domain
+    const std::vector<EntityItemPointer>& getOutOfBounds() const { return _outOfBounds; }
+
+    // entities that moved out of their element, with their new maximum AACube
+    const std::vector<std::pair<EntityItemPointer, AACube>>& getToResort() const { return _toResort; }
+
+    // entities that moved out of their bounds in the spatial index
+    const std::vector<EntityItemPointer>& getToReindex() const { return _toReindex; }
+
+private:
+    quint64 _now { 0 };
+    const EntitySpatialIndex* _spatialIndex { nullptr };
+
+    std::vector<EntityItemPointer> _entitiesToUpdate;
+    std::vector<EntityItemPointer> _entitiesToMove;
+
+    std::vector<EntityItemPointer> _finishedUpdating;
+    std::vector<EntityItemPointer> _finishedMoving;
+    std::vector<EntityItemPointer> _outOfBounds;
+    std::vector<std::pair<EntityItemPointer, AACube>> _toResort;
+    std::vector<EntityItemPointer> _toReindex;
+
+    quint64 _usecsSimulating { 0 };
+};
+
+#endif // hifi_EntitySimulationJob_h
@@ -0,0 +1,496 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <float.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "EntityTreeElement.h"
+
+#include "EntitySpatialIndex.h"
+
+// a leaf is bounded by its entity's box grown by this much, plus how far the entity moves in the look ahead time,
+// so that an entity can move a little before it has to be re-inserted
+const float LEAF_MARGIN = 0.1f; // meters
+const float LEAF_VELOCITY_LOOK_AHEAD = 0.25f; // seconds
+
+static float surfaceArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 size = maximum - minimum;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static bool boxContains(const glm::vec3& minimum, const glm::vec3& maximum, const AABox& box) {
+    return glm::all(glm::greaterThanEqual(box.getMinimum(), minimum)) &&
+        glm::all(glm::lessThanEqual(box.getMaximum(), maximum));
+}
+
+static bool boxesTouch(const glm::vec3& minimum, const glm::vec3& maximum,
+                       const glm::vec3& otherMinimum, const glm::vec3& otherMaximum) {
+    return glm::all(glm::lessThanEqual(minimum, otherMaximum)) && glm::all(glm::greaterThanEqual(maximum, otherMinimum));
+}
+
+static float distanceSquaredToBox(const glm::vec3& minimum, const glm::vec3& maximum, const glm::vec3& point) {
+    glm::vec3 offset = glm::max(glm::max(minimum - point, point - maximum), glm::vec3(0.0f));
+    return glm::dot(offset, offset);
+}
+
+// slab test, entry is where the ray enters the box, or 0 if it starts inside
+static bool rayHitsBox(const glm::vec3& minimum, const glm::vec3& maximum,
+                       const glm::vec3& origin, const glm::vec3& inverseDirection, float& entry) {
+    float tMin = 0.0f;
+    float tMax = FLT_MAX;
+    for (int i = 0; i < 3; i++) {
+        if (glm::isinf(inverseDirection[i])) {
+            // the ray is parallel to this slab, and would give 0 * inf = NaN below if it started on one of its planes
+            if (origin[i] < minimum[i] || origin[i] > maximum[i]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (minimum[i] - origin[i]) * inverseDirection[i];
+        float t2 = (maximum[i] - origin[i]) * inverseDirection[i];
+        tMin = glm::max(tMin, glm::min(t1, t2));
+        tMax = glm::min(tMax, glm::max(t1, t2));
+    }
+    entry = tMin;
+    return tMax >= entry;
+}
+
+void EntitySpatialIndex::setEnabled(bool enabled) {
+    if (enabled != _enabled) {
+        clear();
+        _enabled = enabled;
+    }
+}
+
+void EntitySpatialIndex::clear() {
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeList = NULL_NODE;
+    _leaves.clear();
+    _unindexed.clear();
+}
+
+bool EntitySpatialIndex::needsUpdate(const EntityItemPointer& entity) const {
+    if (!_enabled) {
+        return false;
+    }
+
+    auto leaf = _leaves.find(entity.get());
+    if (leaf == _leaves.end()) {
+        // it is either new, or unindexed and about to get indexed
+        return isIndexable(entity) || _unindexed.find(entity.get()) == _unindexed.end();
+    }
+
+    if (!isIndexable(entity)) {
+        return true;
+    }
+    const Node& node = _nodes[leaf->second];
+    return !boxContains(node.minimum, node.maximum, entity->getAABox());
+}
+
+void EntitySpatialIndex::updateEntity(const EntityItemPointer& entity) {
+    if (!_enabled) {
+        return;
+    }
+
+    const EntityItem* key = entity.get();
+    AABox box = entity->getAABox();
+    auto leaf = _leaves.find(key);
+
+    if (!isIndexable(entity) || box.isInvalid()) {
+        if (leaf != _leaves.end()) {
+            removeLeaf(leaf->second);
+            freeNode(leaf->second);
+            _leaves.erase(leaf);
+        }
+        _unindexed[key] = entity;
+        return;
+    }
+
+    int index;
+    if (leaf != _leaves.end()) {
+        index = leaf->second;
+        if (boxContains(_nodes[index].minimum, _nodes[index].maximum, box)) {
+            // still inside its margin
+            return;
+        }
+        removeLeaf(index);
+    } else {
+        _unindexed.erase(key);
+        index = allocateNode();
+        _nodes[index].entity = entity;
+        _leaves[key] = index;
+    }
+
+    float margin = LEAF_MARGIN + glm::length(entity->getVelocity()) * LEAF_VELOCITY_LOOK_AHEAD;
+    _nodes[index].minimum = box.getMinimum() - glm::vec3(margin);
+    _nodes[index].maximum = box.getMaximum() + glm::vec3(margin);
+    insertLeaf(index);
+}
+
+void EntitySpatialIndex::removeEntity(const EntityItemPointer& entity) {
+    if (!_enabled) {
+        return;
+    }
+
+    auto leaf = _leaves.find(entity.get());
+    if (leaf != _leaves.end()) {
+        removeLeaf(leaf->second);
+        freeNode(leaf->second);
+        _leaves.erase(leaf);
+    } else {
+        _unindexed.erase(entity.get());
+    }
+}
+
+int EntitySpatialIndex::allocateNode() {
+    if (_freeList == NULL_NODE) {
+        _nodes.emplace_back();
+        return (int)_nodes.size() - 1;
+    }
+
+    int index = _freeList;
+    _freeList = _nodes[index].parent;
+    _nodes[index] = Node();
+    return index;
+}
+
+void EntitySpatialIndex::freeNode(int index) {
+    Node& node = _nodes[index];
+    node.entity.reset();
+    node.left = NULL_NODE;
+    node.right = NULL_NODE;
+    node.height = -1;
+    node.parent = _freeList;
+    _freeList = index;
+}
+
+void EntitySpatialIndex::refit(int index) {
+    Node& node = _nodes[index];
+    const Node& left = _nodes[node.left];
+    const Node& right = _nodes[node.right];
+    node.minimum = glm::min(left.minimum, right.minimum);
+    node.maximum = glm::max(left.maximum, right.maximum);
+    node.height = 1 + std::max(left.height, right.height);
+}
+
+void EntitySpatialIndex::insertLeaf(int leaf) {
+    if (_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the sibling that grows the total surface area of the hierarchy the least
+    glm::vec3 leafMinimum = _nodes[leaf].minimum;
+    glm::vec3 leafMaximum = _nodes[leaf].maximum;
+    int index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node& node = _nodes[index];
+        float area = surfaceArea(node.minimum, node.maximum);
+        float combinedArea = surfaceArea(glm::min(node.minimum, leafMinimum), glm::max(node.maximum, leafMaximum));
+
+        // the cost of making the leaf a sibling of this node, and what every node below pays for growing this one
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int childIndex) {
+            const Node& child = _nodes[childIndex];
+            float grownArea = surfaceArea(glm::min(child.minimum, leafMinimum), glm::max(child.maximum, leafMaximum));
+            if (child.isLeaf()) {
+                return grownArea + inheritanceCost;
+            }
+            return grownArea - surfaceArea(child.minimum, child.maximum) + inheritanceCost;
+        };
+        float leftCost = descendCost(node.left);
+        float rightCost = descendCost(node.right);
+
+        if (cost < leftCost && cost < rightCost) {
+            break;
+        }
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+    int sibling = index;
+
+    // a new parent takes the sibling's place, with the sibling and the leaf as its children
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].left = sibling;
+    _nodes[newParent].right = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+    refit(newParent);
+
+    if (oldParent == NULL_NODE) {
+        _root = newParent;
+    } else if (_nodes[oldParent].left == sibling) {
+        _nodes[oldParent].left = newParent;
+    } else {
+        _nodes[oldParent].right = newParent;
+    }
+
+    for (index = _nodes[leaf].parent; index != NULL_NODE; index = _nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+void EntitySpatialIndex::removeLeaf(int leaf) {
+    if (leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+
+    // the leaf's sibling takes the place of their parent
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+    freeNode(parent);
+
+    if (grandParent == NULL_NODE) {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        return;
+    }
+
+    if (_nodes[grandParent].left == parent) {
+        _nodes[grandParent].left = sibling;
+    } else {
+        _nodes[grandParent].right = sibling;
+    }
+    _nodes[sibling].parent = grandParent;
+
+    for (int index = grandParent; index != NULL_NODE; index = _nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+// rotates the taller child of A up into A's place when the heights of A's children differ by more than one,
+// and returns the index of the node now in that place
+int EntitySpatialIndex::balance(int iA) {
+    Node& A = _nodes[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int iB = A.left;
+    int iC = A.right;
+    Node& B = _nodes[iB];
+    Node& C = _nodes[iC];
+
+    int heightDifference = C.height - B.height;
+    if (heightDifference > 1) {
+        // C takes A's place, A keeps B and the shorter of C's children
+        int iF = C.left;
+        int iG = C.right;
+        C.left = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+        if (C.parent == NULL_NODE) {
+            _root = iC;
+        } else if (_nodes[C.parent].left == iA) {
+            _nodes[C.parent].left = iC;
+        } else {
+            _nodes[C.parent].right = iC;
+        }
+
+        bool fIsTaller = _nodes[iF].height > _nodes[iG].height;
+        int iTaller = fIsTaller ? iF : iG;
+        int iShorter = fIsTaller ? iG : iF;
+        C.right = iTaller;
+        A.right = iShorter;
+        _nodes[iShorter].parent = iA;
+        refit(iA);
+        refit(iC);
+        return iC;
+    }
+
+    if (heightDifference < -1) {
+        // B takes A's place, A keeps C and the shorter of B's children
+        int iD = B.left;
+        int iE = B.right;
+        B.left = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+        if (B.parent == NULL_NODE) {
+            _root = iB;
+        } else if (_nodes[B.parent].left == iA) {
+            _nodes[B.parent].left = iB;
+        } else {
+            _nodes[B.parent].right = iB;
+        }
+
+        bool dIsTaller = _nodes[iD].height > _nodes[iE].height;
+        int iTaller = dIsTaller ? iD : iE;
+        int iShorter = dIsTaller ? iE : iD;
+        B.right = iTaller;
+        A.left = iShorter;
+        _nodes[iShorter].parent = iA;
+        refit(iA);
+        refit(iB);
+        return iB;
+    }
+
+    return iA;
+}
+
+template <typename NodeTest, typename F>
+void EntitySpatialIndex::forEachCandidate(NodeTest nodeTest, F f) const {
+    for (auto& unindexed : _unindexed) {
+        f(unindexed.second);
+    }
+
+    if (_root == NULL_NODE) {
+        return;
+    }
+
+    const int EXPECTED_MAX_DEPTH = 64;
+    std::vector<int> stack;
+    stack.reserve(EXPECTED_MAX_DEPTH);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+        if (!nodeTest(node.minimum, node.maximum)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            f(node.entity);
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void EntitySpatialIndex::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) const {
+    float radiusSquared = radius * radius;
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return distanceSquaredToBox(minimum, maximum, center) <= radiusSquared;
+    }, [&](const EntityItemPointer& entity) {
+        if (EntityTreeElement::entityTouchesSphere(entity, center, radius)) {
+            foundEntities.push_back(entity);
+        }
+    });
+}
+
+void EntitySpatialIndex::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) const {
+    glm::vec3 cubeMinimum = cube.getMinimumPoint();
+    glm::vec3 cubeMaximum = cube.getMaximumPoint();
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return boxesTouch(minimum, maximum, cubeMinimum, cubeMaximum);
+    }, [&](const EntityItemPointer& entity) {
+        if (entity->getAABox().touches(cube)) {
+            foundEntities.push_back(entity);
+        }
+    });
+}
+
+void EntitySpatialIndex::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) const {
+    glm::vec3 boxMinimum = box.getMinimum();
+    glm::vec3 boxMaximum = box.getMaximum();
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return boxesTouch(minimum, maximum, boxMinimum, boxMaximum);
+    }, [&](const EntityItemPointer& entity) {
+        if (entity->getAABox().touches(box)) {
+            foundEntities.push_back(entity);
+        }
+    });
+}
+
+EntityItemPointer EntitySpatialIndex::findClosestEntity(const glm::vec3& position, float targetRadius) const {
+    EntityItemPointer closestEntity;
+    float closestDistance = FLT_MAX;
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        float limit = glm::min(targetRadius, closestDistance);
+        return distanceSquaredToBox(minimum, maximum, position) <= limit * limit;
+    }, [&](const EntityItemPointer& entity) {
+        float distance = glm::distance(entity->getPosition(), position);
+        if (distance <= targetRadius && distance < closestDistance) {
+            closestEntity = entity;
+            closestDistance = distance;
+        }
+    });
+    return closestEntity;
+}
+
+bool EntitySpatialIndex::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                             OctreeElementPointer& element, float& distance, BoxFace& face,
+                                             glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
+                                             void** intersectedObject, bool precisionPicking) const {
+    bool found = false;
+    bool keepSearching = true;
+    auto testEntity = [&](const EntityItemPointer& entity) {
+        if (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) {
+            return;
+        }
+        if (EntityTreeElement::findEntityRayIntersection(entity, origin, direction, keepSearching, element, distance,
+                                                         face, surfaceNormal, intersectedObject, precisionPicking)) {
+            found = true;
+        }
+    };
+
+    for (auto& unindexed : _unindexed) {
+        testEntity(unindexed.second);
+    }
+
+    if (_root == NULL_NODE) {
+        return found;
+    }
+
+    // visit the nearer child first, and skip any node that the ray enters beyond the closest intersection so far
+    glm::vec3 inverseDirection = 1.0f / direction;
+    float entry;
+    if (!rayHitsBox(_nodes[_root].minimum, _nodes[_root].maximum, origin, inverseDirection, entry)) {
+        return found;
+    }
+
+    const int EXPECTED_MAX_DEPTH = 64;
+    std::vector<std::pair<int, float>> stack;
+    stack.reserve(EXPECTED_MAX_DEPTH);
+    stack.emplace_back(_root, entry);
+    while (!stack.empty()) {
+        int index = stack.back().first;
+        float nodeEntry = stack.back().second;
+        stack.pop_back();
+        if (nodeEntry >= distance) {
+            continue;
+        }
+
+        const Node& node = _nodes[index];
+        if (node.isLeaf()) {
+            testEntity(node.entity);
+            continue;
+        }
+
+        float leftEntry, rightEntry;
+        bool hitsLeft = rayHitsBox(_nodes[node.left].minimum, _nodes[node.left].maximum, origin, inverseDirection, leftEntry);
+        bool hitsRight = rayHitsBox(_nodes[node.right].minimum, _nodes[node.right].maximum, origin, inverseDirection, rightEntry);
+        if (hitsLeft && hitsRight) {
+            if (leftEntry < rightEntry) {
+                stack.emplace_back(node.right, rightEntry);
+                stack.emplace_back(node.left, leftEntry);
+            } else {
+                stack.emplace_back(node.left, leftEntry);
+                stack.emplace_back(node.right, rightEntry);
+            }
+        } else if (hitsLeft) {
+            stack.emplace_back(node.left, leftEntry);
+        } else if (hitsRight) {
+            stack.emplace_back(node.right, rightEntry);
+        }
+    }
+    return found;
+}
@@ -0,0 +1,117 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <AABox.h>
+#include <AACube.h>
+#include <BoxBase.h>
+#include <OctreeElement.h>
+
+#include "EntityItem.h"
+
+/// A bounding volume hierarchy over the world frame AABoxes of the entities of an EntityTree.
+///
+/// The octree keeps an entity in the smallest element that holds its maximum AACube, so large entities sit near the
+/// root and are tested by every query. The hierarchy is a dynamic AABB tree, kept balanced with rotations as entities
+/// are added and removed, whose leaves are bounded by the entity's box plus a margin. An entity that moves inside its
+/// margin costs nothing to update, one that leaves it is removed and re-inserted.
+///
+/// Entities with a parent move whenever their parent does, without the tree hearing of it, so they are not put in the
+/// hierarchy. They are kept on a list that every query tests.
+///
+/// The index is changed only under the tree's write lock, and queried under its read lock. Queries don't change it, so
+/// any number of them can run at once.
+class EntitySpatialIndex {
+public:
+    /// the index does nothing while it is disabled, enabling it leaves it empty
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /// adds the entity, or updates it if it is already in the index
+    void updateEntity(const EntityItemPointer& entity);
+    void removeEntity(const EntityItemPointer& entity);
+    void clear();
+
+    /// \return true if updateEntity() would have to change the index for this entity. Doesn't change the index, so it
+    /// can be called from several threads at once while the index is not being changed.
+    bool needsUpdate(const EntityItemPointer& entity) const;
+
+    /// finds all entities that touch a sphere, with the same test as EntityTreeElement::getEntities()
+    void findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) const;
+
+    /// finds all entities whose AABox touches a cube
+    void findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) const;
+
+    /// finds all entities whose AABox touches a box
+    void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) const;
+
+    /// \return the entity whose position is closest to position and no further than targetRadius from it
+    EntityItemPointer findClosestEntity(const glm::vec3& position, float targetRadius) const;
+
+    /// finds the closest entity the ray intersects, with the same test as EntityTreeElement::findDetailedRayIntersection()
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, OctreeElementPointer& element,
+                             float& distance, BoxFace& face, glm::vec3& surfaceNormal,
+                             const QVector<EntityItemID>& entityIdsToInclude, void** intersectedObject,
+                             bool precisionPicking) const;
+
+    int getNumEntities() const { return (int)(_leaves.size() + _unindexed.size()); }
+    int getNumUnindexed() const { return (int)_unindexed.size(); }
+    int getHeight() const { return _root == NULL_NODE ? 0 : _nodes[_root].height + 1; }
+
+private:
+    static const int NULL_NODE = -1;
+
+    struct Node {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int parent { NULL_NODE }; // also the next free node while the node is on the free list
+        int left { NULL_NODE };
+        int right { NULL_NODE };
+        int height { 0 }; // 0 for leaves, -1 for free nodes
+        EntityItemPointer entity; // only set on leaves
+
+        bool isLeaf() const { return left == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int index);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int index);
+    void refit(int index);
+
+    // calls f with every leaf whose node passes the test, and with every unindexed entity
+    template <typename NodeTest, typename F>
+    void forEachCandidate(NodeTest nodeTest, F f) const;
+
+    static bool isIndexable(const EntityItemPointer& entity) { return entity->getParentID().isNull(); }
+
+    bool _enabled { true };
+
+    std::vector<Node> _nodes;
+    int _root { NULL_NODE };
+    int _freeList { NULL_NODE };
+
+    std::unordered_map<const EntityItem*, int> _leaves;
+    std::unordered_map<const EntityItem*, EntityItemPointer> _unindexed;
+};
+
+#endif // hifi_EntitySpatialIndex_h
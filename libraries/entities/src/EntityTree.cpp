@@ -9,11 +9,19 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <OctreeBinarySnapshot.h>
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QRunnable>
+#include <QThread>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
+#include "EntityBinaryRecord.h"
 #include "EntitySimulation.h"
 #include "VariantMapToScriptValue.h"
 
@@ -28,15 +36,27 @@
 
 static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC * 50;
 
+// runs one piece of a query batch on the query thread pool
+class EntityQueryJob : public QRunnable {
+public:
+    EntityQueryJob(std::function<void()> work) : _work(work) { }
+    void run() override { _work(); }
+private:
+    std::function<void()> _work;
+};
+
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage),
     _fbxService(NULL),
     _simulation(NULL)
 {
     resetClientEditStats();
+    _queryThreadPool.setExpiryTimeout(-1);
 }
 
 EntityTree::~EntityTree() {
+    // query batches still running read the tree
+    _queryThreadPool.waitForDone();
     eraseAllOctreeElements(false);
 }
 
@@ -61,6 +81,14 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         element->cleanupEntities();
     }
     _entityToElementMap.clear();
+    _encodeCache.clear();
+    _spatialIndex.clear();
+    if (_wantJournal) {
+        // nothing from before the erase should come back when the journal is replayed
+        QMutexLocker locker(&_journalLock);
+        _journalCleared = true;
+        _journaledChanges.clear();
+    }
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -86,7 +114,9 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
     if (_simulation) {
         _simulation->addEntity(entity);
     }
+    _spatialIndex.updateEntity(entity);
     _isDirty = true;
+    journalEntityChange(entity->getEntityItemID(), false);
     maybeNotifyNewCollisionSoundURL("", entity->getCollisionSoundURL());
     emit addingEntity(entity->getEntityItemID());
 }
@@ -147,6 +177,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 recurseTreeWithOperator(&theOperator);
                 entity->setProperties(tempProperties);
                 _isDirty = true;
+                journalEntityChange(entity->getEntityItemID(), false);
             }
         }
     } else {
@@ -245,7 +276,9 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
             }
         }
 
+        _spatialIndex.updateEntity(entity);
         _isDirty = true;
+        journalEntityChange(entity->getEntityItemID(), false);
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -431,6 +464,8 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
             _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            _encodeCache.remove(theEntity->getEntityItemID());
+            journalEntityChange(theEntity->getEntityItemID(), true);
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -440,6 +475,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             theEntity->clearActions(_simulation);
             _simulation->removeEntity(theEntity);
         }
+        _spatialIndex.removeEntity(theEntity);
     }
 }
 
@@ -520,25 +556,79 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
                                     OctreeElementPointer& element, float& distance, 
                                     BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude, void** intersectedObject,
                                     Octree::lockType lockType, bool* accurateResult, bool precisionPicking) {
-    RayArgs args = { origin, direction, element, distance, face, surfaceNormal, entityIdsToInclude, intersectedObject, false, precisionPicking };
+    bool found = false;
     distance = FLT_MAX;
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        found = findRayIntersectionWorker(origin, direction, element, distance, face, surfaceNormal,
+                                          entityIdsToInclude, intersectedObject, precisionPicking);
     }, requireLock);
 
     if (accurateResult) {
         *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
     }
 
+    return found;
+}
+
+bool EntityTree::findRayIntersectionWorker(const glm::vec3& origin, const glm::vec3& direction,
+                                          OctreeElementPointer& element, float& distance, BoxFace& face,
+                                          glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
+                                          void** intersectedObject, bool precisionPicking) {
+    distance = FLT_MAX;
+    if (_spatialIndex.isEnabled()) {
+        return _spatialIndex.findRayIntersection(origin, direction, element, distance, face, surfaceNormal,
+                                                 entityIdsToInclude, intersectedObject, precisionPicking);
+    }
+
+    RayArgs args = { origin, direction, element, distance, face, surfaceNormal, entityIdsToInclude, intersectedObject, false, precisionPicking };
+    recurseTreeWithOperation(findRayIntersectionOp, &args);
     return args.found;
 }
 
+void EntityTree::runQueryBatch(EntityQueryBatchPointer batch) {
+    quint64 start = usecTimestampNow();
+    withReadLock([&] {
+        batch->prepare();
+
+        // the pool only helps with batches big enough to share, the calling thread claims queries as well
+        const int QUERIES_PER_JOB = 64;
+        int numSharedQueries = (int)batch->_sharedQueries.size();
+        int numJobs = std::min(_queryThreadPool.maxThreadCount(), (numSharedQueries - 1) / QUERIES_PER_JOB);
+        for (int i = 0; i < numJobs; ++i) {
+            // a job that starts after the batch is done finds nothing left to claim, so it only needs the batch
+            _queryThreadPool.start(new EntityQueryJob([this, batch] {
+                batch->runSharedQueries(*this);
+            }));
+        }
+
+        for (int query : batch->_callerQueries) {
+            batch->runQuery(*this, query);
+        }
+        batch->runSharedQueries(*this);
+
+        // wait for the queries other threads claimed, not for the jobs, which may not have started yet
+        batch->_sharedQueriesDone.acquire(numSharedQueries);
+    });
+    batch->_usecsRunning = usecTimestampNow() - start;
+}
+
+void EntityTree::startQueryBatch(EntityQueryBatchPointer batch, std::function<void()> finished) {
+    _queryThreadPool.start(new EntityQueryJob([this, batch, finished] {
+        runQueryBatch(batch);
+        finished();
+    }));
+}
+
 
 EntityItemPointer EntityTree::findClosestEntity(glm::vec3 position, float targetRadius) {
     FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
     withReadLock([&] {
+        if (_spatialIndex.isEnabled()) {
+            args.closestEntity = _spatialIndex.findClosestEntity(position, targetRadius);
+            return;
+        }
         // NOTE: This should use recursion, since this is a spatial operation
         recurseTreeWithOperation(findNearPointOperation, &args);
     });
@@ -571,6 +661,12 @@ bool EntityTree::findInSphereOperation(OctreeElementPointer element, void* extra
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) {
+    if (_spatialIndex.isEnabled()) {
+        foundEntities.clear();
+        _spatialIndex.findEntities(center, radius, foundEntities);
+        return;
+    }
+
     FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>() };
     // NOTE: This should use recursion, since this is a spatial operation
     recurseTreeWithOperation(findInSphereOperation, &args);
@@ -601,6 +697,12 @@ bool EntityTree::findInCubeOperation(OctreeElementPointer element, void* extraDa
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
+    if (_spatialIndex.isEnabled()) {
+        foundEntities.clear();
+        _spatialIndex.findEntities(cube, foundEntities);
+        return;
+    }
+
     FindEntitiesInCubeArgs args(cube);
     // NOTE: This should use recursion, since this is a spatial operation
     recurseTreeWithOperation(findInCubeOperation, &args);
@@ -630,6 +732,12 @@ bool EntityTree::findInBoxOperation(OctreeElementPointer element, void* extraDat
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
+    if (_spatialIndex.isEnabled()) {
+        foundEntities.clear();
+        _spatialIndex.findEntities(box, foundEntities);
+        return;
+    }
+
     FindEntitiesInBoxArgs args(box);
     // NOTE: This should use recursion, since this is a spatial operation
     recurseTreeWithOperation(findInBoxOperation, &args);
@@ -758,122 +866,159 @@ void EntityTree::fixupTerseEditLogging(EntityItemProperties& properties, QList<Q
     }
 }
 
+// An edit decoded from an edit packet, without the tree lock, to be applied later under it
+class EntityDecodedEdit : public OctreeDecodedEdit {
+public:
+    PacketType type;
+    bool isValid { false };
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+    QSet<EntityItemID> erasedEntityItemIDs;
+};
+
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
+    OctreeDecodedEditPointer edit;
+    int processedBytes = decodeEditPacketData(message, editData, maxLength, edit);
+    if (edit) {
+        applyDecodedEdit(*edit, senderNode);
+    }
+    return processedBytes;
+}
 
+int EntityTree::decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     OctreeDecodedEditPointer& edit) {
     if (!getIsServer()) {
         qCDebug(entities) << "UNEXPECTED!!! processEditPacketData() should only be called on a server tree.";
         return 0;
     }
 
+    std::unique_ptr<EntityDecodedEdit> decoded(new EntityDecodedEdit());
+    decoded->type = message.getType();
+
     int processedBytes = 0;
     // we handle these types of "edit" packets
-    switch (message.getType()) {
+    switch (decoded->type) {
         case PacketType::EntityErase: {
             QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
-            processedBytes = processEraseMessageDetails(dataByteArray, senderNode);
+            processedBytes = decodeEraseMessageDetails(dataByteArray, decoded->erasedEntityItemIDs);
             break;
         }
 
         case PacketType::EntityAdd:
         case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
             _totalEditMessages++;
 
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-           
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (existingEntity && message.getType() == PacketType::EntityEdit) {
-                    // if the EntityItem exists, then update it
-                    startLogging = usecTimestampNow();
-                    if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
-                        qCDebug(entities) << "   properties:" << properties;
-                    }
-                    if (wantTerseEditLogging()) {
-                        QList<QString> changedProperties = properties.listChangedProperties();
-                        fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
-                    }
-                    endLogging = usecTimestampNow();
-
-                    startUpdate = usecTimestampNow();
-                    updateEntity(entityItemID, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (message.getType() == PacketType::EntityAdd) {
-                    if (senderNode->getCanRez()) {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
+            quint64 startDecode = usecTimestampNow();
+            decoded->isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                            decoded->entityItemID, decoded->properties);
+            _totalDecodeTime += usecTimestampNow() - startDecode;
+            break;
+        }
 
-                        }
-                    } else {
-                        qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
-                                          << "] attempted to add an entity.";
-                    }
-                } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
-                }
-            }
+        default:
+            return 0;
+    }
 
+    edit = std::move(decoded);
+    return processedBytes;
+}
 
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
+void EntityTree::applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& senderNode) {
+    EntityDecodedEdit& decoded = static_cast<EntityDecodedEdit&>(edit);
 
-            break;
+    if (decoded.type == PacketType::EntityErase) {
+        if (wantEditLogging() || wantTerseEditLogging()) {
+            foreach (const EntityItemID& entityItemID, decoded.erasedEntityItemIDs) {
+                qCDebug(entities) << "User [" << senderNode->getUUID() << "] deleting entity. ID:" << entityItemID;
+            }
+        }
+        if (!decoded.erasedEntityItemIDs.isEmpty()) {
+            deleteEntities(decoded.erasedEntityItemIDs, true, true);
         }
+        return;
+    }
 
-        default:
-            processedBytes = 0;
-            break;
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (!decoded.isValid) {
+        return;
     }
-    return processedBytes;
+
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    const EntityItemID& entityItemID = decoded.entityItemID;
+    EntityItemProperties& properties = decoded.properties;
+
+    // search for the entity by EntityItemID
+    startLookup = usecTimestampNow();
+    EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+    endLookup = usecTimestampNow();
+    if (existingEntity && decoded.type == PacketType::EntityEdit) {
+        // if the EntityItem exists, then update it
+        startLogging = usecTimestampNow();
+        if (wantEditLogging()) {
+            qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+            qCDebug(entities) << "   properties:" << properties;
+        }
+        if (wantTerseEditLogging()) {
+            QList<QString> changedProperties = properties.listChangedProperties();
+            fixupTerseEditLogging(properties, changedProperties);
+            qCDebug(entities) << senderNode->getUUID() << "edit" <<
+                existingEntity->getDebugName() << changedProperties;
+        }
+        endLogging = usecTimestampNow();
+
+        startUpdate = usecTimestampNow();
+        updateEntity(entityItemID, properties, senderNode);
+        existingEntity->markAsChangedOnServer();
+        endUpdate = usecTimestampNow();
+        _totalUpdates++;
+    } else if (decoded.type == PacketType::EntityAdd) {
+        if (senderNode->getCanRez()) {
+            // this is a new entity... assign a new entityID
+            properties.setCreated(properties.getLastEdited());
+            startCreate = usecTimestampNow();
+            EntityItemPointer newEntity = addEntity(entityItemID, properties);
+            endCreate = usecTimestampNow();
+            _totalCreates++;
+            if (newEntity) {
+                newEntity->markAsChangedOnServer();
+                notifyNewlyCreatedEntity(*newEntity, senderNode);
+
+                startLogging = usecTimestampNow();
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                    << newEntity->getEntityItemID();
+                    qCDebug(entities) << "   properties:" << properties;
+                }
+                if (wantTerseEditLogging()) {
+                    QList<QString> changedProperties = properties.listChangedProperties();
+                    fixupTerseEditLogging(properties, changedProperties);
+                    qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
+                }
+                endLogging = usecTimestampNow();
+
+            }
+        } else {
+            qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
+                              << "] attempted to add an entity.";
+        }
+    } else {
+        static QString repeatedMessage =
+            LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+        qCDebug(entities) << "Edit failed. [" << decoded.type <<"] " <<
+                "entity id:" << entityItemID << 
+                "existingEntity pointer:" << existingEntity.get();
+    }
+
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
 }
 
 
@@ -915,6 +1060,27 @@ void EntityTree::entityChanged(EntityItemPointer entity) {
     if (_simulation) {
         _simulation->changeEntity(entity);
     }
+    _spatialIndex.updateEntity(entity);
+}
+
+bool EntityTree::addToSpatialIndexOperation(OctreeElementPointer element, void* extraData) {
+    EntitySpatialIndex* spatialIndex = static_cast<EntitySpatialIndex*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entity) {
+        spatialIndex->updateEntity(entity);
+    });
+    return true;
+}
+
+void EntityTree::setWantSpatialIndex(bool wantSpatialIndex) {
+    if (wantSpatialIndex == _spatialIndex.isEnabled()) {
+        return;
+    }
+
+    _spatialIndex.setEnabled(wantSpatialIndex);
+    if (wantSpatialIndex) {
+        recurseTreeWithOperation(addToSpatialIndexOperation, &_spatialIndex);
+    }
 }
 
 void EntityTree::update() {
@@ -994,7 +1160,7 @@ void EntityTree::forgetEntitiesDeletedBefore(quint64 sinceTime) {
 }
 
 
-// TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
+// TODO: consider consolidating decodeEraseMessageDetails() and processEraseMessage()
 int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode) {
     #ifdef EXTRA_ERASE_DEBUGGING
         qDebug() << "EntityTree::processEraseMessage()";
@@ -1034,12 +1200,11 @@ int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePo
     return message.getPosition();
 }
 
-// This version skips over the header
-// NOTE: Caller must lock the tree before calling this.
-// TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
-int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode) {
+// This version skips over the header, and only reads the IDs so that it does not need the tree lock
+// TODO: consider consolidating decodeEraseMessageDetails() and processEraseMessage()
+int EntityTree::decodeEraseMessageDetails(const QByteArray& dataByteArray, QSet<EntityItemID>& entityItemIDsToDelete) {
     #ifdef EXTRA_ERASE_DEBUGGING
-        qDebug() << "EntityTree::processEraseMessageDetails()";
+        qDebug() << "EntityTree::decodeEraseMessageDetails()";
     #endif
     const unsigned char* packetData = (const unsigned char*)dataByteArray.constData();
     const unsigned char* dataAt = packetData;
@@ -1052,13 +1217,11 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
     processedBytes += sizeof(numberOfIds);
 
     if (numberOfIds > 0) {
-        QSet<EntityItemID> entityItemIDsToDelete;
-
         for (size_t i = 0; i < numberOfIds; i++) {
 
 
             if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
-                qCDebug(entities) << "EntityTree::processEraseMessageDetails().... bailing because not enough bytes in buffer";
+                qCDebug(entities) << "EntityTree::decodeEraseMessageDetails().... bailing because not enough bytes in buffer";
                 break; // bail to prevent buffer overflow
             }
 
@@ -1068,18 +1231,11 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
             processedBytes += encodedID.size();
 
             #ifdef EXTRA_ERASE_DEBUGGING
-                qDebug() << "    ---- EntityTree::processEraseMessageDetails() contains id:" << entityID;
+                qDebug() << "    ---- EntityTree::decodeEraseMessageDetails() contains id:" << entityID;
             #endif
 
-            EntityItemID entityItemID(entityID);
-            entityItemIDsToDelete << entityItemID;
-
-            if (wantEditLogging() || wantTerseEditLogging()) {
-                qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
-            }
-
+            entityItemIDsToDelete << EntityItemID(entityID);
         }
-        deleteEntities(entityItemIDsToDelete, true, true);
     }
     return (int)processedBytes;
 }
@@ -1211,6 +1367,11 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     if (! entityDescription.contains("Entities")) {
         entityDescription["Entities"] = QVariantList();
     }
+    if (!element || element == _rootElement) {
+        // the whole tree is written from a snapshot, so edits only wait on us while it is taken
+        takeSnapshot()->writeToMap(entityDescription, skipDefaultValues);
+        return true;
+    }
     QScriptEngine scriptEngine;
     RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues);
     recurseTreeWithOperator(&theOperator);
@@ -1248,6 +1409,201 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return true;
 }
 
+bool EntityTree::writeToBinaryRecords(QVector<QByteArray>& records, OctreeElementPointer element) {
+    if (element && element != _rootElement) {
+        qCDebug(entities) << "binary snapshots can only be written for the whole tree";
+        return false;
+    }
+    takeSnapshot()->writeToBinaryRecords(records);
+    return true;
+}
+
+bool EntityTree::readFromBinaryChunks(const QVector<QByteArray>& chunks, PacketVersion version) {
+    // edit packets carry no version of their own. Properties added since an older snapshot was written are simply
+    // not in its records, like in an older SVO, but one whose encoding has changed makes a record that no longer
+    // decodes to its end. Then the whole load fails, rather than losing the entity.
+    if (version > expectedVersion()) {
+        qCritical() << "binary snapshot has entity version" << (int)version << "which is newer than"
+            << (int)expectedVersion() << "- it was written by a newer server";
+        return false;
+    }
+    bool isOlderVersion = version < expectedVersion();
+
+    struct DecodedEntity {
+        QByteArray record;
+        EntityItemID entityID;
+        EntityItemProperties properties;
+        bool isDecoded { false };
+    };
+
+    QVector<QVector<DecodedEntity>> decodedChunks(chunks.size());
+    for (int i = 0; i < chunks.size(); ++i) {
+        QVector<QByteArray> records;
+        if (!OctreeBinarySnapshot::splitChunk(chunks[i], records)) {
+            qCritical() << "binary snapshot has a corrupt chunk of entities";
+            return false;
+        }
+        decodedChunks[i].resize(records.size());
+        for (int j = 0; j < records.size(); ++j) {
+            decodedChunks[i][j].record = records[j];
+        }
+    }
+
+    // decoding the properties does not touch the tree, so the chunks are decoded on several threads
+    std::atomic<int> nextChunk { 0 };
+    auto decodeChunks = [&] {
+        for (int i = nextChunk++; i < decodedChunks.size(); i = nextChunk++) {
+            for (auto& decoded : decodedChunks[i]) {
+                decoded.isDecoded = EntityBinaryRecord::decode(decoded.record, decoded.entityID, decoded.properties,
+                                                               isOlderVersion);
+            }
+        }
+    };
+
+    int numThreads = std::min(QThread::idealThreadCount(), decodedChunks.size()) - 1;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back(decodeChunks);
+    }
+    decodeChunks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // the entities are added in the order they were written, from this thread
+    QScriptEngine scriptEngine;
+    for (auto& decodedChunk : decodedChunks) {
+        for (auto& decoded : decodedChunk) {
+            if (!decoded.isDecoded && EntityBinaryRecord::isJSON(decoded.record)) {
+                decoded.isDecoded = EntityBinaryRecord::decodeJSON(decoded.record, decoded.entityID, decoded.properties,
+                                                                   scriptEngine);
+            }
+            if (!decoded.isDecoded && isOlderVersion) {
+                qCritical() << "binary snapshot has entity version" << (int)version << "and an Entity that can't be"
+                    << "read by version" << (int)expectedVersion();
+                return false;
+            }
+            if (!decoded.isDecoded) {
+                qCDebug(entities) << "skipping an Entity that could not be decoded from the binary snapshot";
+                continue;
+            }
+
+            EntityItemPointer entity = addEntity(decoded.entityID, decoded.properties);
+            if (!entity) {
+                qCDebug(entities) << "adding Entity failed:" << decoded.entityID << decoded.properties.getType();
+            }
+        }
+    }
+
+    return true;
+}
+
+EntityTreeSnapshotPointer EntityTree::takeSnapshot() {
+    QMutexLocker snapshotLocker(&_snapshotLock);
+
+    auto snapshot = std::make_shared<EntityTreeSnapshot>(++_snapshotEpoch, _latestSnapshot);
+
+    quint64 lockWaitStart = usecTimestampNow();
+    quint64 lockStart;
+    withReadLock([&] {
+        lockStart = usecTimestampNow();
+        for (auto it = _entityToElementMap.constBegin(); it != _entityToElementMap.constEnd(); ++it) {
+            EntityItemPointer entity = it.value()->getEntityWithEntityItemID(it.key());
+            if (entity) {
+                snapshot->addEntity(*entity);
+            }
+        }
+    });
+    quint64 lockEnd = usecTimestampNow();
+
+    snapshot->finish();
+    _latestSnapshot = snapshot;
+
+    _snapshotLockWaitTime = lockStart - lockWaitStart;
+    _snapshotLockHoldTime = lockEnd - lockStart;
+    _snapshotNumShared = snapshot->getNumShared();
+    _snapshotNumEntities = snapshot->getNumEntities();
+
+    return _latestSnapshot;
+}
+
+bool EntityTree::enableJournal() {
+    _wantJournal = true;
+    return true;
+}
+
+void EntityTree::journalEntityChange(const EntityItemID& entityID, bool deleted) {
+    if (_wantJournal) {
+        QMutexLocker locker(&_journalLock);
+        _journaledChanges[entityID] = deleted;
+    }
+}
+
+void EntityTree::discardJournal() {
+    QMutexLocker locker(&_journalLock);
+    _journalCleared = false;
+    _journaledChanges.clear();
+}
+
+void EntityTree::takeJournalRecords(QVariantList& records) {
+    // only the IDs are recorded on the edit path, the properties are read here on the persist thread
+    bool cleared;
+    QHash<EntityItemID, bool> changes;
+    {
+        QMutexLocker locker(&_journalLock);
+        cleared = _journalCleared;
+        _journalCleared = false;
+        changes.swap(_journaledChanges);
+    }
+
+    if (cleared) {
+        QVariantMap record;
+        record["op"] = "clear";
+        records << record;
+    }
+
+    QScriptEngine scriptEngine;
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        EntityItemPointer entity = it.value() ? EntityItemPointer() : findEntityByEntityItemID(it.key());
+
+        QVariantMap record;
+        if (entity) {
+            // every property is kept so that replaying the record leaves the entity exactly as it is now
+            record["op"] = "set";
+            record["entity"] = EntityItemPropertiesToScriptValue(&scriptEngine, entity->getProperties()).toVariant();
+        } else {
+            record["op"] = "delete";
+            record["id"] = it.key().toString();
+        }
+        records << record;
+    }
+}
+
+void EntityTree::readJournalRecord(const QVariantMap& record) {
+    QString op = record["op"].toString();
+
+    if (op == "clear") {
+        eraseAllOctreeElements();
+    } else if (op == "delete") {
+        deleteEntity(EntityItemID(QUuid(record["id"].toString())), true, true);
+    } else if (op == "set") {
+        QVariantMap entityMap = record["entity"].toMap();
+        QScriptEngine scriptEngine;
+        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+        EntityItemProperties properties;
+        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+        // the record has every property, so the entity is re-created rather than edited
+        EntityItemID entityItemID(QUuid(entityMap["id"].toString()));
+        deleteEntity(entityItemID, true, true);
+        if (!addEntity(entityItemID, properties)) {
+            qCDebug(entities) << "replaying journaled Entity failed:" << entityItemID << properties.getType();
+        }
+    } else {
+        qCDebug(entities) << "unknown Entity journal record:" << op;
+    }
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
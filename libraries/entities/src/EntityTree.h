@@ -12,7 +12,13 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+#include <functional>
+
+#include <QHash>
+#include <QMutex>
 #include <QSet>
+#include <QThreadPool>
 #include <QVector>
 
 #include <Octree.h>
@@ -23,6 +29,10 @@ typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EntityEncodeCache.h"
+#include "EntityQueryBatch.h"
+#include "EntitySpatialIndex.h"
+#include "EntityTreeSnapshot.h"
 
 class Model;
 class EntitySimulation;
@@ -80,6 +90,9 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual int decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     OctreeDecodedEditPointer& edit) override;
+    virtual void applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& senderNode) override;
 
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         OctreeElementPointer& node, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
@@ -144,6 +157,13 @@ public:
     /// \remark Side effect: any initial contents in entities will be lost
     void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities);
 
+    /// runs every query of the batch on the query threads and the calling thread, and blocks until they are done.
+    /// the tree is read locked for the whole batch, so every query sees the tree as it was when the batch started
+    void runQueryBatch(EntityQueryBatchPointer batch);
+
+    /// runs the batch on the query threads without blocking, then calls finished from one of them
+    void startQueryBatch(EntityQueryBatchPointer batch, std::function<void()> finished);
+
     void addNewlyCreatedHook(NewlyCreatedEntityHook* hook);
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
@@ -163,7 +183,7 @@ public:
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
-    int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
+    int decodeEraseMessageDetails(const QByteArray& buffer, QSet<EntityItemID>& entityItemIDs);
 
     EntityItemFBXService* getFBXService() const { return _fbxService; }
     void setFBXService(EntityItemFBXService* service) { _fbxService = service; }
@@ -201,6 +221,24 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
 
+    virtual bool writeToBinaryRecords(QVector<QByteArray>& records, OctreeElementPointer element) override;
+    virtual bool readFromBinaryChunks(const QVector<QByteArray>& chunks, PacketVersion version) override;
+
+    /// An immutable copy of every entity as it is now. The tree is only locked while the entities that changed since
+    /// the last snapshot are copied, readers can then take as long as they need with it.
+    EntityTreeSnapshotPointer takeSnapshot();
+
+    // stats for the last snapshot taken
+    quint64 getSnapshotLockWaitTime() const { return _snapshotLockWaitTime; }
+    quint64 getSnapshotLockHoldTime() const { return _snapshotLockHoldTime; }
+    int getSnapshotNumShared() const { return _snapshotNumShared; }
+    int getSnapshotNumEntities() const { return _snapshotNumEntities; }
+
+    virtual bool enableJournal() override;
+    virtual void takeJournalRecords(QVariantList& records) override;
+    virtual void discardJournal() override;
+    virtual void readJournalRecord(const QVariantMap& record) override;
+
     float getContentsLargestDimension();
 
     virtual void resetEditStats() override {
@@ -230,6 +268,17 @@ public:
 
     EntityTreePointer getThisPointer() { return std::static_pointer_cast<EntityTree>(shared_from_this()); }
 
+    /// encodings of entities shared by the send threads of every viewer - only used in server trees
+    EntityEncodeCache& getEncodeCache() { return _encodeCache; }
+
+    /// bounding volume hierarchy that serves findEntities(), findClosestEntity() and findRayIntersection()
+    EntitySpatialIndex& getSpatialIndex() { return _spatialIndex; }
+
+    /// while off, the spatial index isn't kept up to date and queries recurse the octree instead - on by default.
+    /// turning it on indexes every entity in the tree, so the caller must hold the write lock
+    void setWantSpatialIndex(bool wantSpatialIndex);
+    bool getWantSpatialIndex() const { return _spatialIndex.isEnabled(); }
+
     bool isDeletedEntity(const QUuid& id) {
         QReadLocker locker(&_deletedEntitiesLock);
         return _deletedEntityItemIDs.contains(id);
@@ -255,8 +304,16 @@ protected:
     static bool findInSphereOperation(OctreeElementPointer element, void* extraData);
     static bool findInCubeOperation(OctreeElementPointer element, void* extraData);
     static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
+    static bool addToSpatialIndexOperation(OctreeElementPointer element, void* extraData);
     static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
 
+    // NOTE: assumes caller has handled locking
+    friend class EntityQueryBatch;
+    bool findRayIntersectionWorker(const glm::vec3& origin, const glm::vec3& direction, OctreeElementPointer& element,
+                                   float& distance, BoxFace& face, glm::vec3& surfaceNormal,
+                                   const QVector<EntityItemID>& entityIdsToInclude, void** intersectedObject,
+                                   bool precisionPicking);
+
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
     QReadWriteLock _newlyCreatedHooksLock;
@@ -299,6 +356,30 @@ protected:
     quint64 _totalCreateTime = 0;
     quint64 _totalLoggingTime = 0;
 
+    EntityEncodeCache _encodeCache;
+
+    EntitySpatialIndex _spatialIndex;
+
+    QThreadPool _queryThreadPool; // runs query batches, and helps with the queries of blocking ones
+
+    QMutex _snapshotLock; // one snapshot is taken at a time
+    // unchanged entities in the next snapshot are shared with this one. Keeping it means a copy of the properties of
+    // every entity stays alive between snapshots, but the peak is no higher than a full copy: taking the next one only
+    // adds the entities edited since.
+    EntityTreeSnapshotPointer _latestSnapshot;
+    quint64 _snapshotEpoch { 0 };
+    std::atomic<quint64> _snapshotLockWaitTime { 0 };
+    std::atomic<quint64> _snapshotLockHoldTime { 0 };
+    std::atomic<int> _snapshotNumShared { 0 };
+    std::atomic<int> _snapshotNumEntities { 0 };
+
+    // entities added, edited or deleted since the persist thread last took the journal records - only used in server trees
+    void journalEntityChange(const EntityItemID& entityID, bool deleted);
+    std::atomic<bool> _wantJournal { false };
+    QMutex _journalLock;
+    bool _journalCleared { false };
+    QHash<EntityItemID, bool> _journaledChanges; // entity ID to whether it was deleted
+
     // these performance statistics are only used in the client
     void resetClientEditStats();
     int _totalTrackedEdits = 0;
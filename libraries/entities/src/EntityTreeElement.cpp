@@ -322,7 +322,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
+                OctreeElement::AppendState appendEntityState = appendEntityData(entity, packetData,
                     params, entityTreeElementExtraEncodeData);
 
                 // If none of this entity data was able to be appended, then discard it
@@ -412,6 +412,44 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     return appendElementState;
 }
 
+OctreeElement::AppendState EntityTreeElement::appendEntityData(EntityItemPointer entity, OctreePacketData* packetData,
+                                                EncodeBitstreamParams& params,
+                                                EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const {
+
+    // Only the entity server shares encodings between its viewers. An entity that was partially sent to this viewer
+    // is only asked for the properties that didn't fit, and that encoding is particular to this viewer.
+    bool useEncodeCache = _myTree && _myTree->getIsServer();
+    if (useEncodeCache && entityTreeElementExtraEncodeData->entities.contains(entity->getEntityItemID())) {
+        useEncodeCache = entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID()) ==
+            entity->getEntityProperties(params);
+    }
+
+    if (!useEncodeCache) {
+        return entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+    }
+
+    EntityEncodeCache& encodeCache = _myTree->getEncodeCache();
+    EntityEncodeCache::Version version = EntityEncodeCache::versionOf(*entity);
+
+    QByteArray encoded;
+    if (encodeCache.find(entity->getEntityItemID(), version, encoded) && packetData->appendRawData(encoded)) {
+        params.trackSend(entity->getID(), entity->getLastEdited());
+        return OctreeElement::COMPLETED;
+    }
+
+    // if the cached encoding didn't fit, appendEntityData will work out how much of the entity does
+    int entityStart = packetData->getUncompressedByteOffset();
+    OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData, params,
+        entityTreeElementExtraEncodeData);
+
+    if (appendEntityState == OctreeElement::COMPLETED && encoded.isEmpty()) {
+        int entityEnd = packetData->getUncompressedByteOffset();
+        encodeCache.insert(entity->getEntityItemID(), version,
+            QByteArray((const char*)packetData->getUncompressedData(entityStart), entityEnd - entityStart));
+    }
+    return appendEntityState;
+}
+
 bool EntityTreeElement::containsEntityBounds(EntityItemPointer entity) const {
     return containsBounds(entity->getMaximumAACube());
 }
@@ -519,72 +557,81 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
                                     const QVector<EntityItemID>& entityIdsToInclude, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
-    int entityNumber = 0;
     bool somethingIntersected = false;
     forEachEntity([&](EntityItemPointer entity) {
         if (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) {
             return;
         }
 
-        AABox entityBox = entity->getAABox();
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
-
-        // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
-            return;
+        if (findEntityRayIntersection(entity, origin, direction, keepSearching, element, distance, face, surfaceNormal,
+                                      intersectedObject, precisionPicking)) {
+            somethingIntersected = true;
         }
+    });
+    return somethingIntersected;
+}
 
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-        glm::mat4 translation = glm::translate(entity->getPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-        glm::vec3 dimensions = entity->getDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
-
-        AABox entityFrameBox(corner, dimensions);
-
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
-
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance, 
-                                                localFace, localSurfaceNormal)) {
-            if (localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
-                    if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
-                        localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
-
-                        if (localDistance < distance) {
-                            distance = localDistance;
-                            face = localFace;
-                            surfaceNormal = localSurfaceNormal;
-                            *intersectedObject = (void*)entity.get();
-                            somethingIntersected = true;
-                        }
-                    }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle effect entities
-                    if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
+bool EntityTreeElement::findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                                    const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element,
+                                    float& distance, BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject,
+                                    bool precisionPicking) {
+    AABox entityBox = entity->getAABox();
+    float localDistance;
+    BoxFace localFace;
+    glm::vec3 localSurfaceNormal;
+
+    // if the ray doesn't intersect with our cube, we can stop searching!
+    if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+        return false;
+    }
+
+    // extents is the entity relative, scaled, centered extents of the entity
+    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+    glm::mat4 translation = glm::translate(entity->getPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+
+    glm::vec3 dimensions = entity->getDimensions();
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
+
+    AABox entityFrameBox(corner, dimensions);
+
+    glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+    glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+    // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+    // and testing intersection there.
+    if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance, 
+                                            localFace, localSurfaceNormal)) {
+        if (localDistance < distance) {
+            // now ask the entity if we actually intersect
+            if (entity->supportsDetailedRayIntersection()) {
+                if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
+                    localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+
+                    if (localDistance < distance) {
                         distance = localDistance;
                         face = localFace;
                         surfaceNormal = localSurfaceNormal;
                         *intersectedObject = (void*)entity.get();
-                        somethingIntersected = true;
+                        return true;
                     }
                 }
+            } else {
+                // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                // Never intersect with particle effect entities
+                if (localDistance < distance && EntityTypes::getEntityTypeName(entity->getType()) != "ParticleEffect") {
+                    distance = localDistance;
+                    face = localFace;
+                    surfaceNormal = localSurfaceNormal;
+                    *intersectedObject = (void*)entity.get();
+                    return true;
+                }
             }
         }
-        entityNumber++;
-    });
-    return somethingIntersected;
+    }
+    return false;
 }
 
 // TODO: change this to use better bounding shape for entity than sphere
@@ -630,51 +677,53 @@ EntityItemPointer EntityTreeElement::getClosestEntity(glm::vec3 position) const
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<EntityItemPointer>& foundEntities) const {
     forEachEntity([&](EntityItemPointer entity) {
+        if (entityTouchesSphere(entity, searchPosition, searchRadius)) {
+            foundEntities.push_back(entity);
+        }
+    });
+}
 
-        AABox entityBox = entity->getAABox();
+bool EntityTreeElement::entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& searchPosition, float searchRadius) {
+    AABox entityBox = entity->getAABox();
 
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
+    // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
+    glm::vec3 penetration;
+    if (!entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
+        return false;
+    }
 
-            glm::vec3 dimensions = entity->getDimensions();
+    glm::vec3 dimensions = entity->getDimensions();
 
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably dull actuall hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
-                (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
+    // FIXME - consider allowing the entity to determine penetration so that
+    //         entities could presumably dull actuall hull testing if they wanted to
+    // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
+    //         can we handle the ellipsoid case better? We only currently handle perfect spheres
+    //         with centered registration points
+    if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
+        (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
 
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
+        // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
+        //       maximum bounding sphere, which is actually larger than our actual radius
+        float entityTrueRadius = dimensions.x / 2.0f;
 
-                if (findSphereSpherePenetration(searchPosition, searchRadius, 
-                        entity->getCenterPosition(), entityTrueRadius, penetration)) {
-                    foundEntities.push_back(entity);
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-                glm::mat4 translation = glm::translate(entity->getPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+        return findSphereSpherePenetration(searchPosition, searchRadius,
+                                           entity->getCenterPosition(), entityTrueRadius, penetration);
+    }
 
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
+    // determine the worldToEntityMatrix that doesn't include scale because
+    // we're going to use the registration aware aa box in the entity frame
+    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+    glm::mat4 translation = glm::translate(entity->getPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-                AABox entityFrameBox(corner, dimensions);
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
 
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
-                    foundEntities.push_back(entity);
-                }
-            }
-        }
-    });
+    AABox entityFrameBox(corner, dimensions);
+
+    glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
+    return entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration);
 }
 
 void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
@@ -847,6 +896,9 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                     bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
                     if (entityItem->getDirtyFlags()) {
                         _myTree->entityChanged(entityItem);
+                    } else {
+                        // the dirty flags are only for the simulation, the entity may still have moved
+                        _myTree->getSpatialIndex().updateEntity(entityItem);
                     }
                     bool bestFitAfter = bestFitEntityBounds(entityItem);
 
@@ -153,6 +153,14 @@ public:
     virtual bool findSpherePenetration(const glm::vec3& center, float radius,
                         glm::vec3& penetration, void** penetratedObject) const;
 
+    /// intersects a ray with a single entity, only reports the intersection if it is closer than distance
+    static bool findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                        const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element, float& distance,
+                        BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject, bool precisionPicking);
+
+    /// \return true if the entity touches the sphere, the test used by getEntities(position, radius)
+    static bool entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+
 
     template <typename F>
     void forEachEntity(F f) const {
@@ -231,6 +239,12 @@ public:
 
 protected:
     virtual void init(unsigned char * octalCode);
+
+    /// appends one entity, re-using its encoding from the tree's encode cache when the whole entity is being sent
+    OctreeElement::AppendState appendEntityData(EntityItemPointer entity, OctreePacketData* packetData,
+                                                EncodeBitstreamParams& params,
+                                                EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const;
+
     EntityTreePointer _myTree;
     EntityItems _entityItems;
 };
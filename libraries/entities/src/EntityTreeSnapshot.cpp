@@ -0,0 +1,75 @@
+//
+//  EntityTreeSnapshot.cpp
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/6/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtScript/QScriptEngine>
+
+#include "EntityBinaryRecord.h"
+#include "EntityItem.h"
+
+#include "EntityTreeSnapshot.h"
+
+EntityTreeSnapshot::EntityTreeSnapshot(quint64 epoch, EntityTreeSnapshotPointer previous) :
+    _epoch(epoch),
+    _previous(previous)
+{
+    if (_previous) {
+        _entries.reserve(_previous->_entries.size());
+    }
+}
+
+void EntityTreeSnapshot::addEntity(const EntityItem& entity) {
+    EntityItemID entityID = entity.getEntityItemID();
+    EntityEncodeCache::Version version = EntityEncodeCache::versionOf(entity);
+
+    if (_previous) {
+        auto it = _previous->_entries.constFind(entityID);
+        if (it != _previous->_entries.constEnd() && it->version == version) {
+            // unchanged, both epochs point at the same properties
+            _entries.insert(entityID, *it);
+            ++_numShared;
+            return;
+        }
+    }
+
+    _entries.insert(entityID, { version, std::make_shared<const EntityItemProperties>(entity.getProperties()) });
+}
+
+EntityTreeSnapshot::PropertiesPointer EntityTreeSnapshot::getProperties(const EntityItemID& entityID) const {
+    auto it = _entries.constFind(entityID);
+    return it != _entries.constEnd() ? it->properties : PropertiesPointer();
+}
+
+void EntityTreeSnapshot::writeToMap(QVariantMap& map, bool skipDefaultValues) const {
+    QVariantList entitiesQList = qvariant_cast<QVariantList>(map["Entities"]);
+    entitiesQList.reserve(entitiesQList.size() + _entries.size());
+
+    QScriptEngine scriptEngine;
+    foreach (const Entry& entry, _entries) {
+        QScriptValue qScriptValues;
+        if (skipDefaultValues) {
+            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, *entry.properties);
+        } else {
+            qScriptValues = EntityItemPropertiesToScriptValue(&scriptEngine, *entry.properties);
+        }
+        entitiesQList << qScriptValues.toVariant();
+    }
+
+    map["Entities"] = entitiesQList;
+}
+
+void EntityTreeSnapshot::writeToBinaryRecords(QVector<QByteArray>& records) const {
+    records.reserve(records.size() + _entries.size());
+
+    QScriptEngine scriptEngine;
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); ++it) {
+        records << EntityBinaryRecord::encode(it.key(), *it->properties, scriptEngine);
+    }
+}
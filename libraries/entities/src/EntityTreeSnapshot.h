@@ -0,0 +1,68 @@
+//
+//  EntityTreeSnapshot.h
+//  libraries/entities/src
+//
+//  Created by High Fidelity on 2/6/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshot_h
+#define hifi_EntityTreeSnapshot_h
+
+#include <memory>
+
+#include <QtCore/QHash>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+#include "EntityEncodeCache.h"
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+class EntityTreeSnapshot;
+using EntityTreeSnapshotPointer = std::shared_ptr<const EntityTreeSnapshot>;
+
+/// An immutable copy of the properties of every entity in an EntityTree at one point in time (its epoch).
+/// Entities that have not changed since the previous snapshot share their properties with it, so only edited
+/// entities are copied while the tree is locked. Readers hold on to a snapshot for as long as they need it without
+/// holding the tree lock, and an epoch is freed once its last reader lets go of it.
+class EntityTreeSnapshot {
+public:
+    using PropertiesPointer = std::shared_ptr<const EntityItemProperties>;
+
+    EntityTreeSnapshot(quint64 epoch, EntityTreeSnapshotPointer previous);
+
+    /// adds the entity as it is now, call with the tree locked
+    void addEntity(const EntityItem& entity);
+
+    /// call once every entity is added, lets go of the previous epoch
+    void finish() { _previous.reset(); }
+
+    quint64 getEpoch() const { return _epoch; }
+    int getNumEntities() const { return _entries.size(); }
+    int getNumShared() const { return _numShared; } // entities whose properties came from the previous epoch
+
+    PropertiesPointer getProperties(const EntityItemID& entityID) const;
+
+    /// appends every entity to the "Entities" list of the map, the same way EntityTree::writeToMap does
+    void writeToMap(QVariantMap& map, bool skipDefaultValues) const;
+
+    /// appends an EntityBinaryRecord for every entity, for a binary snapshot
+    void writeToBinaryRecords(QVector<QByteArray>& records) const;
+
+private:
+    struct Entry {
+        EntityEncodeCache::Version version;
+        PropertiesPointer properties;
+    };
+
+    quint64 _epoch;
+    EntityTreeSnapshotPointer _previous;
+    QHash<EntityItemID, Entry> _entries;
+    int _numShared { 0 };
+};
+
+#endif // hifi_EntityTreeSnapshot_h
@@ -0,0 +1,159 @@
+//
+//  Blendshapes.cpp
+//  libraries/model-networking/src/model-networking
+//
+//  Created by High Fidelity on 2/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "Blendshapes.h"
+
+// zero deltas are cheaper to apply than the overhead of starting another run
+static const int MAX_RUN_GAP = 4;
+
+static const int FLOATS_PER_VERTEX = 3;
+
+// blendshapes with a smaller coefficient are skipped
+static const float MIN_COEFFICIENT = 0.0001f;
+static const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+
+//
+// output[i] += input[i] * scale
+//
+static void addScaledScalar(const float* input, float* output, int count, float scale) {
+    for (int i = 0; i < count; i++) {
+        output[i] += input[i] * scale;
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <xmmintrin.h>
+
+static void addScaled(const float* input, float* output, int count, float scale) {
+    __m128 s = _mm_set1_ps(scale);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(&output[i]), _mm_mul_ps(_mm_loadu_ps(&input[i]), s));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(&output[i + 4]), _mm_mul_ps(_mm_loadu_ps(&input[i + 4]), s));
+        _mm_storeu_ps(&output[i], a);
+        _mm_storeu_ps(&output[i + 4], b);
+    }
+
+    addScaledScalar(input + i, output + i, count - i, scale);
+}
+
+#else
+
+static void addScaled(const float* input, float* output, int count, float scale) {
+    addScaledScalar(input, output, count, scale);
+}
+
+#endif
+
+PackedBlendshapes::PackedBlendshapes(const FBXGeometry& geometry) {
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        if (mesh.blendshapes.isEmpty()) {
+            continue;
+        }
+        int meshOffset = _numVertices;
+        int numMeshVertices = mesh.vertices.size();
+        _vertices += mesh.vertices;
+        _normals += mesh.normals;
+        _normals.resize(_vertices.size());
+        _numVertices += numMeshVertices;
+
+        if ((int)_runs.size() < mesh.blendshapes.size()) {
+            _runs.resize(mesh.blendshapes.size());
+        }
+
+        for (int i = 0; i < mesh.blendshapes.size(); i++) {
+            const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+            std::vector<Run>& runs = _runs[i];
+
+            // walk the vertices the blendshape moves in order, starting a new run where the gap to the last is too big
+            std::vector<int> order;
+            order.reserve(blendshape.indices.size());
+            for (int j = 0; j < blendshape.indices.size(); j++) {
+                int index = blendshape.indices.at(j);
+                if (index >= 0 && index < numMeshVertices) {
+                    order.push_back(j);
+                }
+            }
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return blendshape.indices.at(a) < blendshape.indices.at(b);
+            });
+
+            Run* run = nullptr;
+            for (int j : order) {
+                int vertex = meshOffset + blendshape.indices.at(j);
+                int runEnd = run ? run->firstVertex + run->numVertices : 0;
+                if (!run || vertex >= runEnd + MAX_RUN_GAP) {
+                    runs.push_back({ vertex, 0, (int)_vertexDeltas.size() });
+                    run = &runs.back();
+                    runEnd = vertex;
+                }
+                if (vertex >= runEnd) {
+                    int numNewVertices = vertex + 1 - runEnd;
+                    _vertexDeltas.resize(_vertexDeltas.size() + numNewVertices * FLOATS_PER_VERTEX, 0.0f);
+                    _normalDeltas.resize(_normalDeltas.size() + numNewVertices * FLOATS_PER_VERTEX, 0.0f);
+                    run->numVertices += numNewVertices;
+                }
+
+                // an index can be listed more than once, its deltas add up
+                int delta = run->firstDelta + (vertex - run->firstVertex) * FLOATS_PER_VERTEX;
+                glm::vec3 vertexDelta = blendshape.vertices.value(j);
+                glm::vec3 normalDelta = blendshape.normals.value(j);
+                for (int k = 0; k < FLOATS_PER_VERTEX; k++) {
+                    _vertexDeltas[delta + k] += vertexDelta[k];
+                    _normalDeltas[delta + k] += normalDelta[k];
+                }
+            }
+        }
+    }
+}
+
+void PackedBlendshapes::blend(const QVector<float>& coefficients, int beginVertex, int endVertex,
+                              glm::vec3* vertices, glm::vec3* normals) const {
+    std::copy(_vertices.constData() + beginVertex, _vertices.constData() + endVertex, vertices + beginVertex);
+    std::copy(_normals.constData() + beginVertex, _normals.constData() + endVertex, normals + beginVertex);
+
+    for (int i = 0, n = std::min(coefficients.size(), (int)_runs.size()); i < n; i++) {
+        float vertexCoefficient = coefficients.at(i);
+        if (vertexCoefficient < MIN_COEFFICIENT) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+
+        // skip to the first run that ends past the beginning of the range
+        const std::vector<Run>& runs = _runs[i];
+        auto run = std::lower_bound(runs.begin(), runs.end(), beginVertex, [](const Run& run, int vertex) {
+            return run.firstVertex + run.numVertices <= vertex;
+        });
+        for (; run != runs.end() && run->firstVertex < endVertex; ++run) {
+            int firstVertex = std::max(run->firstVertex, beginVertex);
+            int lastVertex = std::min(run->firstVertex + run->numVertices, endVertex);
+            int numFloats = (lastVertex - firstVertex) * FLOATS_PER_VERTEX;
+            int delta = run->firstDelta + (firstVertex - run->firstVertex) * FLOATS_PER_VERTEX;
+
+            addScaled(&_vertexDeltas[delta], (float*)(vertices + firstVertex), numFloats, vertexCoefficient);
+            addScaled(&_normalDeltas[delta], (float*)(normals + firstVertex), numFloats, normalCoefficient);
+        }
+    }
+}
+
+void PackedBlendshapes::blend(const QVector<float>& coefficients,
+                              QVector<glm::vec3>& vertices, QVector<glm::vec3>& normals) const {
+    vertices.resize(_numVertices);
+    normals.resize(_numVertices);
+    blend(coefficients, 0, _numVertices, vertices.data(), normals.data());
+}
@@ -0,0 +1,68 @@
+//
+//  Blendshapes.h
+//  libraries/model-networking/src/model-networking
+//
+//  Created by High Fidelity on 2/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Blendshapes_h
+#define hifi_Blendshapes_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <FBXReader.h>
+
+/// The blendshapes of the meshes of a geometry, packed for blending.
+///
+/// The vertices of the meshes that have blendshapes are laid end to end, in the order of the meshes, which is the
+/// layout Model uploads to its blended vertex buffers. Each blendshape is stored as runs of consecutive vertices, with
+/// the deltas of a run in a flat float array laid out like the vertices they apply to, so that applying a run is a
+/// vectorized multiply-add. Small gaps between the vertices a blendshape moves are filled with zero deltas to make
+/// longer runs.
+///
+/// Once built the blendshapes don't change, so any number of threads can blend them at once, each into its own range
+/// of vertices.
+class PackedBlendshapes {
+public:
+    explicit PackedBlendshapes(const FBXGeometry& geometry);
+
+    /// the number of vertices in the meshes that have blendshapes
+    int getNumVertices() const { return _numVertices; }
+
+    /// blends the vertices and normals in [beginVertex, endVertex) with the coefficients of the blendshapes. vertices
+    /// and normals hold getNumVertices() elements, and only the given range is written.
+    void blend(const QVector<float>& coefficients, int beginVertex, int endVertex,
+               glm::vec3* vertices, glm::vec3* normals) const;
+
+    void blend(const QVector<float>& coefficients, QVector<glm::vec3>& vertices, QVector<glm::vec3>& normals) const;
+
+private:
+    struct Run {
+        int firstVertex;
+        int numVertices;
+        int firstDelta; // the index in _vertexDeltas and _normalDeltas of the first float of the run
+    };
+
+    // the runs of each blendshape index, across all the meshes, sorted by first vertex
+    std::vector<std::vector<Run>> _runs;
+
+    std::vector<float> _vertexDeltas;
+    std::vector<float> _normalDeltas;
+
+    QVector<glm::vec3> _vertices;
+    QVector<glm::vec3> _normals;
+    int _numVertices { 0 };
+};
+
+using PackedBlendshapesPointer = std::shared_ptr<const PackedBlendshapes>;
+
+#endif // hifi_Blendshapes_h
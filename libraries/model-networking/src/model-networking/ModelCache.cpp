@@ -44,6 +44,84 @@ QSharedPointer<Resource> ModelCache::createResource(const QUrl& url, const QShar
     return QSharedPointer<Resource>();
 }
 
+static int getNumIndices(const FBXGeometry& geometry) {
+    int numIndices = 0;
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        foreach (const FBXMeshPart& part, mesh.parts) {
+            numIndices += part.quadIndices.size() + part.triangleIndices.size();
+        }
+    }
+    return numIndices;
+}
+
+static MeshPickBVHs buildMeshPickBVHs(const FBXGeometry& geometry) {
+    const int INDICES_PER_TRIANGLE = 3;
+    const int INDICES_PER_QUAD = 4;
+
+    MeshPickBVHs bvhs;
+    bvhs.reserve(geometry.meshes.size());
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        // the triangles are in the frame of the geometry, models map rays into it with their own offset and transform
+        std::vector<glm::vec3> vertices;
+        vertices.reserve(mesh.vertices.size());
+        foreach (const glm::vec3& vertex, mesh.vertices) {
+            vertices.push_back(glm::vec3(mesh.modelTransform * glm::vec4(vertex, 1.0f)));
+        }
+
+        std::vector<Triangle> triangles;
+        foreach (const FBXMeshPart& part, mesh.parts) {
+            int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
+            for (int q = 0; q < numberOfQuads; q++) {
+                const glm::vec3& v0 = vertices[part.quadIndices[q * INDICES_PER_QUAD]];
+                const glm::vec3& v1 = vertices[part.quadIndices[q * INDICES_PER_QUAD + 1]];
+                const glm::vec3& v2 = vertices[part.quadIndices[q * INDICES_PER_QUAD + 2]];
+                const glm::vec3& v3 = vertices[part.quadIndices[q * INDICES_PER_QUAD + 3]];
+                triangles.push_back({ v0, v1, v3 });
+                triangles.push_back({ v1, v2, v3 });
+            }
+
+            int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
+            for (int t = 0; t < numberOfTris; t++) {
+                const glm::vec3& v0 = vertices[part.triangleIndices[t * INDICES_PER_TRIANGLE]];
+                const glm::vec3& v1 = vertices[part.triangleIndices[t * INDICES_PER_TRIANGLE + 1]];
+                const glm::vec3& v2 = vertices[part.triangleIndices[t * INDICES_PER_TRIANGLE + 2]];
+                triangles.push_back({ v0, v1, v2 });
+            }
+        }
+        bvhs.emplace_back(std::move(triangles));
+    }
+    return bvhs;
+}
+
+MeshPickBVHsPointer ModelCache::getMeshPickBVHs(const NetworkGeometry& geometry) {
+    const FBXGeometry& fbxGeometry = geometry.getFBXGeometry();
+    int numIndices = getNumIndices(fbxGeometry);
+    {
+        QMutexLocker locker(&_meshPickBVHsMutex);
+        auto cached = _meshPickBVHs.find(geometry.getURL());
+        if (cached != _meshPickBVHs.end() && cached->numIndices == numIndices) {
+            if (auto bvhs = cached->bvhs.lock()) {
+                return bvhs;
+            }
+        }
+    }
+
+    // build outside of the lock, a large model takes a while and other models may want theirs in the meantime
+    auto bvhs = std::make_shared<MeshPickBVHs>(buildMeshPickBVHs(fbxGeometry));
+
+    QMutexLocker locker(&_meshPickBVHsMutex);
+    CachedMeshPickBVHs& cached = _meshPickBVHs[geometry.getURL()];
+    if (cached.numIndices == numIndices) {
+        // another model with this URL may have built them at the same time, share theirs
+        if (auto otherBVHs = cached.bvhs.lock()) {
+            return otherBVHs;
+        }
+    }
+    cached.bvhs = bvhs;
+    cached.numIndices = numIndices;
+    return bvhs;
+}
+
 
 GeometryReader::GeometryReader(const QUrl& url, const QByteArray& data, const QVariantHash& mapping) :
     _url(url),
@@ -143,6 +221,27 @@ bool NetworkGeometry::isLoadedWithTextures() const {
     return true;
 }
 
+MeshPickBVHsPointer NetworkGeometry::getMeshPickBVHs() const {
+    QMutexLocker locker(&_meshPickBVHsMutex);
+    if (!_meshPickBVHs) {
+        auto modelCache = DependencyManager::get<ModelCache>();
+        if (modelCache) {
+            _meshPickBVHs = modelCache->getMeshPickBVHs(*this);
+        } else {
+            _meshPickBVHs = std::make_shared<MeshPickBVHs>(buildMeshPickBVHs(*_geometry));
+        }
+    }
+    return _meshPickBVHs;
+}
+
+PackedBlendshapesPointer NetworkGeometry::getPackedBlendshapes() const {
+    QMutexLocker locker(&_packedBlendshapesMutex);
+    if (!_packedBlendshapes) {
+        _packedBlendshapes = std::make_shared<PackedBlendshapes>(*_geometry);
+    }
+    return _packedBlendshapes;
+}
+
 void NetworkGeometry::setTextureWithNameToURL(const QString& name, const QUrl& url) {
 
 
@@ -12,12 +12,17 @@
 #ifndef hifi_ModelCache_h
 #define hifi_ModelCache_h
 
+#include <memory>
+
 #include <QMap>
+#include <QMutex>
 #include <QRunnable>
 
 #include <DependencyManager.h>
 #include <ResourceCache.h>
+#include <TriangleBVH.h>
 
+#include "Blendshapes.h"
 #include "FBXReader.h"
 #include "OBJReader.h"
 
@@ -34,6 +39,10 @@ class NetworkTexture;
 class NetworkMaterial;
 class NetworkShape;
 
+/// The triangles of each mesh of a geometry, in the frame of the geometry, for precision picking.
+using MeshPickBVHs = std::vector<TriangleBVH>;
+using MeshPickBVHsPointer = std::shared_ptr<const MeshPickBVHs>;
+
 /// Stores cached geometry.
 class ModelCache : public ResourceCache, public Dependency {
     Q_OBJECT
@@ -51,11 +60,22 @@ public:
     /// Set a batch to the simple pipeline, returning the previous pipeline
     void useSimpleDrawPipeline(gpu::Batch& batch, bool noBlend = false);
 
+    /// \return the pick hierarchies of the geometry's meshes, built the first time any model with the same URL asks
+    /// for them and shared by all of those models while any of them holds on to them
+    MeshPickBVHsPointer getMeshPickBVHs(const NetworkGeometry& geometry);
+
 private:
     ModelCache();
     virtual ~ModelCache();
 
     QHash<QUrl, QWeakPointer<NetworkGeometry> > _networkGeometry;
+
+    struct CachedMeshPickBVHs {
+        std::weak_ptr<const MeshPickBVHs> bvhs;
+        int numIndices { 0 }; // tells a geometry that was reloaded with different meshes from the one in the cache
+    };
+    QMutex _meshPickBVHsMutex;
+    QHash<QUrl, CachedMeshPickBVHs> _meshPickBVHs;
 };
 
 class NetworkGeometry : public QObject {
@@ -81,6 +101,14 @@ public:
     // WARNING: only valid when isLoaded returns true.
     const FBXGeometry& getFBXGeometry() const { return *_geometry; }
     const std::vector<std::unique_ptr<NetworkMesh>>& getMeshes() const { return _meshes; }
+
+    // WARNING: only valid when isLoaded returns true.
+    /// \return the hierarchies for ray picks against the triangles of each mesh, in the frame of the geometry
+    MeshPickBVHsPointer getMeshPickBVHs() const;
+
+    // WARNING: only valid when isLoaded returns true.
+    /// \return the blendshapes of the geometry's meshes, packed for blending
+    PackedBlendshapesPointer getPackedBlendshapes() const;
   //  const model::AssetPointer getAsset() const { return _asset; }
 
    // model::MeshPointer getShapeMesh(int shapeID);
@@ -149,6 +177,13 @@ protected:
 
     // cache for isLoadedWithTextures()
     mutable bool _isLoadedWithTextures = false;
+
+    // picks can come from any thread
+    mutable QMutex _meshPickBVHsMutex;
+    mutable MeshPickBVHsPointer _meshPickBVHs;
+
+    mutable QMutex _packedBlendshapesMutex;
+    mutable PackedBlendshapesPointer _packedBlendshapes;
 };
 
 /// Reads geometry in a worker thread.
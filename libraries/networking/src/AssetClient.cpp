@@ -224,18 +224,19 @@ void AssetClient::handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> messag
 }
 
 void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    // the rest of the message may still be arriving, which is safe to read alongside
     auto assetHash = message->read(SHA256_HASH_LENGTH);
     qCDebug(asset_client) << "Got reply for asset: " << assetHash.toHex();
 
     MessageID messageID;
-    message->readHeadPrimitive(&messageID);
+    message->readPrimitive(&messageID);
 
     AssetServerError error;
-    message->readHeadPrimitive(&error);
+    message->readPrimitive(&error);
 
     DataOffset length = 0;
     if (!error) {
-        message->readHeadPrimitive(&length);
+        message->readPrimitive(&length);
     } else {
         qCWarning(asset_client) << "Failure getting asset: " << error;
     }
@@ -131,6 +131,20 @@ void LimitedNodeList::setThisNodeCanAdjustLocks(bool canAdjustLocks) {
     }
 }
 
+void LimitedNodeList::setThisNodeIsTrusted(bool isTrusted) {
+    _thisNodeIsTrusted = isTrusted;
+}
+
+NLPacket::HashType LimitedNodeList::verificationHashTypeForNode(const Node& node) const {
+    // both ends of a connection have to come to the same answer here, from what the domain-server told each of them
+    NLPacket::HashTypes sharedHashTypes = NLPacket::SUPPORTED_HASH_TYPES & node.getSupportedHashTypes();
+    if (sharedHashTypes & NLPacket::hashTypeMask(NLPacket::HashType::SipHash)) {
+        return NLPacket::HashType::SipHash;
+    } else {
+        return NLPacket::HashType::Md5;
+    }
+}
+
 void LimitedNodeList::setThisNodeCanRez(bool canRez) {
     if (_thisNodeCanRez != canRez) {
         _thisNodeCanRez = canRez;
@@ -204,6 +218,18 @@ bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
     }
 }
 
+bool LimitedNodeList::verificationHashMatchesNode(const udt::Packet& packet, const Node& node,
+                                                  bool thisNodeIsTrusted) {
+    // node IDs are no secret, so a packet is only taken to be from a trusted node without checking its hash when it
+    // comes from where we talk to that node
+    const HifiSockAddr* activeSocket = node.getActiveSocket();
+    if (thisNodeIsTrusted && node.isTrusted() && activeSocket && *activeSocket == packet.getSenderSockAddr()) {
+        return true;
+    }
+
+    return NLPacket::verificationHashMatches(packet, node.getConnectionSecret(), node.getVerificationHashType());
+}
+
 bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
     
     PacketType headerType = NLPacket::typeInHeader(packet);
@@ -219,11 +245,8 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
                 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-            
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!verificationHashMatchesNode(packet, *matchingNode, _thisNodeIsTrusted)) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
                     
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -261,7 +284,8 @@ void LimitedNodeList::collectPacketStats(const NLPacket& packet) {
     _numCollectedBytes += packet.getDataSize();
 }
 
-void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret) {
+void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret,
+                                       NLPacket::HashType hashType) {
     if (!NON_SOURCED_PACKETS.contains(packet.getType())) {
         packet.writeSourceID(getSessionUUID());
     }
@@ -269,7 +293,7 @@ void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& conn
     if (!connectionSecret.isNull()
         && !NON_SOURCED_PACKETS.contains(packet.getType())
         && !NON_VERIFIED_PACKETS.contains(packet.getType())) {
-        packet.writeVerificationHashGivenSecret(connectionSecret);
+        packet.writeVerificationHashGivenSecret(connectionSecret, hashType);
     }
 }
 
@@ -283,17 +307,18 @@ qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const Node&
     emit dataSent(destinationNode.getType(), packet.getDataSize());
     destinationNode.recordBytesSent(packet.getDataSize());
     
-    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    return sendUnreliablePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret(),
+                                destinationNode.getVerificationHashType());
 }
 
 qint64 LimitedNodeList::sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                             const QUuid& connectionSecret) {
+                                             const QUuid& connectionSecret, NLPacket::HashType hashType) {
     Q_ASSERT(!packet.isPartOfMessage());
     Q_ASSERT_X(!packet.isReliable(), "LimitedNodeList::sendUnreliablePacket",
                "Trying to send a reliable packet unreliably.");
     
     collectPacketStats(packet);
-    fillPacketHeader(packet, connectionSecret);
+    fillPacketHeader(packet, connectionSecret, hashType);
     
     return _nodeSocket.writePacket(packet, sockAddr);
 }
@@ -306,7 +331,8 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
         emit dataSent(destinationNode.getType(), packet->getDataSize());
         destinationNode.recordBytesSent(packet->getDataSize());
         
-        return sendPacket(std::move(packet), *activeSocket, destinationNode.getConnectionSecret());
+        return sendPacket(std::move(packet), *activeSocket, destinationNode.getConnectionSecret(),
+                          destinationNode.getVerificationHashType());
     } else {
         qDebug() << "LimitedNodeList::sendPacket called without active socket for node" << destinationNode << "- not sending";
         return 0;
@@ -314,18 +340,18 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
 }
 
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                                   const QUuid& connectionSecret) {
+                                   const QUuid& connectionSecret, NLPacket::HashType hashType) {
     Q_ASSERT(!packet->isPartOfMessage());
     if (packet->isReliable()) {
         collectPacketStats(*packet);
-        fillPacketHeader(*packet, connectionSecret);
+        fillPacketHeader(*packet, connectionSecret, hashType);
         
         auto size = packet->getDataSize();
         _nodeSocket.writePacket(std::move(packet), sockAddr);
         
         return size;
     } else {
-        return sendUnreliablePacket(*packet, sockAddr, connectionSecret);
+        return sendUnreliablePacket(*packet, sockAddr, connectionSecret, hashType);
     }
 }
 
@@ -335,12 +361,13 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
     if (activeSocket) {
         qint64 bytesSent = 0;
         auto connectionSecret = destinationNode.getConnectionSecret();
+        auto hashType = destinationNode.getVerificationHashType();
         
         // close the last packet in the list
         packetList.closeCurrentPacket();
         
         while (!packetList._packets.empty()) {
-            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret);
+            bytesSent += sendPacket(packetList.takeFront<NLPacket>(), *activeSocket, connectionSecret, hashType);
         }
         
         emit dataSent(destinationNode.getType(), bytesSent);
@@ -353,14 +380,14 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const Node& des
 }
 
 qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                                       const QUuid& connectionSecret) {
+                                       const QUuid& connectionSecret, NLPacket::HashType hashType) {
     qint64 bytesSent = 0;
     
     // close the last packet in the list
     packetList.closeCurrentPacket();
     
     while (!packetList._packets.empty()) {
-        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret);
+        bytesSent += sendPacket(packetList.takeFront<NLPacket>(), sockAddr, connectionSecret, hashType);
     }
     
     return bytesSent;
@@ -388,7 +415,8 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
         for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
             NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
             collectPacketStats(*nlPacket);
-            fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret());
+            fillPacketHeader(*nlPacket, destinationNode.getConnectionSecret(),
+                             destinationNode.getVerificationHashType());
         }
         
         return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
@@ -398,6 +426,59 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
     }
 }
 
+qint64 LimitedNodeList::batchPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
+                                    udt::PacketBatch& batch) {
+    Q_ASSERT(!packet->isPartOfMessage());
+    if (packet->isReliable()) {
+        return sendPacket(std::move(packet), destinationNode);
+    }
+    
+    auto activeSocket = destinationNode.getActiveSocket();
+    if (!activeSocket) {
+        return 0;
+    }
+    
+    auto size = packet->getDataSize();
+    emit dataSent(destinationNode.getType(), size);
+    destinationNode.recordBytesSent(size);
+    
+    collectPacketStats(*packet);
+    fillPacketHeader(*packet, destinationNode.getConnectionSecret(), destinationNode.getVerificationHashType());
+    
+    batch.add(std::move(packet), *activeSocket);
+    
+    return size;
+}
+
+qint64 LimitedNodeList::batchPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode,
+                                        udt::PacketBatch& batch) {
+    if (packetList->isReliable()) {
+        return sendPacketList(std::move(packetList), destinationNode);
+    }
+    
+    auto activeSocket = destinationNode.getActiveSocket();
+    if (!activeSocket) {
+        qCDebug(networking) << "LimitedNodeList::batchPacketList called without active socket for node. Not sending.";
+        return 0;
+    }
+    
+    // close the last packet in the list
+    packetList->closeCurrentPacket();
+    
+    qint64 bytesBatched = 0;
+    while (!packetList->_packets.empty()) {
+        auto packet = packetList->takeFront<NLPacket>();
+        collectPacketStats(*packet);
+        fillPacketHeader(*packet, destinationNode.getConnectionSecret(),
+                         destinationNode.getVerificationHashType());
+        
+        bytesBatched += packet->getDataSize();
+        batch.add(std::move(packet), *activeSocket);
+    }
+    
+    return bytesBatched;
+}
+
 qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode,
                                    const HifiSockAddr& overridenSockAddr) {
     if (overridenSockAddr.isNull() && !destinationNode.getActiveSocket()) {
@@ -409,7 +490,8 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     auto& destinationSockAddr = (overridenSockAddr.isNull()) ? *destinationNode.getActiveSocket()
                                                              : overridenSockAddr;
     
-    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret());
+    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret(),
+                      destinationNode.getVerificationHashType());
 }
 
 int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -509,7 +591,8 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool canAdjustLocks, bool canRez,
-                                                   const QUuid& connectionSecret) {
+                                                   const QUuid& connectionSecret,
+                                                   NLPacket::HashTypes supportedHashTypes, bool isTrusted) {
     NodeHash::const_iterator it = _nodeHash.find(uuid);
 
     if (it != _nodeHash.end()) {
@@ -520,11 +603,19 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setCanAdjustLocks(canAdjustLocks);
         matchingNode->setCanRez(canRez);
         matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setSupportedHashTypes(supportedHashTypes);
+        matchingNode->setIsTrusted(isTrusted);
+        matchingNode->setVerificationHashType(verificationHashTypeForNode(*matchingNode));
 
         return matchingNode;
     } else {
         // we didn't have this node, so add them
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, canAdjustLocks, canRez, connectionSecret, this);
+        newNode->setSupportedHashTypes(supportedHashTypes);
+        newNode->setIsTrusted(isTrusted);
+
+        // pick the hash before anyone can send to the node
+        newNode->setVerificationHashType(verificationHashTypeForNode(*newNode));
 
         if (nodeType == NodeType::AudioMixer) {
             LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
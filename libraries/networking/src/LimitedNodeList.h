@@ -40,6 +40,7 @@
 #include "NLPacketList.h"
 #include "PacketReceiver.h"
 #include "ReceivedMessage.h"
+#include "udt/PacketBatch.h"
 #include "udt/PacketHeaders.h"
 #include "udt/Socket.h"
 #include "UUIDHasher.h"
@@ -109,6 +110,16 @@ public:
 
     bool getThisNodeCanRez() const { return _thisNodeCanRez; }
     void setThisNodeCanRez(bool canRez);
+
+    bool getThisNodeIsTrusted() const { return _thisNodeIsTrusted; }
+    void setThisNodeIsTrusted(bool isTrusted);
+
+    /// the verification hash for packets to and from a node, the fastest hash both nodes support
+    NLPacket::HashType verificationHashTypeForNode(const Node& node) const;
+
+    /// whether a sourced packet from node carries the hash it should. The hash is not checked between two trusted
+    /// nodes, but only when the packet comes from the node's active socket.
+    static bool verificationHashMatchesNode(const udt::Packet& packet, const Node& node, bool thisNodeIsTrusted);
     
     quint16 getSocketLocalPort() const { return _nodeSocket.localPort(); }
     QUdpSocket& getDTLSSocket();
@@ -117,18 +128,25 @@ public:
 
     qint64 sendUnreliablePacket(const NLPacket& packet, const Node& destinationNode);
     qint64 sendUnreliablePacket(const NLPacket& packet, const HifiSockAddr& sockAddr,
-                                const QUuid& connectionSecret = QUuid());
+                                const QUuid& connectionSecret = QUuid(),
+                                NLPacket::HashType hashType = NLPacket::HashType::Md5);
 
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode);
     qint64 sendPacket(std::unique_ptr<NLPacket> packet, const HifiSockAddr& sockAddr,
-                      const QUuid& connectionSecret = QUuid());
+                      const QUuid& connectionSecret = QUuid(), NLPacket::HashType hashType = NLPacket::HashType::Md5);
 
     qint64 sendPacketList(NLPacketList& packetList, const Node& destinationNode);
     qint64 sendPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
-                          const QUuid& connectionSecret = QUuid());
+                          const QUuid& connectionSecret = QUuid(),
+                          NLPacket::HashType hashType = NLPacket::HashType::Md5);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // unreliable packets are held in the batch until sendBatch, reliable ones are sent right away
+    qint64 batchPacket(std::unique_ptr<NLPacket> packet, const Node& destinationNode, udt::PacketBatch& batch);
+    qint64 batchPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode, udt::PacketBatch& batch);
+    qint64 sendBatch(udt::PacketBatch& batch) { return _nodeSocket.writePacketBatch(batch); }
+
     void (*linkedDataCreateCallback)(Node *);
 
     size_t size() const { return _nodeHash.size(); }
@@ -138,7 +156,9 @@ public:
     SharedNodePointer addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       bool canAdjustLocks = false, bool canRez = false,
-                                      const QUuid& connectionSecret = QUuid());
+                                      const QUuid& connectionSecret = QUuid(),
+                                      NLPacket::HashTypes supportedHashTypes = NLPacket::SUPPORTED_HASH_TYPES,
+                                      bool isTrusted = false);
 
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
 
@@ -257,7 +277,8 @@ protected:
     qint64 writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
-    void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid(),
+                          NLPacket::HashType hashType = NLPacket::HashType::Md5);
     
     bool isPacketVerified(const udt::Packet& packet);
     bool packetVersionMatch(const udt::Packet& packet);
@@ -291,6 +312,7 @@ protected:
     QElapsedTimer _packetStatTimer;
     bool _thisNodeCanAdjustLocks;
     bool _thisNodeCanRez;
+    bool _thisNodeIsTrusted { false };
 
     QPointer<QTimer> _initialSTUNTimer;
     int _numInitialSTUNRequests = 0;
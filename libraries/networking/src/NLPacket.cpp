@@ -11,6 +11,16 @@
 
 #include "NLPacket.h"
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QtEndian>
+
+#include "SipHash.h"
+
+static_assert(NUM_BYTES_SIP_HASH == NUM_BYTES_MD5_HASH, "a SipHash has to fit where the MD5 hash goes in the header");
+
+const NLPacket::HashTypes NLPacket::SUPPORTED_HASH_TYPES =
+    NLPacket::hashTypeMask(NLPacket::HashType::Md5) | NLPacket::hashTypeMask(NLPacket::HashType::SipHash);
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
@@ -32,7 +42,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -87,7 +97,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -144,23 +154,53 @@ QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
     return QUuid::fromRfc4122(QByteArray::fromRawData(packet.getData() + offset, NUM_BYTES_RFC4122_UUID));
 }
 
-QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
+const char* NLPacket::verificationHashInHeader(const udt::Packet& packet) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-    return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
+    return packet.getData() + offset;
 }
 
-QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
+// the RFC 4122 bytes of the secret, without going through a QByteArray
+static void writeConnectionSecretBytes(const QUuid& connectionSecret, uchar* bytes) {
+    qToBigEndian(connectionSecret.data1, bytes);
+    qToBigEndian(connectionSecret.data2, bytes + 4);
+    qToBigEndian(connectionSecret.data3, bytes + 6);
+    memcpy(bytes + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+}
+
+void NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType,
+                                      char* hash) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
         + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
-    
-    // add the packet payload and the connection UUID
-    hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
-    hash.addData(connectionSecret.toRfc4122());
-    
-    // return the hash
-    return hash.result();
+    const char* payload = packet.getData() + offset;
+    int payloadSize = packet.getDataSize() - offset;
+
+    uchar secretBytes[NUM_BYTES_RFC4122_UUID];
+    writeConnectionSecretBytes(connectionSecret, secretBytes);
+
+    switch (hashType) {
+        case HashType::SipHash:
+            // the secret is the key, so the payload is hashed in place in one pass
+            sipHash128(secretBytes, payload, payloadSize, reinterpret_cast<uchar*>(hash));
+            break;
+        case HashType::Md5: {
+            // add the packet payload and the connection UUID
+            QCryptographicHash md5(QCryptographicHash::Md5);
+            md5.addData(payload, payloadSize);
+            md5.addData(reinterpret_cast<const char*>(secretBytes), NUM_BYTES_RFC4122_UUID);
+            memcpy(hash, md5.result().constData(), NUM_BYTES_MD5_HASH);
+            break;
+        }
+        case HashType::None:
+            memset(hash, 0, NUM_BYTES_MD5_HASH);
+            break;
+    }
+}
+
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType) {
+    char expectedHash[NUM_BYTES_MD5_HASH];
+    hashForPacketAndSecret(packet, connectionSecret, hashType, expectedHash);
+
+    return memcmp(verificationHashInHeader(packet), expectedHash, NUM_BYTES_MD5_HASH) == 0;
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -207,12 +247,10 @@ void NLPacket::writeSourceID(const QUuid& sourceID) const {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
+void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret, HashType hashType) const {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    hashForPacketAndSecret(*this, connectionSecret, hashType, _packet.get() + offset);
 }
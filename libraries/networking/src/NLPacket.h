@@ -21,6 +21,18 @@
 class NLPacket : public udt::Packet {
     Q_OBJECT
 public:
+    /// How the verification hash in the header of sourced, verified packets is computed. Each node tells the
+    /// domain-server which types it can compute, and two peers use the best type they share - see
+    /// LimitedNodeList::verificationHashTypeForNode().
+    enum class HashType : quint8 {
+        None = 0, // not hashed, no node is picked to use it
+        Md5,
+        SipHash
+    };
+    using HashTypes = quint8; // a mask with the bit (1 << type) set for each supported type
+    static HashTypes hashTypeMask(HashType type) { return (HashTypes)(1 << (int)type); }
+    static const HashTypes SUPPORTED_HASH_TYPES;
+
     // this is used by the Octree classes - must be known at compile time
     static const int MAX_PACKET_HEADER_SIZE =
         sizeof(udt::Packet::SequenceNumberAndBitField) + sizeof(udt::Packet::MessageNumberAndBitField) +
@@ -29,7 +41,7 @@ public:
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                                             bool isReliable = false, bool isPartOfMessage = false);
     
-    static std::unique_ptr<NLPacket> fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+    static std::unique_ptr<NLPacket> fromReceivedPacket(udt::PacketBuffer data, qint64 size,
                                                         const HifiSockAddr& senderSockAddr);
     static std::unique_ptr<NLPacket> fromBase(std::unique_ptr<Packet> packet);
     
@@ -47,8 +59,12 @@ public:
     static PacketVersion versionInHeader(const udt::Packet& packet);
     
     static QUuid sourceIDInHeader(const udt::Packet& packet);
-    static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+    static const char* verificationHashInHeader(const udt::Packet& packet);
+
+    // writes the NUM_BYTES_MD5_HASH byte hash of the packet payload to hash
+    static void hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType,
+                                       char* hash);
+    static bool verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret, HashType hashType);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
@@ -58,12 +74,12 @@ public:
     const QUuid& getSourceID() const { return _sourceID; }
     
     void writeSourceID(const QUuid& sourceID) const;
-    void writeVerificationHashGivenSecret(const QUuid& connectionSecret) const;
+    void writeVerificationHashGivenSecret(const QUuid& connectionSecret, HashType hashType) const;
 
 protected:
     
     NLPacket(PacketType type, qint64 size = -1, bool forceReliable = false, bool isPartOfMessage = false);
-    NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr);
+    NLPacket(udt::PacketBuffer data, qint64 size, const HifiSockAddr& senderSockAddr);
     
     NLPacket(const NLPacket& other);
     NLPacket(NLPacket&& other);
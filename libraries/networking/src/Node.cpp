@@ -86,6 +86,8 @@ QDataStream& operator<<(QDataStream& out, const Node& node) {
     out << node._localSocket;
     out << node._canAdjustLocks;
     out << node._canRez;
+    out << node._supportedHashTypes;
+    out << node._isTrusted;
 
     return out;
 }
@@ -97,6 +99,8 @@ QDataStream& operator>>(QDataStream& in, Node& node) {
     in >> node._localSocket;
     in >> node._canAdjustLocks;
     in >> node._canRez;
+    in >> node._supportedHashTypes;
+    in >> node._isTrusted;
 
     return in;
 }
@@ -23,6 +23,7 @@
 
 #include "HifiSockAddr.h"
 #include "NetworkPeer.h"
+#include "NLPacket.h"
 #include "NodeData.h"
 #include "NodeType.h"
 #include "SimpleMovingAverage.h"
@@ -64,6 +65,18 @@ public:
     void setCanRez(bool canRez) { _canRez = canRez; }
     bool getCanRez() { return _canRez; }
 
+    // the verification hashes the node can compute, from its connect request
+    void setSupportedHashTypes(NLPacket::HashTypes supportedHashTypes) { _supportedHashTypes = supportedHashTypes; }
+    NLPacket::HashTypes getSupportedHashTypes() const { return _supportedHashTypes; }
+
+    // trusted nodes are assignment clients the domain-server was told share a private network with it
+    void setIsTrusted(bool isTrusted) { _isTrusted = isTrusted; }
+    bool isTrusted() const { return _isTrusted; }
+
+    // the hash used on packets to and from this node, picked by the node list
+    void setVerificationHashType(NLPacket::HashType hashType) { _verificationHashType = hashType; }
+    NLPacket::HashType getVerificationHashType() const { return _verificationHashType; }
+
     friend QDataStream& operator<<(QDataStream& out, const Node& node);
     friend QDataStream& operator>>(QDataStream& in, Node& node);
 
@@ -83,6 +96,9 @@ private:
     MovingPercentile _clockSkewMovingPercentile;
     bool _canAdjustLocks;
     bool _canRez;
+    NLPacket::HashTypes _supportedHashTypes { NLPacket::hashTypeMask(NLPacket::HashType::Md5) };
+    bool _isTrusted { false };
+    NLPacket::HashType _verificationHashType { NLPacket::HashType::Md5 };
 };
 
 Q_DECLARE_METATYPE(Node*)
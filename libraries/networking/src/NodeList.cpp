@@ -289,6 +289,9 @@ void NodeList::sendDomainServerCheckIn() {
 
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
+
+        // pack the verification hashes we can compute, so that the domain-server can tell our peers
+        packetStream << NLPacket::SUPPORTED_HASH_TYPES;
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected() ) {
@@ -516,6 +519,10 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     quint8 thisNodeCanRez;
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez((bool) thisNodeCanRez);
+
+    quint8 thisNodeIsTrusted;
+    packetStream >> thisNodeIsTrusted;
+    setThisNodeIsTrusted((bool) thisNodeIsTrusted);
     
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
@@ -545,8 +552,11 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     HifiSockAddr nodePublicSocket, nodeLocalSocket;
     bool canAdjustLocks;
     bool canRez;
+    NLPacket::HashTypes supportedHashTypes;
+    bool isTrusted;
 
-    packetStream >> nodeType >> nodeUUID >> nodePublicSocket >> nodeLocalSocket >> canAdjustLocks >> canRez;
+    packetStream >> nodeType >> nodeUUID >> nodePublicSocket >> nodeLocalSocket >> canAdjustLocks >> canRez
+        >> supportedHashTypes >> isTrusted;
 
     // if the public socket address is 0 then it's reachable at the same IP
     // as the domain server
@@ -558,7 +568,7 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
 
     SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket,
                                              nodeLocalSocket, canAdjustLocks, canRez,
-                                             connectionUUID);
+                                             connectionUUID, supportedHashTypes, isTrusted);
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
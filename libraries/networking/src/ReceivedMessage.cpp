@@ -12,35 +12,62 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 static int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
 static int sharedPtrReceivedMessageMetaTypeId = qRegisterMetaType<QSharedPointer<ReceivedMessage>>("QSharedPointer<ReceivedMessage>");
 
-static const int HEAD_DATA_SIZE = 512;
-
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
-    : _data(packetList.getMessage()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(packetList.getNumPackets()),
+    : _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
       _senderSockAddr(packetList.getSenderSockAddr()),
       _isComplete(true)
 {
+    _firstSegment.copiedData = packetList.getMessage();
+    _firstSegment.data = _firstSegment.copiedData.constData();
+    _firstSegment.size = _firstSegment.copiedData.size();
+    _size = _firstSegment.size;
 }
 
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
-    : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(1),
+    : _numPackets(1),
       _sourceID(packet.getSourceID()),
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
       _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
+    _firstSegment.copiedData = packet.readAll();
+    _firstSegment.data = _firstSegment.copiedData.constData();
+    _firstSegment.size = _firstSegment.copiedData.size();
+    _size = _firstSegment.size;
+}
+
+ReceivedMessage::ReceivedMessage(std::unique_ptr<NLPacket> packet)
+    : _numPackets(1),
+      _sourceID(packet->getSourceID()),
+      _packetType(packet->getType()),
+      _packetVersion(packet->getVersion()),
+      _senderSockAddr(packet->getSenderSockAddr()),
+      _isComplete(packet->getPacketPosition() == NLPacket::ONLY)
+{
+    _firstSegment.data = packet->getPayload() + packet->pos();
+    _firstSegment.size = packet->bytesLeftToRead();
+    _firstSegment.packet = std::move(packet);
+    _size = _firstSegment.size;
+}
+
+ReceivedMessage::~ReceivedMessage() {
+    Segment* segment = _firstSegment.next;
+    while (segment) {
+        Segment* next = segment->next;
+        delete segment;
+        segment = next;
+    }
 }
 
 void ReceivedMessage::setFailed() {
@@ -49,7 +76,7 @@ void ReceivedMessage::setFailed() {
     emit completed();
 }
 
-void ReceivedMessage::appendPacket(NLPacket& packet) {
+void ReceivedMessage::appendPacket(std::unique_ptr<NLPacket> packet) {
     Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket", 
                "We should not be appending to a complete message");
 
@@ -58,48 +85,120 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    bool isLastPacket = packet->getPacketPosition() == NLPacket::PacketPosition::LAST;
+
+    Segment* segment = new Segment();
+    segment->data = packet->getPayload();
+    segment->size = packet->getPayloadSize();
+    segment->offset = _lastSegment->offset + _lastSegment->size;
+    segment->packet = std::move(packet);
+
+    // link the segment before publishing the new size, a reader never looks past the size it loaded
+    _lastSegment->next.store(segment, std::memory_order_release);
+    _lastSegment = segment;
+    _size.store(segment->offset + segment->size, std::memory_order_release);
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress();
     }
 
-    if (packet.getPacketPosition() == NLPacket::PacketPosition::LAST) {
+    if (isLastPacket) {
         _isComplete = true;
         emit completed();
     }
 }
 
-qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    return size;
+const ReceivedMessage::Segment* ReceivedMessage::findSegment(qint64 position) const {
+    const Segment* segment = _readSegment;
+    if (position < segment->offset) {
+        segment = &_firstSegment;
+    }
+    while (position >= segment->offset + segment->size) {
+        segment = segment->next.load(std::memory_order_acquire);
+    }
+    _readSegment = segment;
+    return segment;
 }
 
-qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
-    _position += size;
-    return size;
+qint64 ReceivedMessage::copyTo(qint64 position, char* data, qint64 size) const {
+    size = std::max(std::min(size, getSize() - position), (qint64)0);
+
+    qint64 copied = 0;
+    while (copied < size) {
+        const Segment* segment = findSegment(position + copied);
+        qint64 offsetInSegment = position + copied - segment->offset;
+        qint64 bytesToCopy = std::min(size - copied, segment->size - offsetInSegment);
+        memcpy(data + copied, segment->data + offsetInSegment, bytesToCopy);
+        copied += bytesToCopy;
+    }
+    return copied;
 }
 
-qint64 ReceivedMessage::readHead(char* data, qint64 size) {
-    memcpy(data, _headData.constData() + _position, size);
-    _position += size;
-    return size;
+void ReceivedMessage::updateContiguousData() const {
+    qint64 size = getSize();
+    if (_contiguousData.size() == size) {
+        return;
+    }
+
+    if (!_contiguousData.isEmpty()) {
+        // getRawMessage() may have handed out a pointer into it
+        _outgrownContiguousData << _contiguousData;
+    }
+
+    // walks the chain itself, the read position and its segment belong to the reader
+    _contiguousData = QByteArray(size, Qt::Uninitialized);
+    char* data = _contiguousData.data();
+    for (const Segment* segment = &_firstSegment; segment; segment = segment->next.load(std::memory_order_acquire)) {
+        qint64 bytesToCopy = std::min(segment->size, size - segment->offset);
+        if (bytesToCopy <= 0) {
+            break;
+        }
+        memcpy(data + segment->offset, segment->data, bytesToCopy);
+    }
 }
 
-QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+QByteArray ReceivedMessage::getMessage() const {
+    if (!_firstSegment.next.load(std::memory_order_acquire)) {
+        if (!_firstSegment.packet) {
+            return _firstSegment.copiedData;
+        }
+        return QByteArray(_firstSegment.data, _firstSegment.size);
+    }
+
+    QMutexLocker locker(&_contiguousLock);
+    updateContiguousData();
+    return _contiguousData;
 }
 
-QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+const char* ReceivedMessage::getRawMessage() const {
+    if (!_firstSegment.next.load(std::memory_order_acquire)) {
+        return _firstSegment.data;
+    }
+
+    QMutexLocker locker(&_contiguousLock);
+    updateContiguousData();
+    return _contiguousData.constData();
+}
+
+qint64 ReceivedMessage::peek(char* data, qint64 size) {
+    return copyTo(_position, data, size);
+}
+
+qint64 ReceivedMessage::read(char* data, qint64 size) {
+    qint64 bytesRead = copyTo(_position, data, size);
+    _position += bytesRead;
+    return bytesRead;
+}
+
+QByteArray ReceivedMessage::peek(qint64 size) {
+    QByteArray data(std::max(std::min(size, getBytesLeftToRead()), (qint64)0), Qt::Uninitialized);
+    copyTo(_position, data.data(), data.size());
     return data;
 }
 
-QByteArray ReceivedMessage::readHead(qint64 size) {
-    auto data = _headData.mid(_position, size);
-    _position += size;
+QByteArray ReceivedMessage::read(qint64 size) {
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -108,9 +207,19 @@ QByteArray ReceivedMessage::readAll() {
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    size = std::min(size, getBytesLeftToRead());
+    if (size <= 0) {
+        return QByteArray();
+    }
+
+    const Segment* segment = findSegment(_position);
+    qint64 offsetInSegment = _position - segment->offset;
+    if (offsetInSegment + size > segment->size) {
+        return read(size);
+    }
+
     _position += size;
-    return data;
+    return QByteArray::fromRawData(segment->data + offsetInSegment, size);
 }
 
 void ReceivedMessage::onComplete() {
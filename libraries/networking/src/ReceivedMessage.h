@@ -16,24 +16,36 @@
 #include <QObject>
 
 #include <atomic>
+#include <memory>
+
+#include <QMutex>
 
 #include "NLPacketList.h"
 
+// The packets of a message stay where they were received, in a chain of segments, so that appending a packet never
+// copies or moves the bytes already received. Packets are appended by the thread receiving them while another thread
+// may already be reading the message (see PacketReceiver::registerListener), which only ever reads as far as the size
+// published after the last append.
 class ReceivedMessage : public QObject {
     Q_OBJECT
 public:
     ReceivedMessage(const NLPacketList& packetList);
     ReceivedMessage(NLPacket& packet);
+    ReceivedMessage(std::unique_ptr<NLPacket> packet); // keeps the packet, without copying its payload
+    ~ReceivedMessage();
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    // These return the message in one piece. A message that came in more than one packet is copied into one
+    // buffer the first time, so only use them on complete messages, and prefer read() for large ones. The pointer
+    // getRawMessage() returns stays valid for the life of the message, even if more packets arrive after it.
+    QByteArray getMessage() const;
+    const char* getRawMessage() const;
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
 
     void setFailed();
 
-    void appendPacket(NLPacket& packet);
+    void appendPacket(std::unique_ptr<NLPacket> packet);
 
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
@@ -46,35 +58,27 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size.load(std::memory_order_acquire); }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    qint64 getBytesLeftToRead() const { return getSize() - _position; }
 
     void seek(qint64 position) { _position = position; }
 
     qint64 peek(char* data, qint64 size);
     qint64 read(char* data, qint64 size);
 
-    // Temporary functionality for reading in the first HEAD_DATA_SIZE bytes of the message
-    // safely across threads.
-    qint64 readHead(char* data, qint64 size);
-
     QByteArray peek(qint64 size);
     QByteArray read(qint64 size);
     QByteArray readAll();
 
-    QByteArray readHead(qint64 size);
-
     // This will return a QByteArray referencing the underlying data _without_ refcounting that data.
     // Be careful when using this method, only use it when the lifetime of the returned QByteArray will not
-    // exceed that of the ReceivedMessage.
+    // exceed that of the ReceivedMessage. Bytes that straddle two packets are copied into a QByteArray of their own.
     QByteArray readWithoutCopy(qint64 size);
 
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
-    template<typename T> qint64 readHeadPrimitive(T* data);
-
 signals:
     void progress();
     void completed();
@@ -83,10 +87,33 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
-    QByteArray _headData;
+    struct Segment {
+        std::unique_ptr<NLPacket> packet; // owns the bytes of the segment, unless they were copied into copiedData
+        QByteArray copiedData;
+        const char* data { nullptr };
+        qint64 size { 0 };
+        qint64 offset { 0 }; // in the message
+        std::atomic<Segment*> next { nullptr };
+    };
+
+    // finds the segment holding the byte at position, which has to be below the published size
+    const Segment* findSegment(qint64 position) const;
+
+    // copies up to size bytes from position, without moving the read position
+    qint64 copyTo(qint64 position, char* data, qint64 size) const;
 
-    std::atomic<qint64> _size { true };  
+    // copies every segment into _contiguousData, call with _contiguousLock held
+    void updateContiguousData() const;
+
+    Segment _firstSegment;
+    Segment* _lastSegment { &_firstSegment }; // only used by the thread appending packets
+    mutable const Segment* _readSegment { &_firstSegment }; // where the last read was, only used by the reader
+
+    mutable QMutex _contiguousLock;
+    mutable QByteArray _contiguousData; // the one piece copy of a message that has more than one segment
+    mutable QList<QByteArray> _outgrownContiguousData; // copies made before the last packets arrived, still pointed to
+
+    std::atomic<qint64> _size { 0 };
     std::atomic<qint64> _position { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
@@ -110,8 +137,4 @@ template<typename T> qint64 ReceivedMessage::readPrimitive(T* data) {
     return read(reinterpret_cast<char*>(data), sizeof(T));
 }
 
-template<typename T> qint64 ReceivedMessage::readHeadPrimitive(T* data) {
-    return readHead(reinterpret_cast<char*>(data), sizeof(T));
-}
-
 #endif
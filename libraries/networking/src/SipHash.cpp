@@ -0,0 +1,95 @@
+//
+//  SipHash.cpp
+//  libraries/networking/src
+//
+//  Created by High Fidelity on 2/16/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+static inline uint64_t rotateLeft(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+// the words of the message and key are little endian, whatever the host is
+static inline uint64_t readLittleEndian(const uint8_t* bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24)
+        | ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48)
+        | ((uint64_t)bytes[7] << 56);
+}
+
+static inline void writeLittleEndian(uint64_t word, uint8_t* bytes) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t)(word >> (8 * i));
+    }
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+void sipHash128(const uint8_t* key, const char* data, int size, uint8_t* hash) {
+    const int COMPRESSION_ROUNDS = 2;
+    const int FINALIZATION_ROUNDS = 4;
+
+    uint64_t k0 = readLittleEndian(key);
+    uint64_t k1 = readLittleEndian(key + 8);
+
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1 ^ 0xee; // 0xee selects the 128 bit output
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* wholeWordsEnd = bytes + (size - (size % 8));
+
+    for (; bytes != wholeWordsEnd; bytes += 8) {
+        uint64_t word = readLittleEndian(bytes);
+        v3 ^= word;
+        for (int i = 0; i < COMPRESSION_ROUNDS; i++) {
+            sipRound(v0, v1, v2, v3);
+        }
+        v0 ^= word;
+    }
+
+    // the last word holds the bytes left over and the low byte of the message length
+    uint64_t lastWord = (uint64_t)size << 56;
+    for (int i = 0; i < size % 8; i++) {
+        lastWord |= (uint64_t)bytes[i] << (8 * i);
+    }
+
+    v3 ^= lastWord;
+    for (int i = 0; i < COMPRESSION_ROUNDS; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    v0 ^= lastWord;
+
+    v2 ^= 0xee;
+    for (int i = 0; i < FINALIZATION_ROUNDS; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, hash);
+
+    v1 ^= 0xdd;
+    for (int i = 0; i < FINALIZATION_ROUNDS; i++) {
+        sipRound(v0, v1, v2, v3);
+    }
+    writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, hash + 8);
+}
@@ -0,0 +1,25 @@
+//
+//  SipHash.h
+//  libraries/networking/src
+//
+//  Created by High Fidelity on 2/16/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <stdint.h>
+
+const int NUM_BYTES_SIP_HASH_KEY = 16;
+const int NUM_BYTES_SIP_HASH = 16;
+
+/// SipHash-2-4 with its 128 bit output (https://131002.net/siphash/), a keyed hash that is a good deal cheaper than MD5
+/// for the short messages we send. Computes the hash of size bytes at data with a 16 byte key in a single pass, and
+/// writes it to the 16 bytes at hash.
+void sipHash128(const uint8_t* key, const char* data, int size, uint8_t* hash);
+
+#endif // hifi_SipHash_h
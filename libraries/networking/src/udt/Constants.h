@@ -25,6 +25,10 @@ namespace udt {
     static const int CONNECTION_SEND_BUFFER_SIZE_PACKETS = 8192;
     static const int UDP_SEND_BUFFER_SIZE_BYTES = 1048576;
     static const int UDP_RECEIVE_BUFFER_SIZE_BYTES = 1048576;
+    static const int MAX_DATAGRAMS_PER_RECEIVE_BATCH = 64;
+    static const int MAX_DATAGRAMS_PER_SEND_BATCH = 64;
+    static const int MAX_POOLED_RECEIVE_BUFFERS = 1024;
+    static const int MAX_SEND_QUEUE_SCHEDULER_THREADS = 4;
     static const int DEFAULT_SYN_INTERVAL_USECS = 10 * 1000;
     static const int SEQUENCE_NUMBER_BITS = sizeof(SequenceNumber) * 8;
     static const int MESSAGE_LINE_NUMBER_BITS = 32;
@@ -0,0 +1,20 @@
+//
+//  PacketBatch.cpp
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 2/2/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBatch.h"
+
+using namespace udt;
+
+void PacketBatch::add(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
+    Q_ASSERT_X(!packet->isReliable(), "PacketBatch::add", "Cannot batch a reliable packet");
+    
+    _packets.push_back({ std::move(packet), sockAddr });
+}
@@ -0,0 +1,49 @@
+//
+//  PacketBatch.h
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 2/2/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBatch_h
+#define hifi_PacketBatch_h
+
+#include <memory>
+#include <vector>
+
+#include "../HifiSockAddr.h"
+#include "Packet.h"
+
+namespace udt {
+
+// Unreliable packets that are held back so that Socket::writePacketBatch can send all of them at once,
+// typically everything a mixer sends out in one frame
+class PacketBatch {
+public:
+    void add(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr);
+    
+    bool isEmpty() const { return _packets.empty(); }
+    int getNumPackets() const { return (int)_packets.size(); }
+    
+    void clear() { _packets.clear(); }
+    
+private:
+    friend class Socket;
+    
+    struct BatchedPacket {
+        std::unique_ptr<Packet> packet;
+        HifiSockAddr sockAddr;
+    };
+    
+    std::vector<BatchedPacket> _packets;
+};
+    
+} // namespace udt
+
+#endif // hifi_PacketBatch_h
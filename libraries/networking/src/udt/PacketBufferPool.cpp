@@ -0,0 +1,72 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 1/31/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+using namespace udt;
+
+void PacketBufferDeleter::operator()(char* buffer) const {
+    if (_pool) {
+        _pool->release(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
+std::shared_ptr<PacketBufferPool> PacketBufferPool::create(int maxFreeBuffers) {
+    return std::shared_ptr<PacketBufferPool>(new PacketBufferPool(maxFreeBuffers));
+}
+
+PacketBufferPool::PacketBufferPool(int maxFreeBuffers) :
+    _maxFreeBuffers(maxFreeBuffers)
+{
+    _freeBuffers.reserve(maxFreeBuffers);
+}
+
+PacketBufferPool::~PacketBufferPool() {
+    // every buffer that is still out holds a reference to us, so all of them are back by now
+    for (char* buffer : _freeBuffers) {
+        delete[] buffer;
+    }
+}
+
+void PacketBufferPool::acquire(std::vector<PacketBuffer>& buffers, int numBuffers) {
+    auto pool = shared_from_this();
+
+    int numReused = 0;
+    {
+        std::lock_guard<std::mutex> lock(_freeBuffersMutex);
+        while ((int)buffers.size() < numBuffers && !_freeBuffers.empty()) {
+            buffers.emplace_back(_freeBuffers.back(), PacketBufferDeleter(pool));
+            _freeBuffers.pop_back();
+            ++numReused;
+        }
+    }
+    _numReused += numReused;
+
+    while ((int)buffers.size() < numBuffers) {
+        buffers.emplace_back(new char[BUFFER_SIZE], PacketBufferDeleter(pool));
+        ++_numAllocated;
+    }
+}
+
+void PacketBufferPool::release(char* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(_freeBuffersMutex);
+        if ((int)_freeBuffers.size() < _maxFreeBuffers) {
+            _freeBuffers.push_back(buffer);
+            return;
+        }
+    }
+
+    // we already have as many spare buffers as we want to hold on to
+    delete[] buffer;
+}
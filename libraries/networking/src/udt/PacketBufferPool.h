@@ -0,0 +1,75 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 1/31/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Constants.h"
+
+namespace udt {
+
+class PacketBufferPool;
+
+// Frees the memory of a packet - buffers that came from a PacketBufferPool go back to it, any other buffer is deleted
+class PacketBufferDeleter {
+public:
+    PacketBufferDeleter() {}
+    PacketBufferDeleter(std::shared_ptr<PacketBufferPool> pool) : _pool(std::move(pool)) {}
+
+    void operator()(char* buffer) const;
+
+private:
+    std::shared_ptr<PacketBufferPool> _pool;
+};
+
+using PacketBuffer = std::unique_ptr<char[], PacketBufferDeleter>;
+
+// Recycles the buffers that datagrams are received into, so that the receive path does not go through the allocator
+// for every packet. Buffers are handed out on the socket thread and come back from whichever thread destroys the packet.
+class PacketBufferPool : public std::enable_shared_from_this<PacketBufferPool> {
+public:
+    // large enough for any datagram that fits in an ethernet frame
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE_WITH_UDP_HEADER;
+
+    static std::shared_ptr<PacketBufferPool> create(int maxFreeBuffers);
+    ~PacketBufferPool();
+
+    // tops buffers up to numBuffers buffers of BUFFER_SIZE bytes
+    void acquire(std::vector<PacketBuffer>& buffers, int numBuffers);
+
+    quint64 getNumAllocated() const { return _numAllocated; }
+    quint64 getNumReused() const { return _numReused; }
+
+private:
+    friend class PacketBufferDeleter;
+
+    PacketBufferPool(int maxFreeBuffers);
+
+    void release(char* buffer);
+
+    std::mutex _freeBuffersMutex;
+    std::vector<char*> _freeBuffers;
+    int _maxFreeBuffers;
+
+    std::atomic<quint64> _numAllocated { 0 };
+    std::atomic<quint64> _numReused { 0 };
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
@@ -45,6 +45,16 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
             return 17;
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            return VERSION_AUDIO_CODEC_BYTE;
+        case PacketType::DomainConnectRequest:
+        case PacketType::DomainListRequest:
+        case PacketType::DomainList:
+        case PacketType::DomainServerAddedNode:
+            return VERSION_DOMAIN_NEGOTIATES_VERIFICATION_HASH;
         default:
             return 17;
     }
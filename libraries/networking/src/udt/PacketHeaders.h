@@ -163,4 +163,8 @@ const PacketVersion VERSION_ENTITIES_POLYLINE_TEXTURE = 50;
 const PacketVersion VERSION_ENTITIES_HAVE_PARENTS = 51;
 const PacketVersion VERSION_ENTITIES_REMOVED_START_AUTOMATICALLY_FROM_ANIMATION_PROPERTY_GROUP = 52;
 
+const PacketVersion VERSION_AUDIO_CODEC_BYTE = 18;
+
+const PacketVersion VERSION_DOMAIN_NEGOTIATES_VERIFICATION_HASH = 18;
+
 #endif // hifi_PacketHeaders_h
@@ -12,11 +12,8 @@
 #include "SendQueue.h"
 
 #include <algorithm>
-#include <thread>
 
-#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
-#include <QtCore/QThread>
 
 #include <SharedUtil.h>
 
@@ -24,6 +21,7 @@
 #include "ControlPacket.h"
 #include "Packet.h"
 #include "PacketList.h"
+#include "SendQueueScheduler.h"
 #include "Socket.h"
 
 using namespace udt;
@@ -57,58 +55,47 @@ std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destin
     
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination));
     
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // the socket's scheduler runs the queue from here on, starting with the handshake
+    queue->_scheduler->add(queue.get());
     
     return queue;
 }
     
 SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
     _socket(socket),
+    _scheduler(&socket->getSendQueueScheduler()),
     _destination(dest)
 {
 }
 
+SendQueue::~SendQueue() {
+    // waits for a scheduler thread that might be in the middle of a step of this queue
+    _scheduler->remove(this);
+}
+
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
     _packets.queuePacket(std::move(packet));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // in case the queue is waiting for packets to send
+    wake();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
     _packets.queuePacketList(std::move(packetList));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // in case the queue is waiting for packets to send
+    wake();
 }
 
 void SendQueue::stop() {
-    
     _state = State::Stopped;
     
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
+    // the next step lets the scheduler know we're done
+    wake();
+}
+
+void SendQueue::wake() {
+    _scheduler->wake(this);
 }
     
 void SendQueue::sendPacket(const Packet& packet) {
@@ -153,8 +140,8 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
         _naks.insert(start, end);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // in case the queue is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
@@ -179,31 +166,27 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
         }
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // in case the queue is waiting for losses to re-send
+    wake();
 }
 
-void SendQueue::sendHandshake() {
-    std::unique_lock<std::mutex> handshakeLock { _handshakeMutex };
-    if (!_hasReceivedHandshakeACK) {
+void SendQueue::sendHandshake(p_high_resolution_clock::time_point now) {
+    if (now >= _nextHandshakeTime) {
         // we haven't received a handshake ACK from the client, send another now
         static const auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, 0);
         _socket->writeBasePacket(*handshakePacket, _destination);
         
         // we wait for the ACK or the re-send interval to expire
         static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
+        _nextHandshakeTime = now + HANDSHAKE_RESEND_INTERVAL;
     }
 }
 
 void SendQueue::handshakeACK() {
-    {
-        std::lock_guard<std::mutex> locker { _handshakeMutex };
-        _hasReceivedHandshakeACK = true;
-    }
+    _hasReceivedHandshakeACK = true;
     
-    // Notify on the handshake ACK condition
-    _handshakeACKCondition.notify_one();
+    // we can start sending right away
+    wake();
 }
 
 SequenceNumber SendQueue::getNextSequenceNumber() {
@@ -230,62 +213,65 @@ void SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     emit packetSent(packetSize, payloadSize);
 }
 
-void SendQueue::run() {
+bool SendQueue::step(p_high_resolution_clock::time_point& nextStepTime) {
+    // Record when the step started, the next one is timed from here
+    const auto stepStartTimestamp = p_high_resolution_clock::now();
+    
     if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
+        // we've been asked to stop, possibly before we even got a chance to start
 #ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run after being told to stop. Will not run.";
+        qDebug() << "SendQueue stepped after being told to stop. Will not run.";
 #endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qDebug() << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+        return false;
     }
     
-    _state = State::Running;
+    // don't overwrite a stop that came in since the check above
+    State notStarted = State::NotStarted;
+    _state.compare_exchange_strong(notStarted, State::Running);
     
     // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
-
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
+    if (!_hasReceivedHandshakeACK) {
+        sendHandshake(stepStartTimestamp);
         
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
+        // handshakeACK wakes us up before then if the ACK comes in
+        nextStepTime = _nextHandshakeTime;
+        return true;
     }
-        
-    while (_state == State::Running) {
-        // Record how long the loop takes to execute
-        const auto loopStartTimestamp = p_high_resolution_clock::now();
-        
-        bool sentAPacket = maybeResendPacket();
-        
-        // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
-        // (this is according to the current flow window size) then we send out a new packet
-        if (!sentAPacket) {
-            sentAPacket = maybeSendNewPacket();
+    
+    if (_waitState != WaitState::None && !handleWaitEnd(stepStartTimestamp)) {
+        return false;
+    }
+    
+    bool sentAPacket = maybeResendPacket();
+    
+    // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
+    // (this is according to the current flow window size) then we send out a new packet
+    if (!sentAPacket) {
+        sentAPacket = maybeSendNewPacket();
+    }
+    
+    // check now if we were just told to stop
+    if (_state != State::Running) {
+        return false;
+    }
+    
+    if (!sentAPacket) {
+        // check if it is time to break this connection
+        if (hasTimedOut()) {
+            deactivate();
+            return false;
         }
         
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(sentAPacket)) {
-            return;
+        if (startWaitingIfIdle(stepStartTimestamp)) {
+            // we're woken up before the deadline if there is something new to send
+            nextStepTime = _waitDeadline;
+            return true;
         }
-        
-        // sleep as long as we need until next packet send, if we can
-        const auto loopEndTimestamp = p_high_resolution_clock::now();
-        const auto timeToSleep = (loopStartTimestamp + std::chrono::microseconds(_packetSendPeriod)) - loopEndTimestamp;
-        std::this_thread::sleep_for(timeToSleep);
     }
+    
+    // run again once it is time for the next packet send
+    nextStepTime = stepStartTimestamp + std::chrono::microseconds(_packetSendPeriod);
+    return true;
 }
 
 bool SendQueue::maybeSendNewPacket() {
@@ -380,92 +366,96 @@ bool SendQueue::maybeResendPacket() {
     return false;
 }
 
-bool SendQueue::isInactive(bool sentAPacket) {
-    if (!sentAPacket) {
-        // check if it is time to break this connection
+bool SendQueue::hasTimedOut() const {
+    // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
+    // at least 5 seconds
+    static const int NUM_TIMEOUTS_BEFORE_INACTIVE = 16;
+    static const int MIN_SECONDS_BEFORE_INACTIVE_MS = 5 * 1000;
+    if (_timeoutExpiryCount >= NUM_TIMEOUTS_BEFORE_INACTIVE &&
+        (QDateTime::currentMSecsSinceEpoch() - _lastReceiverResponse) > MIN_SECONDS_BEFORE_INACTIVE_MS) {
+        // If the flow window has been full for over CONSIDER_INACTIVE_AFTER,
+        // then signal the queue is inactive so it can be cleaned up
         
-        // that will be the case if we have had 16 timeouts since hearing back from the client, and it has been
-        // at least 5 seconds
-        static const int NUM_TIMEOUTS_BEFORE_INACTIVE = 16;
-        static const int MIN_SECONDS_BEFORE_INACTIVE_MS = 5 * 1000;
-        if (_timeoutExpiryCount >= NUM_TIMEOUTS_BEFORE_INACTIVE &&
-            (QDateTime::currentMSecsSinceEpoch() - _lastReceiverResponse) > MIN_SECONDS_BEFORE_INACTIVE_MS) {
-            // If the flow window has been full for over CONSIDER_INACTIVE_AFTER,
-            // then signal the queue is inactive and return so it can be cleaned up
-            
 #ifdef UDT_CONNECTION_DEBUG
-            qCDebug(networking) << "SendQueue to" << _destination << "reached" << NUM_TIMEOUTS_BEFORE_INACTIVE << "timeouts"
-                << "and 5s before receiving any ACK/NAK and is now inactive. Stopping.";
+        qCDebug(networking) << "SendQueue to" << _destination << "reached" << NUM_TIMEOUTS_BEFORE_INACTIVE << "timeouts"
+            << "and 5s before receiving any ACK/NAK and is now inactive. Stopping.";
 #endif
-            
-            deactivate();
-            return true;
-        }
-        
-        // During our processing above we didn't send any packets
-        
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
-        // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
-        using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
-        DoubleLock doubleLock(_packets.getLock(), _naksLock);
-        DoubleLock::Lock locker(doubleLock, std::try_to_lock);
+        return true;
+    }
+    
+    return false;
+}
+
+bool SendQueue::startWaitingIfIdle(p_high_resolution_clock::time_point now) {
+    // During our processing we didn't send any packets
+    
+    // If that is still the case we should wait until we have data to handle.
+    // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock.
+    // Anything queued once we let go of the locks wakes us up again, so nothing can be missed.
+    using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
+    DoubleLock doubleLock(_packets.getLock(), _naksLock);
+    DoubleLock::Lock locker(doubleLock, std::try_to_lock);
+    
+    if (!locker.owns_lock() || !_packets.isEmpty() || !_naks.isEmpty()) {
+        return false;
+    }
+    
+    // The packets queue and loss list mutexes are now both locked and they're both empty
+    
+    if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
+        // we've sent the client as much data as we have (and they've ACKed it)
+        // either wait for new data to send or 5 seconds before cleaning up the queue
+        static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
         
-        if (locker.owns_lock() && _packets.isEmpty() && _naks.isEmpty()) {
-            // The packets queue and loss list mutexes are now both locked and they're both empty
-            
-            if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
-                // we've sent the client as much data as we have (and they've ACKed it)
-                // either wait for new data to send or 5 seconds before cleaning up the queue
-                static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                // we have the lock again - Make sure to unlock it
-                locker.unlock();
-                
-                if (cvStatus == std::cv_status::timeout) {
+        _waitState = WaitState::ForData;
+        _waitDeadline = now + EMPTY_QUEUES_INACTIVE_TIMEOUT;
+    } else {
+        // We think the client is still waiting for data (based on the sequence number gap)
+        // Let's wait either for a response from the client or until the estimated timeout
+        // (plus the sync interval to allow the client to respond) has elapsed
+        _waitState = WaitState::ForResponse;
+        _waitDeadline = now + std::chrono::microseconds(_estimatedTimeout + _syncInterval);
+    }
+    
+    return true;
+}
+
+bool SendQueue::handleWaitEnd(p_high_resolution_clock::time_point now) {
+    auto waitState = _waitState;
+    _waitState = WaitState::None;
+    
+    if (now < _waitDeadline) {
+        // we were woken up before the deadline, there is something new to send
+        return true;
+    }
+    
+    if (waitState == WaitState::ForData) {
 #ifdef UDT_CONNECTION_DEBUG
-                    qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
-                        << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
-                        << "seconds and receiver has ACKed all packets."
-                        << "The queue is now inactive and will be stopped.";
+        qCDebug(networking) << "SendQueue to" << _destination << "has been empty for 5 seconds"
+            << "and receiver has ACKed all packets."
+            << "The queue is now inactive and will be stopped.";
 #endif
-                    
-                    // Deactivate queue
-                    deactivate();
-                    return true;
-                }
-            } else {
-                // We think the client is still waiting for data (based on the sequence number gap)
-                // Let's wait either for a response from the client or until the estimated timeout
-                // (plus the sync interval to allow the client to respond) has elapsed
-                auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, waitDuration);
-                
-                if (cvStatus == std::cv_status::timeout) {
-                    // increase the number of timeouts
-                    ++_timeoutExpiryCount;
-                    
-                    if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                        // after a timeout if we still have sent packets that the client hasn't ACKed we
-                        // add them to the loss list
-                        
-                        // Note that thanks to the DoubleLock we have the _naksLock right now
-                        _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
-                    }
-                }
-            }
-        }
+        
+        // Deactivate queue
+        deactivate();
+        return false;
     }
     
-    return false;
+    // increase the number of timeouts
+    ++_timeoutExpiryCount;
+    
+    if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+        // after a timeout if we still have sent packets that the client hasn't ACKed we
+        // add them to the loss list
+        std::lock_guard<std::mutex> nakLocker(_naksLock);
+        _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+    }
+    
+    return true;
 }
 
 void SendQueue::deactivate() {
-    // this queue is inactive - emit that signal and stop the while
+    // this queue is inactive - emit that signal and stop stepping
     emit queueInactive();
     
     _state = State::Stopped;
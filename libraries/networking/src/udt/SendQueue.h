@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -38,8 +37,12 @@ class BasePacket;
 class ControlPacket;
 class Packet;
 class PacketList;
+class SendQueueScheduler;
 class Socket;
-    
+
+// Sends the reliable packets of a Connection, keeping to the packet send period and flow window set by its congestion
+// control. Rather than running on a thread of its own, the queue is run one step at a time by the SendQueueScheduler
+// of its Socket, and each step says when the queue next wants to run.
 class SendQueue : public QObject {
     Q_OBJECT
     
@@ -51,6 +54,7 @@ public:
     };
     
     static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination);
+    ~SendQueue();
     
     void queuePacket(std::unique_ptr<Packet> packet);
     void queuePacketList(std::unique_ptr<PacketList> packetList);
@@ -64,6 +68,10 @@ public:
     
     void setEstimatedTimeout(int estimatedTimeout) { _estimatedTimeout = estimatedTimeout; }
     void setSyncInterval(int syncInterval) { _syncInterval = syncInterval; }
+
+    // Sends whatever is due and sets when the queue next wants to run, returns false once the queue has stopped.
+    // Only called by the SendQueueScheduler, which never runs the same queue on two threads at once.
+    bool step(p_high_resolution_clock::time_point& nextStepTime);
     
 public slots:
     void stop();
@@ -79,15 +87,19 @@ signals:
     
     void queueInactive();
     
-private slots:
-    void run();
-    
 private:
+    // what the queue is waiting for while it has nothing to send
+    enum class WaitState {
+        None,
+        ForData, // everything has been ACKed, waiting for new packets to send
+        ForResponse // waiting for the receiver to ACK or NAK what was sent
+    };
+
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
-    void sendHandshake();
+    void sendHandshake(p_high_resolution_clock::time_point now);
     
     void sendPacket(const Packet& packet);
     void sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
@@ -95,8 +107,12 @@ private:
     bool maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool sentAPacket);
+    bool hasTimedOut() const; // true once the receiver has not responded for too long
+    bool startWaitingIfIdle(p_high_resolution_clock::time_point now); // starts waiting if there is nothing left to send
+    bool handleWaitEnd(p_high_resolution_clock::time_point now); // returns false if the wait means the queue is inactive
     void deactivate(); // makes the queue inactive and cleans it up
+
+    void wake(); // has the scheduler run the queue as soon as possible
     
     // Increments current sequence number and return it
     SequenceNumber getNextSequenceNumber();
@@ -104,6 +120,7 @@ private:
     PacketQueue _packets;
     
     Socket* _socket { nullptr }; // Socket to send packet on
+    SendQueueScheduler* _scheduler { nullptr }; // Runs this queue, owned by the socket
     HifiSockAddr _destination; // Destination addr
     
     std::atomic<uint32_t> _lastACKSequenceNumber { 0 }; // Last ACKed sequence number
@@ -127,11 +144,12 @@ private:
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
     std::unordered_map<SequenceNumber, std::unique_ptr<Packet>> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
+    p_high_resolution_clock::time_point _nextHandshakeTime; // when to re-send the handshake if it is still not ACKed
+
+    // only touched from step
+    WaitState _waitState { WaitState::None };
+    p_high_resolution_clock::time_point _waitDeadline;
 };
     
 }
@@ -0,0 +1,187 @@
+//
+//  SendQueueScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 2/4/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueScheduler.h"
+
+#include <algorithm>
+
+#include "SendQueue.h"
+
+using namespace udt;
+
+SendQueueScheduler::SendQueueScheduler(int numThreads) {
+    numThreads = std::max(numThreads, 1);
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.emplace_back(&SendQueueScheduler::run, this);
+    }
+}
+
+SendQueueScheduler::~SendQueueScheduler() {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        _isStopping = true;
+    }
+    _queuesChanged.notify_all();
+
+    // each thread finishes the step it is in
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void SendQueueScheduler::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> locker(_mutex);
+        QueueID queueID = _nextQueueID++;
+        _queueIDs[queue] = queueID;
+
+        QueueState& state = _queues[queueID];
+        state.queue = queue;
+        schedule(queueID, state, Clock::now());
+    }
+    _queuesChanged.notify_all();
+}
+
+void SendQueueScheduler::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    auto idIt = _queueIDs.find(queue);
+    if (idIt == _queueIDs.end()) {
+        return;
+    }
+    QueueID queueID = idIt->second;
+
+    QueueState& state = _queues[queueID];
+    if (state.isRunning) {
+        // the thread running it will let us know once it is done
+        state.isRemoved = true;
+        _queuesChanged.wait(locker, [&]{ return !_queues[queueID].isRunning; });
+    }
+
+    // any step still scheduled for it is skipped since its ID is no longer known
+    forget(queueID);
+}
+
+void SendQueueScheduler::wake(SendQueue* queue) {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    auto idIt = _queueIDs.find(queue);
+    if (idIt == _queueIDs.end()) {
+        return;
+    }
+    QueueID queueID = idIt->second;
+
+    QueueState& state = _queues[queueID];
+    if (state.isRunning) {
+        // its next step will be due right away
+        state.wasWoken = true;
+        return;
+    }
+
+    auto now = Clock::now();
+    if (state.dueTime > now) {
+        schedule(queueID, state, now);
+        locker.unlock();
+        _queuesChanged.notify_all();
+    }
+}
+
+int SendQueueScheduler::getNumQueues() {
+    std::lock_guard<std::mutex> locker(_mutex);
+    return (int)_queues.size();
+}
+
+SendQueueScheduler::Stats SendQueueScheduler::sampleStats() {
+    std::lock_guard<std::mutex> locker(_mutex);
+    Stats stats = _stats;
+    _stats = Stats();
+    return stats;
+}
+
+void SendQueueScheduler::schedule(QueueID queueID, QueueState& state, Clock::time_point dueTime) {
+    state.dueTime = dueTime;
+    ++state.generation;
+
+    _steps.push_back({ dueTime, _nextOrder++, queueID, state.generation });
+    std::push_heap(_steps.begin(), _steps.end());
+}
+
+void SendQueueScheduler::forget(QueueID queueID) {
+    auto it = _queues.find(queueID);
+    if (it != _queues.end()) {
+        _queueIDs.erase(it->second.queue);
+        _queues.erase(it);
+    }
+}
+
+void SendQueueScheduler::run() {
+    std::unique_lock<std::mutex> locker(_mutex);
+
+    while (!_isStopping) {
+        if (_steps.empty()) {
+            _queuesChanged.wait(locker);
+            continue;
+        }
+
+        ScheduledStep next = _steps.front();
+
+        auto it = _queues.find(next.queueID);
+        if (it == _queues.end() || it->second.generation != next.generation || it->second.isRunning) {
+            // this step is for a queue that was removed or has since been rescheduled
+            std::pop_heap(_steps.begin(), _steps.end());
+            _steps.pop_back();
+            continue;
+        }
+
+        auto now = Clock::now();
+        if (next.dueTime > now) {
+            // sleep until the step is due, or until a step is scheduled that is due sooner
+            _queuesChanged.wait_until(locker, next.dueTime);
+            continue;
+        }
+
+        std::pop_heap(_steps.begin(), _steps.end());
+        _steps.pop_back();
+
+        QueueID queueID = next.queueID;
+        SendQueue* queue = it->second.queue;
+        it->second.isRunning = true;
+        it->second.wasWoken = false;
+
+        quint64 lateness = std::chrono::duration_cast<std::chrono::microseconds>(now - next.dueTime).count();
+        ++_stats.steps;
+        _stats.totalLatenessUsecs += lateness;
+        _stats.maxLatenessUsecs = std::max(_stats.maxLatenessUsecs, lateness);
+
+        locker.unlock();
+
+        Clock::time_point nextStepTime;
+        bool keepRunning = queue->step(nextStepTime);
+
+        locker.lock();
+
+        // whoever removes a queue waits for us, so it is still known here
+        QueueState& state = _queues[queueID];
+        state.isRunning = false;
+
+        if (state.isRemoved) {
+            _queuesChanged.notify_all();
+        } else if (!keepRunning) {
+            // the queue stopped, it is not run again
+            forget(queueID);
+        } else {
+            schedule(queueID, state, state.wasWoken ? Clock::now() : nextStepTime);
+
+            // another thread might be waiting on a step that is due later than this one
+            _queuesChanged.notify_all();
+        }
+    }
+}
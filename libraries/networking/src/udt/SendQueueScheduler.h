@@ -0,0 +1,109 @@
+//
+//  SendQueueScheduler.h
+//  libraries/networking/src/udt
+//
+//  Created by High Fidelity on 2/4/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SendQueueScheduler_h
+#define hifi_SendQueueScheduler_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+class SendQueue;
+
+// Runs the SendQueue of every reliable connection of a Socket on a small, fixed set of threads.
+// Each queue tells the scheduler when it next wants to send, which is how its congestion control packet send period
+// is kept, and the scheduler runs the queue that is due the soonest. A queue is only ever run by one thread at a time.
+class SendQueueScheduler {
+public:
+    using Clock = p_high_resolution_clock;
+
+    struct Stats {
+        quint64 steps { 0 };
+        quint64 totalLatenessUsecs { 0 }; // how long steps waited for a thread past the time they were due
+        quint64 maxLatenessUsecs { 0 };
+    };
+
+    SendQueueScheduler(int numThreads);
+    ~SendQueueScheduler();
+
+    // starts running a queue, its first step is due right away
+    void add(SendQueue* queue);
+
+    // stops running a queue, waiting for a thread that is in the middle of a step of it
+    void remove(SendQueue* queue);
+
+    // runs the next step of a queue as soon as possible, for when it has something new to send
+    void wake(SendQueue* queue);
+
+    int getNumThreads() const { return (int)_threads.size(); }
+    int getNumQueues();
+
+    Stats sampleStats(); // returns the stats since the last sample
+
+private:
+    // every queue added gets an ID of its own, so that the steps left over from a queue that is gone are never taken
+    // for the steps of a new queue at the same address
+    using QueueID = quint64;
+
+    struct ScheduledStep {
+        Clock::time_point dueTime;
+        quint64 order; // breaks ties between steps due at the same time in the order they were scheduled
+        QueueID queueID;
+        uint32_t generation; // steps from before the queue was last rescheduled are skipped
+
+        // std heaps keep the largest element on top, so the earliest step has to compare greatest
+        bool operator<(const ScheduledStep& other) const {
+            return (dueTime != other.dueTime) ? dueTime > other.dueTime : order > other.order;
+        }
+    };
+
+    struct QueueState {
+        SendQueue* queue { nullptr };
+        Clock::time_point dueTime;
+        uint32_t generation { 0 };
+        bool isRunning { false };
+        bool wasWoken { false }; // woken while it was running
+        bool isRemoved { false }; // removed while it was running
+    };
+
+    void run();
+    void schedule(QueueID queueID, QueueState& state, Clock::time_point dueTime);
+    void forget(QueueID queueID);
+
+    std::mutex _mutex;
+    std::condition_variable _queuesChanged;
+
+    std::vector<ScheduledStep> _steps;
+    std::unordered_map<QueueID, QueueState> _queues;
+    std::unordered_map<SendQueue*, QueueID> _queueIDs; // of the queues that are still scheduled
+    QueueID _nextQueueID { 0 };
+    quint64 _nextOrder { 0 };
+    bool _isStopping { false };
+
+    Stats _stats;
+
+    std::vector<std::thread> _threads;
+};
+
+} // namespace udt
+
+#endif // hifi_SendQueueScheduler_h
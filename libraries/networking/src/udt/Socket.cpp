@@ -11,6 +11,16 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <LogHandler.h>
@@ -19,6 +29,7 @@
 #include "Connection.h"
 #include "ControlPacket.h"
 #include "Packet.h"
+#include "PacketBatch.h"
 #include "../NLPacket.h"
 #include "../NLPacketList.h"
 #include "PacketList.h"
@@ -38,6 +49,11 @@ Socket::Socket(QObject* parent) :
     _synTimer->start(_synInterval);
 }
 
+void Socket::bind(const QHostAddress& address, quint16 port) {
+    _udpSocket.bind(address, port);
+    setSystemBufferSizes();
+}
+
 void Socket::rebind() {
     quint16 oldPort = _udpSocket.localPort();
     
@@ -144,6 +160,97 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
     return totalBytesSent;
 }
 
+qint64 Socket::writePacketBatch(PacketBatch& batch) {
+    auto& packets = batch._packets;
+    qint64 totalBytesSent = 0;
+    
+    // write the correct sequence numbers to the packets here, as writePacket would have
+    for (auto& batched : packets) {
+        batched.packet->writeSequenceNumber(++_unreliableSequenceNumbers[batched.sockAddr]);
+    }
+    
+    size_t nextPacket = 0;
+    
+#ifdef Q_OS_LINUX
+    int socketDescriptor = (int) _udpSocket.socketDescriptor();
+    
+    mmsghdr messages[MAX_DATAGRAMS_PER_SEND_BATCH];
+    iovec vectors[MAX_DATAGRAMS_PER_SEND_BATCH];
+    sockaddr_in destinations[MAX_DATAGRAMS_PER_SEND_BATCH];
+    
+    while (socketDescriptor != -1 && nextPacket < packets.size()) {
+        // gather the next run of IPv4 datagrams, anything else goes through writeDatagram
+        int numDatagrams = 0;
+        memset(messages, 0, sizeof(messages));
+        
+        for (size_t i = nextPacket; i < packets.size() && numDatagrams < MAX_DATAGRAMS_PER_SEND_BATCH; ++i) {
+            const Packet& packet = *packets[i].packet;
+            const HifiSockAddr& sockAddr = packets[i].sockAddr;
+            
+            if (sockAddr.getAddress().protocol() != QAbstractSocket::IPv4Protocol) {
+                break;
+            }
+            
+            memset(&destinations[numDatagrams], 0, sizeof(sockaddr_in));
+            destinations[numDatagrams].sin_family = AF_INET;
+            destinations[numDatagrams].sin_addr.s_addr = htonl(sockAddr.getAddress().toIPv4Address());
+            destinations[numDatagrams].sin_port = htons(sockAddr.getPort());
+            
+            vectors[numDatagrams].iov_base = const_cast<char*>(packet.getData());
+            vectors[numDatagrams].iov_len = packet.getDataSize();
+            
+            messages[numDatagrams].msg_hdr.msg_name = &destinations[numDatagrams];
+            messages[numDatagrams].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[numDatagrams].msg_hdr.msg_iov = &vectors[numDatagrams];
+            messages[numDatagrams].msg_hdr.msg_iovlen = 1;
+            
+            ++numDatagrams;
+        }
+        
+        if (numDatagrams == 0) {
+            totalBytesSent += writeDatagram(packets[nextPacket].packet->getData(),
+                                            packets[nextPacket].packet->getDataSize(), packets[nextPacket].sockAddr);
+            ++nextPacket;
+            continue;
+        }
+        
+        int numSent = sendmmsg(socketDescriptor, messages, numDatagrams, 0);
+        ++_numSendCalls;
+        
+        if (numSent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            
+            // like a failed writeDatagram, the datagram that failed is dropped and we carry on with the rest
+            static const QString WRITE_ERROR_REGEX = "Socket::writePacketBatch sendmmsg failed - .*";
+            static QString repeatedMessage
+                = LogHandler::getInstance().addRepeatedMessageRegex(WRITE_ERROR_REGEX);
+            
+            qCDebug(networking) << "Socket::writePacketBatch sendmmsg failed -" << strerror(errno);
+            numSent = 1;
+        } else {
+            for (int i = 0; i < numSent; ++i) {
+                totalBytesSent += messages[i].msg_len;
+            }
+            _numDatagramsSent += numSent;
+        }
+        
+        nextPacket += numSent;
+    }
+#endif
+    
+    // without sendmmsg each datagram is its own write
+    for (; nextPacket < packets.size(); ++nextPacket) {
+        totalBytesSent += writeDatagram(packets[nextPacket].packet->getData(), packets[nextPacket].packet->getDataSize(),
+                                        packets[nextPacket].sockAddr);
+    }
+    
+    batch.clear();
+    
+    return totalBytesSent;
+}
+
 void Socket::writeReliablePacket(Packet* packet, const HifiSockAddr& sockAddr) {
     findOrCreateConnection(sockAddr).sendReliablePacket(std::unique_ptr<Packet>(packet));
 }
@@ -160,6 +267,11 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     
     qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
     
+    ++_numSendCalls;
+    if (bytesWritten >= 0) {
+        ++_numDatagramsSent;
+    }
+    
     if (bytesWritten < 0) {
         // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
         static const QString WRITE_ERROR_REGEX = "Socket::writeDatagram QAbstractSocket::NetworkError - Unable to send a message";
@@ -233,61 +345,136 @@ void Socket::readPendingDatagrams() {
         HifiSockAddr senderSockAddr;
         
         // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        auto buffer = PacketBuffer(new char[packetSizeWithHeader]);
        
         // pull the datagram
         _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
                                 senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
         
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        ++_numReceiveCalls;
+        ++_numDatagramsReceived;
         
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                it->second(std::move(basePacket));
-            }
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        
+#ifdef Q_OS_LINUX
+        // QUdpSocket stops watching the descriptor when it signals readyRead, until a datagram is read through it.
+        // Now that one was, whatever else is waiting is drained in batches.
+        readPendingDatagramsBatched();
+#endif
+    }
+}
+
+void Socket::readPendingDatagramsBatched() {
+#ifdef Q_OS_LINUX
+    mmsghdr messages[MAX_DATAGRAMS_PER_RECEIVE_BATCH];
+    iovec vectors[MAX_DATAGRAMS_PER_RECEIVE_BATCH];
+    sockaddr_storage senderAddresses[MAX_DATAGRAMS_PER_RECEIVE_BATCH];
+    
+    int socketDescriptor = (int) _udpSocket.socketDescriptor();
+    
+    while (true) {
+        // make sure we have a recycled buffer to receive each datagram of this batch into
+        _bufferPool->acquire(_receiveBuffers, MAX_DATAGRAMS_PER_RECEIVE_BATCH);
+        
+        memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < MAX_DATAGRAMS_PER_RECEIVE_BATCH; ++i) {
+            vectors[i].iov_base = _receiveBuffers[i].get();
+            vectors[i].iov_len = PacketBufferPool::BUFFER_SIZE;
             
-            return;
+            messages[i].msg_hdr.msg_name = &senderAddresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(senderAddresses[i]);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
         }
         
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+        int numDatagrams = recvmmsg(socketDescriptor, messages, MAX_DATAGRAMS_PER_RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
         
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            
-            // move this control packet to the matching connection
-            auto& connection = findOrCreateConnection(senderSockAddr);
-            connection.processControl(move(controlPacket));
+        if (numDatagrams < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                qCDebug(networking) << "Socket::readPendingDatagramsBatched recvmmsg failed -" << strerror(errno);
+            }
+            break;
+        }
+        
+        ++_numReceiveCalls;
+        _numDatagramsReceived += numDatagrams;
+        
+        for (int i = 0; i < numDatagrams; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                // larger than any packet we send, drop it - the buffer goes back to the pool
+                qCDebug(networking) << "Socket::readPendingDatagramsBatched dropping a datagram larger than"
+                    << PacketBufferPool::BUFFER_SIZE << "bytes";
+                continue;
+            }
             
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    
-                    if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                  packet->getDataSize(),
-                                                                  packet->getPayloadSize())) {
-                        // the connection indicated that we should not continue processing this packet
-                        return;
-                    }
-                }
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&senderAddresses[i]));
+            processDatagram(std::move(_receiveBuffers[i]), (int) messages[i].msg_len, senderSockAddr);
+        }
+        
+        // the buffers of this batch now belong to their packets, or return to the pool for the dropped datagrams
+        _receiveBuffers.erase(_receiveBuffers.begin(), _receiveBuffers.begin() + numDatagrams);
+        
+        if (numDatagrams < MAX_DATAGRAMS_PER_RECEIVE_BATCH) {
+            // the socket is drained, QUdpSocket signals readyRead when there is more
+            break;
+        }
+    }
+#endif
+}
 
-                if (packet->isPartOfMessage()) {
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    connection.queueReceivedMessagePacket(std::move(packet));
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+void Socket::processDatagram(PacketBuffer buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+    
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            it->second(std::move(basePacket));
+        }
+        
+        return;
+    }
+    
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+    
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        
+        // move this control packet to the matching connection
+        auto& connection = findOrCreateConnection(senderSockAddr);
+        connection.processControl(move(controlPacket));
+        
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                
+                if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                              packet->getDataSize(),
+                                                              packet->getPayloadSize())) {
+                    // the connection indicated that we should not continue processing this packet
+                    return;
                 }
             }
+
+            if (packet->isPartOfMessage()) {
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                connection.queueReceivedMessagePacket(std::move(packet));
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
+            }
         }
     }
 }
@@ -362,6 +549,14 @@ Socket::StatsVector Socket::sampleStatsForAllConnections() {
     return result;
 }
 
+SendQueueScheduler& Socket::getSendQueueScheduler() {
+    if (!_sendQueueScheduler) {
+        // sockets that never send reliably don't start any threads
+        int numThreads = std::min(QThread::idealThreadCount(), MAX_SEND_QUEUE_SCHEDULER_THREADS);
+        _sendQueueScheduler.reset(new SendQueueScheduler(numThreads));
+    }
+    return *_sendQueueScheduler;
+}
 
 std::vector<HifiSockAddr> Socket::getConnectionSockAddrs() {    
     std::vector<HifiSockAddr> addr;
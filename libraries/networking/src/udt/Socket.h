@@ -14,6 +14,7 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 
@@ -24,6 +25,8 @@
 #include "../HifiSockAddr.h"
 #include "CongestionControl.h"
 #include "Connection.h"
+#include "PacketBufferPool.h"
+#include "SendQueueScheduler.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -33,6 +36,7 @@ namespace udt {
 
 class BasePacket;
 class Packet;
+class PacketBatch;
 class PacketList;
 class SequenceNumber;
 
@@ -57,10 +61,11 @@ public:
     qint64 writePacket(const Packet& packet, const HifiSockAddr& sockAddr);
     qint64 writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr);
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
+    qint64 writePacketBatch(PacketBatch& batch); // sends and clears the batch, with as few syscalls as we can
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
     
-    void bind(const QHostAddress& address, quint16 port = 0) { _udpSocket.bind(address, port); setSystemBufferSizes(); }
+    void bind(const QHostAddress& address, quint16 port = 0);
     void rebind();
     
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
@@ -77,6 +82,9 @@ public:
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
     
     StatsVector sampleStatsForAllConnections();
+    
+    // runs the send queues of all reliable connections, started with the first one
+    SendQueueScheduler& getSendQueueScheduler();
 
 public slots:
     void cleanupConnection(HifiSockAddr sockAddr);
@@ -88,6 +96,8 @@ private slots:
     
 private:
     void setSystemBufferSizes();
+    void readPendingDatagramsBatched(); // drains the socket with recvmmsg on Linux
+    void processDatagram(PacketBuffer buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr);
     Connection& findOrCreateConnection(const HifiSockAddr& sockAddr);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
@@ -107,10 +117,23 @@ private:
     
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
+    
+    // declared before the connections so that it outlives their send queues
+    std::unique_ptr<SendQueueScheduler> _sendQueueScheduler;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
     
     int _synInterval = 10; // 10ms
     QTimer* _synTimer;
+
+    // on Linux the socket is drained in batches with recvmmsg, into recycled buffers
+    std::shared_ptr<PacketBufferPool> _bufferPool { PacketBufferPool::create(MAX_POOLED_RECEIVE_BUFFERS) };
+    std::vector<PacketBuffer> _receiveBuffers;
+
+    quint64 _numReceiveCalls { 0 };
+    quint64 _numDatagramsReceived { 0 };
+    
+    std::atomic<quint64> _numSendCalls { 0 };
+    std::atomic<quint64> _numDatagramsSent { 0 };
     
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<DefaultCC>() };
     
@@ -41,6 +41,7 @@
 #include <PathUtils.h>
 #include <Gzip.h>
 
+#include "OctreeBinarySnapshot.h"
 #include "OctreeConstants.h"
 #include "OctreeElementBag.h"
 #include "Octree.h"
@@ -48,7 +49,7 @@
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "hfb"};
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale) {
     return voxelSizeScale / powf(2, renderLevel);
@@ -1631,8 +1632,10 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElementPointer element,
 }
 
 bool Octree::readFromFile(const char* fileName) {
-    QString qFileName = findMostRecentFileExtension(fileName, PERSIST_EXTENSIONS);
+    return readFromPersistFile(findMostRecentFileExtension(fileName, PERSIST_EXTENSIONS));
+}
 
+bool Octree::readFromPersistFile(const QString& qFileName) {
     if (qFileName.endsWith(".json.gz")) {
         return readJSONFromGzippedFile(qFileName);
     }
@@ -1640,7 +1643,7 @@ bool Octree::readFromFile(const char* fileName) {
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "unable to open for reading: " << fileName;
+        qCritical() << "unable to open for reading: " << qFileName;
         return false;
     }
 
@@ -1714,6 +1717,11 @@ bool Octree::readFromURL(const QString& urlString) {
 bool Octree::readFromStream(unsigned long streamLength, QDataStream& inputStream) {
     // decide if this is binary SVO or JSON-formatted SVO
     QIODevice *device = inputStream.device();
+    if (OctreeBinarySnapshot::isSnapshot(device)) {
+        qCDebug(octree) << "Reading from binary snapshot Stream length:" << streamLength;
+        return readBinaryFromStream(streamLength, inputStream);
+    }
+
     char firstChar;
     device->getChar(&firstChar);
     device->ungetChar(firstChar);
@@ -1900,6 +1908,8 @@ void Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "hfb") {
+        writeToBinaryFile(cFileName, element);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -1950,6 +1960,85 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     }
 }
 
+bool Octree::readBinaryFromStream(unsigned long streamLength, QDataStream& inputStream) {
+    PacketType gotType;
+    PacketVersion gotVersion;
+    if (!OctreeBinarySnapshot::readHeader(inputStream, gotType, gotVersion)) {
+        return false;
+    }
+    if (gotType != expectedDataPacketType()) {
+        qCritical() << "binary snapshot is of type" << gotType << "expected" << expectedDataPacketType();
+        return false;
+    }
+
+    QIODevice* device = inputStream.device();
+    qint64 startPosition = device->pos();
+
+    // chunks are handed to the tree in batches, so it can decode a batch on several threads while only a batch of
+    // the file is in memory at a time
+    QVector<QByteArray> batch;
+    batch.reserve(OctreeBinarySnapshot::CHUNKS_PER_BATCH);
+    while (true) {
+        QByteArray chunk;
+        if (!OctreeBinarySnapshot::readChunk(inputStream, chunk)) {
+            return false;
+        }
+
+        bool isEnd = chunk.isEmpty();
+        if (!isEnd) {
+            batch << chunk;
+        }
+
+        if (batch.size() == OctreeBinarySnapshot::CHUNKS_PER_BATCH || (isEnd && !batch.isEmpty())) {
+            if (!readFromBinaryChunks(batch, gotVersion)) {
+                qCritical() << "failed to read entities from binary snapshot";
+                return false;
+            }
+            batch.clear();
+
+            if (streamLength > 0 && !device->isSequential()) {
+                emit importProgress((int)(100 * (device->pos() - startPosition) / (qint64)streamLength));
+            }
+        }
+
+        if (isEnd) {
+            return true;
+        }
+    }
+}
+
+void Octree::writeToBinaryFile(const char* fileName, OctreeElementPointer element) {
+    qCDebug(octree, "Saving binary snapshot to file %s...", fileName);
+
+    OctreeElementPointer top;
+    if (element) {
+        top = element;
+    } else {
+        top = _rootElement;
+    }
+
+    QVector<QByteArray> records;
+    if (!writeToBinaryRecords(records, top)) {
+        qCritical("Failed to convert the octree to binary records while saving a binary snapshot.");
+        return;
+    }
+
+    QFile persistFile(fileName);
+    if (!persistFile.open(QIODevice::WriteOnly)) {
+        qCritical("Could not write binary snapshot.");
+        return;
+    }
+
+    QDataStream outputStream(&persistFile);
+    PacketType expectedType = expectedDataPacketType();
+    OctreeBinarySnapshot::writeHeader(outputStream, expectedType, versionForPacketType(expectedType));
+    OctreeBinarySnapshot::writeRecords(outputStream, records);
+
+    if (outputStream.status() != QDataStream::Ok) {
+        qCritical("Failed to write binary snapshot.");
+    }
+}
+
 void Octree::writeToSVOFile(const char* fileName, OctreeElementPointer element) {
     qWarning() << "SVO file format depricated. Support for reading SVO files is no longer support and will be removed soon.";
 
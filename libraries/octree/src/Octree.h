@@ -37,6 +37,13 @@ using OctreePointer = std::shared_ptr<Octree>;
 
 extern QVector<QString> PERSIST_EXTENSIONS;
 
+/// an edit that was decoded from an edit packet and has yet to be applied to the tree, see Octree::decodeEditPacketData()
+class OctreeDecodedEdit {
+public:
+    virtual ~OctreeDecodedEdit() { }
+};
+using OctreeDecodedEditPointer = std::unique_ptr<OctreeDecodedEdit>;
+
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
 class RecurseOctreeOperator {
 public:
@@ -220,6 +227,12 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Splits processEditPacketData() in two, so that edits can be decoded without the tree lock and then applied in
+    // batches under a single write lock. Returns the bytes read, or -1 if the tree can only use processEditPacketData().
+    virtual int decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     OctreeDecodedEditPointer& edit) { return -1; }
+    virtual void applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& sourceNode) { } // needs a write lock
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -304,17 +317,32 @@ public:
     void writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "svo");
     void writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
     void writeToSVOFile(const char* filename, OctreeElementPointer element = NULL);
+    void writeToBinaryFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues) = 0;
 
     // Octree importers
-    bool readFromFile(const char* filename);
+    bool readFromFile(const char* filename); // reads the most recent of the file's PERSIST_EXTENSIONS
+    bool readFromPersistFile(const QString& fileName); // reads this file, whatever else is next to it
     bool readFromURL(const QString& url); // will support file urls as well...
     bool readFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readBinaryFromStream(unsigned long streamLength, QDataStream& inputStream);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // Journaled persistence - trees that support it keep track of what changed so that the persist thread can append
+    // just those changes to an OctreeJournal, and only rewrite the whole file when it compacts the journal.
+    virtual bool enableJournal() { return false; } // returns false if the tree has no journal support
+    virtual void takeJournalRecords(QVariantList& records) { } // the changes since the last call, needs a read lock
+    virtual void discardJournal() { } // forgets the changes since the last call, no lock needed
+    virtual void readJournalRecord(const QVariantMap& record) { } // re-applies a change while loading, needs a write lock
+
+    // Binary snapshots - trees that support them write themselves out as independent records, which are handed back a
+    // batch of chunks at a time while loading (see OctreeBinarySnapshot).
+    virtual bool writeToBinaryRecords(QVector<QByteArray>& records, OctreeElementPointer element) { return false; }
+    virtual bool readFromBinaryChunks(const QVector<QByteArray>& chunks, PacketVersion version) { return false; }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -0,0 +1,120 @@
+//
+//  OctreeBinarySnapshot.cpp
+//  libraries/octree/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <QDebug>
+#include <QtEndian>
+
+#include "OctreeBinarySnapshot.h"
+
+const QByteArray OctreeBinarySnapshot::MAGIC = "HFBS";
+
+// a chunk holds RECORDS_PER_CHUNK records, anything bigger than this is a corrupt file
+const quint32 MAX_CHUNK_BYTES = 256 * 1024 * 1024;
+
+bool OctreeBinarySnapshot::isSnapshot(QIODevice* device) {
+    return device && device->peek(MAGIC.size()) == MAGIC;
+}
+
+void OctreeBinarySnapshot::writeHeader(QDataStream& stream, PacketType dataType, PacketVersion dataVersion) {
+    stream.writeRawData(MAGIC.constData(), MAGIC.size());
+    stream << FORMAT_VERSION << (quint8)dataType << (quint8)dataVersion;
+}
+
+bool OctreeBinarySnapshot::readHeader(QDataStream& stream, PacketType& dataType, PacketVersion& dataVersion) {
+    QByteArray magic(MAGIC.size(), 0);
+    if (stream.readRawData(magic.data(), magic.size()) != magic.size() || magic != MAGIC) {
+        qCritical() << "not a binary snapshot";
+        return false;
+    }
+
+    quint32 formatVersion;
+    quint8 type;
+    quint8 version;
+    stream >> formatVersion >> type >> version;
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "binary snapshot header is truncated";
+        return false;
+    }
+    if (formatVersion != FORMAT_VERSION) {
+        qCritical() << "unsupported binary snapshot format version" << formatVersion;
+        return false;
+    }
+
+    dataType = (PacketType)type;
+    dataVersion = version;
+    return true;
+}
+
+void OctreeBinarySnapshot::writeRecords(QDataStream& stream, const QVector<QByteArray>& records) {
+    QByteArray chunk;
+    for (int start = 0; start < records.size(); start += RECORDS_PER_CHUNK) {
+        int end = std::min(start + RECORDS_PER_CHUNK, records.size());
+
+        chunk.resize(0);
+        for (int i = start; i < end; ++i) {
+            quint32 size = qToLittleEndian((quint32)records[i].size());
+            chunk.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            chunk.append(records[i]);
+        }
+
+        stream << (quint32)(end - start) << (quint32)chunk.size();
+        stream.writeRawData(chunk.constData(), chunk.size());
+    }
+
+    // the end of the file is an empty chunk
+    stream << (quint32)0 << (quint32)0;
+}
+
+bool OctreeBinarySnapshot::readChunk(QDataStream& stream, QByteArray& chunk) {
+    quint32 numRecords;
+    quint32 numBytes;
+    stream >> numRecords >> numBytes;
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "binary snapshot ends without an end of file marker";
+        return false;
+    }
+    if (numBytes > MAX_CHUNK_BYTES || (numRecords == 0) != (numBytes == 0)) {
+        qCritical() << "binary snapshot has a corrupt chunk of" << numRecords << "records in" << numBytes << "bytes";
+        return false;
+    }
+
+    chunk.resize(numBytes);
+    if (numBytes > 0 && stream.readRawData(chunk.data(), numBytes) != (int)numBytes) {
+        qCritical() << "binary snapshot has a truncated chunk";
+        return false;
+    }
+    return true;
+}
+
+bool OctreeBinarySnapshot::splitChunk(const QByteArray& chunk, QVector<QByteArray>& records) {
+    const char* dataAt = chunk.constData();
+    const char* end = dataAt + chunk.size();
+
+    while (dataAt < end) {
+        quint32 size;
+        if (end - dataAt < (int)sizeof(size)) {
+            return false;
+        }
+        memcpy(&size, dataAt, sizeof(size));
+        size = qFromLittleEndian(size);
+        dataAt += sizeof(size);
+
+        if ((quint32)(end - dataAt) < size) {
+            return false;
+        }
+        records << QByteArray::fromRawData(dataAt, size);
+        dataAt += size;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+//
+//  OctreeBinarySnapshot.h
+//  libraries/octree/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeBinarySnapshot_h
+#define hifi_OctreeBinarySnapshot_h
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QVector>
+
+#include <udt/PacketHeaders.h>
+
+/// The binary persist file format, for trees that can write themselves out as a list of independent records.
+/// After a short header the records are stored in chunks, each prefixed with its record count and size, and the file
+/// ends with an empty chunk. A reader only needs one chunk at a time, and the records of a batch of chunks can be
+/// decoded on several threads before they are added to the tree.
+class OctreeBinarySnapshot {
+public:
+    static const QByteArray MAGIC;
+    static const quint32 FORMAT_VERSION = 1;
+    static const int RECORDS_PER_CHUNK = 256;
+    static const int CHUNKS_PER_BATCH = 64; // how many chunks a reader hands to the tree at once
+
+    /// true if the device is positioned at the start of a binary snapshot, nothing is read from it
+    static bool isSnapshot(QIODevice* device);
+
+    static void writeHeader(QDataStream& stream, PacketType dataType, PacketVersion dataVersion);
+    static bool readHeader(QDataStream& stream, PacketType& dataType, PacketVersion& dataVersion);
+
+    /// writes the records in chunks of RECORDS_PER_CHUNK, followed by the end of file marker
+    static void writeRecords(QDataStream& stream, const QVector<QByteArray>& records);
+
+    /// reads the next chunk, an empty chunk means the end of the file was reached
+    static bool readChunk(QDataStream& stream, QByteArray& chunk);
+
+    /// splits a chunk into its records, which share the memory of the chunk so it has to outlive them
+    static bool splitChunk(const QByteArray& chunk, QVector<QByteArray>& records);
+};
+
+#endif // hifi_OctreeBinarySnapshot_h
@@ -0,0 +1,146 @@
+//
+//  OctreeJournal.cpp
+//  libraries/octree/src
+//
+//  Created by High Fidelity on 2/5/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "OctreeLogging.h"
+#include "OctreeJournal.h"
+
+OctreeJournal::OctreeJournal(const QString& filename) :
+    _file(filename)
+{
+}
+
+bool OctreeJournal::open() {
+    if (_file.isOpen()) {
+        return true;
+    }
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(octree) << "Could not open octree journal" << _file.fileName() << "-" << _file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool OctreeJournal::append(const QVariantList& records) {
+    if (records.isEmpty()) {
+        return true;
+    }
+    if (!open()) {
+        return false;
+    }
+
+    QByteArray data;
+    foreach (const QVariant& record, records) {
+        data += QJsonDocument(QJsonObject::fromVariantMap(record.toMap())).toJson(QJsonDocument::Compact);
+        data += '\n';
+    }
+
+    if (_file.write(data) != data.size() || !_file.flush()) {
+        qCWarning(octree) << "Could not write to octree journal" << _file.fileName() << "-" << _file.errorString();
+        return false;
+    }
+
+    _recordsAppended += records.size();
+    return true;
+}
+
+bool OctreeJournal::read(QVariantList& records) {
+    QFile file(_file.fileName());
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(octree) << "Could not open octree journal" << file.fileName() << "for reading -" << file.errorString();
+        return false;
+    }
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        QJsonDocument document = QJsonDocument::fromJson(line);
+        if (!line.endsWith('\n') || !document.isObject()) {
+            // the last write was cut short, nothing after it made it to disk
+            qCWarning(octree) << "Ignoring torn record at the end of octree journal" << file.fileName();
+            break;
+        }
+        records << document.object().toVariantMap();
+    }
+    return true;
+}
+
+static bool appendFile(const QString& filename, const QString& toFilename) {
+    QFile file(filename);
+    QFile toFile(toFilename);
+    if (!file.open(QIODevice::ReadOnly) || !toFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    return toFile.write(data) == data.size() && toFile.flush();
+}
+
+bool OctreeJournal::beginCompaction() {
+    _file.close();
+    if (!_file.exists()) {
+        return true;
+    }
+
+    QString compactingFilename = getCompactingFilename();
+    bool isMovedAside;
+    if (QFile::exists(compactingFilename)) {
+        // the records of a compaction that never finished still come first
+        isMovedAside = appendFile(_file.fileName(), compactingFilename) && QFile::remove(_file.fileName());
+    } else {
+        isMovedAside = QFile::rename(_file.fileName(), compactingFilename);
+    }
+    if (!isMovedAside) {
+        qCWarning(octree) << "Could not move octree journal" << _file.fileName() << "to" << compactingFilename;
+    }
+    return isMovedAside;
+}
+
+void OctreeJournal::endCompaction() {
+    QString compactingFilename = getCompactingFilename();
+    if (QFile::exists(compactingFilename) && !QFile::remove(compactingFilename)) {
+        qCWarning(octree) << "Could not remove compacted octree journal" << compactingFilename;
+    }
+}
+
+void OctreeJournal::recoverCompaction(bool isFileWritten) {
+    QString compactingFilename = getCompactingFilename();
+    if (!QFile::exists(compactingFilename)) {
+        return;
+    }
+
+    if (isFileWritten) {
+        qCDebug(octree) << "Dropping octree journal records that made it into the persist file -" << compactingFilename;
+        endCompaction();
+        return;
+    }
+
+    // Each step can be cut short and redone: the records that may end up in the journal twice are all newer than the
+    // ones before them, and replaying them again leaves the tree the same.
+    qCDebug(octree) << "Restoring octree journal records that did not make it into the persist file -"
+        << compactingFilename;
+    _file.close();
+    if (_file.exists() && !(appendFile(_file.fileName(), compactingFilename) && QFile::remove(_file.fileName()))) {
+        qCWarning(octree) << "Could not restore octree journal" << _file.fileName() << "from" << compactingFilename;
+        return;
+    }
+    if (!QFile::rename(compactingFilename, _file.fileName())) {
+        qCWarning(octree) << "Could not restore octree journal" << _file.fileName() << "from" << compactingFilename;
+    }
+}
+
+qint64 OctreeJournal::getSize() const {
+    return _file.isOpen() ? _file.size() : QFileInfo(_file.fileName()).size();
+}
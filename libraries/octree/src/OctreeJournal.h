@@ -0,0 +1,57 @@
+//
+//  OctreeJournal.h
+//  libraries/octree/src
+//
+//  Created by High Fidelity on 2/5/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournal_h
+#define hifi_OctreeJournal_h
+
+#include <QFile>
+#include <QString>
+#include <QVariantList>
+
+/// Append-only log of the changes made to a tree since its persist file was last written. Each record is one line of
+/// compact JSON, so a record torn by a crash only loses that record and the ones after it.
+///
+/// While the persist file is rewritten the records are moved aside to <journal>.compacting, so that the ones from
+/// before the rewrite are never replayed over the file that already has them.
+class OctreeJournal {
+public:
+    OctreeJournal(const QString& filename);
+
+    QString getFilename() const { return _file.fileName(); }
+
+    /// appends the records and flushes them to disk, returns false if they could not be written
+    bool append(const QVariantList& records);
+
+    /// reads every complete record in the journal
+    bool read(QVariantList& records);
+
+    /// moves the records aside before the persist file is rewritten, new records go to an empty journal
+    bool beginCompaction();
+
+    /// drops the records moved aside, once the persist file has everything in them
+    void endCompaction();
+
+    /// deals with a compaction that was cut short, before the journal is read: the records moved aside are dropped if
+    /// the persist file was written, or else put back in front of the newer ones
+    void recoverCompaction(bool isFileWritten);
+
+    qint64 getSize() const;
+    quint64 getRecordsAppended() const { return _recordsAppended; }
+
+private:
+    bool open();
+    QString getCompactingFilename() const { return _file.fileName() + ".compacting"; }
+
+    QFile _file;
+    quint64 _recordsAppended { 0 };
+};
+
+#endif // hifi_OctreeJournal_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <time.h>
@@ -18,6 +19,7 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -30,6 +32,9 @@
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::JOURNAL_FLUSH_INTERVAL = 1000; // every second
+const qint64 OctreePersistThread::JOURNAL_COMPACTION_SIZE = 16 * 1024 * 1024;
+const int OctreePersistThread::JOURNAL_COMPACTION_AGE = 1000 * 60 * 10; // every 10 minutes
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
@@ -43,7 +48,8 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _journal(fileNameWithoutExtension(filename, PERSIST_EXTENSIONS) + ".journal")
 {
     parseSettings(settings);
 
@@ -57,6 +63,8 @@ QString OctreePersistThread::getPersistFileMimeType() const {
         return "application/json";
     } if (_persistAsFileType == "json.gz") {
         return "application/zip";
+    } if (_persistAsFileType == "hfb") {
+        return "application/octet-stream";
     }
     return "";
 }
@@ -151,20 +159,40 @@ bool OctreePersistThread::process() {
                 // that file as our persist file.
                 restoreFromMostRecentBackup();
 
+                // the journal records moved aside for that save are not in the file, this is done before the lock
+                // file is removed so that a crash in the middle of it is recovered the same way
+                _journal.recoverCompaction(false);
+
                 lockFile.close();
                 qCDebug(octree) << "Loading Octree... lock file closed:" << lockFileName;
                 remove(qPrintable(lockFileName));
                 qCDebug(octree) << "Loading Octree... lock file removed:" << lockFileName;
+            } else {
+                // the last save finished, whatever it moved aside from the journal is in the file
+                _journal.recoverCompaction(true);
             }
 
+            QString persistFileName = findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS);
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            if (!persistantFileRead && QFileInfo(persistFileName).exists()) {
+                persistantFileRead = recoverFromUnreadableFile(persistFileName);
+            }
+            replayJournal(); // bring the tree up to date with the changes made since the file was written
             _tree->pruneTree();
         });
 
         quint64 loadDone = usecTimestampNow();
         _loadTimeUSecs = loadDone - loadStarted;
 
-        _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        if (_journal.getSize() > 0) {
+            // the journal still holds changes that are not in the file - fold them in with the next persist
+            _tree->setDirtyBit();
+        } else {
+            _tree->clearDirtyBit(); // the tree is clean since we just loaded it
+        }
+
+        // from here on changes go to the journal, if the tree supports one
+        _wantJournal = _tree->enableJournal();
         qCDebug(octree, "DONE loading Octrees from file... fileRead=%s", debug::valueOf(persistantFileRead));
 
         unsigned long nodeCount = OctreeElement::getNodeCount();
@@ -210,9 +238,21 @@ bool OctreePersistThread::process() {
         quint64 sinceLastSave = now - _lastCheck;
         quint64 intervalToCheck = _persistInterval * MSECS_TO_USECS;
 
+        if (_dirtySince == 0 && _tree->isDirty()) {
+            _dirtySince = now;
+        }
+
         if (sinceLastSave > intervalToCheck) {
             _lastCheck = now;
-            persist();
+            if (!_wantJournal || isJournalDueForCompaction(now)) {
+                persist();
+            } else {
+                _lastJournalFlush = now;
+                flushJournal();
+            }
+        } else if (_wantJournal && now - _lastJournalFlush > JOURNAL_FLUSH_INTERVAL * MSECS_TO_USECS) {
+            _lastJournalFlush = now;
+            flushJournal();
         }
     }
     
@@ -248,7 +288,7 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
 }
 
 void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
+    if (_tree->isDirty() && _initialLoadComplete && !_persistBlocked) {
 
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -267,19 +307,117 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
+            // Everything journaled so far is about to be in the file. It is moved aside while the lock file is there,
+            // so that a crash before the file is written replays it, and a crash after doesn't.
+            if (!_journal.beginCompaction()) {
+                lockFile.close();
+                remove(qPrintable(lockFileName));
+                qCDebug(octree) << "Not saving Octree, its journal could not be compacted";
+                return;
+            }
+            if (_wantJournal) {
+                _tree->discardJournal();
+            }
+
             _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
             time(&_lastPersistTime);
             _tree->clearDirtyBit(); // tree is clean after saving
+            _dirtySince = 0;
             qCDebug(octree) << "DONE saving Octree to file...";
 
             lockFile.close();
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
             remove(qPrintable(lockFileName));
             qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
+
+            _journal.endCompaction();
         }
     }
 }
 
+// A file that is there but can't be read - say a binary snapshot written by a newer server - must not be overwritten
+// by whatever the tree holds instead, so a copy of it is kept, and the tree falls back to the most recent file in
+// another format, like the JSON a domain was persisted as before it switched to binary snapshots.
+bool OctreePersistThread::recoverFromUnreadableFile(const QString& unreadableFileName) {
+    // throw away whatever part of the file was read
+    _tree->eraseAllOctreeElements();
+
+    QString keptFileName = unreadableFileName + ".unreadable-"
+        + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
+    bool isKept = QFile::copy(unreadableFileName, keptFileName);
+    if (isKept) {
+        qCritical() << "Could not read" << unreadableFileName << "- a copy of it is kept at" << keptFileName;
+    } else {
+        qCritical() << "Could not read" << unreadableFileName << "and could not keep a copy of it";
+    }
+
+    QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
+    QFileInfo unreadableFile(unreadableFileName);
+    QFileInfoList otherFiles;
+    foreach (const QString& extension, PERSIST_EXTENSIONS) {
+        QFileInfo otherFile(sansExt + "." + extension);
+        if (otherFile.exists() && otherFile.absoluteFilePath() != unreadableFile.absoluteFilePath()) {
+            otherFiles << otherFile;
+        }
+    }
+    std::sort(otherFiles.begin(), otherFiles.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastModified() > b.lastModified();
+    });
+
+    foreach (const QFileInfo& otherFile, otherFiles) {
+        if (_tree->readFromPersistFile(otherFile.absoluteFilePath())) {
+            qCritical() << "Loaded" << otherFile.absoluteFilePath() << "instead, from"
+                << otherFile.lastModified().toString();
+
+            // without a copy of the unreadable file, saving over it is left to an operator
+            _persistBlocked = !isKept;
+            if (_persistBlocked) {
+                qCritical() << "Not saving to" << _filename << "until it is moved out of the way";
+            }
+            return true;
+        }
+        _tree->eraseAllOctreeElements();
+    }
+
+    _persistBlocked = true;
+    qCritical() << "Nothing could be loaded in place of" << unreadableFileName << "- not saving to" << _filename
+        << "until an operator restores or removes it. Changes are still journaled to" << _journal.getFilename();
+    return false;
+}
+
+// Compacting rewrites the whole file, so it waits until the journal has grown big enough to slow down the next load,
+// or until the tree has had changes for a while - which also saves the changes that are not journaled, like
+// server-side kinematic motion.
+bool OctreePersistThread::isJournalDueForCompaction(quint64 now) const {
+    const quint64 MSECS_TO_USECS = 1000;
+    bool isOld = _dirtySince != 0 && now - _dirtySince >= JOURNAL_COMPACTION_AGE * MSECS_TO_USECS;
+    return isOld || _journal.getSize() >= JOURNAL_COMPACTION_SIZE;
+}
+
+void OctreePersistThread::flushJournal() {
+    QVariantList records;
+    _tree->withReadLock([&] {
+        _tree->takeJournalRecords(records);
+    });
+
+    if (!records.isEmpty() && _journal.append(records)) {
+        qCDebug(octree) << "journaled" << records.size() << "changes," << _journal.getSize() << "bytes in journal";
+    }
+}
+
+void OctreePersistThread::replayJournal() {
+    QVariantList records;
+    if (!_journal.read(records) || records.isEmpty()) {
+        return;
+    }
+
+    qCDebug(octree) << "Replaying" << records.size() << "changes from journal" << _journal.getFilename() << "...";
+    foreach (const QVariant& record, records) {
+        _tree->readJournalRecord(record.toMap());
+    }
+    qCDebug(octree) << "DONE replaying journal...";
+}
+
 void OctreePersistThread::restoreFromMostRecentBackup() {
     qCDebug(octree) << "Restoring from most recent backup...";
     
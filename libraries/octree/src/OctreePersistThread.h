@@ -17,6 +17,7 @@
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeJournal.h"
 
 /// Generalized threaded processor for handling received inbound packets.
 class OctreePersistThread : public GenericThread {
@@ -32,6 +33,9 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int JOURNAL_FLUSH_INTERVAL;
+    static const qint64 JOURNAL_COMPACTION_SIZE; // bytes
+    static const int JOURNAL_COMPACTION_AGE; // msecs since the tree was first changed after the last compaction
 
     OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool wantBackup = false, const QJsonObject& settings = QJsonObject(),
@@ -46,6 +50,12 @@ public:
     QString getPersistFileMimeType() const;
     QByteArray getPersistFileContents() const;
 
+    /// Trees with journal support have their changes appended to this journal between persists. Every persist
+    /// interval the journal is compacted into the persist file, if it has reached JOURNAL_COMPACTION_SIZE or the
+    /// oldest change in it JOURNAL_COMPACTION_AGE.
+    const OctreeJournal& getJournal() const { return _journal; }
+    bool isJournaling() const { return _wantJournal; }
+
 signals:
     void loadCompleted();
 
@@ -54,9 +64,13 @@ protected:
     virtual bool process();
 
     void persist();
+    bool isJournalDueForCompaction(quint64 now) const;
+    void flushJournal();
+    void replayJournal();
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
+    bool recoverFromUnreadableFile(const QString& unreadableFileName);
     bool getMostRecentBackup(const QString& format, QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime);
     quint64 getMostRecentBackupTimeInUsecs(const QString& format);
     void parseSettings(const QJsonObject& settings);
@@ -66,6 +80,7 @@ private:
     QString _filename;
     int _persistInterval;
     bool _initialLoadComplete;
+    bool _persistBlocked { false }; // nothing could be loaded from the files there are, so they are left alone
 
     quint64 _loadTimeUSecs;
 
@@ -78,6 +93,11 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    OctreeJournal _journal;
+    bool _wantJournal { false };
+    quint64 _lastJournalFlush { 0 };
+    quint64 _dirtySince { 0 }; // when the tree was first changed after the last persist, 0 while it is clean
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -9,6 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
+#include <memory>
+
 #include <QMetaType>
 #include <QRunnable>
 #include <QThreadPool>
@@ -51,9 +54,7 @@ Model::Model(RigPointer rig, QObject* parent) :
     _isVisible(true),
     _blendNumber(0),
     _appliedBlendNumber(0),
-    _calculatedMeshPartBoxesValid(false),
     _calculatedMeshBoxesValid(false),
-    _calculatedMeshTrianglesValid(false),
     _meshGroupsKnown(false),
     _isWireframe(false),
     _renderCollisionHull(false),
@@ -230,11 +231,26 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
 
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
 
+        // the triangles are kept in the frame of the geometry, shared by every model with the same URL, so the ray is
+        // mapped into that frame rather than the triangles into the world. The mapping is affine and the direction
+        // isn't normalized, so distances along the ray are the same in both frames.
+        MeshPickBVHsPointer meshBVHs;
+        glm::mat4 geometryToWorldMatrix;
+        glm::vec3 geometryFrameOrigin;
+        glm::vec3 geometryFrameDirection;
+        if (pickAgainstTriangles) {
+            meshBVHs = _geometry->getMeshPickBVHs();
+            geometryToWorldMatrix = getGeometryToWorldMatrix();
+            glm::mat4 worldToGeometryMatrix = glm::inverse(geometryToWorldMatrix);
+            geometryFrameOrigin = glm::vec3(worldToGeometryMatrix * glm::vec4(origin, 1.0f));
+            geometryFrameDirection = glm::vec3(worldToGeometryMatrix * glm::vec4(direction, 0.0f));
+        }
+
         // If we hit the models box, then consider the submeshes...
         _mutex.lock();
 
         if (!_calculatedMeshBoxesValid) {
-            recalculateMeshBoxes(pickAgainstTriangles);
+            recalculateMeshBoxes();
         }
 
         foreach (const AABox& subMeshBox, _calculatedMeshBoxes) {
@@ -242,25 +258,18 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
             if (subMeshBox.findRayIntersection(origin, direction, distanceToSubMesh, subMeshFace, subMeshSurfaceNormal)) {
                 if (distanceToSubMesh < bestDistance) {
                     if (pickAgainstTriangles) {
-                        if (!_calculatedMeshTrianglesValid) {
-                            recalculateMeshBoxes(pickAgainstTriangles);
-                        }
-                        // check our triangles here....
-                        const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                        int t = 0;
-                        foreach (const Triangle& triangle, meshTriangles) {
-                            t++;
-
-                            float thisTriangleDistance;
-                            if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance)) {
-                                if (thisTriangleDistance < bestDistance) {
-                                    bestDistance = thisTriangleDistance;
-                                    intersectedSomething = true;
-                                    face = subMeshFace;
-                                    surfaceNormal = triangle.getNormal();
-                                    extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
-                                }
-                            }
+                        float triangleDistance;
+                        glm::vec3 triangleNormal;
+                        if (subMeshIndex < (int)meshBVHs->size() &&
+                                (*meshBVHs)[subMeshIndex].findRayIntersection(geometryFrameOrigin,
+                                    geometryFrameDirection, triangleDistance, triangleNormal) &&
+                                triangleDistance < bestDistance) {
+                            bestDistance = triangleDistance;
+                            intersectedSomething = true;
+                            face = subMeshFace;
+                            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(geometryToWorldMatrix)));
+                            surfaceNormal = glm::normalize(normalMatrix * triangleNormal);
+                            extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
                         }
                     } else {
                         // this is the non-triangle picking case...
@@ -310,20 +319,25 @@ bool Model::convexHullContains(glm::vec3 point) {
     // we can use the AABox's contains() by mapping our point into the model frame
     // and testing there.
     if (modelFrameBox.contains(modelFramePoint)){
+        // test the point against the triangles in the frame of the geometry, which keeps which side of their planes
+        // it is on
+        MeshPickBVHsPointer meshBVHs = _geometry->getMeshPickBVHs();
+        glm::vec3 geometryFramePoint = glm::vec3(glm::inverse(getGeometryToWorldMatrix()) * glm::vec4(point, 1.0f));
+
         _mutex.lock();
-        if (!_calculatedMeshTrianglesValid) {
-            recalculateMeshBoxes(true);
+        if (!_calculatedMeshBoxesValid) {
+            recalculateMeshBoxes();
         }
 
         // If we are inside the models box, then consider the submeshes...
         int subMeshIndex = 0;
         foreach(const AABox& subMeshBox, _calculatedMeshBoxes) {
-            if (subMeshBox.contains(point)) {
+            if (subMeshBox.contains(point) && subMeshIndex < (int)meshBVHs->size()) {
                 bool insideMesh = true;
                 // To be inside the sub mesh, we need to be behind every triangles' planes
-                const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                foreach (const Triangle& triangle, meshTriangles) {
-                    if (!isPointBehindTrianglesPlane(point, triangle.v0, triangle.v1, triangle.v2)) {
+                const std::vector<Triangle>& meshTriangles = (*meshBVHs)[subMeshIndex].getTriangles();
+                for (const Triangle& triangle : meshTriangles) {
+                    if (!isPointBehindTrianglesPlane(geometryFramePoint, triangle.v0, triangle.v1, triangle.v2)) {
                         // it's not behind at least one so we bail
                         insideMesh = false;
                         break;
@@ -349,117 +363,20 @@ bool Model::convexHullContains(glm::vec3 point) {
 // can occur multiple times. In addition, rendering does it's own ray picking in order to decide which
 // entity-scripts to call.  I think it would be best to do the picking once-per-frame (in cpu, or gpu if possible)
 // and then the calls use the most recent such result.
-void Model::recalculateMeshBoxes(bool pickAgainstTriangles) {
+void Model::recalculateMeshBoxes() {
     PROFILE_RANGE(__FUNCTION__);
-    bool calculatedMeshTrianglesNeeded = pickAgainstTriangles && !_calculatedMeshTrianglesValid;
 
-    if (!_calculatedMeshBoxesValid || calculatedMeshTrianglesNeeded || (!_calculatedMeshPartBoxesValid && pickAgainstTriangles) ) {
+    if (!_calculatedMeshBoxesValid) {
         const FBXGeometry& geometry = _geometry->getFBXGeometry();
         int numberOfMeshes = geometry.meshes.size();
         _calculatedMeshBoxes.resize(numberOfMeshes);
-        _calculatedMeshTriangles.clear();
-        _calculatedMeshTriangles.resize(numberOfMeshes);
-        _calculatedMeshPartBoxes.clear();
         for (int i = 0; i < numberOfMeshes; i++) {
             const FBXMesh& mesh = geometry.meshes.at(i);
             Extents scaledMeshExtents = calculateScaledOffsetExtents(mesh.meshExtents, _translation, _rotation);
 
             _calculatedMeshBoxes[i] = AABox(scaledMeshExtents);
-
-            if (pickAgainstTriangles) {
-                QVector<Triangle> thisMeshTriangles;
-                for (int j = 0; j < mesh.parts.size(); j++) {
-                    const FBXMeshPart& part = mesh.parts.at(j);
-
-                    bool atLeastOnePointInBounds = false;
-                    AABox thisPartBounds;
-
-                    const int INDICES_PER_TRIANGLE = 3;
-                    const int INDICES_PER_QUAD = 4;
-
-                    if (part.quadIndices.size() > 0) {
-                        int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
-                        int vIndex = 0;
-                        for (int q = 0; q < numberOfQuads; q++) {
-                            int i0 = part.quadIndices[vIndex++];
-                            int i1 = part.quadIndices[vIndex++];
-                            int i2 = part.quadIndices[vIndex++];
-                            int i3 = part.quadIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-                            glm::vec3 mv3 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i3], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-                            thisPartBounds += mv3;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-                            glm::vec3 v3 = calculateScaledOffsetPoint(mv3);
-
-                            // Sam's recommended triangle slices
-                            Triangle tri1 = { v0, v1, v3 };
-                            Triangle tri2 = { v1, v2, v3 };
-
-                            // NOTE: Random guy on the internet's recommended triangle slices
-                            //Triangle tri1 = { v0, v1, v2 };
-                            //Triangle tri2 = { v2, v3, v0 };
-
-                            thisMeshTriangles.push_back(tri1);
-                            thisMeshTriangles.push_back(tri2);
-
-                        }
-                    }
-
-                    if (part.triangleIndices.size() > 0) {
-                        int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
-                        int vIndex = 0;
-                        for (int t = 0; t < numberOfTris; t++) {
-                            int i0 = part.triangleIndices[vIndex++];
-                            int i1 = part.triangleIndices[vIndex++];
-                            int i2 = part.triangleIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-
-                            Triangle tri = { v0, v1, v2 };
-
-                            thisMeshTriangles.push_back(tri);
-                        }
-                    }
-                    _calculatedMeshPartBoxes[QPair<int,int>(i, j)] = thisPartBounds;
-                }
-                _calculatedMeshTriangles[i] = thisMeshTriangles;
-                _calculatedMeshPartBoxesValid = true;
-            }
         }
         _calculatedMeshBoxesValid = true;
-        _calculatedMeshTrianglesValid = pickAgainstTriangles;
     }
 }
 
@@ -670,6 +587,12 @@ AABox Model::calculateScaledOffsetAABox(const AABox& box, glm::vec3 modelPositio
     return AABox(calculateScaledOffsetExtents(Extents(box), modelPosition, modelOrientation));
 }
 
+glm::mat4 Model::getGeometryToWorldMatrix() const {
+    // the same transform as calculateScaledOffsetPoint()
+    return glm::translate(_translation) * glm::mat4_cast(_rotation) * glm::scale(_scale) * glm::translate(_offset) *
+        _geometry->getFBXGeometry().offset;
+}
+
 glm::vec3 Model::calculateScaledOffsetPoint(const glm::vec3& point) const {
     // we need to include any fst scaling, translation, and rotation, which is captured in the offset matrix
     glm::vec3 offsetPoint = glm::vec3(_geometry->getFBXGeometry().offset * glm::vec4(point, 1.0f));
@@ -794,68 +717,78 @@ QStringList Model::getJointNames() const {
     return isActive() ? _geometry->getFBXGeometry().getJointNames() : QStringList();
 }
 
+// the blend of a model's vertices with its blendshape coefficients, shared by the Blenders it is split across
+class Blend {
+public:
+    Blend(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
+          const PackedBlendshapesPointer& blendshapes, const QVector<float>& blendshapeCoefficients, int numBlenders);
+
+    QPointer<Model> model;
+    int blendNumber;
+    QWeakPointer<NetworkGeometry> geometry;
+    PackedBlendshapesPointer blendshapes;
+    QVector<float> blendshapeCoefficients;
+
+    // each Blender writes its own range, through pointers taken before any of them start
+    QVector<glm::vec3> vertices;
+    QVector<glm::vec3> normals;
+    glm::vec3* vertexData;
+    glm::vec3* normalData;
+
+    std::atomic<int> remainingBlenders;
+};
+
+Blend::Blend(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
+             const PackedBlendshapesPointer& blendshapes, const QVector<float>& blendshapeCoefficients,
+             int numBlenders) :
+    model(model),
+    blendNumber(blendNumber),
+    geometry(geometry),
+    blendshapes(blendshapes),
+    blendshapeCoefficients(blendshapeCoefficients),
+    vertices(blendshapes->getNumVertices()),
+    normals(blendshapes->getNumVertices()),
+    vertexData(vertices.data()),
+    normalData(normals.data()),
+    remainingBlenders(numBlenders) {
+}
+
 class Blender : public QRunnable {
 public:
 
-    Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients);
+    Blender(const std::shared_ptr<Blend>& blend, int beginVertex, int endVertex);
 
     virtual void run();
 
 private:
 
-    QPointer<Model> _model;
-    int _blendNumber;
-    QWeakPointer<NetworkGeometry> _geometry;
-    QVector<FBXMesh> _meshes;
-    QVector<float> _blendshapeCoefficients;
+    std::shared_ptr<Blend> _blend;
+    int _beginVertex;
+    int _endVertex;
 };
 
-Blender::Blender(Model* model, int blendNumber, const QWeakPointer<NetworkGeometry>& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients) :
-    _model(model),
-    _blendNumber(blendNumber),
-    _geometry(geometry),
-    _meshes(meshes),
-    _blendshapeCoefficients(blendshapeCoefficients) {
+Blender::Blender(const std::shared_ptr<Blend>& blend, int beginVertex, int endVertex) :
+    _blend(blend),
+    _beginVertex(beginVertex),
+    _endVertex(endVertex) {
 }
 
 void Blender::run() {
     PROFILE_RANGE(__FUNCTION__);
-    QVector<glm::vec3> vertices, normals;
-    if (!_model.isNull()) {
-        int offset = 0;
-        foreach (const FBXMesh& mesh, _meshes) {
-            if (mesh.blendshapes.isEmpty()) {
-                continue;
-            }
-            vertices += mesh.vertices;
-            normals += mesh.normals;
-            glm::vec3* meshVertices = vertices.data() + offset;
-            glm::vec3* meshNormals = normals.data() + offset;
-            offset += mesh.vertices.size();
-            const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-            for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
-                float vertexCoefficient = _blendshapeCoefficients.at(i);
-                const float EPSILON = 0.0001f;
-                if (vertexCoefficient < EPSILON) {
-                    continue;
-                }
-                float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-                const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
-                for (int j = 0; j < blendshape.indices.size(); j++) {
-                    int index = blendshape.indices.at(j);
-                    meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
-                    meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
-                }
-            }
-        }
+    Blend& blend = *_blend;
+    if (!blend.model.isNull()) {
+        blend.blendshapes->blend(blend.blendshapeCoefficients, _beginVertex, _endVertex,
+                                 blend.vertexData, blend.normalData);
+    }
+
+    // the last Blender of the blend posts the result to the geometry cache, which will dispatch to the model if still
+    // alive
+    if (blend.remainingBlenders.fetch_sub(1) == 1) {
+        QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
+            Q_ARG(const QPointer<Model>&, blend.model), Q_ARG(int, blend.blendNumber),
+            Q_ARG(const QWeakPointer<NetworkGeometry>&, blend.geometry),
+            Q_ARG(const QVector<glm::vec3>&, blend.vertices), Q_ARG(const QVector<glm::vec3>&, blend.normals));
     }
-    // post the result to the geometry cache, which will dispatch to the model if still alive
-    QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
-        Q_ARG(const QPointer<Model>&, _model), Q_ARG(int, _blendNumber),
-        Q_ARG(const QWeakPointer<NetworkGeometry>&, _geometry), Q_ARG(const QVector<glm::vec3>&, vertices),
-        Q_ARG(const QVector<glm::vec3>&, normals));
 }
 
 void Model::setScaleToFit(bool scaleToFit, const glm::vec3& dimensions) {
@@ -944,7 +877,6 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
         //       not too bad at this point, because it doesn't impact rendering. However it does slow down ray picking
         //       because ray picking needs valid boxes to work
         _calculatedMeshBoxesValid = false;
-        _calculatedMeshTrianglesValid = false;
         onInvalidate();
 
         // check for scale to fit
@@ -1053,8 +985,20 @@ float Model::getLimbLength(int jointIndex) const {
 bool Model::maybeStartBlender() {
     const FBXGeometry& fbxGeometry = _geometry->getFBXGeometry();
     if (fbxGeometry.hasBlendedMeshes()) {
-        QThreadPool::globalInstance()->start(new Blender(this, ++_blendNumber, _geometry,
-            fbxGeometry.meshes, _blendshapeCoefficients));
+        PackedBlendshapesPointer blendshapes = _geometry->getPackedBlendshapes();
+
+        // split large meshes across threads, small ones aren't worth the overhead
+        const int MIN_VERTICES_PER_BLENDER = 8192;
+        int numVertices = blendshapes->getNumVertices();
+        int numBlenders = glm::clamp(numVertices / MIN_VERTICES_PER_BLENDER, 1, QThread::idealThreadCount());
+
+        auto blend = std::make_shared<Blend>(this, ++_blendNumber, _geometry, blendshapes, _blendshapeCoefficients,
+                                             numBlenders);
+        for (int i = 0; i < numBlenders; i++) {
+            int beginVertex = (int)((qint64)numVertices * i / numBlenders);
+            int endVertex = (int)((qint64)numVertices * (i + 1) / numBlenders);
+            QThreadPool::globalInstance()->start(new Blender(blend, beginVertex, endVertex));
+        }
         return true;
     }
     return false;
@@ -14,7 +14,6 @@
 #include <string>
 
 #include <QDebug>
-#include <QThread>
 
 #include "PerfStat.h"
 
@@ -80,30 +79,8 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // ----------------------------------------------------------------------------
 
 std::atomic<bool> PerformanceTimer::_isActive(false);
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
-
-PerformanceTimer::PerformanceTimer(const QString& name) {
-    if (_isActive) {
-        _name = name;
-        QString& fullName = _fullNames[QThread::currentThread()];
-        fullName.append("/");
-        fullName.append(_name);
-        _start = usecTimestampNow();
-    }
-}
-
-PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
-        quint64 elapsedusec = (usecTimestampNow() - _start);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedusec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
-    }
-}
-
 // static
 bool PerformanceTimer::isActive() {
     return _isActive;
@@ -113,8 +90,11 @@ bool PerformanceTimer::isActive() {
 void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
-        if (!active) {
-            _fullNames.clear();
+        Tracer::setConsumerActive(Tracer::PerformanceTimers, active);
+        if (active) {
+            // skip whatever was recorded for a trace before the timer was turned on
+            Tracer::forEachNewScope([](TracePathID path, quint64 elapsedUsecs) {});
+        } else {
             _records.clear();
         }
         
@@ -124,6 +104,21 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
+    // sum the scopes recorded since the last tally by path, then look their names up once
+    std::map<TracePathID, quint64> elapsedByPath;
+    Tracer::forEachNewScope([&](TracePathID path, quint64 elapsedUsecs) {
+        elapsedByPath[path] += elapsedUsecs;
+    });
+
+    static QHash<TracePathID, QString> pathNames;
+    for (auto& pathElapsed : elapsedByPath) {
+        auto nameIt = pathNames.find(pathElapsed.first);
+        if (nameIt == pathNames.end()) {
+            nameIt = pathNames.insert(pathElapsed.first, Tracer::getPathName(pathElapsed.first));
+        }
+        _records[nameIt.value()].accumulateResult(pathElapsed.second);
+    }
+
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
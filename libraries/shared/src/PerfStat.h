@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include "SharedUtil.h"
 #include "SimpleMovingAverage.h"
+#include "Trace.h"
 
 #include <atomic>
 #include <cstring>
@@ -73,11 +74,13 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
-class PerformanceTimer {
+/// Times a scope with the Tracer. While the timer is active the recorded scopes are tallied into records by the path
+/// of the scopes they were nested in, like "/paintGL/mainRender".
+class PerformanceTimer : public TraceScope {
 public:
-
-    PerformanceTimer(const QString& name);
-    ~PerformanceTimer();
+    template <size_t N>
+    PerformanceTimer(const char (&name)[N]) : TraceScope(name) {}
+    PerformanceTimer(TraceScope::DynamicName name) : TraceScope(name) {}
     
     static bool isActive();
     static void setActive(bool active);
@@ -88,12 +91,8 @@ public:
     static void dumpAllTimerRecords();
 
 private:
-    quint64 _start = 0;
-    QString _name;
     static std::atomic<bool> _isActive;
-    static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
 };
 
-
 #endif // hifi_PerfStat_h
@@ -339,6 +339,16 @@ QList<SpatiallyNestablePointer> SpatiallyNestable::getChildren() const {
     return children;
 }
 
+const SpatiallyNestable* SpatiallyNestable::getRootAncestor() const {
+    const SpatiallyNestable* root = this;
+    SpatiallyNestablePointer parent = getParentPointer();
+    while (parent) {
+        root = parent.get();
+        parent = parent->getParentPointer();
+    }
+    return root;
+}
+
 const Transform SpatiallyNestable::getAbsoluteJointTransformInObjectFrame(int jointIndex) const {
     Transform jointTransformInObjectFrame;
     glm::vec3 position = getAbsoluteJointTranslationInObjectFrame(jointIndex);
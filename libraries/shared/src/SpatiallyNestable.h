@@ -85,6 +85,11 @@ public:
     virtual void setLocalScale(const glm::vec3& scale);
 
     QList<SpatiallyNestablePointer> getChildren() const;
+
+    // the object at the top of this object's chain of parents, or this object if it has no parent.
+    // objects with the same root ancestor move together, so they can't be moved on different threads.
+    const SpatiallyNestable* getRootAncestor() const;
+
     NestableType getNestableType() const { return _nestableType; }
 
     // this object's frame
@@ -0,0 +1,399 @@
+//
+//  Trace.cpp
+//  libraries/shared/src
+//
+//  Created by High Fidelity on 2/17/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+#include "PortableHighResolutionClock.h"
+
+static const TracePathID ROOT_PATH = 0;
+static const TracePathID NULL_PATH = 0xffff;
+
+// a scope takes two words: its start in nanoseconds, then its length in nanoseconds above its kind and path ID
+struct TraceEvent {
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> durationKindAndPath;
+};
+
+static const uint64_t PATH_MASK = 0xffff;
+static const uint64_t RANGE_BIT = 1 << 16;
+static const int DURATION_SHIFT = 17;
+
+struct TraceRecord {
+    uint64_t start;
+    uint64_t duration;
+    TracePathID path;
+    bool isRange;
+};
+
+static uint64_t nowNsecs() {
+    auto sinceEpoch = p_high_resolution_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+}
+
+// literal names are keyed by their address, other names by a hash of their characters with the top bit set, which
+// user space addresses never have
+static const uint64_t DYNAMIC_NAME_BIT = 1ULL << 63;
+
+static uint64_t hashName(const char* name) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *name; name++) {
+        hash = (hash ^ (uint8_t)*name) * 1099511628211ULL;
+    }
+    return hash | DYNAMIC_NAME_BIT;
+}
+
+class ThreadTrace {
+public:
+    static const uint64_t NUM_EVENTS = 1 << 16;
+    static const uint64_t EVENT_INDEX_MASK = NUM_EVENTS - 1;
+
+    ThreadTrace(int id, const QString& name) : events(new TraceEvent[NUM_EVENTS]), id(id), name(name) {}
+
+    static ThreadTrace* current();
+
+    // owner thread only
+
+    TracePathID childPath(TracePathID parent, const char* name, bool isLiteral);
+
+    void record(uint64_t start, uint64_t duration, TracePathID path, bool isRange) {
+        uint64_t index = head.load(std::memory_order_relaxed);
+
+        // claim the slot before overwriting it, so that readers can tell which events they might have seen torn
+        claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        TraceEvent& event = events[index & EVENT_INDEX_MASK];
+        event.start.store(start, std::memory_order_relaxed);
+        event.durationKindAndPath.store((duration << DURATION_SHIFT) | (isRange ? RANGE_BIT : 0) | path,
+                                        std::memory_order_relaxed);
+
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    TracePathID currentPath { ROOT_PATH };
+
+    // any thread
+
+    // calls f with a TraceRecord for each event from index first on that was not overwritten while it was read,
+    // returns the head
+    template <typename F>
+    uint64_t readEvents(uint64_t first, F f) const;
+
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<uint64_t> head { 0 };
+    std::atomic<uint64_t> claimed { 0 };
+
+    const int id;
+    const QString name;
+    std::atomic<bool> isFinished { false };
+
+    // the thread calling Tracer::forEachNewScope() only
+    uint64_t tallyCursor { 0 };
+
+private:
+    static const int PATH_CACHE_SIZE = 1024;
+    static const int MAX_PATH_CACHE_PROBES = 8;
+
+    struct PathCacheEntry {
+        uint64_t nameKey { 0 };
+        TracePathID parent { NULL_PATH };
+        TracePathID path { NULL_PATH };
+    };
+    PathCacheEntry _pathCache[PATH_CACHE_SIZE];
+};
+
+template <typename F>
+uint64_t ThreadTrace::readEvents(uint64_t first, F f) const {
+    uint64_t last = head.load(std::memory_order_acquire);
+    if (last > NUM_EVENTS && first < last - NUM_EVENTS) {
+        first = last - NUM_EVENTS;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> copied;
+    copied.reserve(last - first);
+    for (uint64_t index = first; index < last; index++) {
+        const TraceEvent& event = events[index & EVENT_INDEX_MASK];
+        copied.emplace_back(event.start.load(std::memory_order_relaxed),
+                            event.durationKindAndPath.load(std::memory_order_relaxed));
+    }
+
+    // anything the writer claimed while we copied may have been overwritten
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t claimedAfterCopy = claimed.load(std::memory_order_relaxed);
+    uint64_t firstIntact = claimedAfterCopy > NUM_EVENTS ? claimedAfterCopy - NUM_EVENTS : 0;
+
+    for (uint64_t index = std::max(first, firstIntact); index < last; index++) {
+        auto& event = copied[index - first];
+        f(TraceRecord { event.first, event.second >> DURATION_SHIFT, (TracePathID)(event.second & PATH_MASK),
+                        (event.second & RANGE_BIT) != 0 });
+    }
+
+    return last;
+}
+
+// the interned scope names and paths, and every thread that recorded a scope
+class TraceRegistry {
+public:
+    static TraceRegistry& getInstance() {
+        static TraceRegistry instance;
+        return instance;
+    }
+
+    TracePathID internPath(TracePathID parent, const char* name);
+    QString getPathName(TracePathID path);
+
+    std::shared_ptr<ThreadTrace> addThread();
+    std::vector<std::shared_ptr<ThreadTrace>> getThreads();
+
+private:
+    TraceRegistry() { _paths.push_back({ NULL_PATH, 0 }); } // the root path
+
+    struct Path {
+        TracePathID parent;
+        uint16_t scope;
+    };
+
+    QMutex _mutex;
+    std::unordered_map<std::string, uint16_t> _scopeIDs;
+    std::vector<std::string> _scopeNames;
+    std::unordered_map<uint32_t, TracePathID> _pathIDs;
+    std::vector<Path> _paths;
+    std::vector<std::shared_ptr<ThreadTrace>> _threads;
+    int _nextThreadID { 1 };
+};
+
+TracePathID TraceRegistry::internPath(TracePathID parent, const char* name) {
+    QMutexLocker locker(&_mutex);
+
+    auto scopeIt = _scopeIDs.find(name);
+    uint16_t scope;
+    if (scopeIt != _scopeIDs.end()) {
+        scope = scopeIt->second;
+    } else if (_scopeNames.size() < NULL_PATH) {
+        scope = (uint16_t)_scopeNames.size();
+        _scopeNames.push_back(name);
+        _scopeIDs.emplace(name, scope);
+    } else {
+        return NULL_PATH;
+    }
+
+    uint32_t pathKey = ((uint32_t)parent << 16) | scope;
+    auto pathIt = _pathIDs.find(pathKey);
+    if (pathIt != _pathIDs.end()) {
+        return pathIt->second;
+    } else if (_paths.size() < NULL_PATH) {
+        TracePathID path = (TracePathID)_paths.size();
+        _paths.push_back({ parent, scope });
+        _pathIDs.emplace(pathKey, path);
+        return path;
+    } else {
+        return NULL_PATH;
+    }
+}
+
+QString TraceRegistry::getPathName(TracePathID path) {
+    QMutexLocker locker(&_mutex);
+
+    QString pathName;
+    while (path != ROOT_PATH && path < _paths.size()) {
+        pathName.prepend(QString::fromStdString(_scopeNames[_paths[path].scope]));
+        pathName.prepend('/');
+        path = _paths[path].parent;
+    }
+    return pathName;
+}
+
+std::shared_ptr<ThreadTrace> TraceRegistry::addThread() {
+    QThread* thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+
+    QMutexLocker locker(&_mutex);
+
+    // forget the threads that have exited since the last one was added
+    _threads.erase(std::remove_if(_threads.begin(), _threads.end(), [](const std::shared_ptr<ThreadTrace>& trace) {
+        return trace->isFinished.load();
+    }), _threads.end());
+
+    int id = _nextThreadID++;
+    if (name.isEmpty()) {
+        name = QString("Thread %1").arg(id);
+    }
+
+    auto trace = std::make_shared<ThreadTrace>(id, name);
+    _threads.push_back(trace);
+    return trace;
+}
+
+std::vector<std::shared_ptr<ThreadTrace>> TraceRegistry::getThreads() {
+    QMutexLocker locker(&_mutex);
+    return _threads;
+}
+
+// owned by the thread's storage, so that the registry hears when the thread exits
+class ThreadTraceHandle {
+public:
+    ThreadTraceHandle(std::shared_ptr<ThreadTrace> trace) : trace(trace) {}
+    ~ThreadTraceHandle() { trace->isFinished = true; }
+
+    std::shared_ptr<ThreadTrace> trace;
+};
+
+ThreadTrace* ThreadTrace::current() {
+    static QThreadStorage<ThreadTraceHandle*> currentTrace;
+
+    ThreadTraceHandle* handle = currentTrace.localData();
+    if (!handle) {
+        handle = new ThreadTraceHandle(TraceRegistry::getInstance().addThread());
+        currentTrace.setLocalData(handle);
+    }
+    return handle->trace.get();
+}
+
+TracePathID ThreadTrace::childPath(TracePathID parent, const char* name, bool isLiteral) {
+    uint64_t nameKey = isLiteral ? (uint64_t)(uintptr_t)name : hashName(name);
+
+    uint64_t slot = (nameKey ^ (nameKey >> 17) ^ ((uint64_t)parent * 0x9E3779B97F4A7C15ULL)) % PATH_CACHE_SIZE;
+    for (int probe = 0; probe < MAX_PATH_CACHE_PROBES; probe++) {
+        PathCacheEntry& entry = _pathCache[(slot + probe) % PATH_CACHE_SIZE];
+        if (entry.path == NULL_PATH) {
+            TracePathID path = TraceRegistry::getInstance().internPath(parent, name);
+            if (path != NULL_PATH) {
+                entry.nameKey = nameKey;
+                entry.parent = parent;
+                entry.path = path;
+            }
+            return path;
+        } else if (entry.nameKey == nameKey && entry.parent == parent) {
+            return entry.path;
+        }
+    }
+
+    // too many paths near this slot to cache another one
+    return TraceRegistry::getInstance().internPath(parent, name);
+}
+
+std::atomic<int> Tracer::_activeConsumers { 0 };
+
+void Tracer::setConsumerActive(Consumer consumer, bool active) {
+    if (active) {
+        _activeConsumers |= consumer;
+    } else {
+        _activeConsumers &= ~consumer;
+    }
+}
+
+void Tracer::forEachNewScope(std::function<void(TracePathID path, quint64 elapsedUsecs)> f) {
+    for (auto& thread : TraceRegistry::getInstance().getThreads()) {
+        auto tallyScope = [&](const TraceRecord& record) {
+            if (!record.isRange) {
+                f(record.path, record.duration / 1000);
+            }
+        };
+        thread->tallyCursor = thread->readEvents(thread->tallyCursor, tallyScope);
+    }
+}
+
+QString Tracer::getPathName(TracePathID path) {
+    return TraceRegistry::getInstance().getPathName(path);
+}
+
+static void appendJSONString(QByteArray& json, const QString& string) {
+    QString escaped;
+    for (QChar c : string) {
+        if (c == '"' || c == '\\') {
+            escaped.append('\\');
+        }
+        if (c.unicode() >= 0x20) {
+            escaped.append(c);
+        }
+    }
+    json.append('"');
+    json.append(escaped.toUtf8());
+    json.append('"');
+}
+
+QByteArray Tracer::exportChromeTrace() {
+    auto& registry = TraceRegistry::getInstance();
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool isFirstEvent = true;
+
+    std::unordered_map<TracePathID, QString> scopeNames;
+
+    for (auto& thread : registry.getThreads()) {
+        QByteArray tid = QByteArray::number(thread->id);
+
+        if (!isFirstEvent) {
+            json.append(',');
+        }
+        isFirstEvent = false;
+        json.append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid);
+        json.append(",\"args\":{\"name\":");
+        appendJSONString(json, thread->name);
+        json.append("}}");
+
+        thread->readEvents(0, [&](const TraceRecord& record) {
+            auto nameIt = scopeNames.find(record.path);
+            if (nameIt == scopeNames.end()) {
+                QString pathName = registry.getPathName(record.path);
+                nameIt = scopeNames.emplace(record.path, pathName.mid(pathName.lastIndexOf('/') + 1)).first;
+            }
+
+            // complete events, with the times in microseconds
+            json.append(",{\"ph\":\"X\",\"name\":");
+            appendJSONString(json, nameIt->second);
+            json.append(",\"pid\":" + pid + ",\"tid\":" + tid);
+            json.append(",\"ts\":" + QByteArray::number(record.start / 1000.0, 'f', 3));
+            json.append(",\"dur\":" + QByteArray::number(record.duration / 1000.0, 'f', 3) + "}");
+        });
+    }
+
+    json.append("]}");
+    return json;
+}
+
+void TraceScope::begin(const char* name, bool isLiteral, Kind kind) {
+    ThreadTrace* thread = ThreadTrace::current();
+
+    TracePathID path = thread->childPath(thread->currentPath, name, isLiteral);
+    if (path == NULL_PATH) {
+        // out of path IDs, don't record this scope
+        return;
+    }
+
+    _thread = thread;
+    _kind = kind;
+    _path = path;
+    _parentPath = thread->currentPath;
+    if (kind == Timer) {
+        thread->currentPath = path;
+    }
+    _start = nowNsecs();
+}
+
+void TraceScope::end() {
+    uint64_t end = nowNsecs();
+    _thread->record(_start, end - _start, _path, _kind == Range);
+    _thread->currentPath = _parentPath;
+}
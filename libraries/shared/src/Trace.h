@@ -0,0 +1,109 @@
+//
+//  Trace.h
+//  libraries/shared/src
+//
+//  Created by High Fidelity on 2/17/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Trace_h
+#define hifi_Trace_h
+
+#include <atomic>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+/// Identifies a scope together with the scopes it is nested in on its thread, like "/paintGL/mainRender". Each
+/// distinct path is interned once, so that a recorded scope is a path ID and two timestamps.
+using TracePathID = uint16_t;
+
+class ThreadTrace;
+
+/// Records the scopes timed by PerformanceTimer and PROFILE_RANGE. Every thread writes its scopes to its own ring
+/// buffer, without locks, and readers copy the buffers while they are written. A thread only takes a lock the first
+/// time it sees a scope in a given path.
+///
+/// Two consumers read the buffers: PerformanceTimer tallies them into its records for the stats overlay, and
+/// exportChromeTrace() dumps them for chrome://tracing or Perfetto. Scopes are recorded while either one is active.
+class Tracer {
+public:
+    enum Consumer {
+        PerformanceTimers = 1,
+        TraceExport = 2
+    };
+
+    static bool isRecording() { return _activeConsumers.load(std::memory_order_relaxed) != 0; }
+    static void setConsumerActive(Consumer consumer, bool active);
+
+    static bool isTracing() { return (_activeConsumers.load() & TraceExport) != 0; }
+    static void setTracing(bool tracing) { setConsumerActive(TraceExport, tracing); }
+
+    /// \return the scopes still in the thread buffers in the Chrome trace event format
+    static QByteArray exportChromeTrace();
+
+    /// calls f with the path and length of each scope recorded since the last call. Only one thread can call this.
+    static void forEachNewScope(std::function<void(TracePathID path, quint64 elapsedUsecs)> f);
+
+    /// \return the names of the scopes in the path, joined like "/paintGL/mainRender"
+    static QString getPathName(TracePathID path);
+
+private:
+    static std::atomic<int> _activeConsumers;
+};
+
+/// Records the time between its construction and destruction with the Tracer, in the path of the scopes around it.
+/// String literals are interned by their address, which costs a lookup in a table of the thread's own; other names
+/// are hashed every time.
+class TraceScope {
+public:
+    enum Kind {
+        Timer, // tallied by PerformanceTimer, and part of the path of the scopes nested in it
+        Range // only exported, it doesn't change the path of the scopes nested in it
+    };
+
+    struct DynamicName {
+        DynamicName(const char* name) : name(name) {}
+        const char* name;
+    };
+
+    template <size_t N>
+    TraceScope(const char (&name)[N], Kind kind = Timer) {
+        if (Tracer::isRecording()) {
+            begin(name, true, kind);
+        }
+    }
+
+    TraceScope(DynamicName name, Kind kind = Timer) {
+        if (Tracer::isRecording()) {
+            begin(name.name, false, kind);
+        }
+    }
+
+    ~TraceScope() {
+        if (_thread) {
+            end();
+        }
+    }
+
+private:
+    TraceScope(const TraceScope& other) = delete;
+    TraceScope& operator=(const TraceScope& other) = delete;
+
+    void begin(const char* name, bool isLiteral, Kind kind);
+    void end();
+
+    ThreadTrace* _thread { nullptr };
+    Kind _kind { Timer };
+    TracePathID _path { 0 };
+    TracePathID _parentPath { 0 };
+    uint64_t _start { 0 };
+};
+
+#endif // hifi_Trace_h
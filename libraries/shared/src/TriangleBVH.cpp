@@ -0,0 +1,255 @@
+//
+//  TriangleBVH.cpp
+//  libraries/shared/src
+//
+//  Created by High Fidelity on 2/19/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <limits>
+
+#include "TriangleBVH.h"
+
+static const int MAX_LEAF_TRIANGLES = 4;
+static const int NUM_SPLIT_BINS = 16;
+// past this depth nodes are split in half, which keeps the tree shallow enough for a fixed traversal stack on a
+// degenerate mesh, of up to 2^24 triangles
+static const int MAX_SAH_DEPTH = 40;
+static const int MAX_DEPTH = 64;
+
+namespace {
+
+struct Bounds {
+    glm::vec3 minimum { std::numeric_limits<float>::max() };
+    glm::vec3 maximum { -std::numeric_limits<float>::max() };
+
+    void add(const glm::vec3& point) {
+        minimum = glm::min(minimum, point);
+        maximum = glm::max(maximum, point);
+    }
+    void add(const Bounds& other) {
+        minimum = glm::min(minimum, other.minimum);
+        maximum = glm::max(maximum, other.maximum);
+    }
+    float getHalfArea() const {
+        if (minimum.x > maximum.x) {
+            return 0.0f;
+        }
+        glm::vec3 size = maximum - minimum;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+};
+
+struct BuildTask {
+    int node;
+    int begin;
+    int end;
+    int depth;
+};
+
+}
+
+TriangleBVH::TriangleBVH(std::vector<Triangle> triangles) {
+    int numTriangles = (int)triangles.size();
+    if (numTriangles == 0) {
+        return;
+    }
+
+    std::vector<Bounds> triangleBounds(numTriangles);
+    std::vector<glm::vec3> centroids(numTriangles);
+    std::vector<int> order(numTriangles);
+    for (int i = 0; i < numTriangles; i++) {
+        const Triangle& triangle = triangles[i];
+        triangleBounds[i].add(triangle.v0);
+        triangleBounds[i].add(triangle.v1);
+        triangleBounds[i].add(triangle.v2);
+        centroids[i] = (triangle.v0 + triangle.v1 + triangle.v2) / 3.0f;
+        order[i] = i;
+    }
+
+    // a binary tree with at least one triangle in each leaf has fewer than twice as many nodes as triangles
+    _nodes.reserve(2 * numTriangles);
+    _nodes.emplace_back();
+
+    std::vector<BuildTask> tasks;
+    tasks.push_back({ 0, 0, numTriangles, 0 });
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        Bounds bounds;
+        Bounds centroidBounds;
+        for (int i = task.begin; i < task.end; i++) {
+            bounds.add(triangleBounds[order[i]]);
+            centroidBounds.add(centroids[order[i]]);
+        }
+        _nodes[task.node].minimum = bounds.minimum;
+        _nodes[task.node].maximum = bounds.maximum;
+
+        int count = task.end - task.begin;
+        if (count <= MAX_LEAF_TRIANGLES) {
+            _nodes[task.node].firstChild = task.begin;
+            _nodes[task.node].numTriangles = count;
+            continue;
+        }
+
+        // split across the axis along which the centroids are most spread out
+        glm::vec3 centroidExtent = centroidBounds.maximum - centroidBounds.minimum;
+        int axis = 0;
+        if (centroidExtent.y > centroidExtent[axis]) {
+            axis = 1;
+        }
+        if (centroidExtent.z > centroidExtent[axis]) {
+            axis = 2;
+        }
+
+        int middle = task.begin;
+        if (centroidExtent[axis] > 0.0f && task.depth < MAX_SAH_DEPTH) {
+            // sort the centroids into bins, and split at the bin boundary with the lowest surface area cost
+            float binScale = NUM_SPLIT_BINS * (1.0f - std::numeric_limits<float>::epsilon()) / centroidExtent[axis];
+            float binMinimum = centroidBounds.minimum[axis];
+            auto binOf = [&](int triangle) {
+                return std::min((int)((centroids[triangle][axis] - binMinimum) * binScale), NUM_SPLIT_BINS - 1);
+            };
+
+            Bounds binBounds[NUM_SPLIT_BINS];
+            int binCounts[NUM_SPLIT_BINS] = { 0 };
+            for (int i = task.begin; i < task.end; i++) {
+                int bin = binOf(order[i]);
+                binBounds[bin].add(triangleBounds[order[i]]);
+                binCounts[bin]++;
+            }
+
+            float rightCosts[NUM_SPLIT_BINS];
+            Bounds rightBounds;
+            int rightCount = 0;
+            for (int bin = NUM_SPLIT_BINS - 1; bin > 0; bin--) {
+                rightBounds.add(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = rightBounds.getHalfArea() * rightCount;
+            }
+
+            int bestSplit = 1;
+            float bestCost = std::numeric_limits<float>::max();
+            Bounds leftBounds;
+            int leftCount = 0;
+            for (int bin = 1; bin < NUM_SPLIT_BINS; bin++) {
+                leftBounds.add(binBounds[bin - 1]);
+                leftCount += binCounts[bin - 1];
+                float cost = leftBounds.getHalfArea() * leftCount + rightCosts[bin];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = bin;
+                }
+            }
+
+            middle = (int)(std::partition(order.begin() + task.begin, order.begin() + task.end, [&](int triangle) {
+                return binOf(triangle) < bestSplit;
+            }) - order.begin());
+        }
+
+        if (middle == task.begin || middle == task.end) {
+            // too deep, or the centroids couldn't be told apart along the axis: split the triangles in half
+            middle = task.begin + count / 2;
+            std::nth_element(order.begin() + task.begin, order.begin() + middle, order.begin() + task.end,
+                             [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+
+        int firstChild = (int)_nodes.size();
+        _nodes[task.node].firstChild = firstChild;
+        _nodes.emplace_back();
+        _nodes.emplace_back();
+        tasks.push_back({ firstChild + 1, middle, task.end, task.depth + 1 });
+        tasks.push_back({ firstChild, task.begin, middle, task.depth + 1 });
+    }
+
+    _triangles.reserve(numTriangles);
+    for (int triangle : order) {
+        _triangles.push_back(triangles[triangle]);
+    }
+}
+
+// the distance along the ray at which it enters the node, if it does so closer than maxDistance
+static bool findRayNodeIntersection(const glm::vec3& origin, const glm::vec3& inverseDirection,
+                                    const glm::vec3& minimum, const glm::vec3& maximum,
+                                    float maxDistance, float& distance) {
+    glm::vec3 toMinimum = (minimum - origin) * inverseDirection;
+    glm::vec3 toMaximum = (maximum - origin) * inverseDirection;
+    glm::vec3 nearest = glm::min(toMinimum, toMaximum);
+    glm::vec3 furthest = glm::max(toMinimum, toMaximum);
+    float enter = std::max(std::max(nearest.x, nearest.y), std::max(nearest.z, 0.0f));
+    float exit = std::min(std::min(furthest.x, furthest.y), furthest.z);
+    if (enter > exit || enter >= maxDistance) {
+        return false;
+    }
+    distance = enter;
+    return true;
+}
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                                      float& distance, glm::vec3& surfaceNormal) const {
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    // dividing by a zero component gives an infinity, which the slab test handles
+    glm::vec3 inverseDirection = 1.0f / direction;
+
+    float bestDistance = std::numeric_limits<float>::max();
+    const Triangle* bestTriangle = nullptr;
+
+    float rootDistance;
+    if (!findRayNodeIntersection(origin, inverseDirection, _nodes[0].minimum, _nodes[0].maximum,
+                                 bestDistance, rootDistance)) {
+        return false;
+    }
+
+    int stack[MAX_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node& node = _nodes[stack[--stackSize]];
+        if (node.isLeaf()) {
+            for (int i = node.firstChild; i < node.firstChild + node.numTriangles; i++) {
+                float triangleDistance;
+                if (findRayTriangleIntersection(origin, direction, _triangles[i], triangleDistance) &&
+                        triangleDistance < bestDistance) {
+                    bestDistance = triangleDistance;
+                    bestTriangle = &_triangles[i];
+                }
+            }
+            continue;
+        }
+
+        // visit the nearer child first, so that the further one can be skipped when a hit is found before it
+        int left = node.firstChild;
+        int right = node.firstChild + 1;
+        float leftDistance, rightDistance;
+        bool hitsLeft = findRayNodeIntersection(origin, inverseDirection, _nodes[left].minimum, _nodes[left].maximum,
+                                                bestDistance, leftDistance);
+        bool hitsRight = findRayNodeIntersection(origin, inverseDirection, _nodes[right].minimum,
+                                                 _nodes[right].maximum, bestDistance, rightDistance);
+        if (hitsLeft && hitsRight) {
+            if (leftDistance > rightDistance) {
+                std::swap(left, right);
+            }
+            stack[stackSize++] = right;
+            stack[stackSize++] = left;
+        } else if (hitsLeft) {
+            stack[stackSize++] = left;
+        } else if (hitsRight) {
+            stack[stackSize++] = right;
+        }
+    }
+
+    if (!bestTriangle) {
+        return false;
+    }
+    distance = bestDistance;
+    surfaceNormal = bestTriangle->getNormal();
+    return true;
+}
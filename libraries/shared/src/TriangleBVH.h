@@ -0,0 +1,58 @@
+//
+//  TriangleBVH.h
+//  libraries/shared/src
+//
+//  Created by High Fidelity on 2/19/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleBVH_h
+#define hifi_TriangleBVH_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GeometryUtil.h"
+
+/// A static bounding volume hierarchy over a list of triangles, for ray picks against meshes with many triangles.
+///
+/// The hierarchy is built once, top down, splitting each node where the surface area heuristic says a ray is least
+/// likely to have to visit both halves. It is never changed after that, so it can be queried from any number of
+/// threads at once. Build it in the frame of the mesh and map rays into that frame, rather than rebuilding it when the
+/// mesh moves.
+class TriangleBVH {
+public:
+    TriangleBVH() {}
+    explicit TriangleBVH(std::vector<Triangle> triangles);
+
+    /// finds the closest triangle the ray intersects, with the same test as findRayTriangleIntersection(). The
+    /// direction doesn't need to be normalized, distance is in units of its length.
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
+                             float& distance, glm::vec3& surfaceNormal) const;
+
+    /// the triangles, in the order of the leaves of the hierarchy
+    const std::vector<Triangle>& getTriangles() const { return _triangles; }
+
+    bool isEmpty() const { return _triangles.empty(); }
+    int getNumTriangles() const { return (int)_triangles.size(); }
+    int getNumNodes() const { return (int)_nodes.size(); }
+
+private:
+    struct Node {
+        glm::vec3 minimum;
+        int firstChild { 0 }; // the index of the left child, the right one follows it; or the first triangle of a leaf
+        glm::vec3 maximum;
+        int numTriangles { 0 }; // 0 for interior nodes
+
+        bool isLeaf() const { return numTriangles > 0; }
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<Triangle> _triangles;
+};
+
+#endif // hifi_TriangleBVH_h
@@ -11,7 +11,7 @@
 #if defined(NSIGHT_FOUND)
 #include "nvToolsExt.h"
 
-ProfileRange::ProfileRange(const char *name) {
+void ProfileRange::push(const char* name) {
     nvtxRangePush(name);
 }
 
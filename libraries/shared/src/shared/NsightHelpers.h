@@ -9,16 +9,25 @@
 #ifndef hifi_gl_NsightHelpers_h
 #define hifi_gl_NsightHelpers_h
 
+#include "../Trace.h"
+
+/// Marks a range in the traces exported by the Tracer, and for Nsight when it is found. Unlike a PerformanceTimer, a
+/// range isn't tallied and isn't part of the path of the scopes nested in it.
+class ProfileRange : public TraceScope {
+public:
+    template <size_t N>
+    ProfileRange(const char (&name)[N]) : TraceScope(name, TraceScope::Range) { push(name); }
+    ProfileRange(TraceScope::DynamicName name) : TraceScope(name, TraceScope::Range) { push(name.name); }
 #if defined(NSIGHT_FOUND)
-    class ProfileRange {
-    public:
-        ProfileRange(const char *name);
-        ~ProfileRange();
-    };
-#define PROFILE_RANGE(name) ProfileRange profileRangeThis(name);
+    ~ProfileRange();
+private:
+    static void push(const char* name);
 #else
-#define PROFILE_RANGE(name)
+private:
+    static void push(const char* name) {}
 #endif
+};
 
+#define PROFILE_RANGE(name) ProfileRange profileRangeThis(name);
 
 #endif
\ No newline at end of file
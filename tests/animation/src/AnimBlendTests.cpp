@@ -0,0 +1,266 @@
+//
+//  AnimBlendTests.cpp
+//
+//  Created by High Fidelity on 2/23/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimBlendTests.h"
+
+#include <vector>
+
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+#include "AnimPoseBuffer.h"
+#include "AnimUtil.h"
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(AnimBlendTests)
+
+const int NUM_RIGS = 100;
+const int NUM_JOINTS = 61;
+const float EPSILON = 0.0001f;
+
+static glm::vec3 randomVec3() {
+    return glm::vec3(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+}
+
+static glm::quat randomQuat() {
+    return glm::normalize(glm::quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                    randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f)));
+}
+
+static AnimPose randomPose(float scale) {
+    return AnimPose(glm::vec3(scale), randomQuat(), randomVec3());
+}
+
+static AnimPose randomPose() {
+    return AnimPose(glm::vec3(1.5f) + 0.5f * randomVec3(), randomQuat(), randomVec3());
+}
+
+static AnimPoseVec randomPoses(int numPoses) {
+    AnimPoseVec poses;
+    for (int i = 0; i < numPoses; i++) {
+        poses.push_back(randomPose());
+    }
+    return poses;
+}
+
+// a skeleton's worth of parents, each joint after its parent
+static std::vector<int> createParents() {
+    std::vector<int> parents;
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        parents.push_back(i == 0 ? -1 : (i - 1) / 2);
+    }
+    return parents;
+}
+
+// the blend AnimBlendLinear used to do, one component at a time
+static void blendScalar(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    for (size_t i = 0; i < numPoses; i++) {
+        const AnimPose& aPose = a[i];
+        const AnimPose& bPose = b[i];
+
+        // adjust signs if necessary
+        const glm::quat& q1 = aPose.rot;
+        glm::quat q2 = bPose.rot;
+        float dot = glm::dot(q1, q2);
+        if (dot < 0.0f) {
+            q2 = -q2;
+        }
+
+        result[i].scale = lerp(aPose.scale, bPose.scale, alpha);
+        result[i].rot = glm::normalize(glm::lerp(aPose.rot, q2, alpha));
+        result[i].trans = lerp(aPose.trans, bPose.trans, alpha);
+    }
+}
+
+static void compareWithScalarBlend(const AnimPoseVec& a, const AnimPoseVec& b, float alpha, const AnimPoseVec& result) {
+    AnimPoseVec expected(a.size());
+    blendScalar(a.size(), &a[0], &b[0], alpha, &expected[0]);
+    for (size_t i = 0; i < a.size(); i++) {
+        QCOMPARE_WITH_ABS_ERROR(result[i].scale, expected[i].scale, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(result[i].rot, expected[i].rot, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(result[i].trans, expected[i].trans, EPSILON);
+    }
+}
+
+void AnimBlendTests::blendTest() {
+    srand(1);
+
+    // sizes on either side of the blocks of four that AnimPoseBuffer blends
+    for (int numPoses : { 1, 3, 4, 5, NUM_JOINTS }) {
+        AnimPoseVec a = randomPoses(numPoses);
+        AnimPoseVec b = randomPoses(numPoses);
+        for (float alpha : { 0.0f, 0.3f, 1.0f }) {
+            AnimPoseVec result(numPoses);
+            blend(numPoses, &a[0], &b[0], alpha, &result[0]);
+            compareWithScalarBlend(a, b, alpha, result);
+
+            // AnimBlendLinear blends into the poses of its first child
+            result = a;
+            blend(numPoses, &result[0], &b[0], alpha, &result[0]);
+            compareWithScalarBlend(a, b, alpha, result);
+        }
+
+        // AnimOverlay weights each joint by its bone set
+        std::vector<float> weights;
+        for (int i = 0; i < numPoses; i++) {
+            weights.push_back(i % 3 == 0 ? 0.0f : randFloat());
+        }
+        const float ALPHA = 0.7f;
+        AnimPoseVec result(numPoses);
+        blend(numPoses, &a[0], &b[0], ALPHA, &weights[0], &result[0]);
+        for (int i = 0; i < numPoses; i++) {
+            AnimPose expected;
+            blendScalar(1, &a[i], &b[i], ALPHA * weights[i], &expected);
+            QCOMPARE_WITH_ABS_ERROR(result[i].scale, expected.scale, EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].rot, expected.rot, EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(result[i].trans, expected.trans, EPSILON);
+        }
+    }
+}
+
+void AnimBlendTests::poseBufferTest() {
+    srand(2);
+    QCOMPARE(AnimPoseBuffer().size(), 0);
+
+    for (int numPoses : { 1, 3, 4, 5, NUM_JOINTS }) {
+        AnimPoseVec a = randomPoses(numPoses);
+        AnimPoseVec b = randomPoses(numPoses);
+        AnimPoseBuffer aBuffer(a);
+        AnimPoseBuffer bBuffer(b);
+        QCOMPARE(aBuffer.size(), numPoses);
+        for (int i = 0; i < numPoses; i++) {
+            AnimPose pose = aBuffer.getPose(i);
+            QCOMPARE(pose.scale, a[i].scale);
+            QCOMPARE(pose.rot, a[i].rot);
+            QCOMPARE(pose.trans, a[i].trans);
+        }
+
+        // the blend must not write past the poses, into the padding of the buffer
+        const float ALPHA = 0.4f;
+        AnimPoseVec result(numPoses + 1, AnimPose::identity);
+        AnimPoseBuffer::blend(aBuffer, bBuffer, ALPHA, &result[0]);
+        QCOMPARE(result.back().scale, AnimPose::identity.scale);
+        QCOMPARE(result.back().rot, AnimPose::identity.rot);
+        QCOMPARE(result.back().trans, AnimPose::identity.trans);
+        result.pop_back();
+        compareWithScalarBlend(a, b, ALPHA, result);
+    }
+}
+
+void AnimBlendTests::multiplyTest() {
+    srand(3);
+    for (int i = 0; i < 1000; i++) {
+        // a uniform scale on the left takes the direct path, whatever the scale on the right
+        AnimPose lhs = randomPose(randFloatInRange(0.5f, 1.5f));
+        AnimPose rhs = (i % 2 == 0) ? randomPose() : randomPose(1.0f);
+        glm::mat4 expected = static_cast<glm::mat4>(lhs) * static_cast<glm::mat4>(rhs);
+        QCOMPARE_WITH_ABS_ERROR(static_cast<glm::mat4>(lhs * rhs), expected, EPSILON);
+    }
+}
+
+void AnimBlendTests::benchmarkBlend() {
+    srand(4);
+    std::vector<AnimPoseVec> a, b;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        a.push_back(randomPoses(NUM_JOINTS));
+        b.push_back(randomPoses(NUM_JOINTS));
+    }
+
+    AnimPoseVec result(NUM_JOINTS);
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            blend(NUM_JOINTS, &a[i][0], &b[i][0], 0.3f, &result[0]);
+        }
+    }
+}
+
+void AnimBlendTests::benchmarkScalarBlend() {
+    srand(4);
+    std::vector<AnimPoseVec> a, b;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        a.push_back(randomPoses(NUM_JOINTS));
+        b.push_back(randomPoses(NUM_JOINTS));
+    }
+
+    AnimPoseVec result(NUM_JOINTS);
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            blendScalar(NUM_JOINTS, &a[i][0], &b[i][0], 0.3f, &result[0]);
+        }
+    }
+}
+
+void AnimBlendTests::benchmarkPoseBufferBlend() {
+    srand(4);
+    std::vector<AnimPoseBuffer> a, b;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        a.push_back(AnimPoseBuffer(randomPoses(NUM_JOINTS)));
+        b.push_back(AnimPoseBuffer(randomPoses(NUM_JOINTS)));
+    }
+
+    AnimPoseVec result(NUM_JOINTS);
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            AnimPoseBuffer::blend(a[i], b[i], 0.3f, &result[0]);
+        }
+    }
+}
+
+void AnimBlendTests::benchmarkRelativeToAbsolute() {
+    srand(5);
+    std::vector<int> parents = createParents();
+    std::vector<AnimPoseVec> relativePoses;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        AnimPoseVec poses;
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            poses.push_back(randomPose(1.0f));
+        }
+        relativePoses.push_back(poses);
+    }
+
+    AnimPoseVec poses;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            poses = relativePoses[i];
+            for (int j = 0; j < NUM_JOINTS; j++) {
+                if (parents[j] != -1) {
+                    poses[j] = poses[parents[j]] * poses[j];
+                }
+            }
+        }
+    }
+}
+
+// how AnimPose::operator* used to multiply every pair of poses
+void AnimBlendTests::benchmarkMatrixRelativeToAbsolute() {
+    srand(5);
+    std::vector<int> parents = createParents();
+    std::vector<AnimPoseVec> relativePoses;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        AnimPoseVec poses;
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            poses.push_back(randomPose(1.0f));
+        }
+        relativePoses.push_back(poses);
+    }
+
+    AnimPoseVec poses;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            poses = relativePoses[i];
+            for (int j = 0; j < NUM_JOINTS; j++) {
+                if (parents[j] != -1) {
+                    poses[j] = AnimPose(static_cast<glm::mat4>(poses[parents[j]]) * static_cast<glm::mat4>(poses[j]));
+                }
+            }
+        }
+    }
+}
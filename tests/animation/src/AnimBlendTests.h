@@ -0,0 +1,40 @@
+//
+//  AnimBlendTests.h
+//
+//  Created by High Fidelity on 2/23/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimBlendTests_h
+#define hifi_AnimBlendTests_h
+
+#include <QtTest/QtTest>
+
+class AnimBlendTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that blending poses gives what blending them one component at a time used to, in place and with weights
+    void blendTest();
+
+    // Test that a pose buffer keeps its poses, and blends them like the poses themselves
+    void poseBufferTest();
+
+    // Test that multiplying poses with uniform scales gives what multiplying their matrices does
+    void multiplyTest();
+
+    // Blend the poses of 100 rigs
+    void benchmarkBlend();
+    void benchmarkScalarBlend();
+
+    // Blend between two keyframes of a clip, for 100 rigs
+    void benchmarkPoseBufferBlend();
+
+    // Accumulate the relative poses of 100 rigs into absolute ones
+    void benchmarkRelativeToAbsolute();
+    void benchmarkMatrixRelativeToAbsolute();
+};
+
+#endif // hifi_AnimBlendTests_h
@@ -14,6 +14,14 @@
 #include "AnimationLogging.h"
 #include "AnimVariant.h"
 #include "AnimUtil.h"
+#include "Rig.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+
+#include <glm/gtx/transform.hpp>
+
+#include <NumericalConstants.h>
 
 #include <../QTestExtensions.h>
 
@@ -231,6 +239,54 @@ void AnimTests::testVariant() {
     QVERIFY(q.z == 4.0f);
 }
 
+void AnimTests::testVariantMap() {
+    AnimVariantMap vars;
+    AnimVariantKey floatKey("testVariantMapFloat");
+    AnimVariantKey boolKey("testVariantMapBool");
+    AnimVariantKey triggerKey("testVariantMapTrigger");
+
+    // keys with the same name are the same key, the empty name is never set
+    QVERIFY(floatKey == AnimVariantKey("testVariantMapFloat"));
+    QVERIFY(floatKey != boolKey);
+    QVERIFY(floatKey.getName() == "testVariantMapFloat");
+    QVERIFY(!AnimVariantKey("").isValid());
+    QVERIFY(!AnimVariantKey::find("testVariantMapNeverInterned").isValid());
+    vars.set("", 1.0f);
+    QVERIFY(vars.lookup("", 2.0f) == 2.0f);
+
+    QVERIFY(!vars.hasKey(floatKey));
+    QVERIFY(vars.lookup(floatKey, 2.0f) == 2.0f);
+    vars.set(floatKey, 1.0f);
+    QVERIFY(vars.hasKey(floatKey));
+    QVERIFY(vars.lookup(floatKey, 2.0f) == 1.0f);
+    QVERIFY(vars.lookup("testVariantMapFloat", 2.0f) == 1.0f);
+    vars.unset(floatKey);
+    QVERIFY(!vars.hasKey(floatKey));
+    QVERIFY(vars.lookup(floatKey, 2.0f) == 2.0f);
+
+    // triggers read as true bools until cleared, without being set
+    vars.set(boolKey, false);
+    vars.setTrigger(triggerKey);
+    QVERIFY(!vars.lookup(boolKey, true));
+    QVERIFY(vars.lookup(triggerKey, false));
+    QVERIFY(!vars.hasKey(triggerKey));
+    vars.clearTriggers();
+    QVERIFY(!vars.lookup(triggerKey, false));
+
+    // a map made before later keys were interned still takes them
+    AnimVariantMap other;
+    other.set(floatKey, 3.0f);
+    other.set(AnimVariantKey("testVariantMapLateKey"), 4);
+    vars.copyVariantsFrom(other);
+    QVERIFY(vars.lookup(floatKey, 0.0f) == 3.0f);
+    QVERIFY(vars.lookup("testVariantMapLateKey", 0) == 4);
+    QVERIFY(!vars.lookup(boolKey, true));
+
+    vars.clearMap();
+    QVERIFY(!vars.hasKey(floatKey));
+    QVERIFY(!vars.hasKey(boolKey));
+}
+
 void AnimTests::testAccumulateTime() {
 
     float startFrame = 0.0f;
@@ -258,31 +314,36 @@ void AnimTests::testAccumulateTimeWithParameters(float startFrame, float endFram
 
     float dt = (1.0f / 30.0f) / timeScale;  // sec
     QString id = "testNode";
+    AnimVariantKey onLoop(id + "OnLoop");
+    AnimVariantKey onDone(id + "OnDone");
     AnimNode::Triggers triggers;
     bool loopFlag = false;
 
-    float resultFrame = accumulateTime(startFrame, endFrame, timeScale, startFrame, dt, loopFlag, id, triggers);
+    float resultFrame = accumulateTime(startFrame, endFrame, timeScale, startFrame,
+                                       dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == startFrame + 1.0f);
     QVERIFY(triggers.empty());
     triggers.clear();
 
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == startFrame + 2.0f);
     QVERIFY(triggers.empty());
     triggers.clear();
 
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == startFrame + 3.0f);
     QVERIFY(triggers.empty());
     triggers.clear();
 
     // test onDone trigger and frame clamping.
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 1.0f, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 1.0f,
+                                 dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == endFrame);
     QVERIFY(!triggers.empty() && triggers[0] == "testNodeOnDone");
     triggers.clear();
 
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 0.5f, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 0.5f,
+                                 dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == endFrame);
     QVERIFY(!triggers.empty() && triggers[0] == "testNodeOnDone");
     triggers.clear();
@@ -291,25 +352,27 @@ void AnimTests::testAccumulateTimeWithParameters(float startFrame, float endFram
     loopFlag = true;
 
     // should NOT trigger loop even though we stop at last frame, because there is an extra frame between end and start frames.
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 1.0f, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 1.0f,
+                                 dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == endFrame);
     QVERIFY(triggers.empty());
     triggers.clear();
 
     // now we should hit loop trigger
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == startFrame);
     QVERIFY(!triggers.empty() && triggers[0] == "testNodeOnLoop");
     triggers.clear();
 
     // should NOT trigger loop, even though we move past the end frame, because of extra frame between end and start.
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 0.5f, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, endFrame - 0.5f,
+                                 dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == endFrame + 0.5f);
     QVERIFY(triggers.empty());
     triggers.clear();
 
     // now we should hit loop trigger
-    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, id, triggers);
+    resultFrame = accumulateTime(startFrame, endFrame, timeScale, resultFrame, dt, loopFlag, onLoop, onDone, triggers);
     QVERIFY(resultFrame == startFrame + 0.5f);
     QVERIFY(!triggers.empty() && triggers[0] == "testNodeOnLoop");
     triggers.clear();
@@ -394,3 +457,123 @@ void AnimTests::testAnimPose() {
         }
     }
 }
+
+// a humanoid skeleton with the joints that avatar-animation.json drives
+static FBXGeometry createHumanoidGeometry() {
+    struct JointDesc {
+        const char* name;
+        int parentIndex;
+        glm::vec3 translation;
+    };
+    const JointDesc JOINTS[] = {
+        { "Hips", -1, glm::vec3(0.0f, 1.0f, 0.0f) },
+        { "Spine", 0, glm::vec3(0.0f, 0.1f, 0.0f) },
+        { "Spine1", 1, glm::vec3(0.0f, 0.1f, 0.0f) },
+        { "Spine2", 2, glm::vec3(0.0f, 0.1f, 0.0f) },
+        { "Neck", 3, glm::vec3(0.0f, 0.2f, 0.0f) },
+        { "Head", 4, glm::vec3(0.0f, 0.1f, 0.0f) },
+        { "LeftShoulder", 3, glm::vec3(0.1f, 0.15f, 0.0f) },
+        { "LeftArm", 6, glm::vec3(0.1f, 0.0f, 0.0f) },
+        { "LeftForeArm", 7, glm::vec3(0.25f, 0.0f, 0.0f) },
+        { "LeftHand", 8, glm::vec3(0.25f, 0.0f, 0.0f) },
+        { "RightShoulder", 3, glm::vec3(-0.1f, 0.15f, 0.0f) },
+        { "RightArm", 10, glm::vec3(-0.1f, 0.0f, 0.0f) },
+        { "RightForeArm", 11, glm::vec3(-0.25f, 0.0f, 0.0f) },
+        { "RightHand", 12, glm::vec3(-0.25f, 0.0f, 0.0f) },
+        { "LeftUpLeg", 0, glm::vec3(0.1f, -0.05f, 0.0f) },
+        { "LeftLeg", 14, glm::vec3(0.0f, -0.45f, 0.0f) },
+        { "LeftFoot", 15, glm::vec3(0.0f, -0.45f, 0.0f) },
+        { "LeftToeBase", 16, glm::vec3(0.0f, -0.05f, 0.1f) },
+        { "RightUpLeg", 0, glm::vec3(-0.1f, -0.05f, 0.0f) },
+        { "RightLeg", 18, glm::vec3(0.0f, -0.45f, 0.0f) },
+        { "RightFoot", 19, glm::vec3(0.0f, -0.45f, 0.0f) },
+        { "RightToeBase", 20, glm::vec3(0.0f, -0.05f, 0.1f) }
+    };
+
+    FBXGeometry geometry;
+    for (const JointDesc& desc : JOINTS) {
+        FBXJoint joint;
+        joint.isFree = false;
+        joint.parentIndex = desc.parentIndex;
+        joint.distanceToParent = glm::length(desc.translation);
+        joint.translation = desc.translation;
+        joint.rotationMin = glm::vec3(-PI);
+        joint.rotationMax = glm::vec3(PI);
+        joint.transform = glm::translate(desc.translation);
+        if (desc.parentIndex != -1) {
+            joint.transform = geometry.joints[desc.parentIndex].transform * joint.transform;
+        }
+        joint.bindTransform = joint.transform;
+        joint.name = desc.name;
+        joint.isSkeletonJoint = true;
+        joint.bindTransformFoundInCluster = true;
+        geometry.joints.append(joint);
+        geometry.jointIndices.insert(joint.name, geometry.joints.size());
+    }
+    geometry.rootJointIndex = 0;
+    geometry.leftHandJointIndex = 9;
+    geometry.rightHandJointIndex = 13;
+    return geometry;
+}
+
+void AnimTests::benchmarkAvatarAnimationGraph() {
+    const int NUM_RIGS = 100;
+    const float DELTA_TIME = 1.0f / 60.0f;
+
+    QDir path(__FILE__);
+    path.cdUp();
+    QUrl url = QUrl::fromLocalFile(path.cleanPath(path.absoluteFilePath(
+        "../../../interface/resources/meshes/defaultAvatar_full/avatar-animation.json")));
+
+    FBXGeometry geometry = createHumanoidGeometry();
+    std::vector<RigPointer> rigs;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        RigPointer rig = std::make_shared<Rig>();
+        rig->initJointStates(geometry, glm::mat4());
+        rig->initAnimGraph(url);
+        rigs.push_back(rig);
+    }
+
+    // the graphs load asynchronously, their clips may never load without a network, which leaves them in bind pose
+    const qint64 LOAD_TIMEOUT = 5000;
+    QElapsedTimer timer;
+    timer.start();
+    auto allLoaded = [&] {
+        for (auto& rig : rigs) {
+            if (!rig->getAnimNode()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (!allLoaded() && timer.elapsed() < LOAD_TIMEOUT) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+    QVERIFY(allLoaded());
+
+    // each rig moves differently, so that their state machines are in different states
+    std::vector<glm::vec3> velocities;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        float angle = TWO_PI * i / NUM_RIGS;
+        float speed = (i % 4) * 0.75f;
+        velocities.push_back(speed * glm::vec3(sinf(angle), 0.0f, cosf(angle)));
+    }
+    std::vector<glm::vec3> positions(NUM_RIGS);
+
+    Rig::HeadParameters headParams;
+    Rig::HandParameters handParams;
+    handParams.isLeftEnabled = true;
+    handParams.isRightEnabled = false;
+    handParams.leftPosition = glm::vec3(0.3f, 1.2f, 0.3f);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RIGS; i++) {
+            positions[i] += velocities[i] * DELTA_TIME;
+            rigs[i]->computeMotionAnimationState(DELTA_TIME, positions[i], velocities[i], glm::quat());
+            headParams.isTalking = (i % 3 == 0);
+            rigs[i]->updateFromHeadParameters(headParams, DELTA_TIME);
+            rigs[i]->updateFromHandParameters(handParams, DELTA_TIME);
+            rigs[i]->updateAnimations(DELTA_TIME, glm::mat4());
+        }
+    }
+}
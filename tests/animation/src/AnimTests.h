@@ -25,8 +25,12 @@ private slots:
     void testClipEvaulateWithVars();
     void testLoader();
     void testVariant();
+    void testVariantMap();
     void testAccumulateTime();
     void testAnimPose();
+
+    // Update 100 rigs that evaluate the shipped avatar-animation.json graph
+    void benchmarkAvatarAnimationGraph();
 };
 
 #endif // hifi_AnimTests_h
@@ -0,0 +1,136 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Created by High Fidelity on 1/20/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioCodecTests.h"
+
+#include <limits>
+#include <math.h>
+
+#include "AudioCodec.h"
+#include "AudioConstants.h"
+
+QTEST_MAIN(AudioCodecTests)
+
+const int FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+const int STEREO = 2;
+
+// something closer to speech than white noise - two tones per channel with a little noise on top
+static void fillStereoFrame(int16_t* samples, int frameOffset) {
+    for (int i = 0; i < FRAMES; i++) {
+        float t = (float)(frameOffset + i) / (float)AudioConstants::SAMPLE_RATE;
+        float left = 6000.0f * sinf(2.0f * (float)M_PI * 220.0f * t) + 2000.0f * sinf(2.0f * (float)M_PI * 1250.0f * t);
+        float right = 8000.0f * sinf(2.0f * (float)M_PI * 330.0f * t) + 1000.0f * sinf(2.0f * (float)M_PI * 2900.0f * t);
+        samples[2 * i] = (int16_t)(left + (qrand() % 200) - 100);
+        samples[2 * i + 1] = (int16_t)(right + (qrand() % 200) - 100);
+    }
+}
+
+void AudioCodecTests::addCodecRows() {
+    QTest::addColumn<int>("codecType");
+
+    for (int type = 0; type < AudioCodec::NUM_TYPES; type++) {
+        QTest::newRow(AudioCodec::getCodec(type)->getName()) << type;
+    }
+}
+
+void AudioCodecTests::testRoundTrip_data() {
+    QTest::addColumn<int>("codecType");
+    QTest::addColumn<double>("minSignalToNoise");
+
+    // PCM is lossless, ADPCM has to stay well above what is audible on voice
+    QTest::newRow("pcm") << (int)AudioCodec::PCM << std::numeric_limits<double>::infinity();
+    QTest::newRow("ima_adpcm") << (int)AudioCodec::IMA_ADPCM << 30.0;
+}
+
+void AudioCodecTests::testRoundTrip() {
+    QFETCH(int, codecType);
+    QFETCH(double, minSignalToNoise);
+
+    const AudioCodec* codec = AudioCodec::getCodec(codecType);
+    QVERIFY(codec);
+    QCOMPARE((int)codec->getType(), codecType);
+    QCOMPARE((int)AudioCodec::getTypeForName(codec->getName()), codecType);
+
+    int16_t input[SAMPLES];
+    int16_t output[SAMPLES];
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+
+    double signal = 0.0;
+    double noise = 0.0;
+
+    const int NUM_FRAMES = 100;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillStereoFrame(input, frame * FRAMES);
+
+        int encodedBytes = codec->encode(input, FRAMES, STEREO, encoded);
+        QCOMPARE(encodedBytes, codec->getEncodedBytes(FRAMES, STEREO));
+        QVERIFY(encodedBytes <= AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+        QCOMPARE(codec->getDecodedSamples(encodedBytes, STEREO), SAMPLES);
+
+        QCOMPARE(codec->decode(encoded, encodedBytes, STEREO, output), SAMPLES);
+
+        for (int i = 0; i < SAMPLES; i++) {
+            signal += (double)input[i] * (double)input[i];
+            noise += ((double)input[i] - (double)output[i]) * ((double)input[i] - (double)output[i]);
+        }
+    }
+
+    double signalToNoise = (noise > 0.0) ? 10.0 * log10(signal / noise) : std::numeric_limits<double>::infinity();
+    qDebug() << codec->getName() << "bytes per stereo frame:" << codec->getEncodedBytes(FRAMES, STEREO)
+        << "SNR:" << signalToNoise << "dB";
+    QVERIFY(signalToNoise >= minSignalToNoise);
+}
+
+void AudioCodecTests::testTruncatedPacket() {
+    // a packet too short to hold the block headers must decode to nothing rather than reading past its end
+    const AudioCodec* codec = AudioCodec::getCodec(AudioCodec::IMA_ADPCM);
+    char encoded[IMAADPCMAudioCodec::BLOCK_HEADER_BYTES] = { 0 };
+    QCOMPARE(codec->getDecodedSamples(sizeof(encoded), STEREO), 0);
+
+    QVERIFY(!AudioCodec::getCodec(AudioCodec::NUM_TYPES));
+}
+
+void AudioCodecTests::benchmarkEncode_data() {
+    addCodecRows();
+}
+
+void AudioCodecTests::benchmarkEncode() {
+    QFETCH(int, codecType);
+    const AudioCodec* codec = AudioCodec::getCodec(codecType);
+
+    int16_t input[SAMPLES];
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    fillStereoFrame(input, 0);
+
+    QBENCHMARK {
+        codec->encode(input, FRAMES, STEREO, encoded);
+    }
+}
+
+void AudioCodecTests::benchmarkDecode_data() {
+    addCodecRows();
+}
+
+void AudioCodecTests::benchmarkDecode() {
+    QFETCH(int, codecType);
+    const AudioCodec* codec = AudioCodec::getCodec(codecType);
+
+    int16_t input[SAMPLES];
+    int16_t output[SAMPLES];
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    fillStereoFrame(input, 0);
+    int encodedBytes = codec->encode(input, FRAMES, STEREO, encoded);
+
+    QBENCHMARK {
+        codec->decode(encoded, encodedBytes, STEREO, output);
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  AudioCodecTests.h
+//  tests/audio/src
+//
+//  Created by High Fidelity on 1/20/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodecTests_h
+#define hifi_AudioCodecTests_h
+
+#include <QtTest/QtTest>
+
+class AudioCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testTruncatedPacket();
+
+    // encode and decode of one stereo network frame with each codec
+    void benchmarkEncode_data();
+    void benchmarkEncode();
+    void benchmarkDecode_data();
+    void benchmarkDecode();
+
+private:
+    void addCodecRows();
+};
+
+#endif // hifi_AudioCodecTests_h
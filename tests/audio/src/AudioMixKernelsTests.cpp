@@ -0,0 +1,203 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Created by High Fidelity on 1/14/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsTests.h"
+
+#include <glm/glm.hpp>
+
+#include "AudioConstants.h"
+#include "AudioMixKernels.h"
+
+QTEST_MAIN(AudioMixKernelsTests)
+
+using namespace AudioMixKernels;
+
+// the phase delay history the mixer keeps in front of a mono frame
+const int MAX_DELAY = 20;
+const int FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+// row value for the loops the mixer used before the kernels
+const int LEGACY_PATH = -1;
+
+static void fillRandom(int16_t* samples, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)((qrand() % 65536) - 32768);
+    }
+}
+
+static void legacyMonoToStereo(const int16_t* input, int16_t* preMix, int16_t* mix,
+                               float gainLeft, float gainRight, int delayRight) {
+    memset(preMix, 0, (SAMPLES + 2 * MAX_DELAY) * sizeof(int16_t));
+
+    int delayedIndex = 1;
+    for (int i = 0; i < delayRight; i++) {
+        preMix[delayedIndex] += input[i - delayRight] * gainRight;
+        delayedIndex += 2;
+    }
+
+    int leftIndex = 0;
+    int rightIndex = 1 + delayRight * 2;
+    for (int i = 0; i < FRAMES; i++) {
+        int16_t leftSample = input[i] * gainLeft;
+        int16_t rightSample = input[i] * gainRight;
+        if (leftIndex <= SAMPLES) {
+            preMix[leftIndex] += leftSample;
+        }
+        if (rightIndex <= SAMPLES) {
+            preMix[rightIndex] += rightSample;
+        }
+        leftIndex += 2;
+        rightIndex += 2;
+    }
+
+    for (int s = 0; s < SAMPLES; s++) {
+        mix[s] = glm::clamp(mix[s] + preMix[s], AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+static void legacyStereoGain(const int16_t* input, int16_t* preMix, int16_t* mix, float gain) {
+    memset(preMix, 0, (SAMPLES + 2 * MAX_DELAY) * sizeof(int16_t));
+
+    for (int s = 0; s < SAMPLES; s++) {
+        preMix[s] = glm::clamp(preMix[s] + (int)(input[s] * gain),
+                               AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+    }
+
+    for (int s = 0; s < SAMPLES; s++) {
+        mix[s] = glm::clamp(mix[s] + preMix[s], AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+void AudioMixKernelsTests::initTestCase() {
+    qDebug() << "Best instruction set:" << getInstructionSetName(getBestInstructionSet());
+}
+
+void AudioMixKernelsTests::cleanupTestCase() {
+    setInstructionSet(getBestInstructionSet());
+}
+
+void AudioMixKernelsTests::testMatchesScalar() {
+    int16_t input[MAX_DELAY + SAMPLES];
+    int16_t initialOutput[SAMPLES];
+    int16_t expected[SAMPLES];
+    int16_t actual[SAMPLES];
+
+    const int NUM_ITERATIONS = 1000;
+    for (int iteration = 0; iteration < NUM_ITERATIONS; iteration++) {
+        fillRandom(input, MAX_DELAY + SAMPLES);
+        fillRandom(initialOutput, SAMPLES);
+
+        // include gains above one, to exercise the saturation
+        float gainLeft = (qrand() % 3000) / 1000.0f;
+        float gainRight = (qrand() % 1000) / 1000.0f;
+        int delayLeft = qrand() % (MAX_DELAY + 1);
+        int delayRight = qrand() % (MAX_DELAY + 1);
+        // odd lengths to exercise the leftovers after the SIMD loops
+        int numFrames = qrand() % (FRAMES + 1);
+        const int16_t* frame = input + MAX_DELAY;
+
+        for (int kernel = 0; kernel < 5; kernel++) {
+            for (int set = Scalar; set <= getBestInstructionSet(); set++) {
+                QVERIFY(setInstructionSet((InstructionSet)set));
+
+                int16_t* output = (set == Scalar) ? expected : actual;
+                memcpy(output, initialOutput, sizeof(initialOutput));
+
+                switch (kernel) {
+                    case 0:
+                        applyGain(frame, output, numFrames * 2, gainLeft);
+                        break;
+                    case 1:
+                        addWithGain(frame, output, numFrames * 2, gainLeft);
+                        break;
+                    case 2:
+                        panMonoToStereo(frame, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+                        break;
+                    case 3:
+                        addMonoToStereo(frame, output, numFrames, gainLeft, gainRight, delayLeft, delayRight);
+                        break;
+                    default:
+                        addSaturating(frame, output, numFrames * 2);
+                        break;
+                }
+
+                if (set != Scalar) {
+                    QVERIFY2(memcmp(expected, actual, sizeof(expected)) == 0,
+                             qPrintable(QString("kernel %1 differs for %2").arg(kernel)
+                                        .arg(getInstructionSetName((InstructionSet)set))));
+                }
+            }
+        }
+    }
+}
+
+void AudioMixKernelsTests::addInstructionSetRows() {
+    QTest::addColumn<int>("instructionSet");
+
+    QTest::newRow("legacy") << LEGACY_PATH;
+    for (int set = Scalar; set <= getBestInstructionSet(); set++) {
+        QTest::newRow(getInstructionSetName((InstructionSet)set)) << set;
+    }
+}
+
+void AudioMixKernelsTests::benchmarkMonoToStereo_data() {
+    addInstructionSetRows();
+}
+
+void AudioMixKernelsTests::benchmarkMonoToStereo() {
+    QFETCH(int, instructionSet);
+
+    int16_t input[MAX_DELAY + SAMPLES];
+    int16_t preMix[SAMPLES + 2 * MAX_DELAY];
+    int16_t mix[SAMPLES + 2 * MAX_DELAY];
+    fillRandom(input, MAX_DELAY + SAMPLES);
+    fillRandom(mix, SAMPLES);
+
+    const int16_t* frame = input + MAX_DELAY;
+    const int DELAY = 13;
+
+    if (instructionSet == LEGACY_PATH) {
+        QBENCHMARK {
+            legacyMonoToStereo(frame, preMix, mix, 0.5f, 0.25f, DELAY);
+        }
+    } else {
+        QVERIFY(setInstructionSet((InstructionSet)instructionSet));
+        QBENCHMARK {
+            addMonoToStereo(frame, mix, FRAMES, 0.5f, 0.25f, 0, DELAY);
+        }
+    }
+}
+
+void AudioMixKernelsTests::benchmarkStereoGain_data() {
+    addInstructionSetRows();
+}
+
+void AudioMixKernelsTests::benchmarkStereoGain() {
+    QFETCH(int, instructionSet);
+
+    int16_t input[SAMPLES];
+    int16_t preMix[SAMPLES + 2 * MAX_DELAY];
+    int16_t mix[SAMPLES + 2 * MAX_DELAY];
+    fillRandom(input, SAMPLES);
+    fillRandom(mix, SAMPLES);
+
+    if (instructionSet == LEGACY_PATH) {
+        QBENCHMARK {
+            legacyStereoGain(input, preMix, mix, 0.5f);
+        }
+    } else {
+        QVERIFY(setInstructionSet((InstructionSet)instructionSet));
+        QBENCHMARK {
+            addWithGain(input, mix, SAMPLES, 0.5f);
+        }
+    }
+}
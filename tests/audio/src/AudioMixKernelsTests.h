@@ -0,0 +1,36 @@
+//
+//  AudioMixKernelsTests.h
+//  tests/audio/src
+//
+//  Created by High Fidelity on 1/14/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsTests_h
+#define hifi_AudioMixKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // every instruction set must give the same samples as the scalar kernels
+    void testMatchesScalar();
+
+    // microbenchmarks of a full network frame, against the per-sample loops the mixer used before the kernels
+    void benchmarkMonoToStereo_data();
+    void benchmarkMonoToStereo();
+    void benchmarkStereoGain_data();
+    void benchmarkStereoGain();
+
+private:
+    void addInstructionSetRows();
+};
+
+#endif // hifi_AudioMixKernelsTests_h
@@ -0,0 +1,196 @@
+//
+//  BlendshapeTests.cpp
+//  tests/model-networking/src
+//
+//  Created by High Fidelity on 2/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeTests.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <model-networking/Blendshapes.h>
+#include <SharedUtil.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(BlendshapeTests)
+
+const int NUM_AVATARS = 50;
+const int NUM_BLENDSHAPES = 50;
+const int NUM_BODY_VERTICES = 10000;
+const int NUM_HEAD_VERTICES = 6000;
+
+static glm::vec3 randomVec3() {
+    return glm::vec3(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+}
+
+static FBXMesh createMesh(int numVertices) {
+    FBXMesh mesh;
+    for (int i = 0; i < numVertices; i++) {
+        mesh.vertices.append(randomVec3());
+        mesh.normals.append(glm::normalize(randomVec3()));
+    }
+    return mesh;
+}
+
+// a body without blendshapes, and a head whose blendshapes each move a few regions of the face. Like those exported
+// by modeling tools, the indices aren't sorted and don't cover every vertex of a region.
+static FBXGeometry createAvatar() {
+    FBXGeometry geometry;
+    geometry.meshes.append(createMesh(NUM_BODY_VERTICES));
+
+    FBXMesh head = createMesh(NUM_HEAD_VERTICES);
+    for (int i = 0; i < NUM_BLENDSHAPES; i++) {
+        QVector<int> indices;
+        int numRegions = randIntInRange(2, 4);
+        for (int region = 0; region < numRegions; region++) {
+            int regionSize = randIntInRange(100, 299);
+            int firstVertex = randIntInRange(0, NUM_HEAD_VERTICES - regionSize - 1);
+            for (int vertex = firstVertex; vertex < firstVertex + regionSize; vertex++) {
+                if (rand() % 4 != 0) {
+                    indices.append(vertex);
+                }
+            }
+        }
+        std::random_shuffle(indices.begin(), indices.end());
+
+        FBXBlendshape blendshape;
+        foreach (int index, indices) {
+            blendshape.indices.append(index);
+            blendshape.vertices.append(0.01f * randomVec3());
+            blendshape.normals.append(randomVec3());
+        }
+        head.blendshapes.append(blendshape);
+    }
+    geometry.meshes.append(head);
+    return geometry;
+}
+
+static QVector<float> createCoefficients() {
+    QVector<float> coefficients;
+    for (int i = 0; i < NUM_BLENDSHAPES; i++) {
+        // most facial blendshapes are off at any time
+        coefficients.append(rand() % 3 == 0 ? randFloat() : 0.0f);
+    }
+    return coefficients;
+}
+
+// the blend Model used to do, one delta at a time
+static void blendUnpacked(const FBXGeometry& geometry, const QVector<float>& coefficients,
+                          QVector<glm::vec3>& vertices, QVector<glm::vec3>& normals) {
+    vertices.clear();
+    normals.clear();
+    int offset = 0;
+    foreach (const FBXMesh& mesh, geometry.meshes) {
+        if (mesh.blendshapes.isEmpty()) {
+            continue;
+        }
+        vertices += mesh.vertices;
+        normals += mesh.normals;
+        glm::vec3* meshVertices = vertices.data() + offset;
+        glm::vec3* meshNormals = normals.data() + offset;
+        offset += mesh.vertices.size();
+        const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+        for (int i = 0, n = qMin(coefficients.size(), mesh.blendshapes.size()); i < n; i++) {
+            float vertexCoefficient = coefficients.at(i);
+            const float EPSILON = 0.0001f;
+            if (vertexCoefficient < EPSILON) {
+                continue;
+            }
+            float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+            const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+            for (int j = 0; j < blendshape.indices.size(); j++) {
+                int index = blendshape.indices.at(j);
+                meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
+                meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
+            }
+        }
+    }
+}
+
+void BlendshapeTests::matchesUnpackedBlendTest() {
+    srand(1);
+    FBXGeometry geometry = createAvatar();
+    PackedBlendshapes blendshapes(geometry);
+    QCOMPARE(blendshapes.getNumVertices(), NUM_HEAD_VERTICES);
+
+    for (int frame = 0; frame < 10; frame++) {
+        QVector<float> coefficients = createCoefficients();
+
+        QVector<glm::vec3> expectedVertices, expectedNormals;
+        blendUnpacked(geometry, coefficients, expectedVertices, expectedNormals);
+
+        QVector<glm::vec3> vertices, normals;
+        blendshapes.blend(coefficients, vertices, normals);
+
+        QCOMPARE(vertices.size(), expectedVertices.size());
+        QCOMPARE(normals.size(), expectedNormals.size());
+        for (int i = 0; i < vertices.size(); i++) {
+            QCOMPARE_WITH_ABS_ERROR(vertices[i], expectedVertices[i], 0.0001f);
+            QCOMPARE_WITH_ABS_ERROR(normals[i], expectedNormals[i], 0.0001f);
+        }
+    }
+}
+
+void BlendshapeTests::rangeBlendTest() {
+    srand(2);
+    FBXGeometry geometry = createAvatar();
+    PackedBlendshapes blendshapes(geometry);
+    QVector<float> coefficients = createCoefficients();
+
+    QVector<glm::vec3> expectedVertices, expectedNormals;
+    blendshapes.blend(coefficients, expectedVertices, expectedNormals);
+
+    // uneven pieces, so that they start and end in the middle of runs
+    const int NUM_PIECES = 7;
+    int numVertices = blendshapes.getNumVertices();
+    QVector<glm::vec3> vertices(numVertices), normals(numVertices);
+    for (int i = 0; i < NUM_PIECES; i++) {
+        blendshapes.blend(coefficients, numVertices * i / NUM_PIECES, numVertices * (i + 1) / NUM_PIECES,
+                          vertices.data(), normals.data());
+    }
+    for (int i = 0; i < numVertices; i++) {
+        QCOMPARE_WITH_ABS_ERROR(vertices[i], expectedVertices[i], 0.0001f);
+        QCOMPARE_WITH_ABS_ERROR(normals[i], expectedNormals[i], 0.0001f);
+    }
+}
+
+void BlendshapeTests::benchmarkBlend() {
+    srand(3);
+    std::vector<PackedBlendshapes> avatars;
+    QVector<QVector<float>> coefficients;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        avatars.emplace_back(createAvatar());
+        coefficients.append(createCoefficients());
+    }
+
+    QVector<glm::vec3> vertices, normals;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            avatars[i].blend(coefficients[i], vertices, normals);
+        }
+    }
+}
+
+void BlendshapeTests::benchmarkUnpackedBlend() {
+    srand(3);
+    QVector<FBXGeometry> avatars;
+    QVector<QVector<float>> coefficients;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        avatars.append(createAvatar());
+        coefficients.append(createCoefficients());
+    }
+
+    QVector<glm::vec3> vertices, normals;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            blendUnpacked(avatars[i], coefficients[i], vertices, normals);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+//
+//  BlendshapeTests.h
+//  tests/model-networking/src
+//
+//  Created by High Fidelity on 2/22/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlendshapeTests_h
+#define hifi_BlendshapeTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class BlendshapeTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that packed blendshapes blend like adding up every delta
+    void matchesUnpackedBlendTest();
+
+    // Test that blending a geometry in pieces gives the same vertices as blending it whole
+    void rangeBlendTest();
+
+    // Blend 50 avatars, each with 50 facial blendshapes
+    void benchmarkBlend();
+    void benchmarkUnpackedBlend();
+};
+
+#endif // hifi_BlendshapeTests_h
@@ -0,0 +1,132 @@
+//
+//  PacketHashTests.cpp
+//  tests/networking/src
+//
+//  Created by High Fidelity on 2/16/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketHashTests.h"
+
+#include <LimitedNodeList.h>
+#include <NLPacket.h>
+#include <Node.h>
+#include <SipHash.h>
+
+QTEST_MAIN(PacketHashTests)
+
+Q_DECLARE_METATYPE(NLPacket::HashType)
+
+static std::unique_ptr<NLPacket> createFullPacket() {
+    auto packet = NLPacket::create(PacketType::MixedAudio);
+    QByteArray payload(packet->getPayloadCapacity(), Qt::Uninitialized);
+    for (int i = 0; i < payload.size(); i++) {
+        payload[i] = (char)(i * 7);
+    }
+    packet->write(payload);
+    return packet;
+}
+
+void PacketHashTests::sipHashVectorsTest() {
+    // the key is 00 01 .. 0f and the message of length n is 00 01 .. n-1
+    uint8_t key[NUM_BYTES_SIP_HASH_KEY];
+    for (int i = 0; i < NUM_BYTES_SIP_HASH_KEY; i++) {
+        key[i] = (uint8_t)i;
+    }
+    char message[64];
+    for (int i = 0; i < 64; i++) {
+        message[i] = (char)i;
+    }
+
+    uint8_t hash[NUM_BYTES_SIP_HASH];
+
+    sipHash128(key, message, 0, hash);
+    QCOMPARE(QByteArray((const char*)hash, NUM_BYTES_SIP_HASH).toHex(), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+
+    sipHash128(key, message, 15, hash);
+    QCOMPARE(QByteArray((const char*)hash, NUM_BYTES_SIP_HASH).toHex(), QByteArray("5493e99933b0a8117e08ec0f97cfc3d9"));
+
+    sipHash128(key, message, 63, hash);
+    QCOMPARE(QByteArray((const char*)hash, NUM_BYTES_SIP_HASH).toHex(), QByteArray("5150d1772f50834a503e069a973fbd7c"));
+}
+
+void PacketHashTests::verificationTest_data() {
+    QTest::addColumn<NLPacket::HashType>("hashType");
+
+    QTest::newRow("MD5") << NLPacket::HashType::Md5;
+    QTest::newRow("SipHash") << NLPacket::HashType::SipHash;
+}
+
+void PacketHashTests::verificationTest() {
+    QFETCH(NLPacket::HashType, hashType);
+
+    QUuid secret = QUuid::createUuid();
+    auto packet = createFullPacket();
+    packet->writeVerificationHashGivenSecret(secret, hashType);
+
+    QVERIFY(NLPacket::verificationHashMatches(*packet, secret, hashType));
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, QUuid::createUuid(), hashType));
+
+    NLPacket::HashType otherHashType = hashType == NLPacket::HashType::Md5
+        ? NLPacket::HashType::SipHash : NLPacket::HashType::Md5;
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, secret, otherHashType));
+
+    // flip a bit in the last byte of the payload
+    packet->getData()[packet->getDataSize() - 1] ^= 1;
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, secret, hashType));
+
+    // no hash doesn't pass for a hash
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, secret, NLPacket::HashType::None));
+}
+
+void PacketHashTests::trustedNodeTest() {
+    QUuid secret = QUuid::createUuid();
+    HifiSockAddr nodeSocket(QHostAddress("10.0.0.2"), 40102);
+    Node node(QUuid::createUuid(), NodeType::Agent, nodeSocket, nodeSocket, true, true, secret);
+    node.setIsTrusted(true);
+    node.setVerificationHashType(NLPacket::HashType::SipHash);
+    node.activatePublicSocket();
+
+    // a packet that claims to be from the node, without a hash
+    auto packet = createFullPacket();
+    packet->writeVerificationHashGivenSecret(secret, NLPacket::HashType::None);
+
+    packet->getSenderSockAddr() = nodeSocket;
+    QVERIFY(LimitedNodeList::verificationHashMatchesNode(*packet, node, true));
+
+    // only trusted nodes skip the check
+    QVERIFY(!LimitedNodeList::verificationHashMatchesNode(*packet, node, false));
+    node.setIsTrusted(false);
+    QVERIFY(!LimitedNodeList::verificationHashMatchesNode(*packet, node, true));
+    node.setIsTrusted(true);
+
+    // anyone can claim the ID of a trusted node, from anywhere
+    packet->getSenderSockAddr() = HifiSockAddr(QHostAddress("203.0.113.7"), 40102);
+    QVERIFY(!LimitedNodeList::verificationHashMatchesNode(*packet, node, true));
+    packet->getSenderSockAddr() = HifiSockAddr(QHostAddress("10.0.0.2"), 40103);
+    QVERIFY(!LimitedNodeList::verificationHashMatchesNode(*packet, node, true));
+
+    // the node hashes its packets, so they verify from anywhere
+    packet->writeVerificationHashGivenSecret(secret, NLPacket::HashType::SipHash);
+    QVERIFY(LimitedNodeList::verificationHashMatchesNode(*packet, node, true));
+}
+
+void PacketHashTests::benchmarkHash_data() {
+    verificationTest_data();
+}
+
+void PacketHashTests::benchmarkHash() {
+    QFETCH(NLPacket::HashType, hashType);
+
+    QUuid secret = QUuid::createUuid();
+    auto packet = createFullPacket();
+
+    QBENCHMARK {
+        packet->writeVerificationHashGivenSecret(secret, hashType);
+    }
+
+    QVERIFY(NLPacket::verificationHashMatches(*packet, secret, hashType));
+}
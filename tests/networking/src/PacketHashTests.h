@@ -0,0 +1,37 @@
+//
+//  PacketHashTests.h
+//  tests/networking/src
+//
+//  Created by High Fidelity on 2/16/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketHashTests_h
+#define hifi_PacketHashTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketHashTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test SipHash against the reference test vectors
+    void sipHashVectorsTest();
+
+    // Test that a hashed packet verifies with its own secret and hash type only
+    void verificationTest_data();
+    void verificationTest();
+
+    // Test that packets from trusted nodes are only let through without a hash from the node's address
+    void trustedNodeTest();
+
+    // Hash full size packets with each hash type
+    void benchmarkHash_data();
+    void benchmarkHash();
+};
+
+#endif // hifi_PacketHashTests_h
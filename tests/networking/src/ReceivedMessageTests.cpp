@@ -0,0 +1,191 @@
+//
+//  ReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Created by High Fidelity on 2/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedMessageTests.h"
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(ReceivedMessageTests)
+
+static std::unique_ptr<NLPacket> createMessagePacket(const QByteArray& payload, NLPacket::PacketPosition position,
+                                                     NLPacket::MessagePartNumber partNumber) {
+    auto packet = NLPacket::create(PacketType::AssetGetReply, -1, true, true);
+    packet->write(payload);
+    packet->writeMessageNumber(1, position, partNumber);
+    packet->seek(0);
+    return packet;
+}
+
+// every byte of the message is different from its neighbours, so that a read from the wrong offset shows
+static QByteArray createPayload(int size, int offset) {
+    QByteArray payload(size, Qt::Uninitialized);
+    for (int i = 0; i < size; i++) {
+        payload[i] = (char)((offset + i) * 7);
+    }
+    return payload;
+}
+
+void ReceivedMessageTests::readAcrossPacketsTest() {
+    const int PAYLOAD_SIZE = 100;
+    QByteArray expected;
+    for (int i = 0; i < 3; i++) {
+        expected.append(createPayload(PAYLOAD_SIZE, i * PAYLOAD_SIZE));
+    }
+
+    ReceivedMessage message(createMessagePacket(expected.mid(0, PAYLOAD_SIZE), NLPacket::FIRST, 0));
+    message.appendPacket(createMessagePacket(expected.mid(PAYLOAD_SIZE, PAYLOAD_SIZE), NLPacket::MIDDLE, 1));
+    message.appendPacket(createMessagePacket(expected.mid(2 * PAYLOAD_SIZE, PAYLOAD_SIZE), NLPacket::LAST, 2));
+
+    QVERIFY(message.isComplete());
+    QCOMPARE(message.getNumPackets(), (qint64)3);
+    QCOMPARE(message.getSize(), (qint64)expected.size());
+
+    // a primitive that straddles the first two packets
+    message.seek(PAYLOAD_SIZE - 2);
+    quint32 straddling;
+    QCOMPARE(message.peekPrimitive(&straddling), (qint64)sizeof(straddling));
+    QCOMPARE(memcmp(&straddling, expected.constData() + PAYLOAD_SIZE - 2, sizeof(straddling)), 0);
+    QCOMPARE(message.readPrimitive(&straddling), (qint64)sizeof(straddling));
+    QCOMPARE(message.getPosition(), (qint64)PAYLOAD_SIZE + 2);
+
+    // a read across every packet, after seeking back
+    message.seek(10);
+    QCOMPARE(message.read(2 * PAYLOAD_SIZE + 50), expected.mid(10, 2 * PAYLOAD_SIZE + 50));
+
+    // reads stop at the end of the message
+    message.seek(expected.size() - 20);
+    QCOMPARE(message.readAll(), expected.right(20));
+    QCOMPARE(message.getBytesLeftToRead(), (qint64)0);
+    QCOMPARE(message.read(10), QByteArray());
+
+    message.seek(PAYLOAD_SIZE + 10);
+    QByteArray inPlace = message.readWithoutCopy(20);
+    QCOMPARE(inPlace, expected.mid(PAYLOAD_SIZE + 10, 20));
+    QByteArray straddlingWithoutCopy = message.readWithoutCopy(PAYLOAD_SIZE);
+    QCOMPARE(straddlingWithoutCopy, expected.mid(PAYLOAD_SIZE + 30, PAYLOAD_SIZE));
+
+    QCOMPARE(message.getMessage(), expected);
+    QCOMPARE(memcmp(message.getRawMessage(), expected.constData(), expected.size()), 0);
+}
+
+void ReceivedMessageTests::singlePacketTest() {
+    QByteArray expected = createPayload(200, 0);
+    auto packet = createMessagePacket(expected, NLPacket::ONLY, 0);
+    const char* payload = packet->getPayload();
+
+    ReceivedMessage message(std::move(packet));
+    QVERIFY(message.isComplete());
+    QCOMPARE(message.getSize(), (qint64)expected.size());
+
+    // the message reads the packet it was given
+    QVERIFY(message.getRawMessage() == payload);
+    QVERIFY(message.readWithoutCopy(50).constData() == payload);
+    QCOMPARE(message.readAll(), expected.mid(50));
+    QCOMPARE(message.getMessage(), expected);
+}
+
+void ReceivedMessageTests::readWhileIncompleteTest() {
+    const int PAYLOAD_SIZE = 64;
+    QByteArray expected = createPayload(2 * PAYLOAD_SIZE, 0);
+
+    ReceivedMessage message(createMessagePacket(expected.left(PAYLOAD_SIZE), NLPacket::FIRST, 0));
+    QVERIFY(!message.isComplete());
+    QCOMPARE(message.getSize(), (qint64)PAYLOAD_SIZE);
+
+    // only what has arrived can be read
+    QCOMPARE(message.read(16), expected.left(16));
+    QCOMPARE(message.read(2 * PAYLOAD_SIZE), expected.mid(16, PAYLOAD_SIZE - 16));
+
+    bool completed = false;
+    connect(&message, &ReceivedMessage::completed, [&] { completed = true; });
+    message.appendPacket(createMessagePacket(expected.mid(PAYLOAD_SIZE), NLPacket::LAST, 1));
+
+    QVERIFY(completed);
+    QVERIFY(message.isComplete());
+    QCOMPARE(message.readAll(), expected.mid(PAYLOAD_SIZE));
+}
+
+void ReceivedMessageTests::viewsWhileIncompleteTest() {
+    const int PAYLOAD_SIZE = 64;
+    QByteArray expected = createPayload(3 * PAYLOAD_SIZE, 0);
+
+    ReceivedMessage message(createMessagePacket(expected.left(PAYLOAD_SIZE), NLPacket::FIRST, 0));
+    message.appendPacket(createMessagePacket(expected.mid(PAYLOAD_SIZE, PAYLOAD_SIZE), NLPacket::MIDDLE, 1));
+
+    const char* raw = message.getRawMessage();
+    message.seek(PAYLOAD_SIZE - 10);
+    QByteArray straddling = message.readWithoutCopy(20);
+
+    message.appendPacket(createMessagePacket(expected.mid(2 * PAYLOAD_SIZE), NLPacket::LAST, 2));
+    QVERIFY(message.isComplete());
+
+    // the message was copied into one piece again, the earlier copy is still there
+    QCOMPARE(memcmp(message.getRawMessage(), expected.constData(), expected.size()), 0);
+    QCOMPARE(memcmp(raw, expected.constData(), 2 * PAYLOAD_SIZE), 0);
+    QCOMPARE(straddling, expected.mid(PAYLOAD_SIZE - 10, 20));
+}
+
+static const qint64 LARGE_MESSAGE_SIZE = 100 * 1024 * 1024;
+
+// what the socket hands over for a large message, created outside of the measurement
+static std::vector<std::unique_ptr<NLPacket>> createLargeMessagePackets(const QByteArray& payload) {
+    const int NUM_PACKETS = (int)((LARGE_MESSAGE_SIZE + payload.size() - 1) / payload.size());
+    std::vector<std::unique_ptr<NLPacket>> packets;
+    packets.reserve(NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        NLPacket::PacketPosition position = i == 0 ? NLPacket::FIRST :
+            (i == NUM_PACKETS - 1 ? NLPacket::LAST : NLPacket::MIDDLE);
+        packets.push_back(createMessagePacket(payload, position, i));
+    }
+    return packets;
+}
+
+void ReceivedMessageTests::benchmarkLargeMessage() {
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    QByteArray payload = createPayload(PAYLOAD_SIZE, 0);
+    auto packets = createLargeMessagePackets(payload);
+    const int NUM_PACKETS = (int)packets.size();
+
+    // appending keeps the packets, so the payload is only copied once, by readAll()
+    QByteArray data;
+    QBENCHMARK_ONCE {
+        ReceivedMessage message(std::move(packets[0]));
+        for (int i = 1; i < NUM_PACKETS; i++) {
+            message.appendPacket(std::move(packets[i]));
+        }
+        QVERIFY(message.isComplete());
+        data = message.readAll();
+    }
+
+    QCOMPARE((qint64)data.size(), (qint64)NUM_PACKETS * PAYLOAD_SIZE);
+    QCOMPARE(data.right(PAYLOAD_SIZE), payload);
+}
+
+void ReceivedMessageTests::benchmarkLargeMessageCopied() {
+    const int PAYLOAD_SIZE = NLPacket::maxPayloadSize(PacketType::AssetGetReply, true);
+    QByteArray payload = createPayload(PAYLOAD_SIZE, 0);
+    auto packets = createLargeMessagePackets(payload);
+    const int NUM_PACKETS = (int)packets.size();
+
+    // the message grew as the packets arrived, and each packet was freed once its payload was appended
+    QByteArray data;
+    QBENCHMARK_ONCE {
+        QByteArray message;
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            message.append(packets[i]->getPayload(), packets[i]->getPayloadSize());
+            packets[i].reset();
+        }
+        data = message.mid(1); // readAll() after the head of an asset reply had been read, which copied
+    }
+
+    QCOMPARE((qint64)data.size(), (qint64)NUM_PACKETS * PAYLOAD_SIZE - 1);
+}
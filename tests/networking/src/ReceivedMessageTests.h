@@ -0,0 +1,39 @@
+//
+//  ReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Created by High Fidelity on 2/15/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedMessageTests_h
+#define hifi_ReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test reads that straddle the packets of a message
+    void readAcrossPacketsTest();
+
+    // Test that a single packet message is read in place
+    void singlePacketTest();
+
+    // Test reading a message while its packets are still arriving
+    void readWhileIncompleteTest();
+
+    // Test that what was read in place stays valid while more packets arrive
+    void viewsWhileIncompleteTest();
+
+    // Assemble and read a 100 MB message, the size of a large asset download
+    void benchmarkLargeMessage();
+    void benchmarkLargeMessageCopied(); // appending every payload to one QByteArray, as ReceivedMessage used to
+};
+
+#endif // hifi_ReceivedMessageTests_h
@@ -0,0 +1,150 @@
+//
+//  OctreeJournalTests.cpp
+//  tests/octree/src
+//
+//  Created by High Fidelity on 2/5/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJournalTests.h"
+
+#include <QTemporaryDir>
+
+#include <OctreeJournal.h>
+
+QTEST_MAIN(OctreeJournalTests)
+
+// The tree is a map of entity IDs to values, and the persist file a copy of it. The persist thread writes the file
+// between beginCompaction and endCompaction, and reopens the journal when it starts up.
+
+static QVariantMap setRecord(const QString& id, int value) {
+    QVariantMap record;
+    record["op"] = "set";
+    record["id"] = id;
+    record["value"] = value;
+    return record;
+}
+
+static QVariantMap deleteRecord(const QString& id) {
+    QVariantMap record;
+    record["op"] = "delete";
+    record["id"] = id;
+    return record;
+}
+
+static void applyRecords(QVariantMap& tree, const QVariantList& records) {
+    foreach (const QVariant& record, records) {
+        QVariantMap map = record.toMap();
+        if (map["op"] == "set") {
+            tree[map["id"].toString()] = map["value"];
+        } else {
+            tree.remove(map["id"].toString());
+        }
+    }
+}
+
+static void journalChange(QVariantMap& tree, OctreeJournal& journal, const QVariantMap& record) {
+    applyRecords(tree, QVariantList() << record);
+    QVERIFY(journal.append(QVariantList() << record));
+}
+
+static QVariantMap loadAfterRestart(const QString& filename, const QVariantMap& file, bool isFileWritten) {
+    OctreeJournal journal(filename);
+    journal.recoverCompaction(isFileWritten);
+    QVariantList records;
+    journal.read(records);
+
+    QVariantMap tree = file;
+    applyRecords(tree, records);
+    return tree;
+}
+
+void OctreeJournalTests::compactionReplayTest() {
+    QTemporaryDir dir;
+    QString filename = dir.path() + "/models.journal";
+    OctreeJournal journal(filename);
+
+    QVariantMap tree;
+    journalChange(tree, journal, setRecord("a", 1));
+    journalChange(tree, journal, setRecord("b", 1));
+
+    QVERIFY(journal.beginCompaction());
+    QVariantMap file = tree;
+    journal.endCompaction();
+    QCOMPARE(journal.getSize(), (qint64)0);
+
+    journalChange(tree, journal, setRecord("a", 2));
+    journalChange(tree, journal, deleteRecord("b"));
+
+    QCOMPARE(loadAfterRestart(filename, file, true), tree);
+}
+
+void OctreeJournalTests::crashAfterWriteTest() {
+    QTemporaryDir dir;
+    QString filename = dir.path() + "/models.journal";
+    OctreeJournal journal(filename);
+
+    QVariantMap tree;
+    tree["b"] = 1;
+    QVariantMap file = tree;
+    journalChange(tree, journal, setRecord("a", 1));
+    journalChange(tree, journal, deleteRecord("b"));
+
+    // changes that were not journaled yet when the compaction started, they are only in the file
+    tree["a"] = 2;
+    tree["b"] = 2;
+
+    QVERIFY(journal.beginCompaction());
+    file = tree;
+    journalChange(tree, journal, setRecord("c", 1));
+
+    // the process dies before endCompaction, the older records would revert a and delete b again
+    QCOMPARE(loadAfterRestart(filename, file, true), tree);
+    QCOMPARE(loadAfterRestart(filename, file, true), tree);
+}
+
+void OctreeJournalTests::crashBeforeWriteTest() {
+    QTemporaryDir dir;
+    QString filename = dir.path() + "/models.journal";
+    OctreeJournal journal(filename);
+
+    QVariantMap tree;
+    tree["b"] = 1;
+    QVariantMap file = tree;
+    journalChange(tree, journal, setRecord("a", 1));
+    journalChange(tree, journal, deleteRecord("b"));
+
+    // the process dies before the file is written, so it is still the one from before the journal
+    QVERIFY(journal.beginCompaction());
+    journalChange(tree, journal, setRecord("a", 2));
+    journalChange(tree, journal, setRecord("c", 1));
+
+    QCOMPARE(loadAfterRestart(filename, file, false), tree);
+
+    // the records are back in the journal, and the next compaction moves them all aside
+    QVERIFY(!QFile::exists(filename + ".compacting"));
+    OctreeJournal reopened(filename);
+    QVERIFY(reopened.beginCompaction());
+    QCOMPARE(loadAfterRestart(filename, file, false), tree);
+}
+
+void OctreeJournalTests::tornRecordTest() {
+    QTemporaryDir dir;
+    QString filename = dir.path() + "/models.journal";
+
+    QVariantMap tree;
+    {
+        OctreeJournal journal(filename);
+        journalChange(tree, journal, setRecord("a", 1));
+    }
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write("{\"op\":\"set\",\"id\":\"b\"");
+    file.close();
+
+    QCOMPARE(loadAfterRestart(filename, QVariantMap(), true), tree);
+}
@@ -0,0 +1,33 @@
+//
+//  OctreeJournalTests.h
+//  tests/octree/src
+//
+//  Created by High Fidelity on 2/5/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJournalTests_h
+#define hifi_OctreeJournalTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeJournalTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the file and the journal after a compaction load as the tree that was compacted, plus later changes
+    void compactionReplayTest();
+
+    // Test that a crash after the file is written, before the compaction finishes, doesn't replay older changes
+    void crashAfterWriteTest();
+
+    // Test that a crash before the file is written replays everything journaled since the file before it
+    void crashBeforeWriteTest();
+
+    // Test that a torn record at the end of the journal is dropped
+    void tornRecordTest();
+};
+
+#endif // hifi_OctreeJournalTests_h
@@ -0,0 +1,183 @@
+//
+//  TriangleBVHTests.cpp
+//  tests/shared/src
+//
+//  Created by High Fidelity on 2/19/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleBVHTests.h"
+
+#include <limits>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <NumericalConstants.h>
+#include <TriangleBVH.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(TriangleBVHTests)
+
+const int NUM_RAYS = 256;
+
+// a bumpy sphere of rings * segments quads, facing out
+static std::vector<Triangle> createSphere(int rings, int segments) {
+    auto pointAt = [&](int ring, int segment) {
+        float theta = PI * ring / rings;
+        float phi = TWO_PI * segment / segments;
+        float radius = 1.0f + 0.05f * sinf(17.0f * theta) * cosf(13.0f * phi);
+        return radius * glm::vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    };
+
+    std::vector<Triangle> triangles;
+    triangles.reserve(2 * rings * segments);
+    for (int ring = 0; ring < rings; ring++) {
+        for (int segment = 0; segment < segments; segment++) {
+            glm::vec3 v0 = pointAt(ring, segment);
+            glm::vec3 v1 = pointAt(ring + 1, segment);
+            glm::vec3 v2 = pointAt(ring + 1, segment + 1);
+            glm::vec3 v3 = pointAt(ring, segment + 1);
+            triangles.push_back({ v0, v2, v1 });
+            triangles.push_back({ v0, v3, v2 });
+        }
+    }
+    return triangles;
+}
+
+// rays from around the sphere, most of them aimed at it
+static void createRays(std::vector<glm::vec3>& origins, std::vector<glm::vec3>& directions) {
+    qsrand(1);
+    auto randomFloat = [] { return 2.0f * (float)qrand() / RAND_MAX - 1.0f; };
+    for (int i = 0; i < NUM_RAYS; i++) {
+        glm::vec3 origin = 3.0f * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        glm::vec3 target = 1.2f * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        origins.push_back(origin);
+        directions.push_back(glm::normalize(target - origin));
+    }
+}
+
+static bool findLinearRayIntersection(const std::vector<Triangle>& triangles, const glm::vec3& origin,
+                                      const glm::vec3& direction, float& distance) {
+    bool intersected = false;
+    distance = std::numeric_limits<float>::max();
+    for (const Triangle& triangle : triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangle, triangleDistance) && triangleDistance < distance) {
+            distance = triangleDistance;
+            intersected = true;
+        }
+    }
+    return intersected;
+}
+
+void TriangleBVHTests::matchesLinearPickTest() {
+    std::vector<Triangle> triangles = createSphere(64, 64);
+    TriangleBVH bvh(triangles);
+    QCOMPARE(bvh.getNumTriangles(), (int)triangles.size());
+
+    std::vector<glm::vec3> origins, directions;
+    createRays(origins, directions);
+
+    int numHits = 0;
+    for (int i = 0; i < NUM_RAYS; i++) {
+        float linearDistance;
+        bool linearHit = findLinearRayIntersection(triangles, origins[i], directions[i], linearDistance);
+
+        float distance;
+        glm::vec3 surfaceNormal;
+        bool hit = bvh.findRayIntersection(origins[i], directions[i], distance, surfaceNormal);
+        QCOMPARE(hit, linearHit);
+        if (hit) {
+            QCOMPARE_WITH_ABS_ERROR(distance, linearDistance, EPSILON);
+            // the sphere faces out, so does any triangle a ray from outside it can hit
+            QVERIFY(glm::dot(surfaceNormal, directions[i]) < 0.0f);
+            numHits++;
+        }
+    }
+    QVERIFY(numHits > 0);
+
+    // a ray that starts inside the sphere only sees its back faces
+    float distance;
+    glm::vec3 surfaceNormal;
+    QVERIFY(!bvh.findRayIntersection(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), distance, surfaceNormal));
+
+    TriangleBVH empty;
+    QVERIFY(!empty.findRayIntersection(origins[0], directions[0], distance, surfaceNormal));
+}
+
+void TriangleBVHTests::mappedRayTest() {
+    std::vector<Triangle> triangles = createSphere(32, 32);
+    TriangleBVH bvh(triangles);
+
+    glm::mat4 toWorld = glm::translate(glm::vec3(10.0f, -2.0f, 5.0f)) *
+        glm::mat4_cast(glm::angleAxis(0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)))) *
+        glm::scale(glm::vec3(2.0f, 0.5f, 3.0f));
+    glm::mat4 toLocal = glm::inverse(toWorld);
+
+    std::vector<Triangle> worldTriangles;
+    for (const Triangle& triangle : triangles) {
+        worldTriangles.push_back({ glm::vec3(toWorld * glm::vec4(triangle.v0, 1.0f)),
+                                   glm::vec3(toWorld * glm::vec4(triangle.v1, 1.0f)),
+                                   glm::vec3(toWorld * glm::vec4(triangle.v2, 1.0f)) });
+    }
+
+    std::vector<glm::vec3> origins, directions;
+    createRays(origins, directions);
+
+    for (int i = 0; i < NUM_RAYS; i++) {
+        glm::vec3 origin = glm::vec3(toWorld * glm::vec4(origins[i], 1.0f));
+        glm::vec3 direction = glm::normalize(glm::vec3(toWorld * glm::vec4(directions[i], 0.0f)));
+
+        float worldDistance;
+        bool worldHit = findLinearRayIntersection(worldTriangles, origin, direction, worldDistance);
+
+        float distance;
+        glm::vec3 surfaceNormal;
+        bool hit = bvh.findRayIntersection(glm::vec3(toLocal * glm::vec4(origin, 1.0f)),
+                                           glm::vec3(toLocal * glm::vec4(direction, 0.0f)), distance, surfaceNormal);
+        QCOMPARE(hit, worldHit);
+        if (hit) {
+            QCOMPARE_WITH_ABS_ERROR(distance, worldDistance, 0.001f);
+        }
+    }
+}
+
+void TriangleBVHTests::benchmarkBuild() {
+    std::vector<Triangle> triangles = createSphere(500, 500);
+    QBENCHMARK {
+        TriangleBVH bvh(triangles);
+    }
+}
+
+void TriangleBVHTests::benchmarkPick() {
+    TriangleBVH bvh(createSphere(500, 500));
+    std::vector<glm::vec3> origins, directions;
+    createRays(origins, directions);
+
+    float distance;
+    glm::vec3 surfaceNormal;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RAYS; i++) {
+            bvh.findRayIntersection(origins[i], directions[i], distance, surfaceNormal);
+        }
+    }
+}
+
+void TriangleBVHTests::benchmarkLinearPick() {
+    std::vector<Triangle> triangles = createSphere(500, 500);
+    std::vector<glm::vec3> origins, directions;
+    createRays(origins, directions);
+
+    float distance;
+    QBENCHMARK {
+        for (int i = 0; i < NUM_RAYS; i++) {
+            findLinearRayIntersection(triangles, origins[i], directions[i], distance);
+        }
+    }
+}
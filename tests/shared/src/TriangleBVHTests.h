@@ -0,0 +1,34 @@
+//
+//  TriangleBVHTests.h
+//  tests/shared/src
+//
+//  Created by High Fidelity on 2/19/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleBVHTests_h
+#define hifi_TriangleBVHTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class TriangleBVHTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that picks find the same triangle as testing every triangle
+    void matchesLinearPickTest();
+
+    // Test that a ray mapped into the frame of the triangles hits at the same distance
+    void mappedRayTest();
+
+    // Build and pick against a 500k triangle model
+    void benchmarkBuild();
+    void benchmarkPick();
+    void benchmarkLinearPick();
+};
+
+#endif // hifi_TriangleBVHTests_h
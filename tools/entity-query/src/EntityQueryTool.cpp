@@ -0,0 +1,233 @@
+//
+//  EntityQueryTool.cpp
+//  tools/entity-query/src
+//
+//  Created by High Fidelity on 2/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryTool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <QtCore/QDebug>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+const QCommandLineOption ENTITIES_OPTION {
+    "entities", "how many entities to put in the synthetic domain (defaults to 100000)", "entities", "100000"
+};
+const QCommandLineOption QUERIES_OPTION {
+    "queries", "how many queries of each kind to run (defaults to 10000)", "queries", "10000"
+};
+const QCommandLineOption BATCH_OPTION {
+    "batch", "how many rays to cast in each query batch (defaults to 256)", "batch", "256"
+};
+
+// the synthetic domain is spread over a few square kilometers, like a large city
+const float SYNTHETIC_DOMAIN_SIZE = 2000.0f;
+
+// one entity in this many is a building or a terrain tile, which the octree keeps near its root
+const int LARGE_ENTITY_RATIO = 100;
+
+const float QUERY_RADIUS = 10.0f;
+
+EntityQueryTool::EntityQueryTool(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    parseArguments();
+}
+
+void EntityQueryTool::parseArguments() {
+    _argumentParser.setApplicationDescription("High Fidelity Entity Query Benchmark");
+
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    _argumentParser.addOptions({ ENTITIES_OPTION, QUERIES_OPTION, BATCH_OPTION });
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (_argumentParser.isSet(helpOption)) {
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+}
+
+int EntityQueryTool::run() {
+    int numEntities = _argumentParser.value(ENTITIES_OPTION).toInt();
+    int numQueries = std::max(_argumentParser.value(QUERIES_OPTION).toInt(), 1);
+    int batchSize = std::max(_argumentParser.value(BATCH_OPTION).toInt(), 1);
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setWantSpatialIndex(false);
+    addEntities(tree, numEntities);
+
+    benchmark(tree, numQueries, "octree");
+
+    quint64 start = usecTimestampNow();
+    tree->withWriteLock([&] {
+        tree->setWantSpatialIndex(true);
+    });
+    quint64 buildTime = usecTimestampNow() - start;
+    const EntitySpatialIndex& spatialIndex = tree->getSpatialIndex();
+    qDebug().noquote() << QString("spatial index: %1 entities (%2 unindexed), height %3, built in %4 us")
+        .arg(spatialIndex.getNumEntities())
+        .arg(spatialIndex.getNumUnindexed())
+        .arg(spatialIndex.getHeight())
+        .arg(buildTime);
+
+    benchmark(tree, numQueries, "spatial index");
+    benchmarkBatches(tree, numQueries, batchSize);
+    return 0;
+}
+
+void EntityQueryTool::addEntities(EntityTreePointer tree, int numEntities) const {
+    std::mt19937 generator(numEntities);
+    std::uniform_real_distribution<float> position(-SYNTHETIC_DOMAIN_SIZE / 2.0f, SYNTHETIC_DOMAIN_SIZE / 2.0f);
+    std::uniform_real_distribution<float> size(0.1f, 2.0f);
+    std::uniform_real_distribution<float> largeSize(20.0f, 200.0f);
+
+    quint64 now = usecTimestampNow();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; ++i) {
+            bool isLarge = (i % LARGE_ENTITY_RATIO) == 0;
+            auto& dimension = isLarge ? largeSize : size;
+
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::vec3(position(generator), position(generator) / 10.0f, position(generator)));
+            properties.setDimensions(glm::vec3(dimension(generator), dimension(generator), dimension(generator)));
+            properties.setCreated(now);
+            properties.setLastEdited(now);
+
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+}
+
+void EntityQueryTool::benchmark(EntityTreePointer tree, int numQueries, const QString& label) const {
+    // every run asks the same questions
+    std::mt19937 generator(numQueries);
+    std::uniform_real_distribution<float> position(-SYNTHETIC_DOMAIN_SIZE / 2.0f, SYNTHETIC_DOMAIN_SIZE / 2.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+    auto randomPosition = [&] {
+        return glm::vec3(position(generator), position(generator) / 10.0f, position(generator));
+    };
+
+    auto report = [&](const char* query, quint64 usecs, quint64 numFound) {
+        qDebug().noquote() << QString("%1 %2: %3 queries/s, %4 found per query")
+            .arg(label, 14)
+            .arg(query, 8)
+            .arg((double)numQueries * USECS_PER_SECOND / std::max(usecs, (quint64)1), 12, 'f', 0)
+            .arg((double)numFound / numQueries, 0, 'f', 1);
+    };
+
+    QVector<EntityItemPointer> foundEntities;
+    quint64 numFound = 0;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < numQueries; ++i) {
+        tree->findEntities(randomPosition(), QUERY_RADIUS, foundEntities);
+        numFound += foundEntities.size();
+        foundEntities.clear();
+    }
+    report("sphere", usecTimestampNow() - start, numFound);
+
+    numFound = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < numQueries; ++i) {
+        tree->findEntities(AABox(randomPosition(), QUERY_RADIUS), foundEntities);
+        numFound += foundEntities.size();
+        foundEntities.clear();
+    }
+    report("box", usecTimestampNow() - start, numFound);
+
+    numFound = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < numQueries; ++i) {
+        if (tree->findClosestEntity(randomPosition(), QUERY_RADIUS)) {
+            numFound++;
+        }
+    }
+    report("closest", usecTimestampNow() - start, numFound);
+
+    numFound = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < numQueries; ++i) {
+        glm::vec3 origin = randomPosition();
+        glm::vec3 rayDirection = glm::normalize(glm::vec3(direction(generator), direction(generator),
+                                                          direction(generator)) + glm::vec3(0.0f, 0.0f, 0.01f));
+        OctreeElementPointer element;
+        float distance;
+        BoxFace face;
+        glm::vec3 surfaceNormal;
+        if (tree->findRayIntersection(origin, rayDirection, element, distance, face, surfaceNormal,
+                                      QVector<EntityItemID>(), nullptr, Octree::Lock)) {
+            numFound++;
+        }
+    }
+    report("ray", usecTimestampNow() - start, numFound);
+}
+
+void EntityQueryTool::benchmarkBatches(EntityTreePointer tree, int numQueries, int batchSize) const {
+    std::mt19937 generator(numQueries);
+    std::uniform_real_distribution<float> position(-SYNTHETIC_DOMAIN_SIZE / 2.0f, SYNTHETIC_DOMAIN_SIZE / 2.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> directions;
+    for (int i = 0; i < numQueries; ++i) {
+        origins.push_back(glm::vec3(position(generator), position(generator) / 10.0f, position(generator)));
+        directions.push_back(glm::normalize(glm::vec3(direction(generator), direction(generator), direction(generator))
+                                            + glm::vec3(0.0f, 0.0f, 0.01f)));
+    }
+
+    auto report = [&](const QString& label, quint64 usecs, int numFound) {
+        qDebug().noquote() << QString("%1: %2 rays/s, %3 hit")
+            .arg(label, 23)
+            .arg((double)numQueries * USECS_PER_SECOND / std::max(usecs, (quint64)1), 12, 'f', 0)
+            .arg(numFound);
+    };
+
+    int numFound = 0;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < numQueries; ++i) {
+        OctreeElementPointer element;
+        float distance;
+        BoxFace face;
+        glm::vec3 surfaceNormal;
+        if (tree->findRayIntersection(origins[i], directions[i], element, distance, face, surfaceNormal,
+                                      QVector<EntityItemID>(), nullptr, Octree::Lock)) {
+            numFound++;
+        }
+    }
+    report("one ray at a time", usecTimestampNow() - start, numFound);
+
+    numFound = 0;
+    start = usecTimestampNow();
+    for (int first = 0; first < numQueries; first += batchSize) {
+        auto batch = std::make_shared<EntityQueryBatch>();
+        int last = std::min(first + batchSize, numQueries);
+        for (int i = first; i < last; ++i) {
+            batch->addRay(origins[i], directions[i]);
+        }
+        tree->runQueryBatch(batch);
+        for (int i = 0; i < batch->getNumRays(); ++i) {
+            if (batch->getRayResult(i).intersects) {
+                numFound++;
+            }
+        }
+    }
+    report(QString("batches of %1").arg(batchSize), usecTimestampNow() - start, numFound);
+}
@@ -0,0 +1,45 @@
+//
+//  EntityQueryTool.h
+//  tools/entity-query/src
+//
+//  Created by High Fidelity on 2/12/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_EntityQueryTool_h
+#define hifi_EntityQueryTool_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+
+#include <EntityTree.h>
+
+// Benchmarks the spatial queries of an EntityTree on a synthetic domain, with and without its spatial index,
+// and one at a time against query batches
+class EntityQueryTool : public QCoreApplication {
+    Q_OBJECT
+public:
+    EntityQueryTool(int& argc, char** argv);
+
+    int run();
+
+private:
+    void parseArguments();
+
+    void addEntities(EntityTreePointer tree, int numEntities) const;
+
+    // runs every kind of query numQueries times and prints their throughput
+    void benchmark(EntityTreePointer tree, int numQueries, const QString& label) const;
+
+    // casts numQueries rays one at a time, then in batches, and prints the rays per second of each
+    void benchmarkBatches(EntityTreePointer tree, int numQueries, int batchSize) const;
+
+    QCommandLineParser _argumentParser;
+};
+
+#endif // hifi_EntityQueryTool_h
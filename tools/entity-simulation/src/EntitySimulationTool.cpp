@@ -0,0 +1,151 @@
+//
+//  EntitySimulationTool.cpp
+//  tools/entity-simulation/src
+//
+//  Created by High Fidelity on 2/10/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationTool.h"
+
+#include <algorithm>
+#include <random>
+
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+
+const QCommandLineOption ENTITIES_OPTION {
+    "entities", "how many moving kinematic entities to simulate (defaults to 100000)", "entities", "100000"
+};
+const QCommandLineOption FRAMES_OPTION {
+    "frames", "how many simulation frames to run for each thread count (defaults to 100)", "frames", "100"
+};
+const QCommandLineOption THREADS_OPTION {
+    "threads", "simulation threads to compare against a single thread (defaults to one per core)", "threads", "0"
+};
+
+// the synthetic domain is spread over a few square kilometers, like a large city
+const float SYNTHETIC_DOMAIN_SIZE = 2000.0f;
+
+// the entity server simulates at about this rate
+const quint64 SIMULATION_FRAME_USECS = USECS_PER_SECOND / 60;
+
+EntitySimulationTool::EntitySimulationTool(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    parseArguments();
+}
+
+void EntitySimulationTool::parseArguments() {
+    _argumentParser.setApplicationDescription("High Fidelity Entity Simulation Benchmark");
+
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    _argumentParser.addOptions({ ENTITIES_OPTION, FRAMES_OPTION, THREADS_OPTION });
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (_argumentParser.isSet(helpOption)) {
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+}
+
+int EntitySimulationTool::run() {
+    int numEntities = _argumentParser.value(ENTITIES_OPTION).toInt();
+    int numFrames = std::max(_argumentParser.value(FRAMES_OPTION).toInt(), 1);
+    int numThreads = _argumentParser.value(THREADS_OPTION).toInt();
+    if (numThreads < 1) {
+        numThreads = QThread::idealThreadCount();
+    }
+
+    benchmark(numEntities, numFrames, 1);
+    if (numThreads > 1) {
+        benchmark(numEntities, numFrames, numThreads);
+    }
+    return 0;
+}
+
+void EntitySimulationTool::benchmark(int numEntities, int numFrames, int numThreads) {
+    auto tree = std::make_shared<EntityTree>(true);
+    tree->setIsServer(true);
+    tree->createRootElement();
+
+    SimpleEntitySimulation simulation;
+    simulation.setEntityTree(tree);
+    simulation.setNumSimulationThreads(numThreads);
+    tree->setSimulation(&simulation);
+
+    addMovingEntities(tree, numEntities);
+
+    quint64 totalFrameTime = 0;
+    quint64 maxFrameTime = 0;
+    quint64 totalSimulatingTime = 0;
+    quint64 totalSortingTime = 0;
+    quint64 totalResorted = 0;
+
+    for (int frame = 0; frame < numFrames; ++frame) {
+        quint64 start = usecTimestampNow();
+        tree->update();
+        quint64 frameTime = usecTimestampNow() - start;
+
+        totalFrameTime += frameTime;
+        maxFrameTime = std::max(maxFrameTime, frameTime);
+        totalSimulatingTime += simulation.getUsecsSimulating();
+        totalSortingTime += simulation.getUsecsSorting();
+        totalResorted += simulation.getNumEntitiesResorted();
+
+        // pace the frames like the server does, so entities move about as far per frame
+        if (frameTime < SIMULATION_FRAME_USECS) {
+            usleep((int)(SIMULATION_FRAME_USECS - frameTime));
+        }
+    }
+
+    qDebug().noquote() << QString("%1 threads: %2 entities, frame %3 us (max %4 us), simulate %5 us, sort %6 us, "
+                                  "%7 resorted per frame")
+        .arg(numThreads, 3)
+        .arg(simulation.getNumEntitiesSimulated())
+        .arg(totalFrameTime / numFrames, 8)
+        .arg(maxFrameTime, 8)
+        .arg(totalSimulatingTime / numFrames, 8)
+        .arg(totalSortingTime / numFrames, 8)
+        .arg(totalResorted / numFrames);
+
+    tree->setSimulation(nullptr);
+}
+
+void EntitySimulationTool::addMovingEntities(EntityTreePointer tree, int numEntities) const {
+    std::mt19937 generator(numEntities);
+    std::uniform_real_distribution<float> position(-SYNTHETIC_DOMAIN_SIZE / 2.0f, SYNTHETIC_DOMAIN_SIZE / 2.0f);
+    std::uniform_real_distribution<float> size(0.1f, 2.0f);
+    std::uniform_real_distribution<float> velocity(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> angularVelocity(-PI, PI);
+
+    quint64 now = usecTimestampNow();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; ++i) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::vec3(position(generator), position(generator) / 10.0f, position(generator)));
+            properties.setDimensions(glm::vec3(size(generator), size(generator), size(generator)));
+            properties.setVelocity(glm::vec3(velocity(generator), velocity(generator), velocity(generator)));
+            properties.setAngularVelocity(glm::vec3(angularVelocity(generator), angularVelocity(generator),
+                                                    angularVelocity(generator)));
+            properties.setCreated(now);
+            properties.setLastEdited(now);
+
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+}
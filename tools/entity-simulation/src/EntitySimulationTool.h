@@ -0,0 +1,40 @@
+//
+//  EntitySimulationTool.h
+//  tools/entity-simulation/src
+//
+//  Created by High Fidelity on 2/10/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_EntitySimulationTool_h
+#define hifi_EntitySimulationTool_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+
+#include <EntityTree.h>
+
+// Benchmarks the entity server simulation of a synthetic domain full of moving kinematic entities
+class EntitySimulationTool : public QCoreApplication {
+    Q_OBJECT
+public:
+    EntitySimulationTool(int& argc, char** argv);
+
+    int run();
+
+private:
+    void parseArguments();
+
+    void benchmark(int numEntities, int numFrames, int numThreads);
+
+    void addMovingEntities(EntityTreePointer tree, int numEntities) const;
+
+    QCommandLineParser _argumentParser;
+};
+
+#endif // hifi_EntitySimulationTool_h
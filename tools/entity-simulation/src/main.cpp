@@ -0,0 +1,17 @@
+//
+//  main.cpp
+//  tools/entity-simulation/src
+//
+//  Created by High Fidelity on 2/10/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationTool.h"
+
+int main(int argc, char* argv[]) {
+    EntitySimulationTool app(argc, argv);
+    return app.run();
+}
@@ -0,0 +1,212 @@
+//
+//  EntitySnapshotTool.cpp
+//  tools/entity-snapshot/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshotTool.h"
+
+#include <random>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+
+#include <NumericalConstants.h>
+#include <PathUtils.h>
+#include <SharedUtil.h>
+
+const QCommandLineOption CONVERT_OPTION {
+    "convert", "entity persist file (svo, json, json.gz or hfb) to convert", "file"
+};
+const QCommandLineOption OUTPUT_OPTION {
+    "output", "where to write the converted file, its extension picks the format (defaults to the input as hfb)", "file"
+};
+const QCommandLineOption BENCHMARK_OPTION {
+    "benchmark", "save and load a synthetic domain of this many entities as json.gz and as hfb, and compare", "entities"
+};
+
+// the synthetic domain is spread over a few square kilometers, like a large city
+const float SYNTHETIC_DOMAIN_SIZE = 2000.0f;
+
+EntitySnapshotTool::EntitySnapshotTool(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    parseArguments();
+}
+
+void EntitySnapshotTool::parseArguments() {
+    _argumentParser.setApplicationDescription("High Fidelity Entity Snapshot Tool");
+
+    const QCommandLineOption helpOption = _argumentParser.addHelpOption();
+
+    _argumentParser.addOptions({ CONVERT_OPTION, OUTPUT_OPTION, BENCHMARK_OPTION });
+
+    if (!_argumentParser.parse(arguments())) {
+        qCritical() << _argumentParser.errorText();
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (_argumentParser.isSet(helpOption)
+        || (!_argumentParser.isSet(CONVERT_OPTION) && !_argumentParser.isSet(BENCHMARK_OPTION))) {
+        _argumentParser.showHelp();
+        Q_UNREACHABLE();
+    }
+}
+
+int EntitySnapshotTool::run() {
+    if (_argumentParser.isSet(CONVERT_OPTION)) {
+        QString inputFilename = _argumentParser.value(CONVERT_OPTION);
+        QString outputFilename = _argumentParser.isSet(OUTPUT_OPTION)
+            ? _argumentParser.value(OUTPUT_OPTION)
+            : fileNameWithoutExtension(inputFilename, PERSIST_EXTENSIONS) + ".hfb";
+        return convert(inputFilename, outputFilename);
+    }
+
+    return benchmark(_argumentParser.value(BENCHMARK_OPTION).toInt());
+}
+
+int EntitySnapshotTool::convert(const QString& inputFilename, const QString& outputFilename) {
+    QString fileType;
+    foreach (const QString& extension, PERSIST_EXTENSIONS) {
+        if (outputFilename.endsWith("." + extension) && extension.size() > fileType.size()) {
+            fileType = extension; // json.gz ends with both .gz and .json.gz, the longest match wins
+        }
+    }
+    if (fileType.isEmpty()) {
+        qCritical() << "the extension of" << outputFilename << "is not one of" << PERSIST_EXTENSIONS.toList();
+        return 1;
+    }
+
+    EntityTreePointer tree = createTree();
+    if (!readFile(tree, inputFilename)) {
+        qCritical() << "unable to read" << inputFilename;
+        return 1;
+    }
+
+    int numEntities = tree->takeSnapshot()->getNumEntities();
+    tree->writeToFile(qPrintable(outputFilename), NULL, fileType);
+
+    qDebug() << "converted" << numEntities << "entities from" << inputFilename << "to" << outputFilename;
+    return 0;
+}
+
+int EntitySnapshotTool::benchmark(int numEntities) {
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        qCritical() << "unable to create a temporary directory";
+        return 1;
+    }
+
+    EntityTreePointer tree = createTree();
+    addSyntheticEntities(tree, numEntities);
+    qDebug() << "created a synthetic domain of" << tree->takeSnapshot()->getNumEntities() << "entities";
+
+    // the files get different names since a tree reads whichever of its persist extensions is the most recent
+    const QVector<QString> FILE_TYPES = { "json.gz", "hfb" };
+    for (const QString& fileType : FILE_TYPES) {
+        QString filename = directory.path() + "/" + QString(fileType).replace('.', '-') + "." + fileType;
+
+        quint64 saveStart = usecTimestampNow();
+        tree->writeToFile(qPrintable(filename), NULL, fileType);
+        quint64 saveTime = usecTimestampNow() - saveStart;
+
+        EntityTreePointer loadedTree = createTree();
+        quint64 loadStart = usecTimestampNow();
+        bool loaded = readFile(loadedTree, filename);
+        quint64 loadTime = usecTimestampNow() - loadStart;
+
+        int numLoaded = loadedTree->takeSnapshot()->getNumEntities();
+
+        qDebug().noquote() << QString("%1: save %2 ms, load %3 ms, %4 KB, %5 entities loaded%6")
+            .arg(fileType, 8)
+            .arg(saveTime / USECS_PER_MSEC, 8)
+            .arg(loadTime / USECS_PER_MSEC, 8)
+            .arg(QFileInfo(filename).size() / BYTES_PER_KILOBYTE, 8)
+            .arg(numLoaded)
+            .arg(loaded ? "" : " (FAILED)");
+    }
+
+    return 0;
+}
+
+EntityTreePointer EntitySnapshotTool::createTree() const {
+    auto tree = std::make_shared<EntityTree>(true);
+    tree->setIsServer(true);
+    tree->createRootElement();
+    return tree;
+}
+
+bool EntitySnapshotTool::readFile(EntityTreePointer tree, const QString& filename) const {
+    // read exactly the file we were given, rather than the most recent persist file with the same name
+    bool success = false;
+    tree->withWriteLock([&] {
+        if (filename.endsWith(".json.gz")) {
+            success = tree->readJSONFromGzippedFile(filename);
+            return;
+        }
+
+        QFile file(filename);
+        if (file.open(QIODevice::ReadOnly)) {
+            QDataStream fileInputStream(&file);
+            success = tree->readFromStream(file.size(), fileInputStream);
+        }
+    });
+    return success;
+}
+
+void EntitySnapshotTool::addSyntheticEntities(EntityTreePointer tree, int numEntities) const {
+    std::mt19937 generator(numEntities);
+    std::uniform_real_distribution<float> position(-SYNTHETIC_DOMAIN_SIZE / 2.0f, SYNTHETIC_DOMAIN_SIZE / 2.0f);
+    std::uniform_real_distribution<float> size(0.1f, 10.0f);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_int_distribution<int> color(0, 255);
+
+    // a mix of the kinds of entities that make up most domains, with a few that carry a lot of user data
+    const int MODEL_PERCENT = 40;
+    const int LIGHT_PERCENT = 10;
+    const int TEXT_PERCENT = 5;
+    const int LARGE_USER_DATA_PERCENT = 1;
+    const int LARGE_USER_DATA_BYTES = 4096;
+
+    quint64 now = usecTimestampNow();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; ++i) {
+            EntityItemProperties properties;
+            properties.setPosition(glm::vec3(position(generator), position(generator) / 10.0f, position(generator)));
+            properties.setDimensions(glm::vec3(size(generator), size(generator), size(generator)));
+            properties.setName(QString("entity %1").arg(i));
+            properties.setCreated(now);
+            properties.setLastEdited(now);
+
+            int roll = kind(generator);
+            if (roll < MODEL_PERCENT) {
+                properties.setType(EntityTypes::Model);
+                properties.setModelURL(QString("http://models.example.com/building-%1.fbx").arg(i % 100));
+            } else if (roll < MODEL_PERCENT + LIGHT_PERCENT) {
+                properties.setType(EntityTypes::Light);
+                properties.setIntensity(size(generator));
+            } else if (roll < MODEL_PERCENT + LIGHT_PERCENT + TEXT_PERCENT) {
+                properties.setType(EntityTypes::Text);
+                properties.setText(QString("sign number %1").arg(i));
+            } else {
+                properties.setType(EntityTypes::Box);
+                properties.setColor({ (uint8_t)color(generator), (uint8_t)color(generator), (uint8_t)color(generator) });
+            }
+
+            if (roll < LARGE_USER_DATA_PERCENT) {
+                properties.setUserData(QString(LARGE_USER_DATA_BYTES, 'x'));
+            }
+
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+}
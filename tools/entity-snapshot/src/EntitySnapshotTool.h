@@ -0,0 +1,43 @@
+//
+//  EntitySnapshotTool.h
+//  tools/entity-snapshot/src
+//
+//  Created by High Fidelity on 2/8/16.
+//  Copyright 2016 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_EntitySnapshotTool_h
+#define hifi_EntitySnapshotTool_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+
+#include <EntityTree.h>
+
+// Converts entity persist files between the JSON and binary snapshot formats, and benchmarks loading and saving both
+class EntitySnapshotTool : public QCoreApplication {
+    Q_OBJECT
+public:
+    EntitySnapshotTool(int& argc, char** argv);
+
+    int run();
+
+private:
+    void parseArguments();
+
+    int convert(const QString& inputFilename, const QString& outputFilename);
+    int benchmark(int numEntities);
+
+    EntityTreePointer createTree() const;
+    bool readFile(EntityTreePointer tree, const QString& filename) const;
+    void addSyntheticEntities(EntityTreePointer tree, int numEntities) const;
+
+    QCommandLineParser _argumentParser;
+};
+
+#endif // hifi_EntitySnapshotTool_h
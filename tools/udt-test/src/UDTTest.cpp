@@ -11,13 +11,20 @@
 
 #include "UDTTest.h"
 
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
+#include <udt/PacketBatch.h>
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <SharedUtil.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +62,18 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption SEND_BENCHMARK {
+    "send-benchmark", "send unreliable packets to loopback one by one and then in batches, and compare the cost", "packets"
+};
+const QCommandLineOption RECEIVE_BENCHMARK {
+    "receive-benchmark", "send unreliable packets to our own socket and report how fast they are received", "packets"
+};
+const QCommandLineOption SOAK_CONNECTIONS {
+    "soak", "keep reliable connections to this many local sockets busy (needs ulimit -n above the count)", "connections"
+};
+const QCommandLineOption SOAK_SECONDS {
+    "soak-seconds", "how long the soak runs (default is 30s)", "seconds", "30"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (P/s)", "Est. Max (P/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -171,6 +190,22 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // seed the generator with a value that the receiver will also use when verifying the ordered message
     _generator.seed(messageSeed);
     
+    if (_argumentParser.isSet(SEND_BENCHMARK)) {
+        runSendBenchmark(_argumentParser.value(SEND_BENCHMARK).toInt());
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+    
+    if (_argumentParser.isSet(RECEIVE_BENCHMARK)) {
+        startReceiveBenchmark(_argumentParser.value(RECEIVE_BENCHMARK).toInt());
+        return;
+    }
+    
+    if (_argumentParser.isSet(SOAK_CONNECTIONS)) {
+        startSoak(_argumentParser.value(SOAK_CONNECTIONS).toInt(), _argumentParser.value(SOAK_SECONDS).toInt());
+        return;
+    }
+    
     if (!_target.isNull()) {
         sendInitialPackets();
     } else {
@@ -218,6 +253,12 @@ UDTTest::UDTTest(int& argc, char** argv) :
     statsTimer->start(_statsInterval);
 }
 
+UDTTest::~UDTTest() {
+    if (_benchmarkSender.joinable()) {
+        _benchmarkSender.join();
+    }
+}
+
 void UDTTest::parseArguments() {
     // use a QCommandLineParser to setup command line arguments and give helpful output
     _argumentParser.setApplicationDescription("High Fidelity UDT Protocol Test Client");
@@ -228,7 +269,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, SEND_BENCHMARK, RECEIVE_BENCHMARK,
+        SOAK_CONNECTIONS, SOAK_SECONDS
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -335,6 +377,215 @@ void UDTTest::sendPacket() {
     
 }
 
+void UDTTest::runSendBenchmark(int numPackets) {
+    // nobody reads from the sink, the kernel drops whatever doesn't fit in its buffer
+    QUdpSocket sinkSocket;
+    sinkSocket.bind(QHostAddress::LocalHost);
+    HifiSockAddr sink(QHostAddress::LocalHost, sinkSocket.localPort());
+    
+    int payloadSize = _maxPacketSize - udt::Packet::localHeaderSize(false);
+    
+    // about what a mixer sends out per frame to a busy domain
+    static const int PACKETS_PER_FRAME = 100;
+    
+    // a single run is at the mercy of whatever else the machine is doing, so the modes take turns and the medians
+    // are compared
+    static const int NUM_ROUNDS = 5;
+    std::vector<double> cpuMsecsPerMode[2];
+    quint64 sendCallsPerMode[2] = { 0, 0 };
+    
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        for (int batched = 0; batched < 2; ++batched) {
+            quint64 sendCallsBefore = _socket._numSendCalls;
+            quint64 start = usecTimestampNow();
+            std::clock_t cpuStart = std::clock();
+            
+            udt::PacketBatch batch;
+            for (int i = 0; i < numPackets; ++i) {
+                auto packet = udt::Packet::create(payloadSize, false);
+                packet->setPayloadSize(payloadSize);
+                
+                if (batched) {
+                    batch.add(std::move(packet), sink);
+                    if (batch.getNumPackets() == PACKETS_PER_FRAME) {
+                        _socket.writePacketBatch(batch);
+                    }
+                } else {
+                    _socket.writePacket(*packet, sink);
+                }
+            }
+            _socket.writePacketBatch(batch);
+            
+            static const double USECS_PER_MSEC = 1000.0;
+            double msecs = (usecTimestampNow() - start) / USECS_PER_MSEC;
+            double cpuMsecs = (std::clock() - cpuStart) * 1000.0 / CLOCKS_PER_SEC;
+            quint64 sendCalls = _socket._numSendCalls - sendCallsBefore;
+            cpuMsecsPerMode[batched].push_back(cpuMsecs);
+            sendCallsPerMode[batched] = sendCalls;
+            
+            qDebug() << (batched ? "Batched:   " : "One by one:") << numPackets << "packets in" << msecs << "ms, using"
+                << cpuMsecs << "ms of CPU and" << sendCalls << "send calls";
+        }
+    }
+    
+    for (int batched = 0; batched < 2; ++batched) {
+        auto& cpuMsecs = cpuMsecsPerMode[batched];
+        std::sort(cpuMsecs.begin(), cpuMsecs.end());
+        qDebug() << "Median" << (batched ? "batched:   " : "one by one:") << cpuMsecs[NUM_ROUNDS / 2] << "ms of CPU for"
+            << sendCallsPerMode[batched] << "send calls";
+    }
+}
+
+void UDTTest::startReceiveBenchmark(int numPackets) {
+    qDebug() << "Sending" << numPackets << "unreliable packets of" << _maxPacketSize << "bytes to ourselves";
+    
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        _benchmarkLastReceive = usecTimestampNow();
+        if (_benchmarkPackets++ == 0) {
+            _benchmarkFirstReceive = _benchmarkLastReceive;
+        }
+    });
+    
+    quint16 port = _socket.localPort();
+    int payloadSize = _maxPacketSize - udt::Packet::localHeaderSize(false);
+    
+    _benchmarkSender = std::thread([this, numPackets, port, payloadSize] {
+        // the sender only writes, so it does not need an event loop
+        QUdpSocket senderSocket;
+        
+        auto packet = udt::Packet::create(payloadSize, false);
+        packet->setPayloadSize(payloadSize);
+        
+        for (int i = 0; i < numPackets; ++i) {
+            senderSocket.writeDatagram(packet->getData(), packet->getDataSize(), QHostAddress::LocalHost, port);
+        }
+        
+        _benchmarkSendDone = true;
+    });
+    
+    // the benchmark is over once the sender is done and the socket has gone quiet
+    static const int BENCHMARK_CHECK_INTERVAL_MSECS = 500;
+    
+    QTimer* checkTimer = new QTimer(this);
+    connect(checkTimer, &QTimer::timeout, this, &UDTTest::checkReceiveBenchmark);
+    checkTimer->start(BENCHMARK_CHECK_INTERVAL_MSECS);
+}
+
+void UDTTest::checkReceiveBenchmark() {
+    if (!_benchmarkSendDone || _benchmarkPackets != _benchmarkPacketsAtLastCheck) {
+        _benchmarkPacketsAtLastCheck = _benchmarkPackets;
+        return;
+    }
+    
+    static const double USECS_PER_SECOND = 1000000.0;
+    double seconds = (_benchmarkLastReceive - _benchmarkFirstReceive) / USECS_PER_SECOND;
+    double packetsPerSecond = seconds > 0.0 ? _benchmarkPackets / seconds : 0.0;
+    
+    qDebug() << "Received" << _benchmarkPackets << "packets in" << seconds << "seconds -"
+        << (int) packetsPerSecond << "packets per second";
+    
+    double datagramsPerCall = _socket._numReceiveCalls > 0 ?
+        (double) _socket._numDatagramsReceived / _socket._numReceiveCalls : 0.0;
+#ifdef Q_OS_LINUX
+    qDebug() << "Read" << datagramsPerCall << "datagrams per receive call using recvmmsg";
+#else
+    qDebug() << "Read" << datagramsPerCall << "datagrams per receive call using QUdpSocket";
+#endif
+    
+    qDebug() << "Allocated" << _socket._bufferPool->getNumAllocated() << "packet buffers and re-used"
+        << _socket._bufferPool->getNumReused();
+    
+    quit();
+}
+
+void UDTTest::startSoak(int numConnections, int seconds) {
+    qDebug() << "Soaking" << numConnections << "reliable connections for" << seconds << "seconds";
+    
+    _soakPacketsReceived.resize(numConnections, 0);
+    
+    for (int i = 0; i < numConnections; ++i) {
+        auto receiver = std::unique_ptr<udt::Socket>(new udt::Socket);
+        receiver->bind(QHostAddress::LocalHost);
+        
+        if (receiver->localPort() == 0) {
+            qCritical() << "Could only bind" << i << "of" << numConnections << "sockets - is ulimit -n high enough?";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+        
+        receiver->setPacketHandler([this, i](std::unique_ptr<udt::Packet> packet) {
+            ++_soakPacketsReceived[i];
+        });
+        
+        _soakReceivers.push_back(std::move(receiver));
+    }
+    
+    // every connection gets a packet about as often as an agent hears from the entity server
+    static const int SOAK_SEND_INTERVAL_MSECS = 100;
+    QTimer* sendTimer = new QTimer(this);
+    connect(sendTimer, &QTimer::timeout, this, &UDTTest::sendSoakPackets);
+    sendTimer->start(SOAK_SEND_INTERVAL_MSECS);
+    
+    static const int SOAK_STATS_INTERVAL_MSECS = 1000;
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &UDTTest::sampleSoakStats);
+    statsTimer->start(SOAK_STATS_INTERVAL_MSECS);
+    
+    QTimer::singleShot(seconds * 1000, this, &UDTTest::finishSoak);
+}
+
+void UDTTest::sendSoakPackets() {
+    static const int SOAK_PAYLOAD_SIZE = 100;
+    
+    for (auto& receiver : _soakReceivers) {
+        auto packet = udt::Packet::create(SOAK_PAYLOAD_SIZE, true);
+        packet->setPayloadSize(SOAK_PAYLOAD_SIZE);
+        
+        _socket.writePacket(std::move(packet), HifiSockAddr(QHostAddress::LocalHost, receiver->localPort()));
+        ++_soakPacketsSent;
+    }
+}
+
+static int processThreadCount() {
+    // the scheduler is meant to keep this flat no matter how many connections we have
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine()) {
+            if (line.startsWith("Threads:")) {
+                return line.mid(strlen("Threads:")).trimmed().toInt();
+            }
+        }
+    }
+    return -1;
+}
+
+void UDTTest::sampleSoakStats() {
+    int packetsReceived = 0;
+    for (int received : _soakPacketsReceived) {
+        packetsReceived += received;
+    }
+    
+    auto& scheduler = _socket.getSendQueueScheduler();
+    auto schedulerStats = scheduler.sampleStats();
+    double averageLateness = schedulerStats.steps > 0 ?
+        (double) schedulerStats.totalLatenessUsecs / schedulerStats.steps : 0.0;
+    
+    qDebug() << "Sent" << _soakPacketsSent << "received" << packetsReceived
+        << "| connections" << _socket._connectionsHash.size() << "send queues" << scheduler.getNumQueues()
+        << "| threads" << processThreadCount() << "scheduler threads" << scheduler.getNumThreads()
+        << "| steps" << schedulerStats.steps << "lateness avg" << averageLateness << "us max"
+        << schedulerStats.maxLatenessUsecs << "us";
+}
+
+void UDTTest::finishSoak() {
+    sampleSoakStats();
+    
+    int starved = std::count(_soakPacketsReceived.begin(), _soakPacketsReceived.end(), 0);
+    qDebug() << "Soak finished -" << starved << "of" << _soakReceivers.size() << "connections received nothing";
+    
+    quit();
+}
+
 void UDTTest::handleMessage(std::unique_ptr<Message> message) {
     // generate the byte array that should match this message - using the same seed the sender did
     
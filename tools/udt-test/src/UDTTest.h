@@ -15,7 +15,9 @@
 #define hifi_UDTTest_h
 
 
+#include <atomic>
 #include <random>
+#include <thread>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
@@ -34,10 +36,15 @@ class UDTTest : public QCoreApplication {
     Q_OBJECT
 public:
     UDTTest(int& argc, char** argv);
+    ~UDTTest();
 
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void checkReceiveBenchmark();
+    void sendSoakPackets(); // sends one reliable packet to each soak receiver
+    void sampleSoakStats();
+    void finishSoak();
     
 private:
     void parseArguments();
@@ -46,6 +53,10 @@ private:
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
     
+    void startReceiveBenchmark(int numPackets); // blasts unreliable packets at our own socket from another thread
+    void runSendBenchmark(int numPackets); // compares sending packets one by one to sending them in batches
+    void startSoak(int numConnections, int seconds); // keeps reliable connections to many local sockets busy
+    
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
     
@@ -71,6 +82,17 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+    
+    std::thread _benchmarkSender; // sends the packets for the receive benchmark
+    std::atomic<bool> _benchmarkSendDone { false };
+    int _benchmarkPackets { 0 }; // number of packets received during the receive benchmark
+    int _benchmarkPacketsAtLastCheck { 0 };
+    quint64 _benchmarkFirstReceive { 0 };
+    quint64 _benchmarkLastReceive { 0 };
+    
+    std::vector<std::unique_ptr<udt::Socket>> _soakReceivers; // one per reliable connection of the soak
+    std::vector<int> _soakPacketsReceived; // per receiver
+    int _soakPacketsSent { 0 };
 };
 
 #endif // hifi_UDTTest_h